@@ -0,0 +1,26 @@
+/* Shared helpers for DQ3 zero-copy structure views */
+/* Generated from Dragon Quest III analysis */
+/* Requires C++20 (std::span) */
+
+#ifndef DQ3_VIEW_HPP
+#define DQ3_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace dq3 {
+
+/* SNES WRAM is little-endian; compose bytes so reads are host-independent and unaligned-safe */
+constexpr uint16_t read_u16le(const uint8_t* p) {
+	return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+constexpr uint32_t read_u24le(const uint8_t* p) {
+	return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+		(static_cast<uint32_t>(p[2]) << 16);
+}
+
+} /* namespace dq3 */
+
+#endif /* DQ3_VIEW_HPP */
@@ -0,0 +1,115 @@
+/* Hero Zero-Copy View */
+/* Generated from Dragon Quest III analysis */
+/* Base Address: $3925 */
+/* Size: 60 bytes */
+
+#ifndef DQ3_HERO_VIEW_HPP
+#define DQ3_HERO_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "dq3_view.hpp"
+#include "hero.h"
+
+namespace dq3 {
+
+#pragma pack(push, 1)
+struct Hero_Packed {
+	uint8_t Hero_Level[1]; /* +00 */
+	uint8_t Hero_XP[3]; /* +01 */
+	uint8_t HP_Max[2]; /* +04 */
+	uint8_t Hero_HP[2]; /* +06 */
+	uint8_t MP_Max[2]; /* +08 */
+	uint8_t Hero_MP[2]; /* +0A */
+	uint8_t Hero_Strength[1]; /* +0C */
+	uint8_t Hero_Agility[1]; /* +0D */
+	uint8_t Hero_Stamina[1]; /* +0E */
+	uint8_t Hero_Wisdom[1]; /* +0F */
+	uint8_t Hero_Luck[1]; /* +10 */
+	uint8_t Reserved_11[5]; /* Undocumented +11 */
+	uint8_t Hero_Name[5]; /* +16 */
+	uint8_t Reserved_1B[9]; /* Undocumented +1B */
+	uint8_t Hero_Spells[10]; /* +24 */
+	uint8_t Bag_Number_Equiped[1]; /* +2E */
+	uint8_t Bag_Number_Carried[1]; /* +2F */
+	uint8_t Bag_Items[12]; /* +30 */
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Hero_Packed) == HERO_SIZE, "Hero_Packed must match the WRAM block size");
+static_assert(offsetof(Hero_Packed, Hero_Level) == 0x00);
+static_assert(offsetof(Hero_Packed, Hero_XP) == 0x01);
+static_assert(offsetof(Hero_Packed, HP_Max) == 0x04);
+static_assert(offsetof(Hero_Packed, Hero_HP) == 0x06);
+static_assert(offsetof(Hero_Packed, MP_Max) == 0x08);
+static_assert(offsetof(Hero_Packed, Hero_MP) == 0x0A);
+static_assert(offsetof(Hero_Packed, Hero_Strength) == 0x0C);
+static_assert(offsetof(Hero_Packed, Hero_Agility) == 0x0D);
+static_assert(offsetof(Hero_Packed, Hero_Stamina) == 0x0E);
+static_assert(offsetof(Hero_Packed, Hero_Wisdom) == 0x0F);
+static_assert(offsetof(Hero_Packed, Hero_Luck) == 0x10);
+static_assert(offsetof(Hero_Packed, Reserved_11) == 0x11);
+static_assert(offsetof(Hero_Packed, Hero_Name) == 0x16);
+static_assert(offsetof(Hero_Packed, Reserved_1B) == 0x1B);
+static_assert(offsetof(Hero_Packed, Hero_Spells) == 0x24);
+static_assert(offsetof(Hero_Packed, Bag_Number_Equiped) == 0x2E);
+static_assert(offsetof(Hero_Packed, Bag_Number_Carried) == 0x2F);
+static_assert(offsetof(Hero_Packed, Bag_Items) == 0x30);
+
+class Hero_View {
+public:
+	static constexpr uint32_t base_addr = HERO_BASE_ADDR;
+	static constexpr std::size_t size = HERO_SIZE;
+
+	constexpr explicit Hero_View(std::span<const uint8_t, HERO_SIZE> bytes) : bytes_(bytes) {}
+
+	/* wram must cover at least base_addr + size bytes (e.g. a full 128KB WRAM dump) */
+	static Hero_View from_wram(std::span<const uint8_t> wram) {
+		return Hero_View(wram.subspan<HERO_BASE_ADDR, HERO_SIZE>());
+	}
+
+	const Hero_Packed& raw() const { return *reinterpret_cast<const Hero_Packed*>(bytes_.data()); }
+	std::span<const uint8_t, HERO_SIZE> bytes() const { return bytes_; }
+
+	/* Hero - Level\nTop 7 bits are Hero's level, bottom bit unknown */
+	uint8_t Hero_Level() const { return bytes_[0x00]; }
+	/* Hero - XP */
+	uint32_t Hero_XP() const { return read_u24le(bytes_.data() + 0x01); }
+	/* Hero - Max HP */
+	uint16_t HP_Max() const { return read_u16le(bytes_.data() + 0x04); }
+	/* Hero - Current HP */
+	uint16_t Hero_HP() const { return read_u16le(bytes_.data() + 0x06); }
+	/* Hero - Max MP */
+	uint16_t MP_Max() const { return read_u16le(bytes_.data() + 0x08); }
+	/* Hero - Current MP */
+	uint16_t Hero_MP() const { return read_u16le(bytes_.data() + 0x0A); }
+	/* Hero - Strength stat */
+	uint8_t Hero_Strength() const { return bytes_[0x0C]; }
+	/* Hero - Agility stat */
+	uint8_t Hero_Agility() const { return bytes_[0x0D]; }
+	/* Hero - Stamina stat */
+	uint8_t Hero_Stamina() const { return bytes_[0x0E]; }
+	/* Hero - Wisdom stat */
+	uint8_t Hero_Wisdom() const { return bytes_[0x0F]; }
+	/* Hero - Luck stat, excluding equipment */
+	uint8_t Hero_Luck() const { return bytes_[0x10]; }
+	/* Hero - Name, 4 characters max, ends in AC */
+	std::span<const uint8_t, 5> Hero_Name() const { return bytes_.subspan<0x16, 5>(); }
+	/* Hero spells flags */
+	std::span<const uint8_t, 10> Hero_Spells() const { return bytes_.subspan<0x24, 10>(); }
+	/* Hero - Number of items equipped */
+	uint8_t Bag_Number_Equiped() const { return bytes_[0x2E]; }
+	/* Hero - Number of items in bag */
+	uint8_t Bag_Number_Carried() const { return bytes_[0x2F]; }
+	/* Hero - Each byte is which item is in the bag slot */
+	std::span<const uint8_t, 12> Bag_Items() const { return bytes_.subspan<0x30, 12>(); }
+
+private:
+	std::span<const uint8_t, HERO_SIZE> bytes_;
+};
+
+} /* namespace dq3 */
+
+#endif /* DQ3_HERO_VIEW_HPP */
@@ -0,0 +1,55 @@
+/* Inventory Zero-Copy View */
+/* Generated from Dragon Quest III analysis */
+/* Base Address: $3725 */
+/* Size: 512 bytes */
+
+#ifndef DQ3_INVENTORY_VIEW_HPP
+#define DQ3_INVENTORY_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "dq3_view.hpp"
+#include "inventory.h"
+
+namespace dq3 {
+
+#pragma pack(push, 1)
+struct Inventory_Packed {
+	uint8_t Bag_Items[256]; /* +00 */
+	uint8_t Items_Amounts[256]; /* +100 */
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Inventory_Packed) == INVENTORY_SIZE, "Inventory_Packed must match the WRAM block size");
+static_assert(offsetof(Inventory_Packed, Bag_Items) == 0x00);
+static_assert(offsetof(Inventory_Packed, Items_Amounts) == 0x100);
+
+class Inventory_View {
+public:
+	static constexpr uint32_t base_addr = INVENTORY_BASE_ADDR;
+	static constexpr std::size_t size = INVENTORY_SIZE;
+
+	constexpr explicit Inventory_View(std::span<const uint8_t, INVENTORY_SIZE> bytes) : bytes_(bytes) {}
+
+	/* wram must cover at least base_addr + size bytes (e.g. a full 128KB WRAM dump) */
+	static Inventory_View from_wram(std::span<const uint8_t> wram) {
+		return Inventory_View(wram.subspan<INVENTORY_BASE_ADDR, INVENTORY_SIZE>());
+	}
+
+	const Inventory_Packed& raw() const { return *reinterpret_cast<const Inventory_Packed*>(bytes_.data()); }
+	std::span<const uint8_t, INVENTORY_SIZE> bytes() const { return bytes_; }
+
+	/* Each byte is which item is in bag slot, 0 means empty, game uses values $01-$e4 */
+	std::span<const uint8_t, 256> Bag_Items() const { return bytes_.subspan<0x00, 256>(); }
+	/* Each byte is amount of the item in the bag slot, game allows up to 99 ($63) */
+	std::span<const uint8_t, 256> Items_Amounts() const { return bytes_.subspan<0x100, 256>(); }
+
+private:
+	std::span<const uint8_t, INVENTORY_SIZE> bytes_;
+};
+
+} /* namespace dq3 */
+
+#endif /* DQ3_INVENTORY_VIEW_HPP */
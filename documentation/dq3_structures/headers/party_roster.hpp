@@ -0,0 +1,108 @@
+/* Party Roster */
+/* Generated from Dragon Quest III analysis */
+/* Base Address: $3925 */
+/* Slots: 12 x 60 bytes */
+
+#ifndef DQ3_PARTY_ROSTER_HPP
+#define DQ3_PARTY_ROSTER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "partymember_view.hpp"
+
+namespace dq3 {
+
+/* Compile-time roster slot: slot 0 is the Hero, slot n is party member #(n + 1) */
+template <std::size_t Slot>
+struct RosterSlot {
+	static_assert(Slot < PARTY_ROSTER_SLOTS, "Roster slot out of range");
+
+	static constexpr uint32_t base_addr = PARTYMEMBER_SLOT_ADDR(Slot);
+
+	static PartyMember_View from_wram(std::span<const uint8_t> wram) {
+		return PartyMember_View(wram.subspan<base_addr, PARTYMEMBER_SIZE>());
+	}
+};
+
+class Roster_View {
+public:
+	constexpr explicit Roster_View(std::span<const uint8_t, PARTY_ROSTER_SIZE> bytes) : bytes_(bytes) {}
+
+	/* wram must cover at least PARTYMEMBER_BASE_ADDR + PARTY_ROSTER_SIZE bytes */
+	static Roster_View from_wram(std::span<const uint8_t> wram) {
+		return Roster_View(wram.subspan<PARTYMEMBER_BASE_ADDR, PARTY_ROSTER_SIZE>());
+	}
+
+	template <std::size_t Slot>
+	PartyMember_View slot() const {
+		static_assert(Slot < PARTY_ROSTER_SLOTS, "Roster slot out of range");
+		return PartyMember_View(bytes_.subspan<Slot * PARTYMEMBER_SIZE, PARTYMEMBER_SIZE>());
+	}
+
+	PartyMember_View slot(std::size_t n) const {
+		return PartyMember_View(std::span<const uint8_t, PARTYMEMBER_SIZE>(bytes_.data() + n * PARTYMEMBER_SIZE, PARTYMEMBER_SIZE));
+	}
+
+private:
+	std::span<const uint8_t, PARTY_ROSTER_SIZE> bytes_;
+};
+
+/*
+ * Structure-of-arrays roster snapshots: entry [frame * PARTY_ROSTER_SLOTS + slot] of each
+ * column holds that stat for one slot in one captured frame. Large Frames counts should be
+ * heap-allocated (e.g. std::make_unique<RosterSoA<4096>>()).
+ */
+template <std::size_t Frames = 1>
+struct RosterSoA {
+	static constexpr std::size_t frames = Frames;
+	static constexpr std::size_t count = Frames * PARTY_ROSTER_SLOTS;
+
+	alignas(32) uint8_t Level[count];
+	alignas(32) uint32_t XP[count];
+	alignas(32) uint16_t HP_Max[count];
+	alignas(32) uint16_t HP[count];
+	alignas(32) uint16_t MP_Max[count];
+	alignas(32) uint16_t MP[count];
+	alignas(32) uint8_t Strength[count];
+	alignas(32) uint8_t Agility[count];
+	alignas(32) uint8_t Stamina[count];
+	alignas(32) uint8_t Wisdom[count];
+	alignas(32) uint8_t Luck[count];
+	alignas(32) uint8_t Bag_Number_Equiped[count];
+	alignas(32) uint8_t Bag_Number_Carried[count];
+	uint8_t Name[count][5];
+	uint8_t Spells[count][10];
+	uint8_t Bag_Items[count][12];
+
+	/* Gather every roster slot of one WRAM frame into the columns */
+	void capture(std::size_t frame, std::span<const uint8_t> wram) {
+		const Roster_View roster = Roster_View::from_wram(wram);
+		for (std::size_t slot = 0; slot < PARTY_ROSTER_SLOTS; ++slot) {
+			const PartyMember_View member = roster.slot(slot);
+			const std::size_t i = frame * PARTY_ROSTER_SLOTS + slot;
+			Level[i] = member.Level();
+			XP[i] = member.XP();
+			HP_Max[i] = member.HP_Max();
+			HP[i] = member.HP();
+			MP_Max[i] = member.MP_Max();
+			MP[i] = member.MP();
+			Strength[i] = member.Strength();
+			Agility[i] = member.Agility();
+			Stamina[i] = member.Stamina();
+			Wisdom[i] = member.Wisdom();
+			Luck[i] = member.Luck();
+			Bag_Number_Equiped[i] = member.Bag_Number_Equiped();
+			Bag_Number_Carried[i] = member.Bag_Number_Carried();
+			std::ranges::copy(member.Name(), Name[i]);
+			std::ranges::copy(member.Spells(), Spells[i]);
+			std::ranges::copy(member.Bag_Items(), Bag_Items[i]);
+		}
+	}
+};
+
+} /* namespace dq3 */
+
+#endif /* DQ3_PARTY_ROSTER_HPP */
@@ -0,0 +1,36 @@
+/* PartyMember Data Structure */
+/* Generated from Dragon Quest III analysis */
+/* Base Address: $3925 */
+/* Size: 60 bytes */
+
+#ifndef DQ3_PARTYMEMBER_H
+#define DQ3_PARTYMEMBER_H
+
+#include <stdint.h>
+
+#define PARTYMEMBER_BASE_ADDR 0x3925
+#define PARTYMEMBER_SIZE 60
+#define PARTY_ROSTER_SLOTS 12
+#define PARTY_ROSTER_SIZE (PARTY_ROSTER_SLOTS * PARTYMEMBER_SIZE)
+#define PARTYMEMBER_SLOT_ADDR(n) (PARTYMEMBER_BASE_ADDR + (n) * PARTYMEMBER_SIZE)
+
+typedef struct {
+	uint8_t Level; /* Level\nTop 7 bits are level, bottom bit unknown */
+	uint32_t XP; /* XP */
+	uint16_t HP_Max; /* Max HP */
+	uint16_t HP; /* Current HP */
+	uint16_t MP_Max; /* Max MP */
+	uint16_t MP; /* Current HP */
+	uint8_t Strength; /* Strength stat */
+	uint8_t Agility; /* Agility stat */
+	uint8_t Stamina; /* Stamina stat */
+	uint8_t Wisdom; /* Wisdom stat */
+	uint8_t Luck; /* Luck stat, excluding equipment */
+	char Name[5]; /* Name, 4 characters max, ends in AC */
+	uint8_t Spells; /* Spell flags */
+	uint8_t Bag_Number_Equiped; /* Number of items equipped */
+	uint8_t Bag_Number_Carried; /* Number of items in bag */
+	uint8_t Bag_Items; /* Each byte is which item is in the bag slot */
+} PartyMember_t;
+
+#endif /* DQ3_PARTYMEMBER_H */
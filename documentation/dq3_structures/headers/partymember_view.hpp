@@ -0,0 +1,115 @@
+/* PartyMember Zero-Copy View */
+/* Generated from Dragon Quest III analysis */
+/* Base Address: $3925 */
+/* Size: 60 bytes */
+
+#ifndef DQ3_PARTYMEMBER_VIEW_HPP
+#define DQ3_PARTYMEMBER_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "dq3_view.hpp"
+#include "partymember.h"
+
+namespace dq3 {
+
+#pragma pack(push, 1)
+struct PartyMember_Packed {
+	uint8_t Level[1]; /* +00 */
+	uint8_t XP[3]; /* +01 */
+	uint8_t HP_Max[2]; /* +04 */
+	uint8_t HP[2]; /* +06 */
+	uint8_t MP_Max[2]; /* +08 */
+	uint8_t MP[2]; /* +0A */
+	uint8_t Strength[1]; /* +0C */
+	uint8_t Agility[1]; /* +0D */
+	uint8_t Stamina[1]; /* +0E */
+	uint8_t Wisdom[1]; /* +0F */
+	uint8_t Luck[1]; /* +10 */
+	uint8_t Reserved_11[5]; /* Undocumented +11 */
+	uint8_t Name[5]; /* +16 */
+	uint8_t Reserved_1B[9]; /* Undocumented +1B */
+	uint8_t Spells[10]; /* +24 */
+	uint8_t Bag_Number_Equiped[1]; /* +2E */
+	uint8_t Bag_Number_Carried[1]; /* +2F */
+	uint8_t Bag_Items[12]; /* +30 */
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PartyMember_Packed) == PARTYMEMBER_SIZE, "PartyMember_Packed must match the WRAM block size");
+static_assert(offsetof(PartyMember_Packed, Level) == 0x00);
+static_assert(offsetof(PartyMember_Packed, XP) == 0x01);
+static_assert(offsetof(PartyMember_Packed, HP_Max) == 0x04);
+static_assert(offsetof(PartyMember_Packed, HP) == 0x06);
+static_assert(offsetof(PartyMember_Packed, MP_Max) == 0x08);
+static_assert(offsetof(PartyMember_Packed, MP) == 0x0A);
+static_assert(offsetof(PartyMember_Packed, Strength) == 0x0C);
+static_assert(offsetof(PartyMember_Packed, Agility) == 0x0D);
+static_assert(offsetof(PartyMember_Packed, Stamina) == 0x0E);
+static_assert(offsetof(PartyMember_Packed, Wisdom) == 0x0F);
+static_assert(offsetof(PartyMember_Packed, Luck) == 0x10);
+static_assert(offsetof(PartyMember_Packed, Reserved_11) == 0x11);
+static_assert(offsetof(PartyMember_Packed, Name) == 0x16);
+static_assert(offsetof(PartyMember_Packed, Reserved_1B) == 0x1B);
+static_assert(offsetof(PartyMember_Packed, Spells) == 0x24);
+static_assert(offsetof(PartyMember_Packed, Bag_Number_Equiped) == 0x2E);
+static_assert(offsetof(PartyMember_Packed, Bag_Number_Carried) == 0x2F);
+static_assert(offsetof(PartyMember_Packed, Bag_Items) == 0x30);
+
+class PartyMember_View {
+public:
+	static constexpr uint32_t base_addr = PARTYMEMBER_BASE_ADDR;
+	static constexpr std::size_t size = PARTYMEMBER_SIZE;
+
+	constexpr explicit PartyMember_View(std::span<const uint8_t, PARTYMEMBER_SIZE> bytes) : bytes_(bytes) {}
+
+	/* wram must cover at least base_addr + size bytes (e.g. a full 128KB WRAM dump) */
+	static PartyMember_View from_wram(std::span<const uint8_t> wram) {
+		return PartyMember_View(wram.subspan<PARTYMEMBER_BASE_ADDR, PARTYMEMBER_SIZE>());
+	}
+
+	const PartyMember_Packed& raw() const { return *reinterpret_cast<const PartyMember_Packed*>(bytes_.data()); }
+	std::span<const uint8_t, PARTYMEMBER_SIZE> bytes() const { return bytes_; }
+
+	/* Level\nTop 7 bits are level, bottom bit unknown */
+	uint8_t Level() const { return bytes_[0x00]; }
+	/* XP */
+	uint32_t XP() const { return read_u24le(bytes_.data() + 0x01); }
+	/* Max HP */
+	uint16_t HP_Max() const { return read_u16le(bytes_.data() + 0x04); }
+	/* Current HP */
+	uint16_t HP() const { return read_u16le(bytes_.data() + 0x06); }
+	/* Max MP */
+	uint16_t MP_Max() const { return read_u16le(bytes_.data() + 0x08); }
+	/* Current HP */
+	uint16_t MP() const { return read_u16le(bytes_.data() + 0x0A); }
+	/* Strength stat */
+	uint8_t Strength() const { return bytes_[0x0C]; }
+	/* Agility stat */
+	uint8_t Agility() const { return bytes_[0x0D]; }
+	/* Stamina stat */
+	uint8_t Stamina() const { return bytes_[0x0E]; }
+	/* Wisdom stat */
+	uint8_t Wisdom() const { return bytes_[0x0F]; }
+	/* Luck stat, excluding equipment */
+	uint8_t Luck() const { return bytes_[0x10]; }
+	/* Name, 4 characters max, ends in AC */
+	std::span<const uint8_t, 5> Name() const { return bytes_.subspan<0x16, 5>(); }
+	/* Spell flags */
+	std::span<const uint8_t, 10> Spells() const { return bytes_.subspan<0x24, 10>(); }
+	/* Number of items equipped */
+	uint8_t Bag_Number_Equiped() const { return bytes_[0x2E]; }
+	/* Number of items in bag */
+	uint8_t Bag_Number_Carried() const { return bytes_[0x2F]; }
+	/* Each byte is which item is in the bag slot */
+	std::span<const uint8_t, 12> Bag_Items() const { return bytes_.subspan<0x30, 12>(); }
+
+private:
+	std::span<const uint8_t, PARTYMEMBER_SIZE> bytes_;
+};
+
+} /* namespace dq3 */
+
+#endif /* DQ3_PARTYMEMBER_VIEW_HPP */
@@ -9,12 +9,17 @@ import sys
 import time
 from pathlib import Path
 
+sys.path.append(str(Path(__file__).parent / "tools" / "analysis"))
+import stage_trace
+
 
 def run_command(cmd: list, description: str) -> bool:
     """Run a command and return success status"""
     print(f"🔄 {description}...")
     try:
-        result = subprocess.run(cmd, capture_output=True, text=True, timeout=300)
+        with stage_trace.span(description, "automation", command=" ".join(str(part) for part in cmd[1:])) as scope:
+            result = subprocess.run(cmd, capture_output=True, text=True, timeout=300)
+            scope.set(returncode=result.returncode, children_peak_rss_kb=stage_trace.peak_rss_kb(children=True))
         if result.returncode == 0:
             print(f"✅ {description} - Success")
             if result.stdout.strip():
@@ -37,6 +42,7 @@ def main():
     """Run comprehensive development automation"""
     start_time = time.time()
     project_root = Path(__file__).parent
+    stage_trace.enable()
 
     print("🚀 Starting DQ3R Comprehensive Development Automation")
     print("=" * 60)
@@ -99,6 +105,13 @@ def main():
     print(f"\n⏱️  Total execution time: {elapsed:.2f} seconds")
     print(f"📈 Success rate: {successful_tasks}/{total_tasks} tasks completed")
 
+    print("\n" + "\n".join(stage_trace.format_summary(stage_trace.summary())))
+    try:
+        trace_file = stage_trace.export_chrome_trace(project_root / "logs" / "traces" / "automation_trace.json")
+        print(f"💾 Trace written to {trace_file} (open in chrome://tracing or Perfetto)")
+    except OSError as e:
+        print(f"⚠️  Could not write trace: {e}")
+
     if successful_tasks == total_tasks:
         print("🎉 All automation tasks completed successfully!")
         return 0
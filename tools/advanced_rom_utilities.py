@@ -16,6 +16,9 @@ from dataclasses import dataclass, field
 
 # Import our developed systems
 sys.path.append(str(Path(__file__).parent))
+sys.path.append(str(Path(__file__).parent / "analysis"))
+from rolling_entropy import entropy_profile, shannon_entropy
+
 try:
     from compression.compression_engine import get_compression_engine
     from asset_pipeline.snes_extractor import create_asset_pipeline
@@ -310,22 +313,7 @@ class AdvancedROMAnalyzer:
 
     def _calculate_entropy(self, data: bytes) -> float:
         """Calculate Shannon entropy of data"""
-        if not data:
-            return 0.0
-
-        frequencies = {}
-        for byte in data:
-            frequencies[byte] = frequencies.get(byte, 0) + 1
-
-        entropy = 0.0
-        data_len = len(data)
-
-        for count in frequencies.values():
-            probability = count / data_len
-            if probability > 0:
-                entropy -= probability * (probability.bit_length() - 1)
-
-        return min(entropy, 8.0)  # Cap at 8 bits
+        return shannon_entropy(data)
 
     def _estimate_structure_size(self, offset: int, structure_info: Dict[str, Any]) -> int:
         """Estimate size of variable-length structure"""
@@ -731,9 +719,8 @@ class AdvancedROMAnalyzer:
         low_entropy_regions = []
 
         chunk_size = 0x1000
-        for offset in range(0, len(self.rom_data) - chunk_size, chunk_size):
-            chunk = self.rom_data[offset : offset + chunk_size]
-            entropy = self._calculate_entropy(chunk)
+        for index, entropy in enumerate(entropy_profile(self.rom_data, chunk_size, chunk_size)):
+            offset = index * chunk_size
 
             if entropy > 7.0:
                 high_entropy_regions.append({"offset": offset, "entropy": entropy})
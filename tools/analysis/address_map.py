@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - SNES Address Mapping
+=======================================
+
+Precomputed 256-bank tables for LoROM, HiROM and ExHiROM (mirrors folded
+onto the banks they reflect), so translating an address is two table
+lookups and a range check instead of a chain of branches. The bulk API
+reads the little-endian word at every ROM offset in one pass and
+translates whole arrays of candidate pointers at once.
+"""
+
+import sys
+from array import array
+from itertools import compress
+from typing import Iterable, List, Optional, Sequence, Tuple, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+LOROM = "LoROM"
+HIROM = "HiROM"
+EXHIROM = "ExHiROM"
+
+MAPPINGS = (LOROM, HIROM, EXHIROM)
+
+# Banks that never hold ROM
+WRAM_BANKS = (0x7E, 0x7F)
+
+UNMAPPED = -1
+
+
+def _bank_windows(mapping: str, bank: int) -> Tuple[int, int]:
+    """(ROM offset of bank:0000, lowest address that maps ROM) before any size limit"""
+    if mapping == LOROM:
+        # $8000-$FFFF of banks 00-7D/80-FF, 32KB per bank
+        return (bank & 0x7F) * 0x8000 - 0x8000, 0x8000
+
+    if mapping == HIROM:
+        # C0-FF (and 40-7D) map whole 64KB banks; 00-3F/80-BF mirror their upper halves
+        return (bank & 0x3F) * 0x10000, 0x8000 if bank & 0x7F < 0x40 else 0x0000
+
+    if mapping == EXHIROM:
+        # C0-FF hold the first 4MB and 40-7D the rest; 80-BF and 00-3D mirror their upper halves
+        base = (bank & 0x3F) * 0x10000 + (0 if bank & 0x80 else 0x400000)
+        return base, 0x8000 if bank & 0x7F < 0x40 else 0x0000
+
+    raise ValueError(f"Unknown mapping: {mapping}")
+
+
+class AddressMap:
+    """
+    Bank tables for one mapping and ROM size
+    bank:address maps to bases[bank] + address when lows[bank] <= address < highs[bank].
+    """
+
+    def __init__(self, mapping: str, rom_size: int):
+        if mapping not in MAPPINGS:
+            raise ValueError(f"Unknown mapping: {mapping}")
+
+        self.mapping = mapping
+        self.rom_size = rom_size
+        self.bases: List[int] = [0] * 256
+        self.lows: List[int] = [0x10000] * 256
+        self.highs: List[int] = [0] * 256
+
+        for bank in range(256):
+            if bank in WRAM_BANKS:
+                continue
+            base, low = _bank_windows(mapping, bank)
+            high = min(0x10000, rom_size - base)
+            if low < high:
+                self.bases[bank] = base
+                self.lows[bank] = low
+                self.highs[bank] = high
+
+    def to_offset(self, address: int) -> Optional[int]:
+        """ROM offset of a 24-bit SNES address, or None when it maps no ROM"""
+        bank = (address >> 16) & 0xFF
+        address &= 0xFFFF
+        if self.lows[bank] <= address < self.highs[bank]:
+            return self.bases[bank] + address
+        return None
+
+    def to_snes(self, offset: int) -> int:
+        """Canonical 24-bit SNES address of a ROM offset"""
+        if self.mapping == LOROM:
+            return ((offset // 0x8000) << 16) | 0x8000 | (offset & 0x7FFF)
+        if self.mapping == EXHIROM and offset >= 0x400000:
+            return offset  # Banks 40-7D
+        return 0xC00000 + offset
+
+    def bank_table(self, bank: int) -> List[int]:
+        """ROM offset (or UNMAPPED) for every 16-bit address within one bank"""
+        base, low, high = self.bases[bank], self.lows[bank], self.highs[bank]
+        table = [UNMAPPED] * 0x10000
+        if low < high:
+            table[low:high] = range(base + low, base + high)
+        return table
+
+    def translate(self, addresses: Iterable[int]) -> array:
+        """ROM offsets for an iterable of 24-bit addresses (UNMAPPED where none)"""
+        bases, lows, highs = self.bases, self.lows, self.highs
+        return array(
+            "l",
+            [
+                bases[(a >> 16) & 0xFF] + (a & 0xFFFF)
+                if lows[(a >> 16) & 0xFF] <= (a & 0xFFFF) < highs[(a >> 16) & 0xFF]
+                else UNMAPPED
+                for a in addresses
+            ],
+        )
+
+    def translate_words(self, words: Iterable[int], bank: int) -> array:
+        """ROM offsets for 16-bit addresses inside one bank (UNMAPPED where none)"""
+        return array("l", map(self.bank_table(bank).__getitem__, words))
+
+    def translate_longs(self, words: Sequence[int], banks: Buffer) -> array:
+        """ROM offsets for 24-bit addresses given as parallel address-word and bank-byte sequences"""
+        bases, lows, highs = self.bases, self.lows, self.highs
+        return array(
+            "l",
+            [
+                bases[bank] + word if lows[bank] <= word < highs[bank] else UNMAPPED
+                for word, bank in zip(words, banks)
+            ],
+        )
+
+    def scan_pointers(self, data: Buffer, width: int = 2, bank: int = 0) -> Tuple[array, array]:
+        """
+        Every offset of data holding a pointer into ROM, with the offset it points at
+        width 2 reads 16-bit addresses within bank; width 3 reads full 24-bit addresses.
+        """
+        words = word_values(data)
+        if width == 2:
+            targets = self.translate_words(words, bank)
+        elif width == 3:
+            size = max(0, len(data) - 2)
+            targets = self.translate_longs(words[:size], memoryview(data)[2:])
+        else:
+            raise ValueError(f"Unsupported pointer width: {width}")
+
+        valid = list(map(UNMAPPED.__ne__, targets))
+        return array("l", compress(range(len(targets)), valid)), array("l", compress(targets, valid))
+
+
+def word_values(data: Buffer) -> array:
+    """Little-endian 16-bit value at every offset 0..len(data)-2, built from two aligned reads"""
+    count = max(0, len(data) - 1)
+    values = array("H", bytes(count * 2))
+    if not count:
+        return values
+
+    view = memoryview(data)
+    even = array("H", bytes(view[: ((count + 1) // 2) * 2]))
+    odd = array("H", bytes(view[1 : 1 + (count // 2) * 2]))
+    if sys.byteorder != "little":
+        even.byteswap()
+        odd.byteswap()
+
+    values[0::2] = even
+    values[1::2] = odd
+    return values
+
+
+_address_maps = {}
+
+
+def address_map_for(mapping: str, rom_size: int) -> AddressMap:
+    """Tables for a mapping/size pair, built once per process"""
+    key = (mapping, rom_size)
+    if key not in _address_maps:
+        _address_maps[key] = AddressMap(mapping, rom_size)
+    return _address_maps[key]
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+    from pathlib import Path
+
+    parser = argparse.ArgumentParser(description="Translate SNES addresses or scan a ROM for pointers")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("--mapping", choices=MAPPINGS, default=LOROM, help="Memory mapping")
+    parser.add_argument("addresses", nargs="*", type=lambda v: int(v, 0), help="SNES addresses to resolve")
+    args = parser.parse_args()
+
+    data = Path(args.rom_file).read_bytes()
+    if len(data) % 1024 == 512:
+        data = data[512:]
+    address_map = address_map_for(args.mapping, len(data))
+
+    for address in args.addresses:
+        offset = address_map.to_offset(address)
+        print(f"${address:06X} -> " + (f"${offset:06X}" if offset is not None else "unmapped"))
+
+    start_time = time.time()
+    sources16, _ = address_map.scan_pointers(data, 2)
+    sources24, _ = address_map.scan_pointers(data, 3)
+    elapsed = time.time() - start_time
+    candidates = max(0, len(data) - 1) + max(0, len(data) - 2)
+    print(f"🔗 {candidates:,} candidates in {elapsed:.2f}s ({candidates / max(elapsed, 1e-9) / 1e6:.1f}M/s): "
+          f"{len(sources16):,} 16-bit and {len(sources24):,} 24-bit pointers")
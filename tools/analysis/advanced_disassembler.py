@@ -8,6 +8,7 @@ the maximum coverage analysis and converts them to documented assembly.
 """
 
 import struct
+import sys
 import os
 import json
 from pathlib import Path
@@ -16,6 +17,13 @@ from dataclasses import dataclass
 from collections import defaultdict
 import time
 
+# Shared 65816 opcode table
+sys.path.append(str(Path(__file__).parent.parent / "disassembly"))
+from decoder65816 import OPCODE_TABLE, opcode_definitions, format_operand
+
+OPCODE_WIDTHS = [info.width for info in OPCODE_TABLE]
+
+
 @dataclass
 class CodeRegion:
     """Represents a region of code in the ROM"""
@@ -248,11 +256,6 @@ class SNESDisassembler:
             (0xEA, "NOP", "implied", 1, "No operation"),
             (0x00, "BRK", "immediate", 2, "Break"),
             (0x02, "COP", "immediate", 2, "Coprocessor"),
-
-            # Undefined/Illegal opcodes (appear in some ROMs)
-            (0x03, "???", "unknown", 1, "Unknown/illegal opcode"),
-            (0x07, "???", "unknown", 1, "Unknown/illegal opcode"),
-            (0x0F, "???", "unknown", 1, "Unknown/illegal opcode"),
         ]
 
         # Build opcode dictionary
@@ -264,6 +267,10 @@ class SNESDisassembler:
                 'description': description
             }
 
+        # Fill every opcode the curated list leaves out from the shared decoder table
+        for opcode_val, definition in opcode_definitions().items():
+            opcodes.setdefault(opcode_val, definition)
+
         return opcodes
 
     def rom_offset_to_snes_address(self, offset: int) -> Tuple[int, int]:
@@ -307,10 +314,11 @@ class SNESDisassembler:
         opcode_info = self.opcodes[opcode]
         size = opcode_info['size']
 
-        # Adjust size based on processor flags for certain instructions
-        if opcode_info['mnemonic'] in ['LDA', 'STA', 'ADC', 'SBC', 'CMP', 'AND', 'ORA', 'EOR'] and opcode_info['addressing'] == 'immediate':
+        # Adjust size based on processor flags for M/X-width immediates
+        width = OPCODE_WIDTHS[opcode]
+        if width == 'm':
             size = 2 if self.current_m_flag else 3
-        elif opcode_info['mnemonic'] in ['LDX', 'STX', 'LDY', 'STY', 'CPX', 'CPY'] and opcode_info['addressing'] == 'immediate':
+        elif width == 'x':
             size = 2 if self.current_x_flag else 3
 
         # Read instruction bytes
@@ -432,7 +440,9 @@ class SNESDisassembler:
                 return f"${bytes_data[2]:02X},${bytes_data[1]:02X}"
             return "$??,${??"
         else:
-            return "???"
+            operand = int.from_bytes(bytes(bytes_data[1:]), "little")
+            _, addr = self.rom_offset_to_snes_address(offset)
+            return format_operand(bytes_data[0], operand, len(bytes_data), addr)
 
     def analyze_code_flow(self, start_offset: int, max_size: int = 1024) -> List[Dict[str, Any]]:
         """
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Binary Analysis Store
+========================================
+
+Columnar tables shared between pipeline stages in place of the JSON/CSV
+dumps each stage used to re-parse. A table is one file: a header, a column
+directory, then each column as a little-endian array (strings as a u32
+offset array plus one UTF-8 blob). Readers memory-map the file and cast
+the columns in place, so opening a table costs no parsing; strings are
+decoded only when a row is read.
+
+Every table records a digest of the ROM it describes, and a read for a
+different ROM (or an older format) finds nothing, so stale results are
+never mistaken for current ones.
+"""
+
+import hashlib
+import mmap
+import os
+import struct
+import sys
+from array import array
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Sequence, Tuple, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+STORE_MAGIC = b"DQ3T"
+STORE_VERSION = 1
+HEADER_FORMAT = "<4sHHI16s"  # magic, version, column count, row count, ROM digest
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+COLUMN_FORMAT = "<24sc3xII"  # name, type code, data offset, data length
+COLUMN_SIZE = struct.calcsize(COLUMN_FORMAT)
+
+# Column type codes: array typecodes for numbers, "s" for UTF-8 strings
+NUMERIC_TYPES = {"B": 1, "H": 2, "I": 4, "i": 4, "f": 4}
+STRING_TYPE = "s"
+
+# Columns start on 8-byte boundaries so every cast view is aligned
+ALIGNMENT = 8
+
+# Table schemas written by the pipeline stages
+REGIONS = {"start": "I", "end": "I", "type": "s", "confidence": "f", "description": "s", "hash": "s"}
+TEXT_STRINGS = {"offset": "I", "length": "I", "encoding": "s", "context": "s", "text": "s"}
+DATA_TABLES = {"offset": "I", "type": "s", "entry_count": "I", "entry_size": "I", "description": "s"}
+LABELS = {"offset": "I", "name": "s"}
+INSTRUCTIONS = {"offset": "I"}
+XREFS = {"target": "I", "source": "I", "kind": "B"}
+
+
+def rom_digest(rom_data: Buffer) -> bytes:
+    """Key tying stored tables to the ROM they were computed from"""
+    return hashlib.blake2b(rom_data, digest_size=16).digest()
+
+
+def _numeric_column(view: memoryview, type_code: str) -> Sequence:
+    """Column cast in place, or swapped into a copy on big-endian hosts"""
+    if sys.byteorder == "little":
+        return view.cast(type_code)
+    column = array(type_code, view.tobytes())
+    column.byteswap()
+    return column
+
+
+class StringColumn:
+    """UTF-8 strings stored as rows + 1 offsets into one blob, decoded on access"""
+
+    def __init__(self, offsets: Sequence[int], blob: memoryview):
+        self.offsets = offsets
+        self.blob = blob
+
+    def __len__(self) -> int:
+        return len(self.offsets) - 1
+
+    def __getitem__(self, row: int) -> str:
+        if row < 0:
+            row += len(self)
+        return bytes(self.blob[self.offsets[row] : self.offsets[row + 1]]).decode("utf-8")
+
+    def __iter__(self) -> Iterator[str]:
+        return (self[row] for row in range(len(self)))
+
+
+class Table:
+    """Columns of one stored table (views of the mapped file)"""
+
+    def __init__(self, name: str, rows: int, columns: Dict[str, Sequence], mapped: Optional[mmap.mmap] = None):
+        self.name = name
+        self.rows = rows
+        self.columns = columns
+        self._map = mapped
+
+    def __len__(self) -> int:
+        return self.rows
+
+    def __getitem__(self, column: str) -> Sequence:
+        return self.columns[column]
+
+    def row(self, index: int) -> Dict[str, object]:
+        return {name: column[index] for name, column in self.columns.items()}
+
+    def iter_rows(self) -> Iterator[Dict[str, object]]:
+        names = list(self.columns)
+        for values in zip(*(self.columns[name] for name in names)):
+            yield dict(zip(names, values))
+
+
+class AnalysisStore:
+    """Directory of binary tables, one <name>.dq3t file per table"""
+
+    def __init__(self, root: Optional[Union[str, Path]] = None):
+        self.root = Path(root) if root else Path(__file__).parent.parent.parent / "cache" / "store"
+
+    def path_for(self, name: str) -> Path:
+        return self.root / f"{name}.dq3t"
+
+    def write(self, name: str, schema: Dict[str, str], columns: Dict[str, Sequence], digest: bytes = b""):
+        """
+        Write one table atomically; columns maps each schema name to its values
+        (all the same length), so readers never see a partial table
+        """
+        rows = len(columns[next(iter(schema))]) if schema else 0
+        segments: List[Tuple[str, str, bytes]] = []
+        for column_name, type_code in schema.items():
+            values = columns[column_name]
+            if len(values) != rows:
+                raise ValueError(f"Column {column_name} has {len(values)} rows, expected {rows}")
+            segments.append((column_name, type_code, self._encode(type_code, values)))
+
+        data_start = HEADER_SIZE + COLUMN_SIZE * len(segments)
+        directory = []
+        payload = bytearray()
+        for column_name, type_code, encoded in segments:
+            payload.extend(bytes(-(data_start + len(payload)) % ALIGNMENT))
+            directory.append(
+                struct.pack(
+                    COLUMN_FORMAT, column_name.encode("ascii"), type_code.encode("ascii"),
+                    data_start + len(payload), len(encoded),
+                )
+            )
+            payload.extend(encoded)
+
+        path = self.path_for(name)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        temp_path = path.with_suffix(f".{os.getpid()}.tmp")
+        with open(temp_path, "wb") as f:
+            f.write(struct.pack(HEADER_FORMAT, STORE_MAGIC, STORE_VERSION, len(segments), rows, digest))
+            f.write(b"".join(directory))
+            f.write(payload)
+        os.replace(temp_path, path)
+
+    @staticmethod
+    def _encode(type_code: str, values: Sequence) -> bytes:
+        if type_code == STRING_TYPE:
+            encoded = [str(value).encode("utf-8") for value in values]
+            offsets = array("I", [0])
+            total = 0
+            for item in encoded:
+                total += len(item)
+                offsets.append(total)
+            if sys.byteorder != "little":
+                offsets.byteswap()
+            return offsets.tobytes() + b"".join(encoded)
+
+        if type_code not in NUMERIC_TYPES:
+            raise ValueError(f"Unknown column type: {type_code}")
+        column = array(type_code, values)
+        if sys.byteorder != "little":
+            column.byteswap()
+        return column.tobytes()
+
+    def read(self, name: str, digest: Optional[bytes] = None) -> Optional[Table]:
+        """Map a stored table, or None if it is missing, from another format, or for another ROM"""
+        try:
+            with open(self.path_for(name), "rb") as f:
+                if os.fstat(f.fileno()).st_size < HEADER_SIZE:
+                    return None
+                mapped = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except (OSError, ValueError):
+            return None
+
+        magic, version, column_count, rows, stored_digest = struct.unpack_from(HEADER_FORMAT, mapped)
+        if magic != STORE_MAGIC or version != STORE_VERSION or (digest is not None and stored_digest != digest):
+            mapped.close()
+            return None
+
+        view = memoryview(mapped)
+        columns: Dict[str, Sequence] = {}
+        try:
+            for index in range(column_count):
+                raw_name, raw_type, start, length = struct.unpack_from(
+                    COLUMN_FORMAT, mapped, HEADER_SIZE + index * COLUMN_SIZE
+                )
+                if start + length > len(mapped):
+                    raise ValueError("Column runs past the end of the table")
+                column_name = raw_name.rstrip(b"\0").decode("ascii")
+                type_code = raw_type.decode("ascii")
+                segment = view[start : start + length]
+
+                if type_code == STRING_TYPE:
+                    offsets_size = (rows + 1) * 4
+                    offsets = _numeric_column(segment[:offsets_size], "I")
+                    columns[column_name] = StringColumn(offsets, segment[offsets_size:])
+                elif NUMERIC_TYPES.get(type_code, 0) * rows == length:
+                    columns[column_name] = _numeric_column(segment, type_code)
+                else:
+                    raise ValueError(f"Bad column {column_name}")
+        except (struct.error, ValueError, UnicodeDecodeError):
+            return None  # The map closes once the views above are released
+
+        return Table(name, rows, columns, mapped)
+
+    def tables(self) -> List[str]:
+        """Names of the stored tables"""
+        if not self.root.exists():
+            return []
+        return sorted(path.stem for path in self.root.glob("*.dq3t"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="List or dump tables of the binary analysis store")
+    parser.add_argument("table", nargs="?", help="Table to dump (default: list every table)")
+    parser.add_argument("--store", help="Store directory (default: cache/store)")
+    parser.add_argument("--rows", type=int, default=20, help="Rows to print")
+    args = parser.parse_args()
+
+    store = AnalysisStore(args.store)
+    if not args.table:
+        for name in store.tables():
+            table = store.read(name)
+            if table is None:
+                print(f"   {name}: unreadable")
+            else:
+                print(f"   {name}: {table.rows:,} rows ({', '.join(table.columns)})")
+    else:
+        table = store.read(args.table)
+        if table is None:
+            print(f"ERROR: No table {args.table} in {store.root}")
+            sys.exit(1)
+        print(f"📦 {args.table}: {table.rows:,} rows")
+        for index in range(min(args.rows, table.rows)):
+            print(f"   {table.row(index)}")
@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Tile Atlas Renderer
+======================================
+
+Renders runs of SNES tiles through a palette into one RGBA atlas buffer.
+Tiles are composed as 8-bit indices (with the palette bank folded in), then
+the whole atlas is expanded to RGBA in a single pass through per-channel
+translation tables built from a shared 32K-entry BGR555 lookup table.
+"""
+
+import struct
+import sys
+from array import array
+from typing import Iterable, List, NamedTuple, Optional, Sequence, Tuple, Union
+
+from tile_codec import TILE_PIXELS, TILE_SIZES, decode_mode7, decode_tiles
+
+Buffer = Union[bytes, bytearray, memoryview]
+Color = Tuple[int, ...]
+
+# Pseudo bit depth for Mode 7 (chunky 8-bit characters in the odd VRAM bytes)
+MODE7 = 7
+
+# Shown for palette indices the palette does not define
+INVALID_COLOR = (255, 0, 255, 255)
+
+
+def _build_bgr555_table() -> bytes:
+    """RGBA bytes for every 15-bit SNES color (0bbbbbgggggrrrrr), 4 bytes per entry"""
+    scale = [(value * 255) // 31 for value in range(32)]
+    table = bytearray(0x8000 * 4)
+    table[0::4] = bytes(scale[color & 0x1F] for color in range(0x8000))
+    table[1::4] = bytes(scale[(color >> 5) & 0x1F] for color in range(0x8000))
+    table[2::4] = bytes(scale[(color >> 10) & 0x1F] for color in range(0x8000))
+    table[3::4] = b"\xff" * 0x8000
+    return bytes(table)
+
+
+BGR555_RGBA = _build_bgr555_table()
+
+
+def bgr555_to_rgba(color_value: int) -> Color:
+    """Single SNES color to an (r, g, b, a) tuple"""
+    offset = (color_value & 0x7FFF) * 4
+    return tuple(BGR555_RGBA[offset : offset + 4])
+
+
+def palette_from_bgr555(palette_data: Buffer) -> List[Color]:
+    """Raw CGRAM bytes (little-endian BGR555 words) to RGBA colors"""
+    words = array("H")
+    words.frombytes(bytes(palette_data[: len(palette_data) & ~1]))
+    if sys.byteorder != "little":
+        words.byteswap()
+    return [tuple(BGR555_RGBA[(word & 0x7FFF) * 4 : (word & 0x7FFF) * 4 + 4]) for word in words]
+
+
+class Placement(NamedTuple):
+    """One 8x8 tile drawn at a pixel position in the atlas"""
+
+    x: int
+    y: int
+    tile: int
+    palette: int = 0
+    hflip: bool = False
+    vflip: bool = False
+
+
+def grid_layout(tile_count: int, columns: int, first_tile: int = 0, palette: int = 0) -> List[Placement]:
+    """Tiles first_tile.. laid out left-to-right, top-to-bottom"""
+    return [
+        Placement((i % columns) * 8, (i // columns) * 8, first_tile + i, palette) for i in range(tile_count)
+    ]
+
+
+def tilemap_layout(tilemap: Buffer, columns: int = 32) -> List[Placement]:
+    """
+    SNES BG tilemap words (vhopppcc cccccccc) as placements
+    Bits 0-9 tile number, 10-12 palette, 13 priority (ignored), 14 hflip, 15 vflip.
+    """
+    words = struct.unpack(f"<{len(tilemap) // 2}H", bytes(tilemap[: len(tilemap) & ~1]))
+    return [
+        Placement(
+            (i % columns) * 8,
+            (i // columns) * 8,
+            word & 0x3FF,
+            (word >> 10) & 0x07,
+            bool(word & 0x4000),
+            bool(word & 0x8000),
+        )
+        for i, word in enumerate(words)
+    ]
+
+
+def oam_layout(oam: Buffer, high_table: Optional[Buffer] = None) -> List[Placement]:
+    """
+    OAM low table entries (x, y, tile, vhoopppN) as 8x8 sprite placements
+    Sprite palettes are banks 8-15 of CGRAM; X bit 8 comes from the high table when given.
+    """
+    placements = []
+    for i in range(len(oam) // 4):
+        x, y, tile, attributes = oam[i * 4 : i * 4 + 4]
+        if high_table is not None and (high_table[i >> 2] >> ((i & 3) * 2)) & 1:
+            x -= 256
+        placements.append(
+            Placement(
+                x,
+                y,
+                tile | ((attributes & 0x01) << 8),
+                8 + ((attributes >> 1) & 0x07),
+                bool(attributes & 0x40),
+                bool(attributes & 0x80),
+            )
+        )
+    return placements
+
+
+class Atlas:
+    """
+    Rendered RGBA atlas; pixels is a bytearray, so it can be handed to anything that
+    takes a buffer (memoryview(atlas.pixels), Image.frombuffer) without a copy.
+    """
+
+    def __init__(self, width: int, height: int, pixels: Union[bytearray, memoryview]):
+        self.width = width
+        self.height = height
+        self.pixels = pixels
+
+    def view(self) -> memoryview:
+        """Zero-copy view of the RGBA bytes"""
+        return memoryview(self.pixels)
+
+    def to_image(self):
+        """PIL image sharing the atlas buffer"""
+        from PIL import Image
+
+        return Image.frombuffer("RGBA", (self.width, self.height), self.pixels, "raw", "RGBA", 0, 1)
+
+
+class AtlasRenderer:
+    """
+    Renders tile data through a palette into RGBA atlases
+    palette holds RGB(A) tuples or raw BGR555 bytes and may cover several banks of
+    2**bpp colors each (e.g. a full 256-color CGRAM dump).
+    """
+
+    def __init__(
+        self,
+        palette: Union[Buffer, Sequence[Color]],
+        bpp: int = 4,
+        transparent_zero: bool = False,
+        background: Color = (0, 0, 0, 0),
+    ):
+        if bpp not in TILE_SIZES and bpp != MODE7:
+            raise ValueError(f"Unsupported bit depth: {bpp}")
+
+        self.bpp = bpp
+        self.bank_size = 256 if bpp in (MODE7, 8) else 1 << bpp
+        self.background = bytes(_rgba(background))
+
+        if isinstance(palette, (bytes, bytearray, memoryview)):
+            colors = palette_from_bgr555(palette)
+        else:
+            colors = [_rgba(color) for color in palette]
+
+        # Per-channel translation tables over the global (bank-folded) index
+        channels = [bytearray(256) for _ in range(4)]
+        for index in range(256):
+            color = colors[index] if index < len(colors) else INVALID_COLOR
+            if transparent_zero and index % self.bank_size == 0:
+                color = (0, 0, 0, 0)
+            for channel in range(4):
+                channels[channel][index] = color[channel]
+        self.channels = [bytes(channel) for channel in channels]
+
+        self._bank_tables = {}
+
+    def _bank_table(self, bank: int) -> Optional[bytes]:
+        """Translation table adding a palette bank offset to tile indices"""
+        offset = (bank * self.bank_size) & 0xFF
+        if not offset:
+            return None
+        if offset not in self._bank_tables:
+            self._bank_tables[offset] = bytes((offset + value) & 0xFF for value in range(256))
+        return self._bank_tables[offset]
+
+    def decode(self, tile_data: Buffer) -> bytearray:
+        """Tile data to 64 index bytes per tile"""
+        if self.bpp == MODE7:
+            return decode_mode7(tile_data)
+        return decode_tiles(tile_data, self.bpp)
+
+    def render(
+        self,
+        tile_data: Buffer,
+        placements: Optional[Iterable[Placement]] = None,
+        columns: int = 16,
+        width: Optional[int] = None,
+        height: Optional[int] = None,
+        out: Optional[Union[bytearray, memoryview]] = None,
+    ) -> Atlas:
+        """
+        Render tiles into one atlas; without placements every tile is drawn in a grid
+        of columns tiles. Placements with missing tiles are skipped; later placements
+        draw over earlier ones. out receives the RGBA bytes when given.
+        """
+        indices = self.decode(tile_data)
+        tiles = len(indices) // TILE_PIXELS
+
+        if placements is None:
+            placements = grid_layout(tiles, columns)
+        placements = [placement for placement in placements if 0 <= placement.tile < tiles]
+
+        if width is None:
+            width = max((placement.x + 8 for placement in placements), default=0)
+        if height is None:
+            height = max((placement.y + 8 for placement in placements), default=0)
+
+        size = width * height * 4
+        if out is None:
+            out = bytearray(size)
+        elif len(out) < size:
+            raise ValueError(f"Output buffer too small: need {size} bytes, have {len(out)}")
+
+        canvas = bytearray(width * height)
+        covered = bytearray(width * height)
+        opaque = b"\x01" * 8
+
+        for placement in placements:
+            tile = indices[placement.tile * TILE_PIXELS : (placement.tile + 1) * TILE_PIXELS]
+            bank_table = self._bank_table(placement.palette)
+            if bank_table is not None:
+                tile = tile.translate(bank_table)
+
+            for row in range(8):
+                y = placement.y + row
+                if not 0 <= y < height:
+                    continue
+                source_row = 7 - row if placement.vflip else row
+                pixels = tile[source_row * 8 : source_row * 8 + 8]
+                if placement.hflip:
+                    pixels = pixels[::-1]
+
+                # Clip horizontally
+                left = max(0, -placement.x)
+                right = min(8, width - placement.x)
+                if left >= right:
+                    break
+                start = y * width + placement.x + left
+                canvas[start : start + right - left] = pixels[left:right]
+                covered[start : start + right - left] = opaque[left:right]
+
+        # One pass: indices to RGBA, then restore background where nothing was drawn
+        for channel in range(4):
+            out[channel:size:4] = canvas.translate(self.channels[channel])
+
+        if covered.count(0):
+            keep = int.from_bytes(covered.translate(b"\x00" + b"\xff" * 255), "little")
+            for channel in range(4):
+                fill = covered.translate(bytes([self.background[channel]]) + bytes(255))
+                merged = (int.from_bytes(out[channel:size:4], "little") & keep) | int.from_bytes(fill, "little")
+                out[channel:size:4] = merged.to_bytes(width * height, "little")
+
+        return Atlas(width, height, out)
+
+
+def _rgba(color: Color) -> Color:
+    """RGB or RGBA tuple to RGBA"""
+    return tuple(color[:3]) + ((color[3],) if len(color) > 3 else (255,))
+
+
+def render_atlas(
+    tile_data: Buffer,
+    palette: Union[Buffer, Sequence[Color]],
+    bpp: int = 4,
+    placements: Optional[Iterable[Placement]] = None,
+    columns: int = 16,
+    **options,
+) -> Atlas:
+    """One-call convenience wrapper around AtlasRenderer"""
+    renderer = AtlasRenderer(
+        palette,
+        bpp,
+        transparent_zero=options.pop("transparent_zero", False),
+        background=options.pop("background", (0, 0, 0, 0)),
+    )
+    return renderer.render(tile_data, placements, columns, **options)
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+    from pathlib import Path
+
+    parser = argparse.ArgumentParser(description="Render SNES tiles into an RGBA atlas")
+    parser.add_argument("tile_file", help="Planar tile data")
+    parser.add_argument("palette_file", help="Raw BGR555 palette data")
+    parser.add_argument("--bpp", type=int, default=4, choices=sorted(TILE_SIZES) + [MODE7],
+                        help="Bits per pixel (7 = Mode 7)")
+    parser.add_argument("--columns", type=int, default=16, help="Tiles per atlas row")
+    parser.add_argument("--tilemap", help="BG tilemap to lay tiles out with")
+    parser.add_argument("--output", "-o", help="Output PNG (requires Pillow)")
+    args = parser.parse_args()
+
+    tile_data = Path(args.tile_file).read_bytes()
+    palette_data = Path(args.palette_file).read_bytes()
+    layout = tilemap_layout(Path(args.tilemap).read_bytes()) if args.tilemap else None
+
+    start_time = time.time()
+    atlas = render_atlas(tile_data, palette_data, args.bpp, layout, args.columns)
+    elapsed = time.time() - start_time
+
+    print(f"Atlas: {atlas.width}x{atlas.height} in {elapsed * 1000:.1f} ms")
+    if args.output:
+        atlas.to_image().save(args.output)
+        print(f"Saved: {args.output}")
@@ -14,6 +14,9 @@ from typing import Dict, List, Tuple, Any, Optional
 from dataclasses import dataclass
 import json
 
+from rom_image import open_rom_image
+from spc_render import find_upload_streams
+
 
 @dataclass
 class AudioFunction:
@@ -74,8 +77,8 @@ class DQ3AudioAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, "rb") as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.audio_functions = []
@@ -294,12 +297,24 @@ class DQ3AudioAnalyzer:
             "dsp_register_usage": {},
             "timer_usage": [],
             "memory_layout": {},
+            "upload_streams": [],
         }
 
         # Look for SPC driver upload routines
         spc_upload_functions = self._find_spc_upload_functions()
         driver_analysis["driver_functions"] = spc_upload_functions
 
+        # Driver images in the IPL upload format (what spc_render boots to render tracks)
+        driver_analysis["upload_streams"] = [
+            {
+                "offset": stream.offset,
+                "blocks": [{"apu_address": address, "size": len(data)} for address, data in stream.blocks],
+                "size": stream.size,
+                "entry": stream.entry,
+            }
+            for stream in find_upload_streams(self.rom_data)
+        ]
+
         # Analyze DSP register manipulation
         dsp_usage = self._analyze_dsp_register_usage()
         driver_analysis["dsp_register_usage"] = dsp_usage
@@ -315,6 +330,7 @@ class DQ3AudioAnalyzer:
         print(f"   Driver functions: {len(driver_analysis['driver_functions'])}")
         print(f"   DSP registers used: {len(driver_analysis['dsp_register_usage'])}")
         print(f"   Timer usage patterns: {len(driver_analysis['timer_usage'])}")
+        print(f"   Driver upload lists: {len(driver_analysis['upload_streams'])}")
 
         return driver_analysis
 
@@ -692,17 +708,8 @@ class DQ3AudioAnalyzer:
         return memory_layout
 
     def _snes_to_rom_address(self, snes_addr: int) -> int:
-        """Convert SNES address to ROM file offset"""
-        bank = (snes_addr >> 16) & 0xFF
-        offset = snes_addr & 0xFFFF
-
-        if bank < 0x80 and offset >= 0x8000:
-            return (bank * 0x8000) + (offset - 0x8000)
-        elif bank >= 0x80 and offset >= 0x8000:
-            bank = bank - 0x80
-            return (bank * 0x8000) + (offset - 0x8000)
-
-        return 0
+        """Convert SNES address to ROM file offset (0 when it maps no ROM)"""
+        return self.rom.to_offset(snes_addr) or 0
 
     def disassemble_region(self, start_offset: int, size: int) -> List[Dict]:
         """Disassemble a region of code"""
@@ -15,6 +15,8 @@ from dataclasses import dataclass
 import json
 import math
 
+from rom_image import open_rom_image
+
 
 @dataclass
 class BattleFunction:
@@ -74,8 +76,8 @@ class DQ3BattleAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, "rb") as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.battle_functions = []
@@ -711,17 +713,8 @@ class DQ3BattleAnalyzer:
             return f"check_{effect_name}"
 
     def _snes_to_rom_address(self, snes_addr: int) -> int:
-        """Convert SNES address to ROM file offset"""
-        bank = (snes_addr >> 16) & 0xFF
-        offset = snes_addr & 0xFFFF
-
-        if bank < 0x80 and offset >= 0x8000:
-            return (bank * 0x8000) + (offset - 0x8000)
-        elif bank >= 0x80 and offset >= 0x8000:
-            bank = bank - 0x80
-            return (bank * 0x8000) + (offset - 0x8000)
-
-        return 0
+        """Convert SNES address to ROM file offset (0 when it maps no ROM)"""
+        return self.rom.to_offset(snes_addr) or 0
 
     def disassemble_region(self, start_offset: int, size: int) -> List[Dict]:
         """Disassemble a region of code"""
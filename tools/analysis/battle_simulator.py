@@ -0,0 +1,420 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Monte Carlo Battle Simulator
+===============================================
+
+Runs large numbers of seeded battles between a party and an encounter and
+reports how they go: win rate, rounds, damage dealt and taken.
+
+Party members come from WRAM (the 60-byte roster slots described by
+PartyMember_Packed) or JSON; monsters from the ROM's 16-byte monster
+entries as laid out by DQ3BattleAnalyzer, or JSON. Damage follows the
+series' attack - defense / 2 formula with its variance, critical and miss
+rules; the divisors can be taken from decoded CombatFormula constants.
+
+Battles run in batches, one worker process per batch: each batch keeps its
+party and monster stats as flat per-slot lists and writes each battle's
+outcome into result columns, so workers return a few compact arrays.
+"""
+
+import json
+import os
+import random
+import struct
+from array import array
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Tuple, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+# WRAM party roster (see documentation/dq3_structures/headers/partymember_view.hpp)
+PARTYMEMBER_BASE_ADDR = 0x3925
+PARTYMEMBER_SIZE = 60
+PARTY_ROSTER_SLOTS = 12
+PARTYMEMBER_LAYOUT = {
+    "level": (0x00, "B"),
+    "hp_max": (0x04, "<H"),
+    "hp": (0x06, "<H"),
+    "mp_max": (0x08, "<H"),
+    "mp": (0x0A, "<H"),
+    "strength": (0x0C, "B"),
+    "agility": (0x0D, "B"),
+    "stamina": (0x0E, "B"),
+    "wisdom": (0x0F, "B"),
+    "luck": (0x10, "B"),
+}
+PARTYMEMBER_NAME = (0x16, 5)  # (offset, size): up to 4 characters and the AC terminator
+
+# Monster table entry as assumed by DQ3BattleAnalyzer (HP first, AI pointer last)
+MONSTER_ENTRY_SIZE = 16
+MONSTER_LAYOUT = {
+    "hp": (0x00, "<H"),
+    "mp": (0x02, "<H"),
+    "attack": (0x04, "<H"),
+    "defense": (0x06, "<H"),
+    "agility": (0x08, "B"),
+    "xp": (0x0A, "<H"),
+    "gold": (0x0C, "<H"),
+}
+
+# Battle outcomes in the result columns
+WIN, LOSS, TIMEOUT = 0, 1, 2
+
+MAX_ROUNDS = 100
+BATTLES_PER_BATCH = 20000
+
+# Damage-taken histogram bins (fraction of the party's starting HP)
+HISTOGRAM_BINS = 10
+
+
+@dataclass
+class Combatant:
+    """Battle stats of one party member or monster"""
+
+    name: str
+    hp: int
+    attack: int
+    defense: int
+    agility: int
+
+    @classmethod
+    def from_dict(cls, data: Dict) -> "Combatant":
+        return cls(str(data.get("name", "?")), int(data["hp"]), int(data["attack"]),
+                   int(data.get("defense", 0)), int(data.get("agility", 0)))
+
+
+@dataclass
+class DamageModel:
+    """
+    Physical damage: (attack - defense / defense_divisor) / damage_divisor, varied by
+    +-spread; when that falls under attack / weak_divisor the hit does 0 to that floor.
+    Party hits are critical (attack +-5%, defense ignored) with critical_chance.
+    """
+
+    defense_divisor: int = 2
+    damage_divisor: int = 2
+    spread: float = 1 / 16
+    weak_divisor: int = 16
+    critical_chance: float = 1 / 32
+    miss_chance: float = 1 / 64
+
+    @classmethod
+    def from_formulas(cls, formulas: Sequence) -> "DamageModel":
+        """Defaults, with the defense divisor from the first damage formula's power-of-two constant"""
+        model = cls()
+        for formula in formulas:
+            if getattr(formula, "formula_type", "") != "damage":
+                continue
+            divisors = [value for value in getattr(formula, "constants", []) if value in (2, 4, 8)]
+            if divisors:
+                model.defense_divisor = divisors[0]
+                break
+        return model
+
+
+def party_from_wram(wram: Buffer, slots: Sequence[int] = (0, 1, 2, 3), attack_bonus: Sequence[int] = (),
+                    defense_bonus: Sequence[int] = ()) -> List[Combatant]:
+    """
+    Party members from a WRAM dump; attack is Strength and defense Agility / 2 (plus the given
+    per-member equipment bonuses, which the roster slots do not record). Members at 0 HP stay
+    dead, as in a JSON party file
+    """
+    members = []
+    for index, slot in enumerate(slots):
+        if not 0 <= slot < PARTY_ROSTER_SLOTS:
+            raise ValueError(f"Roster slot {slot} out of range")
+        base = PARTYMEMBER_BASE_ADDR + slot * PARTYMEMBER_SIZE
+        if base + PARTYMEMBER_SIZE > len(wram):
+            raise ValueError("WRAM dump too short for the party roster")
+        stats = {name: struct.unpack_from(fmt, wram, base + offset)[0] for name, (offset, fmt) in PARTYMEMBER_LAYOUT.items()}
+        name_offset, name_size = PARTYMEMBER_NAME
+        name_bytes = bytes(wram[base + name_offset : base + name_offset + name_size])
+        members.append(Combatant(
+            name=f"slot{slot}:{name_bytes.hex()}",
+            hp=stats["hp"],
+            attack=stats["strength"] + (attack_bonus[index] if index < len(attack_bonus) else 0),
+            defense=stats["agility"] // 2 + (defense_bonus[index] if index < len(defense_bonus) else 0),
+            agility=stats["agility"],
+        ))
+    return members
+
+
+def monster_from_rom(data: Buffer, table_offset: int, monster_id: int,
+                     layout: Optional[Dict[str, Tuple[int, str]]] = None) -> Combatant:
+    layout = layout or MONSTER_LAYOUT
+    base = table_offset + monster_id * MONSTER_ENTRY_SIZE
+    if base + MONSTER_ENTRY_SIZE > len(data):
+        raise ValueError(f"Monster {monster_id} lies outside the ROM")
+    stats = {name: struct.unpack_from(fmt, data, base + offset)[0] for name, (offset, fmt) in layout.items()}
+    return Combatant(f"monster_{monster_id:02X}", stats["hp"], stats["attack"], stats["defense"], stats["agility"])
+
+
+@dataclass
+class EncounterReport:
+    """Aggregated outcome of every battle of one encounter"""
+
+    encounter: str
+    battles: int
+    wins: int
+    losses: int
+    timeouts: int
+    mean_rounds: float
+    mean_damage_taken: float
+    mean_damage_dealt: float
+    damage_taken_percentiles: Dict[str, int] = field(default_factory=dict)
+    damage_taken_histogram: List[int] = field(default_factory=list)  # By fraction of party HP
+    party_deaths: List[int] = field(default_factory=list)  # Battles in which each member fell (not dead at the start)
+
+    @property
+    def win_rate(self) -> float:
+        return self.wins / self.battles if self.battles else 0.0
+
+    def to_dict(self) -> Dict:
+        report = asdict(self)
+        report["win_rate"] = self.win_rate
+        return report
+
+
+def _hit_table(attackers: List[Combatant], targets: List[Combatant], model: DamageModel,
+               can_critical: bool) -> List[List[Tuple[int, int, int, int]]]:
+    """
+    [attacker][target] -> (lowest, highest, critical low, critical high) damage; stats are fixed
+    for a battle, so every hit's damage band is known before it is rolled
+    """
+    table = []
+    for attacker in attackers:
+        row = []
+        for target in targets:
+            base = (attacker.attack - target.defense // model.defense_divisor) // model.damage_divisor
+            floor = attacker.attack // model.weak_divisor
+            if base <= floor:
+                low, high = 0, max(1, floor)
+            else:
+                swing = int(base * model.spread)
+                low, high = base - swing, base + swing
+            if can_critical:
+                critical = (max(1, int(attacker.attack * 0.95)), max(1, int(attacker.attack * 1.05)))
+            else:
+                critical = (low, high)
+            row.append((low, high) + critical)
+        table.append(row)
+    return table
+
+
+def _run_batch(party: List[Combatant], monsters: List[Combatant], model: DamageModel,
+               battles: int, seed: int, max_rounds: int = MAX_ROUNDS):
+    """Outcome, rounds, damage taken and dealt per battle (as result columns), plus per-member deaths"""
+    rng = random.Random(seed)
+    uniform = rng.random
+    party_count = len(party)
+    monster_count = len(monsters)
+    party_hp = [member.hp for member in party]
+    monster_hp = [monster.hp for monster in monsters]
+    party_hits = _hit_table(party, monsters, model, True)
+    monster_hits = _hit_table(monsters, party, model, False)
+    miss = model.miss_chance
+    critical = miss + model.critical_chance
+    # Actor i < party_count is a party member, otherwise monster i - party_count
+    agility = [member.agility for member in party] + [monster.agility for monster in monsters]
+    actors = list(range(party_count + monster_count))
+    party_start = sum(1 for value in party_hp if value > 0)
+    enemies_start = sum(1 for value in monster_hp if value > 0)
+
+    outcomes = array("B")
+    rounds_column = array("H")
+    taken_column = array("I")
+    dealt_column = array("I")
+    deaths = [0] * party_count
+
+    for _ in range(battles):
+        hp = party_hp[:]
+        enemy_hp = monster_hp[:]
+        party_alive = party_start
+        enemies_alive = enemies_start
+        taken = dealt = 0
+        outcome = TIMEOUT
+        rounds = 0
+
+        while rounds < max_rounds and party_alive and enemies_alive:
+            rounds += 1
+            # Turn order: agility scaled by a random 50-100%
+            keys = [-value * (0.5 + 0.5 * uniform()) for value in agility]
+            for actor in sorted(actors, key=keys.__getitem__):
+                if actor < party_count:
+                    if hp[actor] <= 0:
+                        continue
+                    target = int(uniform() * monster_count)
+                    while enemy_hp[target] <= 0:
+                        target = int(uniform() * monster_count)
+                    roll = uniform()
+                    if roll < miss:
+                        continue
+                    low, high, critical_low, critical_high = party_hits[actor][target]
+                    if roll < critical:
+                        low, high = critical_low, critical_high
+                    damage = low + int(uniform() * (high - low + 1))
+                    remaining = enemy_hp[target]
+                    if damage >= remaining:
+                        damage = remaining
+                        enemies_alive -= 1
+                    enemy_hp[target] = remaining - damage
+                    dealt += damage
+                    if not enemies_alive:
+                        break
+                else:
+                    monster = actor - party_count
+                    if enemy_hp[monster] <= 0:
+                        continue
+                    target = int(uniform() * party_count)
+                    while hp[target] <= 0:
+                        target = int(uniform() * party_count)
+                    if uniform() < miss:
+                        continue
+                    low, high = monster_hits[monster][target][:2]
+                    damage = low + int(uniform() * (high - low + 1))
+                    remaining = hp[target]
+                    if damage >= remaining:
+                        damage = remaining
+                        party_alive -= 1
+                    hp[target] = remaining - damage
+                    taken += damage
+                    if not party_alive:
+                        break
+
+        if not enemies_alive:
+            outcome = WIN
+        elif not party_alive:
+            outcome = LOSS
+
+        for index, value in enumerate(hp):
+            if value <= 0 < party_hp[index]:
+                deaths[index] += 1
+        outcomes.append(outcome)
+        rounds_column.append(rounds)
+        taken_column.append(taken)
+        dealt_column.append(dealt)
+
+    return outcomes, rounds_column, taken_column, dealt_column, deaths
+
+
+def _batch_worker(task):
+    return _run_batch(*task)
+
+
+def simulate_encounter(party: List[Combatant], monsters: List[Combatant], battles: int = 100000,
+                       model: Optional[DamageModel] = None, seed: int = 0, workers: Optional[int] = None,
+                       name: str = "encounter", max_rounds: int = MAX_ROUNDS) -> EncounterReport:
+    """Run battles seeded battles (batch i uses seed + i, so results do not depend on workers)"""
+    if not party or not monsters:
+        raise ValueError("An encounter needs a party and at least one monster")
+    model = model or DamageModel()
+    tasks = []
+    for index, start in enumerate(range(0, battles, BATTLES_PER_BATCH)):
+        tasks.append((party, monsters, model, min(BATTLES_PER_BATCH, battles - start), seed + index, max_rounds))
+
+    workers = workers or os.cpu_count() or 1
+    if workers == 1 or len(tasks) <= 1:
+        results = [_run_batch(*task) for task in tasks]
+    else:
+        with ProcessPoolExecutor(max_workers=min(workers, len(tasks))) as executor:
+            results = list(executor.map(_batch_worker, tasks))
+
+    outcomes, rounds, taken, dealt = array("B"), array("H"), array("I"), array("I")
+    deaths = [0] * len(party)
+    for batch_outcomes, batch_rounds, batch_taken, batch_dealt, batch_deaths in results:
+        outcomes.extend(batch_outcomes)
+        rounds.extend(batch_rounds)
+        taken.extend(batch_taken)
+        dealt.extend(batch_dealt)
+        deaths = [total + count for total, count in zip(deaths, batch_deaths)]
+
+    party_hp = sum(member.hp for member in party) or 1
+    histogram = [0] * HISTOGRAM_BINS
+    for value in taken:
+        histogram[min(HISTOGRAM_BINS - 1, value * HISTOGRAM_BINS // party_hp)] += 1
+
+    ordered = sorted(taken)
+    percentiles = {f"p{p}": ordered[min(len(ordered) - 1, len(ordered) * p // 100)] for p in (10, 50, 90, 99)} if ordered else {}
+    count = len(outcomes) or 1
+    return EncounterReport(
+        encounter=name,
+        battles=len(outcomes),
+        wins=outcomes.count(WIN),
+        losses=outcomes.count(LOSS),
+        timeouts=outcomes.count(TIMEOUT),
+        mean_rounds=sum(rounds) / count,
+        mean_damage_taken=sum(taken) / count,
+        mean_damage_dealt=sum(dealt) / count,
+        damage_taken_percentiles=percentiles,
+        damage_taken_histogram=histogram,
+        party_deaths=deaths,
+    )
+
+
+def load_combatants(path: Union[str, Path]) -> List[Combatant]:
+    """JSON list of {"name", "hp", "attack", "defense", "agility"} objects"""
+    with open(path, "r") as f:
+        return [Combatant.from_dict(entry) for entry in json.load(f)]
+
+
+if __name__ == "__main__":
+    import argparse
+    import sys
+    import time
+
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Monte Carlo battle simulation for one encounter")
+    parser.add_argument("--party", help="Party JSON (list of combatants)")
+    parser.add_argument("--wram", help="WRAM dump to read the party roster from")
+    parser.add_argument("--slots", default="0,1,2,3", help="Roster slots in the party (with --wram)")
+    parser.add_argument("--monsters", help="Monster JSON (list of combatants)")
+    parser.add_argument("--rom", help="ROM file to read monster entries from")
+    parser.add_argument("--monster-table", type=lambda v: int(v, 0), help="ROM offset of the monster table")
+    parser.add_argument("--monster", action="append", default=[], help="ID[xCOUNT] from the monster table (repeatable)")
+    parser.add_argument("--battles", type=int, default=100000, help="Battles to simulate")
+    parser.add_argument("--seed", type=int, default=0, help="Base seed")
+    parser.add_argument("--workers", type=int, help="Worker processes (default: one per core)")
+    parser.add_argument("--output", "-o", help="Write the report as JSON")
+    args = parser.parse_args()
+
+    try:
+        if args.party:
+            party = load_combatants(args.party)
+        elif args.wram:
+            party = party_from_wram(Path(args.wram).read_bytes(), [int(slot, 0) for slot in args.slots.split(",")])
+        else:
+            raise ValueError("Give --party or --wram")
+
+        if args.monsters:
+            monsters = load_combatants(args.monsters)
+        elif args.rom and args.monster_table is not None and args.monster:
+            rom = open_rom_image(args.rom).data
+            monsters = []
+            for spec in args.monster:
+                monster_id, _, count = spec.partition("x")
+                monsters.extend([monster_from_rom(rom, args.monster_table, int(monster_id, 0))] * int(count or 1))
+        else:
+            raise ValueError("Give --monsters, or --rom with --monster-table and --monster")
+    except (OSError, ValueError, KeyError) as e:
+        print(f"❌ Error: {e}")
+        sys.exit(1)
+
+    name = " + ".join(monster.name for monster in monsters)
+    start_time = time.time()
+    report = simulate_encounter(party, monsters, args.battles, seed=args.seed, workers=args.workers, name=name)
+    elapsed = time.time() - start_time
+
+    print(f"⚔️ {report.battles:,} battles vs {name} in {elapsed:.2f}s ({report.battles / max(elapsed, 1e-9):,.0f}/s)")
+    print(f"   Win rate: {report.win_rate:.1%} (losses {report.losses:,}, timeouts {report.timeouts:,})")
+    print(f"   Rounds: {report.mean_rounds:.2f} mean")
+    print(f"   Damage taken: {report.mean_damage_taken:.1f} mean, {report.damage_taken_percentiles}")
+    print(f"   Damage dealt: {report.mean_damage_dealt:.1f} mean")
+    print(f"   Member deaths: {report.party_deaths}")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report.to_dict(), f, indent=2)
+        print(f"Report saved to {args.output}")
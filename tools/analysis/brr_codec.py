@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - BRR Sample Codec
+===================================
+
+Decodes SNES BRR samples (9-byte blocks: a header with shift, filter and
+loop/end flags, then 16 four-bit residuals) to 16-bit PCM with the DSP's
+own arithmetic, and finds sample chains anywhere in the ROM.
+
+Scanning classifies every 9-byte header phase at once with a byte
+translation and matches chains (legal headers ending in an end block) with
+one regular expression per phase; only the candidates are decoded, in
+worker processes, and kept when their PCM looks like a real sample.
+"""
+
+import os
+import re
+import sys
+import wave
+from array import array
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+BLOCK_SIZE = 9
+SAMPLES_PER_BLOCK = 16
+
+FLAG_END = 0x01
+FLAG_LOOP = 0x02
+
+# DSP output rate; a sample's playback pitch comes from the music driver
+DEFAULT_SAMPLE_RATE = 32000
+
+# Chains worth reporting: enough blocks of audible, mostly unclipped signal whose block
+# shifts change gradually (random headers jump by about 4 on average)
+MIN_BLOCKS = 8
+MAX_BLOCKS = 0x1000
+MAX_SHIFT_STEP = 1.5
+MAX_CLIP_FRACTION = 0.05
+MIN_PEAK = 256
+
+# Candidates decoded per worker task
+DECODE_CHUNK = 256
+
+# Header classes for the chain scan: shift 13-15 never appears in real samples
+_HEADER_INVALID = ord("x")
+_HEADER_BLOCK = ord("b")  # Legal, not the last block
+_HEADER_END = ord("e")  # Legal last block
+_HEADER_CLASSES = bytes(
+    _HEADER_INVALID if header >> 4 > 12 else _HEADER_END if header & FLAG_END else _HEADER_BLOCK
+    for header in range(256)
+)
+_CHAIN = re.compile(rb"b*e")
+
+
+def _nibble_table(shift: int) -> Tuple[int, ...]:
+    """Residual value of each nibble after the header's shift (shifts 13-15 keep only the sign)"""
+    values = []
+    for nibble in range(16):
+        value = nibble - 16 if nibble >= 8 else nibble
+        if shift > 12:
+            values.append(-2048 if value < 0 else 0)
+        else:
+            values.append((value << shift) >> 1)
+    return tuple(values)
+
+
+_NIBBLE_VALUES = [_nibble_table(shift) for shift in range(16)]
+
+
+@dataclass
+class BRRSample:
+    """One BRR chain and its decoded PCM"""
+
+    offset: int
+    blocks: int
+    loops: bool
+    ended: bool  # Chain terminated by an end block (not by the data running out)
+    pcm: array  # int16
+
+    @property
+    def size(self) -> int:
+        return self.blocks * BLOCK_SIZE
+
+    @property
+    def peak(self) -> int:
+        return max(map(abs, self.pcm)) if self.pcm else 0
+
+    @property
+    def clip_fraction(self) -> float:
+        if not self.pcm:
+            return 0.0
+        return (self.pcm.count(32767) + self.pcm.count(-32768) + self.pcm.count(-32767)) / len(self.pcm)
+
+    def looks_valid(self) -> bool:
+        return self.ended and self.blocks >= MIN_BLOCKS and self.peak >= MIN_PEAK and self.clip_fraction <= MAX_CLIP_FRACTION
+
+
+def decode_brr(data: Buffer, offset: int = 0, max_blocks: int = MAX_BLOCKS,
+               history: Tuple[int, int] = (0, 0)) -> BRRSample:
+    """
+    Decode blocks from offset until an end block, max_blocks, or the end of data
+    Filters follow the DSP: the previous two outputs, the older one halved, feed the
+    prediction; each result is clamped to 16 bits and doubled with 16-bit wraparound.
+    history is (last, second to last) output from an earlier block.
+    """
+    pcm = array("h")
+    append = pcm.append
+    p1, p2 = history
+    position = offset
+    blocks = 0
+    loops = False
+    ended = False
+    end = len(data) - BLOCK_SIZE
+
+    while blocks < max_blocks and position <= end:
+        header = data[position]
+        nibbles = _NIBBLE_VALUES[header >> 4]
+        filter_mode = (header >> 2) & 0x03
+
+        for byte in data[position + 1 : position + BLOCK_SIZE]:
+            for residual in (nibbles[byte >> 4], nibbles[byte & 0x0F]):
+                older = p2 >> 1
+                if filter_mode == 0:
+                    sample = residual
+                elif filter_mode == 1:
+                    sample = residual + (p1 >> 1) + ((-p1) >> 5)
+                elif filter_mode == 2:
+                    sample = residual + p1 - older + (older >> 4) + ((p1 * -3) >> 6)
+                else:
+                    sample = residual + p1 - older + ((p1 * -13) >> 7) + ((older * 3) >> 4)
+
+                if sample > 32767:
+                    sample = 32767
+                elif sample < -32768:
+                    sample = -32768
+                sample = ((sample << 1) + 0x8000 & 0xFFFF) - 0x8000
+                append(sample)
+                p2, p1 = p1, sample
+
+        position += BLOCK_SIZE
+        blocks += 1
+        if header & FLAG_END:
+            loops = bool(header & FLAG_LOOP)
+            ended = True
+            break
+
+    return BRRSample(offset, blocks, loops, ended, pcm)
+
+
+def find_brr_chains(data: Buffer, start: int = 0, end: Optional[int] = None,
+                    min_blocks: int = MIN_BLOCKS, max_blocks: int = MAX_BLOCKS) -> List[Tuple[int, int]]:
+    """
+    (offset, blocks) of every chain of legal headers ending in an end block, for all nine
+    block phases. A chain starts right after the previous chain or illegal header, moved up
+    to its first filter-0 block (the DSP has no history at a sample's start), and must keep
+    its mean shift change within MAX_SHIFT_STEP.
+    """
+    end = len(data) if end is None else min(end, len(data))
+    raw = bytes(data[start:end])
+    chains = []
+
+    for phase in range(BLOCK_SIZE):
+        headers = raw[phase::BLOCK_SIZE]
+        # Drop a trailing header whose block is cut off by the end of the range
+        if len(headers) and phase + (len(headers) - 1) * BLOCK_SIZE + BLOCK_SIZE > len(raw):
+            headers = headers[:-1]
+        classes = headers.translate(_HEADER_CLASSES)
+
+        for match in _CHAIN.finditer(classes):
+            first = match.start()
+            while first < match.end() - 1 and headers[first] & 0x0C:
+                first += 1
+            blocks = match.end() - first
+            if not min_blocks <= blocks <= max_blocks or headers[first] & 0x0C:
+                continue
+            shifts = [header >> 4 for header in headers[first : match.end()]]
+            if sum(abs(a - b) for a, b in zip(shifts, shifts[1:])) <= MAX_SHIFT_STEP * (blocks - 1):
+                chains.append((start + phase + first * BLOCK_SIZE, blocks))
+
+    chains.sort()
+    return chains
+
+
+# ROM image handed to each decode worker process once
+_worker_data: Buffer = b""
+
+
+def _init_decode_worker(shared):
+    global _worker_data
+    _worker_data = memoryview(getattr(shared, "data", shared))
+
+
+def _decode_candidates(data: Buffer, chains: List[Tuple[int, int]]) -> List[BRRSample]:
+    samples = []
+    for offset, blocks in chains:
+        sample = decode_brr(data, offset, blocks)
+        if sample.looks_valid():
+            samples.append(sample)
+    return samples
+
+
+def _decode_worker(chains: List[Tuple[int, int]]) -> List[BRRSample]:
+    return _decode_candidates(_worker_data, chains)
+
+
+def scan_brr_samples(data: Buffer, start: int = 0, end: Optional[int] = None,
+                     workers: Optional[int] = None) -> List[BRRSample]:
+    """
+    Valid BRR samples in [start, end), by offset; overlapping candidates keep the first
+    data may be a shared ROM image, which decode workers map by path.
+    """
+    shared = data if hasattr(data, "data") else bytes(data)
+    data = memoryview(getattr(shared, "data", shared))
+    chains = find_brr_chains(data, start, end)
+    tasks = [chains[i : i + DECODE_CHUNK] for i in range(0, len(chains), DECODE_CHUNK)]
+
+    workers = workers or os.cpu_count() or 1
+    decoded: List[BRRSample] = []
+    if workers == 1 or len(tasks) <= 1:
+        for task in tasks:
+            decoded.extend(_decode_candidates(data, task))
+    else:
+        with ProcessPoolExecutor(max_workers=min(workers, len(tasks)),
+                                 initializer=_init_decode_worker, initargs=(shared,)) as executor:
+            for samples in executor.map(_decode_worker, tasks):
+                decoded.extend(samples)
+
+    samples = []
+    claimed_end = -1
+    for sample in sorted(decoded, key=lambda s: s.offset):
+        if sample.offset >= claimed_end:
+            samples.append(sample)
+            claimed_end = sample.offset + sample.size
+    return samples
+
+
+def write_wav(path: Union[str, Path], pcm: array, sample_rate: int = DEFAULT_SAMPLE_RATE):
+    """16-bit mono WAV"""
+    frames = array("h", pcm)
+    if frames.itemsize != 2:
+        raise ValueError("PCM must be 16-bit")
+    if sys.byteorder != "little":
+        frames.byteswap()
+    with wave.open(str(path), "wb") as wav:
+        wav.setnchannels(1)
+        wav.setsampwidth(2)
+        wav.setframerate(sample_rate)
+        wav.writeframes(frames.tobytes())
+
+
+def write_pcm(path: Union[str, Path], pcm: array):
+    """Raw little-endian int16 PCM"""
+    frames = array("h", pcm)
+    if sys.byteorder != "little":
+        frames.byteswap()
+    Path(path).write_bytes(frames.tobytes())
+
+
+def export_samples(samples: List[BRRSample], output_dir: Union[str, Path], fmt: str = "wav",
+                   sample_rate: int = DEFAULT_SAMPLE_RATE, prefix: str = "brr_sample") -> List[Path]:
+    """Write every sample as <prefix>_<offset>.wav (or .pcm)"""
+    if fmt not in ("wav", "pcm"):
+        raise ValueError(f"Unknown audio format: {fmt}")
+    output_dir = Path(output_dir)
+    output_dir.mkdir(parents=True, exist_ok=True)
+
+    paths = []
+    for sample in samples:
+        path = output_dir / f"{prefix}_{sample.offset:06X}.{fmt}"
+        if fmt == "wav":
+            write_wav(path, sample.pcm, sample_rate)
+        else:
+            write_pcm(path, sample.pcm)
+        paths.append(path)
+    return paths
+
+
+def sample_summary(sample: BRRSample) -> Dict[str, object]:
+    return {
+        "offset": f"0x{sample.offset:06X}",
+        "blocks": sample.blocks,
+        "size": sample.size,
+        "samples": len(sample.pcm),
+        "loops": sample.loops,
+        "peak": sample.peak,
+    }
+
+
+if __name__ == "__main__":
+    import argparse
+    import json
+    import time
+
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Find and decode BRR samples in a ROM")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("--start", type=lambda v: int(v, 0), default=0, help="First offset to scan")
+    parser.add_argument("--end", type=lambda v: int(v, 0), help="Offset to stop scanning at")
+    parser.add_argument("--workers", type=int, help="Decode worker processes (default: one per core)")
+    parser.add_argument("--export", help="Write every sample to this directory")
+    parser.add_argument("--format", choices=("wav", "pcm"), default="wav", help="Export format")
+    parser.add_argument("--rate", type=int, default=DEFAULT_SAMPLE_RATE, help="WAV sample rate")
+    parser.add_argument("--output", "-o", help="Write the sample list as JSON")
+    args = parser.parse_args()
+
+    image = open_rom_image(args.rom_file)
+    start_time = time.time()
+    samples = scan_brr_samples(image, args.start, args.end, args.workers)
+    elapsed = time.time() - start_time
+    total_blocks = sum(sample.blocks for sample in samples)
+    print(f"🎵 {len(samples)} BRR samples ({total_blocks:,} blocks) in {elapsed:.2f}s")
+    for sample in samples[:20]:
+        print(f"   ${sample.offset:06X} {sample.blocks:>5} blocks, peak {sample.peak:>5}" + (" (loops)" if sample.loops else ""))
+
+    if args.export:
+        paths = export_samples(samples, args.export, args.format, args.rate)
+        print(f"💾 {len(paths)} samples written to {args.export}")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump([sample_summary(sample) for sample in samples], f, indent=2)
+        print(f"Sample list saved to {args.output}")
@@ -8,6 +8,7 @@ pattern recognition, function identification, and documentation generation.
 """
 
 import struct
+import sys
 import os
 import json
 from pathlib import Path
@@ -17,6 +18,11 @@ from collections import defaultdict, Counter
 import time
 import hashlib
 
+# Shared 65816 opcode table
+sys.path.append(str(Path(__file__).parent.parent / "disassembly"))
+from decoder65816 import opcode_definitions, format_operand
+
+
 @dataclass
 class AnalyzedFunction:
     """Represents a complete analyzed function"""
@@ -236,6 +242,10 @@ class ComprehensiveDisassembler:
                 'analysis': analysis
             }
 
+        # Fill every opcode the curated list leaves out from the shared decoder table
+        for opcode_val, definition in opcode_definitions().items():
+            opcodes.setdefault(opcode_val, definition)
+
         return opcodes
 
     def _init_snes_vectors(self) -> Dict[str, int]:
@@ -601,7 +611,9 @@ class ComprehensiveDisassembler:
                 return f"${addr:06X}", addr
             return "$??????", None
         else:
-            return "???", None
+            operand = int.from_bytes(bytes(bytes_data[1:]), "little")
+            _, addr = self.rom_offset_to_snes_address(offset)
+            return format_operand(bytes_data[0], operand, len(bytes_data), addr), None
 
     def _extract_call_target(self, instruction: Dict[str, Any]) -> Optional[int]:
         """Extract the target address from a call instruction"""
@@ -12,6 +12,8 @@ from pathlib import Path
 from typing import Dict, List, Tuple, Any
 from dataclasses import dataclass
 
+from rom_image import open_rom_image
+
 
 @dataclass
 class CodeRegion:
@@ -31,8 +33,8 @@ class DQ3DeepAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, "rb") as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.code_regions = []
@@ -14,6 +14,8 @@ from typing import Dict, List, Tuple, Any, Optional
 from dataclasses import dataclass
 import json
 
+from rom_image import open_rom_image
+
 
 @dataclass
 class GraphicsFunction:
@@ -59,8 +61,8 @@ class DQ3GraphicsAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, "rb") as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.graphics_functions = []
@@ -497,17 +499,8 @@ class DQ3GraphicsAnalyzer:
             return "infrequent"
 
     def _snes_to_rom_address(self, snes_addr: int) -> int:
-        """Convert SNES address to ROM file offset"""
-        bank = (snes_addr >> 16) & 0xFF
-        offset = snes_addr & 0xFFFF
-
-        if bank < 0x80 and offset >= 0x8000:
-            return (bank * 0x8000) + (offset - 0x8000)
-        elif bank >= 0x80 and offset >= 0x8000:
-            bank = bank - 0x80
-            return (bank * 0x8000) + (offset - 0x8000)
-
-        return 0
+        """Convert SNES address to ROM file offset (0 when it maps no ROM)"""
+        return self.rom.to_offset(snes_addr) or 0
 
     def _find_dma_source_address(self, offset: int) -> Optional[int]:
         """Find DMA source address from DMA setup code"""
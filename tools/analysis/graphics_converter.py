@@ -14,6 +14,9 @@ from pathlib import Path
 from typing import Dict, List, Tuple, Any, Optional
 import time
 
+from tile_codec import decode_tiles, decode_tile, encode_tiles
+from atlas_renderer import AtlasRenderer, Placement, bgr555_to_rgba
+
 try:
     from PIL import Image
     PIL_AVAILABLE = True
@@ -72,17 +75,8 @@ class SNESGraphicsConverter:
 
     def bgr555_to_rgb(self, color_value: int) -> Tuple[int, int, int]:
         """Convert SNES BGR555 color to RGB tuple"""
-        # BGR555 format: 0bbbbbgggggrrrrr
-        blue = (color_value >> 10) & 0x1F
-        green = (color_value >> 5) & 0x1F
-        red = color_value & 0x1F
-
-        # Scale 5-bit values to 8-bit
-        red = (red * 255) // 31
-        green = (green * 255) // 31
-        blue = (blue * 255) // 31
-
-        return (red, green, blue)
+        # BGR555 format: 0bbbbbgggggrrrrr, looked up in the shared 32K color table
+        return bgr555_to_rgba(color_value)[:3]
 
     def load_palette(self, palette_file: Path) -> List[Tuple[int, int, int]]:
         """Load SNES palette from binary file"""
@@ -109,88 +103,60 @@ class SNESGraphicsConverter:
         Decode SNES 4bpp tile data (32 bytes) to pixel indices
         Returns 8x8 array as flat list
         """
-        if len(tile_data) != 32:
-            return [0] * 64  # Default empty tile
-
-        pixels = [0] * 64  # 8x8 pixels
-
-        # SNES 4bpp format: interleaved bitplanes
-        # Bytes 0-1: bitplane 0 row 0-1
-        # Bytes 2-3: bitplane 1 row 0-1
-        # etc.
-
-        for row in range(8):
-            bp0_offset = row * 2
-            bp1_offset = bp0_offset + 16
-
-            if bp0_offset + 1 < len(tile_data) and bp1_offset + 1 < len(tile_data):
-                # Get bitplane data for this row
-                bp0_low = tile_data[bp0_offset]
-                bp0_high = tile_data[bp0_offset + 1]
-                bp1_low = tile_data[bp1_offset]
-                bp1_high = tile_data[bp1_offset + 1]
-
-                for col in range(8):
-                    bit_mask = 1 << (7 - col)
-
-                    # Extract bits from each bitplane
-                    bit0 = 1 if (bp0_low & bit_mask) else 0
-                    bit1 = 1 if (bp0_high & bit_mask) else 0
-                    bit2 = 1 if (bp1_low & bit_mask) else 0
-                    bit3 = 1 if (bp1_high & bit_mask) else 0
-
-                    # Combine into 4-bit color index
-                    color_index = bit0 | (bit1 << 1) | (bit2 << 2) | (bit3 << 3)
-                    pixels[row * 8 + col] = color_index
-
-        return pixels
+        return decode_tile(tile_data, 4)
 
     def decode_2bpp_tile(self, tile_data: bytes) -> List[int]:
         """
         Decode SNES 2bpp tile data (16 bytes) to pixel indices
         """
-        if len(tile_data) != 16:
-            return [0] * 64
-
-        pixels = [0] * 64  # 8x8 pixels
-
-        for row in range(8):
-            bp0_offset = row * 2
-            bp1_offset = bp0_offset + 1
-
-            if bp1_offset < len(tile_data):
-                bp0 = tile_data[bp0_offset]
-                bp1 = tile_data[bp1_offset]
+        return decode_tile(tile_data, 2)
 
-                for col in range(8):
-                    bit_mask = 1 << (7 - col)
-
-                    bit0 = 1 if (bp0 & bit_mask) else 0
-                    bit1 = 1 if (bp1 & bit_mask) else 0
+    def decode_tile_run(self, tile_data: bytes, bpp: int, out: Optional[bytearray] = None,
+                        out_offset: int = 0) -> bytearray:
+        """
+        Decode a whole run of tiles in one call (64 index bytes per tile, row-major)
+        Pass out/out_offset to decode straight into an existing buffer.
+        """
+        return decode_tiles(tile_data, bpp, out, out_offset)
 
-                    color_index = bit0 | (bit1 << 1)
-                    pixels[row * 8 + col] = color_index
+    def planarize_image(self, image: 'Image.Image', palette: List[Tuple[int, int, int]], bpp: int = 4) -> bytes:
+        """
+        Re-planarize an edited tile sheet (width/height multiples of 8, tiles left-to-right,
+        top-to-bottom) into SNES tile data. Paletted images use their indices directly; RGB
+        images are matched against palette (unknown colors become index 0).
+        """
+        width, height = image.size
+        if width % 8 or height % 8:
+            raise ValueError(f"Image size {width}x{height} is not a multiple of 8")
 
-        return pixels
+        if image.mode == 'P':
+            indices = image.tobytes()
+        else:
+            color_index = {}
+            for index, color in enumerate(palette):
+                color_index.setdefault(tuple(color[:3]), index)
+            indices = bytes(color_index.get(pixel[:3], 0) for pixel in image.convert('RGB').getdata())
+
+        # Reorder scanlines into tile-major 8x8 blocks
+        tiles_x = width // 8
+        tile_pixels = bytearray(width * height)
+        for y in range(height):
+            row = indices[y * width:(y + 1) * width]
+            tile_row, pixel_row = divmod(y, 8)
+            for tile_col in range(tiles_x):
+                dest = ((tile_row * tiles_x + tile_col) * 64) + pixel_row * 8
+                tile_pixels[dest:dest + 8] = row[tile_col * 8:tile_col * 8 + 8]
+
+        return bytes(encode_tiles(tile_pixels, bpp))
 
     def create_tile_image(self, pixels: List[int], palette: List[Tuple[int, int, int]]) -> 'Image.Image':
         """Create PIL Image from pixel indices and palette"""
         if not PIL_AVAILABLE:
             return None
 
-        # Create 8x8 RGB image
-        img = Image.new('RGB', (8, 8))
-
-        for y in range(8):
-            for x in range(8):
-                pixel_index = pixels[y * 8 + x]
-                if pixel_index < len(palette):
-                    color = palette[pixel_index]
-                else:
-                    color = (255, 0, 255)  # Magenta for invalid colors
-                img.putpixel((x, y), color)
-
-        return img
+        # Re-planarize to 8bpp so any index renders; out-of-palette indices come out magenta
+        atlas = AtlasRenderer(palette, 8).render(encode_tiles(bytes(pixels[:64]), 8))
+        return atlas.to_image().convert('RGB')
 
     def convert_palettes(self):
         """Convert palette files to PNG format"""
@@ -209,10 +175,7 @@ class SNESGraphicsConverter:
                 colors = self.load_palette(palette_file)
 
                 # Create 16x1 palette image
-                palette_img = Image.new('RGB', (16, 1))
-
-                for i, color in enumerate(colors[:16]):
-                    palette_img.putpixel((i, 0), color)
+                palette_img = Image.frombytes('RGB', (16, 1), bytes(c for color in colors[:16] for c in color))
 
                 # Scale up for visibility
                 palette_img = palette_img.resize((160, 10), Image.NEAREST)
@@ -337,42 +300,38 @@ class SNESGraphicsConverter:
                 # Create tileset image
                 tileset_width = tiles_per_row * 8
                 tileset_height = tiles_per_column * 8
-                tileset_img = Image.new('RGB', (tileset_width, tileset_height), (128, 128, 128))
-
-                tiles_in_set = 0
 
+                # Gather the first tile of each file (2bpp promoted to 4bpp) into one run
+                tile_run = bytearray()
+                placements = []
                 for i in range(tiles_per_set):
                     tile_index = set_index + i
                     if tile_index >= len(tile_files):
                         break
 
-                    tile_file = tile_files[tile_index]
-
                     try:
-                        with open(tile_file, 'rb') as f:
+                        with open(tile_files[tile_index], 'rb') as f:
                             tile_data = f.read()
+                    except OSError:
+                        continue
 
-                        # Decode tile
-                        if len(tile_data) >= 32:
-                            pixels = self.decode_4bpp_tile(tile_data[:32])
-                        elif len(tile_data) >= 16:
-                            pixels = self.decode_2bpp_tile(tile_data[:16])
-                        else:
-                            continue
-
-                        # Create tile image
-                        tile_img = self.create_tile_image(pixels, palette)
+                    if len(tile_data) >= 32:
+                        tile_run += tile_data[:32]
+                    elif len(tile_data) >= 16:
+                        tile_run += encode_tiles(decode_tiles(tile_data[:16], 2), 4)
+                    else:
+                        continue
 
-                        # Calculate position in tileset
-                        tile_x = (i % tiles_per_row) * 8
-                        tile_y = (i // tiles_per_row) * 8
+                    tile_x = (i % tiles_per_row) * 8
+                    tile_y = (i // tiles_per_row) * 8
+                    placements.append(Placement(tile_x, tile_y, len(placements)))
 
-                        # Paste tile into tileset
-                        tileset_img.paste(tile_img, (tile_x, tile_y))
-                        tiles_in_set += 1
+                tiles_in_set = len(placements)
 
-                    except Exception as e:
-                        continue
+                # Render the whole set in one pass
+                renderer = AtlasRenderer(palette, 4, background=(128, 128, 128))
+                atlas = renderer.render(tile_run, placements, width=tileset_width, height=tileset_height)
+                tileset_img = atlas.to_image().convert('RGB')
 
                 if tiles_in_set > 0:
                     # Scale up for visibility
@@ -10,17 +10,22 @@ disassembly coverage, identifying all data structures, code, and assets.
 import struct
 import time
 import hashlib
-import math
 from pathlib import Path
 from typing import Dict, List, Tuple, Any, Optional, Set
 from dataclasses import dataclass, field
 import json
-from collections import defaultdict, Counter
+from collections import defaultdict
 import sys
 
 # Add parent directory for imports
 sys.path.append(str(Path(__file__).parent.parent))
 
+from rom_classifier import (
+    DEFAULT_WINDOW, REGION_AUDIO, REGION_GRAPHICS, REGION_TEXT, ROMClassification, classify_rom
+)
+from rom_image import open_rom_image
+from xref_index import build_xref_index
+
 try:
     from analysis.rom_header_analyzer import DQ3ROMHeaderAnalyzer
     from analysis.deep_rom_analyzer import DQ3DeepAnalyzer
@@ -89,8 +94,8 @@ class MaximumCoverageAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, 'rb') as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.regions = []
@@ -98,6 +103,7 @@ class MaximumCoverageAnalyzer:
         self.coverage_map = [0] * self.rom_size  # 0=unknown, 1=analyzed
         self.data_patterns = defaultdict(list)
         self.cross_references = defaultdict(set)
+        self._classifications = {}
 
         # Statistics
         self.total_bytes_analyzed = 0
@@ -111,26 +117,23 @@ class MaximumCoverageAnalyzer:
         print(f"   ROM: {self.rom_path}")
         print(f"   Size: {self.rom_size:,} bytes ({self.rom_size / (1024*1024):.2f} MB)")
 
+    @property
+    def classification(self) -> ROMClassification:
+        """Shared single-pass region classification of the ROM (see rom_classifier)"""
+        return self._classification_for(DEFAULT_WINDOW)
+
+    def _classification_for(self, window_size: int) -> ROMClassification:
+        if window_size not in self._classifications:
+            self._classifications[window_size] = classify_rom(self.rom_data, window_size, window_size // 4)
+        return self._classifications[window_size]
+
     def analyze_byte_entropy(self, window_size: int = 256) -> Dict[int, float]:
         """Calculate entropy for sliding windows to identify data types"""
         print(f"\nANALYZING: Calculating byte entropy with window size {window_size}...")
 
-        entropy_map = {}
-
-        for offset in range(0, self.rom_size - window_size, window_size // 4):
-            window = self.rom_data[offset:offset + window_size]
-
-            # Calculate Shannon entropy
-            byte_counts = Counter(window)
-            entropy = 0.0
-
-            for count in byte_counts.values():
-                probability = count / len(window)
-                if probability > 0:
-                    entropy -= probability * math.log2(probability)
-
-            entropy_map[offset] = entropy
+        entropy_map = self._classification_for(window_size).entropy_map()
 
+        for offset, entropy in entropy_map.items():
             # Classify based on entropy
             if entropy > 7.5:
                 self._mark_region_type(offset, offset + window_size, "compressed_data")
@@ -148,36 +151,16 @@ class MaximumCoverageAnalyzer:
         """Find all possible pointer references in the ROM"""
         print(f"\n🔗 Scanning for pointer references...")
 
-        pointers = defaultdict(list)
-
-        # SNES addressing patterns
-        for offset in range(0, self.rom_size - 2):
-            # 16-bit pointers
-            ptr16 = struct.unpack('<H', self.rom_data[offset:offset + 2])[0]
-
-            # Check if it's a valid SNES address
-            if 0x8000 <= ptr16 <= 0xFFFF:
-                target = self._snes_to_rom_address(ptr16)
-                if 0 <= target < self.rom_size:
-                    pointers[target].append(offset)
-                    self.cross_references[target].add(offset)
-
-            # 24-bit pointers (if enough data)
-            if offset < self.rom_size - 3:
-                ptr24 = struct.unpack('<I', self.rom_data[offset:offset + 3] + b'\x00')[0]
-                bank = (ptr24 >> 16) & 0xFF
-                addr = ptr24 & 0xFFFF
-
-                if bank <= 0x3F and 0x8000 <= addr <= 0xFFFF:
-                    target = (bank * 0x8000) + (addr - 0x8000)
-                    if 0 <= target < self.rom_size:
-                        pointers[target].append(offset)
-                        self.cross_references[target].add(offset)
+        # 16-bit (bank 0) and 24-bit pointer candidates in one sorted target -> source index
+        self.xref_index = build_xref_index(self.rom_data[: self.rom_size - 1], self.rom.address_map)
+        pointers = self.xref_index.as_dict()
+        for target, sources in pointers.items():
+            self.cross_references[target].update(sources)
 
         print(f"   Found {len(pointers)} pointer targets")
         print(f"   Total references: {sum(len(refs) for refs in pointers.values())}")
 
-        return dict(pointers)
+        return pointers
 
     def identify_data_tables(self) -> List[ROMRegion]:
         """Identify all data tables and lookup tables"""
@@ -216,41 +199,24 @@ class MaximumCoverageAnalyzer:
         print(f"\n📝 Identifying text data...")
 
         text_regions = []
-        current_text_start = None
-        current_text_size = 0
-
-        for offset in range(self.rom_size):
-            byte_val = self.rom_data[offset]
 
-            # Check if byte could be text (printable ASCII or DQ3 character codes)
-            is_text_byte = self._is_text_byte(byte_val)
-
-            if is_text_byte:
-                if current_text_start is None:
-                    current_text_start = offset
-                current_text_size += 1
-            else:
-                # End of text region
-                if current_text_start is not None and current_text_size >= 8:
-                    text_content = self.rom_data[current_text_start:current_text_start + current_text_size]
-
-                    region = ROMRegion(
-                        start_offset=current_text_start,
-                        end_offset=current_text_start + current_text_size,
-                        size=current_text_size,
-                        region_type="text",
-                        confidence=self._calculate_text_confidence(text_content),
-                        description=f"Text data ({current_text_size} bytes)",
-                        analysis_data={
-                            'preview': text_content[:32].hex(),
-                            'probable_encoding': self._detect_text_encoding(text_content)
-                        }
-                    )
-                    text_regions.append(region)
-                    self._mark_bytes_analyzed(current_text_start, current_text_start + current_text_size)
-
-                current_text_start = None
-                current_text_size = 0
+        for start, end, _ in self.classification.regions(REGION_TEXT):
+            text_content = self.rom_data[start:end]
+
+            region = ROMRegion(
+                start_offset=start,
+                end_offset=end,
+                size=end - start,
+                region_type="text",
+                confidence=self._calculate_text_confidence(text_content),
+                description=f"Text data ({end - start} bytes)",
+                analysis_data={
+                    'preview': text_content[:32].hex(),
+                    'probable_encoding': self._detect_text_encoding(text_content)
+                }
+            )
+            text_regions.append(region)
+            self._mark_bytes_analyzed(start, end)
 
         print(f"   Found {len(text_regions)} text regions")
         return text_regions
@@ -284,39 +250,20 @@ class MaximumCoverageAnalyzer:
         except Exception as e:
             print(f"   Warning: Graphics analyzer failed: {e}")
 
-        # Additional pattern-based graphics detection
-        graphics_patterns = [
-            b'\x00\x00\x7E\x7E',  # Common tile pattern
-            b'\xFF\x00\xFF\x00',  # Checkerboard pattern
-            b'\x80\x80\x80\x80',  # Vertical line pattern
-        ]
-
-        for offset in range(0, self.rom_size - 64, 64):
-            chunk = self.rom_data[offset:offset + 64]
-
-            # Check for graphics patterns
-            graphics_score = 0
-            for pattern in graphics_patterns:
-                if pattern in chunk:
-                    graphics_score += 1
-
-            # Check bit patterns typical of graphics
-            bit_patterns = self._analyze_bit_patterns(chunk)
-            if bit_patterns['regularity'] > 0.7:
-                graphics_score += 2
-
-            if graphics_score >= 2:
-                region = ROMRegion(
-                    start_offset=offset,
-                    end_offset=offset + 64,
-                    size=64,
-                    region_type="graphics",
-                    confidence=min(0.9, graphics_score / 4.0),
-                    description="Pattern-detected graphics data",
-                    analysis_data={'patterns_found': graphics_score}
-                )
-                graphics_regions.append(region)
-                self._mark_bytes_analyzed(offset, offset + 64)
+        # Tile-pattern regions from the shared classifier
+        for start, end, _ in self.classification.regions(REGION_GRAPHICS):
+            tile_score = self.classification.summarize(start, end)['tile']
+            region = ROMRegion(
+                start_offset=start,
+                end_offset=end,
+                size=end - start,
+                region_type="graphics",
+                confidence=min(0.9, tile_score + 0.3),
+                description="Pattern-detected graphics data",
+                analysis_data={'tile_score': round(tile_score, 3)}
+            )
+            graphics_regions.append(region)
+            self._mark_bytes_analyzed(start, end)
 
         print(f"   Found {len(graphics_regions)} graphics regions")
         return graphics_regions
@@ -349,30 +296,20 @@ class MaximumCoverageAnalyzer:
         except Exception as e:
             print(f"   Warning: Audio analyzer failed: {e}")
 
-        # Look for audio patterns
-        for offset in range(0, self.rom_size - 256, 256):
-            chunk = self.rom_data[offset:offset + 256]
-
-            # Check for SPC-700 instruction patterns
-            spc_patterns = 0
-            spc_opcodes = [0x8F, 0xAF, 0xC4, 0xE4, 0x3F, 0x6F, 0x2F, 0xF0, 0xD0]
-
-            for byte_val in chunk[::8]:  # Sample every 8th byte
-                if byte_val in spc_opcodes:
-                    spc_patterns += 1
-
-            if spc_patterns >= 4:  # Threshold for likely SPC code
-                region = ROMRegion(
-                    start_offset=offset,
-                    end_offset=offset + 256,
-                    size=256,
-                    region_type="audio",
-                    confidence=min(0.8, spc_patterns / 8.0),
-                    description="Possible SPC-700 code",
-                    analysis_data={'spc_pattern_count': spc_patterns}
-                )
-                audio_regions.append(region)
-                self._mark_bytes_analyzed(offset, offset + 256)
+        # BRR sample regions from the shared classifier
+        for start, end, _ in self.classification.regions(REGION_AUDIO):
+            brr_score = self.classification.summarize(start, end)['brr']
+            region = ROMRegion(
+                start_offset=start,
+                end_offset=end,
+                size=end - start,
+                region_type="audio",
+                confidence=min(0.8, brr_score),
+                description="Possible BRR sample data",
+                analysis_data={'brr_score': round(brr_score, 3)}
+            )
+            audio_regions.append(region)
+            self._mark_bytes_analyzed(start, end)
 
         print(f"   Found {len(audio_regions)} audio regions")
         return audio_regions
@@ -471,7 +408,7 @@ class MaximumCoverageAnalyzer:
             else:
                 if current_start is not None and current_size >= 16:
                     # Analyze this unidentified region
-                    data = self.rom_data[current_start:current_start + current_size]
+                    data = bytes(self.rom_data[current_start:current_start + current_size])
                     analysis = self._analyze_unknown_data(data)
 
                     region = ROMRegion(
@@ -580,16 +517,8 @@ class MaximumCoverageAnalyzer:
         return coverage_report
 
     def _snes_to_rom_address(self, snes_addr: int) -> int:
-        """Convert SNES address to ROM offset"""
-        bank = (snes_addr >> 16) & 0xFF
-        offset = snes_addr & 0xFFFF
-
-        if bank < 0x80 and offset >= 0x8000:
-            return (bank * 0x8000) + (offset - 0x8000)
-        elif bank >= 0x80 and offset >= 0x8000:
-            bank = bank - 0x80
-            return (bank * 0x8000) + (offset - 0x8000)
-        return 0
+        """Convert SNES address to ROM offset (0 when it maps no ROM)"""
+        return self.rom.to_offset(snes_addr) or 0
 
     def _mark_region_type(self, start: int, end: int, region_type: str):
         """Mark bytes as a specific type for tracking"""
@@ -641,19 +570,6 @@ class MaximumCoverageAnalyzer:
 
         return None
 
-    def _is_text_byte(self, byte_val: int) -> bool:
-        """Check if byte could be text"""
-        # Printable ASCII
-        if 0x20 <= byte_val <= 0x7E:
-            return True
-        # Common control characters
-        if byte_val in [0x00, 0x0A, 0x0D, 0xFF]:
-            return True
-        # DQ3 specific character codes (estimated range)
-        if 0x80 <= byte_val <= 0xF0:
-            return True
-        return False
-
     def _calculate_text_confidence(self, text_data: bytes) -> float:
         """Calculate confidence that data is text"""
         if len(text_data) == 0:
@@ -677,20 +593,6 @@ class MaximumCoverageAnalyzer:
         else:
             return "UNKNOWN"
 
-    def _analyze_bit_patterns(self, data: bytes) -> Dict[str, float]:
-        """Analyze bit patterns in data"""
-        if len(data) == 0:
-            return {'regularity': 0.0}
-
-        # Count bit transitions
-        transitions = 0
-        for i in range(len(data) - 1):
-            if data[i] != data[i + 1]:
-                transitions += 1
-
-        regularity = 1.0 - (transitions / len(data))
-        return {'regularity': regularity}
-
     def _analyze_unknown_data(self, data: bytes) -> Dict[str, Any]:
         """Analyze unknown data to determine probable type"""
         if len(data) == 0:
@@ -22,6 +22,9 @@ import threading
 from concurrent.futures import ThreadPoolExecutor
 import csv
 
+from analysis_store import DATA_TABLES, REGIONS, TEXT_STRINGS, AnalysisStore, rom_digest
+from rom_image import open_rom_image
+
 @dataclass
 class ROMRegion:
     """Represents a classified region of ROM data"""
@@ -511,8 +514,12 @@ class MaximumROMAnalyzer:
 
         return True
 
-    def perform_comprehensive_scan(self):
-        """Perform complete ROM analysis"""
+    def perform_comprehensive_scan(self, export_reports: bool = True):
+        """
+        Perform complete ROM analysis
+        Results always go to the binary analysis store; export_reports also writes the
+        CSV/JSON/Markdown reports under docs/maximum_analysis.
+        """
         print("\nSTARTING: Maximum ROM Analysis")
         print("=" * 70)
 
@@ -542,9 +549,11 @@ class MaximumROMAnalyzer:
         print("PHASE 5: Building cross-references...")
         self._build_comprehensive_cross_refs()
 
-        # Phase 6: Generate reports
-        print("PHASE 6: Generating comprehensive reports...")
-        self._generate_maximum_documentation()
+        # Phase 6: Store results, then export reports
+        print("PHASE 6: Storing results...")
+        self._write_analysis_store()
+        if export_reports:
+            self._generate_maximum_documentation()
 
         total_time = time.time() - start_time
         print(f"\nMAXIMUM ANALYSIS COMPLETE!")
@@ -634,6 +643,39 @@ class MaximumROMAnalyzer:
                         if target_offset < self.rom_size:
                             region.cross_refs.append(target_offset)
 
+    def _write_analysis_store(self, store: Optional[AnalysisStore] = None):
+        """Regions, text strings and data tables as binary tables for the later stages"""
+        store = store or AnalysisStore()
+        digest = rom_digest(open_rom_image(self.rom_path).data)
+
+        regions = sorted(self.regions, key=lambda x: x.start_offset)
+        store.write("regions", REGIONS, {
+            'start': [r.start_offset for r in regions],
+            'end': [r.end_offset for r in regions],
+            'type': [r.region_type for r in regions],
+            'confidence': [r.confidence for r in regions],
+            'description': [r.description for r in regions],
+            'hash': [r.hash_id for r in regions],
+        }, digest)
+
+        store.write("text_strings", TEXT_STRINGS, {
+            'offset': [t.offset for t in self.text_strings],
+            'length': [t.length for t in self.text_strings],
+            'encoding': [t.encoding for t in self.text_strings],
+            'context': [t.context for t in self.text_strings],
+            'text': [t.text for t in self.text_strings],
+        }, digest)
+
+        store.write("data_tables", DATA_TABLES, {
+            'offset': [t.offset for t in self.data_tables],
+            'type': [t.table_type for t in self.data_tables],
+            'entry_count': [t.entry_count for t in self.data_tables],
+            'entry_size': [t.entry_size for t in self.data_tables],
+            'description': [t.description for t in self.data_tables],
+        }, digest)
+
+        print(f"Analysis store updated: {store.root}/")
+
     def _generate_maximum_documentation(self):
         """Generate comprehensive documentation suite"""
         docs_dir = Path("docs/maximum_analysis")
@@ -757,9 +799,15 @@ def main():
         print("ERROR: No ROM file found!")
         return
 
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Dragon Quest III - Maximum ROM Analysis")
+    parser.add_argument("--no-reports", action="store_true", help="Only update the binary analysis store")
+    args = parser.parse_args()
+
     # Run maximum analysis
     analyzer = MaximumROMAnalyzer(rom_path)
-    analyzer.perform_comprehensive_scan()
+    analyzer.perform_comprehensive_scan(export_reports=not args.no_reports)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,674 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - RNG Model
+============================
+
+Exact models of a 65816 random number routine, for seed searches and
+simulations that need far more draws than stepping the routine allows.
+
+The routine itself is the reference: RoutineEvaluator runs its straight-
+line 65816 code (loads, stores, shifts, ALU ops, branches) on a state held
+in a few WRAM bytes, and identify_rng fits what it computes:
+
+- affine mod 2^n (LCG-style multiply/shift-add/add routines)
+- affine over GF(2) (xorshift and LFSR routines)
+- anything else with a state of 16 bits or less, as a full transition table
+
+and checks the fit on random probe states, so a returned model agrees with
+the routine bit for bit. Every model advances one state, jumps ahead any
+number of steps in logarithmic time, and advances many states at once:
+affine models pack all states into one integer with a lane per state (one
+multiply steps every lane), GF(2) models keep one integer per state bit
+(byte-sliced planes, so a step is a handful of XORs over all states).
+"""
+
+import random
+import sys
+from array import array
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Sequence, Tuple
+
+sys.path.append(str(Path(__file__).parent.parent / "disassembly"))
+from decoder65816 import FLAG_M, FLAG_X, OPCODE_TABLE, SIZE_TABLES, read_operand
+
+# Probe states used to confirm an affine fit
+PROBES = 512
+
+# Instructions the evaluator runs before giving up on a routine
+MAX_STEPS = 10000
+
+# Largest state tabulated when the routine is neither affine nor (GF(2)-)linear
+MAX_TABLE_BITS = 16
+
+
+# ---------------------------------------------------------------------- routine evaluation
+
+
+class RoutineEvaluator:
+    """
+    Concrete evaluation of a self-contained 65816 routine
+    The direct page is $0000 and absolute operands use data_bank. Only WRAM is modelled:
+    $0000-$1FFF of the system banks (the low-RAM mirror) and banks $7E/$7F. Any other
+    access (hardware registers such as the $4202-$4217 multiplier, ROM tables), calls,
+    indirect modes and decimal mode are rejected (ValueError) rather than guessed at.
+    """
+
+    def __init__(self, code: bytes, start: int = 0, p_flags: int = FLAG_M | FLAG_X, max_steps: int = MAX_STEPS,
+                 data_bank: int = 0x00):
+        self.code = code
+        self.start = start
+        self.p_flags = p_flags & (FLAG_M | FLAG_X)
+        self.max_steps = max_steps
+        self.data_bank = data_bank & 0xFF
+
+    @staticmethod
+    def _key(address: int) -> int:
+        """Memory key of a 24-bit address: low RAM by its offset, the rest of WRAM as $7Exxxx/$7Fxxxx"""
+        bank, offset = address >> 16, address & 0xFFFF
+        if bank in (0x7E, 0x7F):
+            return offset if bank == 0x7E and offset < 0x2000 else address
+        if (bank < 0x40 or 0x80 <= bank < 0xC0) and offset < 0x2000:
+            return offset
+        raise ValueError(f"Access to ${address:06X} is outside WRAM")
+
+    def run(self, memory: Dict[int, int]) -> Tuple[Dict[int, int], int]:
+        """Memory after the routine returns, and the accumulator it returns"""
+        code = self.code
+        mem = dict(memory)
+        key = self._key
+        a = x = y = 0
+        carry = negative = zero = overflow = 0
+        p_flags = self.p_flags
+        data_bank = self.data_bank << 16
+        stack: List[int] = []
+        pos = self.start
+
+        def read(address: int, wide: bool) -> int:
+            low = mem.get(key(address), 0)
+            return low | (mem.get(key(address + 1), 0) << 8) if wide else low
+
+        def write(address: int, value: int, wide: bool):
+            mem[key(address)] = value & 0xFF
+            if wide:
+                mem[key(address + 1)] = (value >> 8) & 0xFF
+
+        for _ in range(self.max_steps):
+            if pos >= len(code):
+                raise ValueError("Routine runs past the end of the code")
+            opcode = code[pos]
+            info = OPCODE_TABLE[opcode]
+            size = SIZE_TABLES[p_flags][opcode]
+            operand = read_operand(code, pos, size)
+            mnemonic, mode = info.mnemonic, info.mode
+            m16 = not p_flags & FLAG_M
+            x16 = not p_flags & FLAG_X
+            mask = 0xFFFF if m16 else 0xFF
+            index_mask = 0xFFFF if x16 else 0xFF
+            next_pos = pos + size
+
+            # Effective address of memory operands
+            if mode in ("zeropage", "long"):
+                address = operand
+            elif mode == "absolute":
+                address = data_bank | operand
+            elif mode == "zeropage_x":
+                address = (operand + x) & 0xFFFF
+            elif mode == "zeropage_y":
+                address = (operand + y) & 0xFFFF
+            elif mode == "absolute_x":
+                address = data_bank | ((operand + x) & 0xFFFF)
+            elif mode == "absolute_y":
+                address = data_bank | ((operand + y) & 0xFFFF)
+            elif mode == "long_x":
+                address = (operand + x) & 0xFFFFFF
+            elif mode in ("immediate", "implied", "accumulator", "relative"):
+                address = None
+            else:
+                raise ValueError(f"Unsupported addressing mode {mode} at 0x{pos:06X}")
+
+            def value_of(wide: bool) -> int:
+                return operand if mode == "immediate" else read(address, wide)
+
+            if mnemonic in ("RTS", "RTL"):
+                return mem, a & mask
+            elif mnemonic == "LDA":
+                value = value_of(m16)
+                a = value if m16 else (a & 0xFF00) | value
+                result = value
+            elif mnemonic in ("LDX", "LDY"):
+                value = value_of(x16)
+                if mnemonic == "LDX":
+                    x = value
+                else:
+                    y = value
+                negative, zero = value & (0x8000 if x16 else 0x80), not value
+                pos = next_pos
+                continue
+            elif mnemonic in ("STA", "STX", "STY", "STZ"):
+                wide = x16 if mnemonic in ("STX", "STY") else m16
+                value = {"STA": a, "STX": x, "STY": y, "STZ": 0}[mnemonic]
+                write(address, value, wide)
+                pos = next_pos
+                continue
+            elif mnemonic in ("ADC", "SBC"):
+                value = value_of(m16)
+                accumulator = a & mask
+                if mnemonic == "SBC":
+                    value ^= mask
+                total = accumulator + value + carry
+                carry = 1 if total > mask else 0
+                sign = 0x8000 if m16 else 0x80
+                overflow = ~(accumulator ^ value) & (accumulator ^ total) & sign
+                result = total & mask
+                a = result if m16 else (a & 0xFF00) | result
+            elif mnemonic in ("AND", "ORA", "EOR"):
+                value = value_of(m16)
+                accumulator = a & mask
+                result = (accumulator & value if mnemonic == "AND" else
+                          accumulator | value if mnemonic == "ORA" else accumulator ^ value)
+                a = result if m16 else (a & 0xFF00) | result
+            elif mnemonic in ("CMP", "CPX", "CPY"):
+                wide = m16 if mnemonic == "CMP" else x16
+                register = a & mask if mnemonic == "CMP" else x if mnemonic == "CPX" else y
+                difference = register - value_of(wide)
+                carry = 1 if difference >= 0 else 0
+                result = difference & (0xFFFF if wide else 0xFF)
+                negative, zero = result & (0x8000 if wide else 0x80), not result
+                pos = next_pos
+                continue
+            elif mnemonic in ("ASL", "LSR", "ROL", "ROR", "INC", "DEC"):
+                value = a & mask if mode == "accumulator" else read(address, m16)
+                top = 0x8000 if m16 else 0x80
+                if mnemonic == "ASL":
+                    carry, result = (1 if value & top else 0), (value << 1) & mask
+                elif mnemonic == "LSR":
+                    carry, result = value & 1, value >> 1
+                elif mnemonic == "ROL":
+                    carry, result = (1 if value & top else 0), ((value << 1) | carry) & mask
+                elif mnemonic == "ROR":
+                    carry, result = value & 1, (value >> 1) | (top if carry else 0)
+                elif mnemonic == "INC":
+                    result = (value + 1) & mask
+                else:
+                    result = (value - 1) & mask
+                if mode == "accumulator":
+                    a = result if m16 else (a & 0xFF00) | result
+                else:
+                    write(address, result, m16)
+            elif mnemonic in ("INX", "INY", "DEX", "DEY"):
+                step = 1 if mnemonic.startswith("IN") else -1
+                if mnemonic.endswith("X"):
+                    x = result = (x + step) & index_mask
+                else:
+                    y = result = (y + step) & index_mask
+                negative, zero = result & (0x8000 if x16 else 0x80), not result
+                pos = next_pos
+                continue
+            elif mnemonic in ("TAX", "TAY"):
+                value = a & index_mask
+                if mnemonic == "TAX":
+                    x = value
+                else:
+                    y = value
+                negative, zero = value & (0x8000 if x16 else 0x80), not value
+                pos = next_pos
+                continue
+            elif mnemonic in ("TXA", "TYA"):
+                value = (x if mnemonic == "TXA" else y) & mask
+                a = value if m16 else (a & 0xFF00) | value
+                result = value
+            elif mnemonic in ("TXY", "TYX"):
+                if mnemonic == "TXY":
+                    y = x
+                else:
+                    x = y
+                pos = next_pos
+                continue
+            elif mnemonic == "XBA":
+                a = ((a >> 8) | (a << 8)) & 0xFFFF
+                negative, zero = a & 0x80, not a & 0xFF
+                pos = next_pos
+                continue
+            elif mnemonic in ("CLC", "SEC", "CLV", "NOP", "SEI", "CLI", "CLD"):
+                if mnemonic == "CLC":
+                    carry = 0
+                elif mnemonic == "SEC":
+                    carry = 1
+                elif mnemonic == "CLV":
+                    overflow = 0
+                pos = next_pos
+                continue
+            elif mnemonic in ("REP", "SEP"):
+                if operand & 0x01:
+                    carry = 1 if mnemonic == "SEP" else 0
+                if operand & 0x08 and mnemonic == "SEP":
+                    raise ValueError(f"Decimal mode at 0x{pos:06X}")
+                p_flags = ((p_flags & ~operand) if mnemonic == "REP" else (p_flags | operand)) & (FLAG_M | FLAG_X)
+                if p_flags & FLAG_X:
+                    x, y = x & 0xFF, y & 0xFF
+                pos = next_pos
+                continue
+            elif mnemonic in ("PHA", "PHX", "PHY", "PHP"):
+                if mnemonic == "PHP":
+                    stack.append((p_flags, carry, negative, zero, overflow))
+                else:
+                    stack.append({"PHA": a, "PHX": x, "PHY": y}[mnemonic])
+                pos = next_pos
+                continue
+            elif mnemonic in ("PLA", "PLX", "PLY", "PLP"):
+                if not stack:
+                    raise ValueError(f"Stack underflow at 0x{pos:06X}")
+                value = stack.pop()
+                if mnemonic == "PLP":
+                    p_flags, carry, negative, zero, overflow = value
+                elif mnemonic == "PLA":
+                    a = value if m16 else (a & 0xFF00) | (value & 0xFF)
+                    negative, zero = (a & mask) & (0x8000 if m16 else 0x80), not a & mask
+                elif mnemonic == "PLX":
+                    x = value & index_mask
+                else:
+                    y = value & index_mask
+                pos = next_pos
+                continue
+            elif mode == "relative":
+                taken = {
+                    "BRA": True, "BEQ": zero, "BNE": not zero, "BCC": not carry, "BCS": carry,
+                    "BPL": not negative, "BMI": negative, "BVC": not overflow, "BVS": overflow,
+                }[mnemonic]
+                displacement = operand - 0x100 if operand >= 0x80 else operand
+                pos = next_pos + displacement if taken else next_pos
+                continue
+            else:
+                raise ValueError(f"Unsupported instruction {mnemonic} at 0x{pos:06X}")
+
+            negative, zero = result & (0x8000 if m16 else 0x80), not result
+            pos = next_pos
+
+        raise ValueError(f"Routine did not return within {self.max_steps} instructions")
+
+
+def routine_transfer(evaluator: RoutineEvaluator, state_addresses: Sequence[int],
+                     memory: Optional[Dict[int, int]] = None) -> Callable[[int], Tuple[int, int]]:
+    """state -> (next state, returned accumulator); state bytes live little-endian at state_addresses"""
+    keys = [RoutineEvaluator._key(address) for address in state_addresses]
+    base = {RoutineEvaluator._key(address): value for address, value in (memory or {}).items()}
+
+    def transfer(state: int) -> Tuple[int, int]:
+        mem = dict(base)
+        for index, address in enumerate(keys):
+            mem[address] = (state >> (8 * index)) & 0xFF
+        after, accumulator = evaluator.run(mem)
+        return sum(after.get(address, 0) << (8 * index) for index, address in enumerate(keys)), accumulator
+
+    return transfer
+
+
+# ---------------------------------------------------------------------- models
+
+
+def _lane_pack(values: Sequence[int], lane_bytes: int) -> int:
+    column = array("I" if lane_bytes == 4 else "Q", values)
+    if sys.byteorder != "little":
+        column.byteswap()
+    return int.from_bytes(column.tobytes(), "little")
+
+
+def _lane_unpack(packed: int, count: int, lane_bytes: int) -> array:
+    column = array("I" if lane_bytes == 4 else "Q")
+    column.frombytes(packed.to_bytes(count * lane_bytes, "little"))
+    if sys.byteorder != "little":
+        column.byteswap()
+    return column
+
+
+class RNGModel:
+    """State advance, jump-ahead and batch stepping of one RNG"""
+
+    kind = "abstract"
+
+    def __init__(self, bits: int, output_shift: Optional[int] = None, output_mask: int = 0xFF):
+        self.bits = bits
+        self.state_mask = (1 << bits) - 1
+        # Output as a slice of the new state, or None when the routine returns something else
+        self.output_shift = output_shift
+        self.output_mask = output_mask
+
+    def step(self, state: int) -> int:
+        return self.advance(state, 1)
+
+    def advance(self, state: int, steps: int) -> int:
+        raise NotImplementedError
+
+    def advance_many(self, states: Sequence[int], steps: int = 1) -> array:
+        return array("Q", (self.advance(state, steps) for state in states))
+
+    def output(self, state: int) -> int:
+        """Value the routine returns when it leaves state behind"""
+        if self.output_shift is None:
+            raise ValueError("Routine output is not a slice of its state")
+        return (state >> self.output_shift) & self.output_mask
+
+    def outputs_many(self, states: Sequence[int]) -> array:
+        shift, mask = self.output_shift, self.output_mask
+        if shift is None:
+            raise ValueError("Routine output is not a slice of its state")
+        return array("I", ((state >> shift) & mask for state in states))
+
+    def stream(self, state: int, count: int) -> Tuple[array, int]:
+        """The next count outputs from state, and the state after them"""
+        outputs = array("I")
+        for _ in range(count):
+            state = self.step(state)
+            outputs.append(self.output(state))
+        return outputs, state
+
+    def describe(self) -> Dict[str, object]:
+        return {"kind": self.kind, "bits": self.bits, "output_shift": self.output_shift, "output_mask": self.output_mask}
+
+
+class AffineRNG(RNGModel):
+    """state' = multiplier * state + increment (mod 2^bits)"""
+
+    kind = "affine"
+
+    def __init__(self, bits: int, multiplier: int, increment: int, output_shift: Optional[int] = None,
+                 output_mask: int = 0xFF):
+        super().__init__(bits, output_shift, output_mask)
+        self.multiplier = multiplier & self.state_mask
+        self.increment = increment & self.state_mask
+
+    def jump(self, steps: int) -> Tuple[int, int]:
+        """(multiplier, increment) of steps applications, by squaring"""
+        mask = self.state_mask
+        total_a, total_c = 1, 0
+        power_a, power_c = self.multiplier, self.increment
+        while steps:
+            if steps & 1:
+                total_a, total_c = (power_a * total_a) & mask, (power_a * total_c + power_c) & mask
+            power_a, power_c = (power_a * power_a) & mask, (power_a * power_c + power_c) & mask
+            steps >>= 1
+        return total_a, total_c
+
+    def advance(self, state: int, steps: int) -> int:
+        multiplier, increment = self.jump(steps)
+        return (multiplier * state + increment) & self.state_mask
+
+    def step(self, state: int) -> int:
+        return (self.multiplier * state + self.increment) & self.state_mask
+
+    def _lane_bytes(self) -> int:
+        # Twice the state width, so a lane's product never carries into the next lane
+        return 4 if self.bits <= 16 else 8
+
+    def advance_many(self, states: Sequence[int], steps: int = 1) -> array:
+        if self.bits > 32:
+            return super().advance_many(states, steps)
+        lane_bytes = self._lane_bytes()
+        count = len(states)
+        multiplier, increment = self.jump(steps)
+        lanes = _lane_pack(states, lane_bytes)
+        mask = _lane_pack([self.state_mask] * count, lane_bytes)
+        packed = ((lanes * multiplier) & mask) + _lane_pack([increment] * count, lane_bytes)
+        return _lane_unpack(packed & mask, count, lane_bytes)
+
+    def stream_many(self, states: Sequence[int], count: int) -> Tuple[List[array], array]:
+        """count output rows (one value per state each) and the final states, stepping all lanes per multiply"""
+        if self.output_shift is None:
+            raise ValueError("Routine output is not a slice of its state")
+        lane_bytes = self._lane_bytes()
+        lanes = len(states)
+        packed = _lane_pack(states, lane_bytes)
+        mask = _lane_pack([self.state_mask] * lanes, lane_bytes)
+        increment = _lane_pack([self.increment] * lanes, lane_bytes)
+        output_mask = _lane_pack([self.output_mask] * lanes, lane_bytes)
+        rows = []
+        for _ in range(count):
+            packed = (((packed * self.multiplier) & mask) + increment) & mask
+            rows.append(_lane_unpack((packed >> self.output_shift) & output_mask, lanes, lane_bytes))
+        return rows, _lane_unpack(packed, lanes, lane_bytes)
+
+    def describe(self) -> Dict[str, object]:
+        description = super().describe()
+        description.update(multiplier=self.multiplier, increment=self.increment)
+        return description
+
+
+class XorLinearRNG(RNGModel):
+    """state' = M * state ^ constant over GF(2); columns[j] is the image of state bit j"""
+
+    kind = "gf2"
+
+    def __init__(self, bits: int, columns: Sequence[int], constant: int, output_shift: Optional[int] = None,
+                 output_mask: int = 0xFF):
+        super().__init__(bits, output_shift, output_mask)
+        self.columns = list(columns)
+        self.constant = constant
+        self._jumps: Dict[int, Tuple[List[int], int]] = {}
+
+    @staticmethod
+    def _apply(columns: Sequence[int], state: int) -> int:
+        result = 0
+        bit = 0
+        while state:
+            if state & 1:
+                result ^= columns[bit]
+            state >>= 1
+            bit += 1
+        return result
+
+    def _compose(self, first: Tuple[List[int], int], second: Tuple[List[int], int]) -> Tuple[List[int], int]:
+        """first, then second"""
+        columns = [self._apply(second[0], column) for column in first[0]]
+        return columns, self._apply(second[0], first[1]) ^ second[1]
+
+    def jump(self, steps: int) -> Tuple[List[int], int]:
+        """(columns, constant) of steps applications, by squaring"""
+        if steps in self._jumps:
+            return self._jumps[steps]
+        total = ([1 << bit for bit in range(self.bits)], 0)
+        power = (self.columns, self.constant)
+        remaining = steps
+        while remaining:
+            if remaining & 1:
+                total = self._compose(total, power)
+            power = self._compose(power, power)
+            remaining >>= 1
+        self._jumps[steps] = total
+        return total
+
+    def step(self, state: int) -> int:
+        return self._apply(self.columns, state) ^ self.constant
+
+    def advance(self, state: int, steps: int) -> int:
+        columns, constant = self.jump(steps)
+        return self._apply(columns, state) ^ constant
+
+    def advance_many(self, states: Sequence[int], steps: int = 1) -> array:
+        """Byte-sliced: plane j holds bit j of every state, one byte per state"""
+        count = len(states)
+        columns, constant = self.jump(steps)
+        planes = [int.from_bytes(bytes((state >> bit) & 1 for state in states), "little") for bit in range(self.bits)]
+        ones = int.from_bytes(b"\x01" * count, "little")
+
+        result = array("Q", bytes(8 * count))
+        for out_bit in range(self.bits):
+            plane = ones if (constant >> out_bit) & 1 else 0
+            for in_bit, column in enumerate(columns):
+                if (column >> out_bit) & 1:
+                    plane ^= planes[in_bit]
+            for index, value in enumerate(plane.to_bytes(count, "little")):
+                if value:
+                    result[index] |= 1 << out_bit
+        return result
+
+    def describe(self) -> Dict[str, object]:
+        description = super().describe()
+        description.update(columns=[f"0x{column:X}" for column in self.columns], constant=self.constant)
+        return description
+
+
+class TableRNG(RNGModel):
+    """Any routine with a small state: full next-state and output tables"""
+
+    kind = "table"
+
+    def __init__(self, bits: int, transitions: array, outputs: array):
+        super().__init__(bits)
+        self.transitions = transitions
+        self.outputs = outputs
+        self._powers = [transitions]  # transitions applied 2^k times
+
+    def _power(self, exponent: int) -> array:
+        while len(self._powers) <= exponent:
+            last = self._powers[-1]
+            self._powers.append(array(last.typecode, map(last.__getitem__, last)))
+        return self._powers[exponent]
+
+    def step(self, state: int) -> int:
+        return self.transitions[state]
+
+    def advance(self, state: int, steps: int) -> int:
+        exponent = 0
+        while steps:
+            if steps & 1:
+                state = self._power(exponent)[state]
+            steps >>= 1
+            exponent += 1
+        return state
+
+    def advance_many(self, states: Sequence[int], steps: int = 1) -> array:
+        current = array("Q", states)
+        exponent = 0
+        while steps:
+            if steps & 1:
+                current = array("Q", map(self._power(exponent).__getitem__, current))
+            steps >>= 1
+            exponent += 1
+        return current
+
+    def output(self, state: int) -> int:
+        raise ValueError("Table outputs belong to the transition, use draw()")
+
+    def draw(self, state: int) -> Tuple[int, int]:
+        """(next state, returned value)"""
+        return self.transitions[state], self.outputs[state]
+
+    def stream(self, state: int, count: int) -> Tuple[array, int]:
+        values = array("I")
+        for _ in range(count):
+            values.append(self.outputs[state])
+            state = self.transitions[state]
+        return values, state
+
+    def outputs_many(self, states: Sequence[int]) -> array:
+        """Values returned by the draw from each state (not after it, unlike the sliced models)"""
+        return array("I", map(self.outputs.__getitem__, states))
+
+
+# ---------------------------------------------------------------------- identification
+
+
+def _find_output_slice(transfer_results: List[Tuple[int, int, int]], bits: int) -> Tuple[Optional[int], int]:
+    """(shift, mask) such that the returned value is that slice of the new state, if any"""
+    for mask in (0xFF, 0xFFFF):
+        for shift in range(0, max(1, bits - 7)):
+            if all(((new_state >> shift) & mask) == (value & mask) and value <= mask
+                   for _, new_state, value in transfer_results):
+                return shift, mask
+    return None, 0xFF
+
+
+def identify_rng(transfer: Callable[[int], Tuple[int, int]], bits: int, probes: int = PROBES, seed: int = 0) -> RNGModel:
+    """Fit the routine's transfer with the simplest exact model; ValueError if none fits"""
+    mask = (1 << bits) - 1
+    rng = random.Random(seed)
+    states = [0, 1, mask, 1 << (bits - 1)] + [rng.getrandbits(bits) for _ in range(probes)]
+    results = [(state,) + transfer(state) for state in states]
+    base = results[0][1]
+    shift, output_mask = _find_output_slice(results, bits)
+
+    multiplier = (results[1][1] - base) & mask
+    if all(new_state == (multiplier * state + base) & mask for state, new_state, _ in results):
+        return AffineRNG(bits, multiplier, base, shift, output_mask)
+
+    columns = [transfer(1 << bit)[0] ^ base for bit in range(bits)]
+    if all(new_state == XorLinearRNG._apply(columns, state) ^ base for state, new_state, _ in results):
+        return XorLinearRNG(bits, columns, base, shift, output_mask)
+
+    if bits > MAX_TABLE_BITS:
+        raise ValueError(f"Routine is not affine or GF(2)-linear and its {bits}-bit state is too wide to tabulate")
+    typecode = "H" if bits <= 16 else "I"
+    transitions, outputs = array(typecode), array("I")
+    for state in range(1 << bits):
+        new_state, value = transfer(state)
+        transitions.append(new_state)
+        outputs.append(value)
+    return TableRNG(bits, transitions, outputs)
+
+
+def model_from_rom(rom_data: bytes, offset: int, state_addresses: Sequence[int], p_flags: int = FLAG_M | FLAG_X,
+                   memory: Optional[Dict[int, int]] = None, data_bank: int = 0x00) -> RNGModel:
+    """Model of the routine at ROM offset whose state is the bytes at state_addresses (low byte first)"""
+    evaluator = RoutineEvaluator(bytes(rom_data), offset, p_flags, data_bank=data_bank)
+    return identify_rng(routine_transfer(evaluator, state_addresses, memory), 8 * len(state_addresses))
+
+
+def find_seeds(model: RNGModel, seeds: Sequence[int], steps: int, wanted: int, mask: int = 0xFFFFFFFF) -> List[int]:
+    """Seeds whose output steps draws later (the steps-th draw) equals wanted under mask"""
+    if isinstance(model, TableRNG):
+        before = model.advance_many(seeds, steps - 1)
+        values = model.outputs_many(before)
+    else:
+        values = model.outputs_many(model.advance_many(seeds, steps))
+    return [seed for seed, value in zip(seeds, values) if value & mask == wanted & mask]
+
+
+if __name__ == "__main__":
+    import argparse
+    import json
+    import time
+
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Fit an exact model to a 65816 RNG routine")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("offset", type=lambda v: int(v, 0), help="ROM offset of the RNG routine")
+    parser.add_argument("--state", required=True, help="Comma-separated WRAM addresses of the state, low byte first")
+    parser.add_argument("--m16", action="store_true", help="Routine entered with a 16-bit accumulator")
+    parser.add_argument("--x16", action="store_true", help="Routine entered with 16-bit index registers")
+    parser.add_argument("--data-bank", type=lambda v: int(v, 0), default=0x00, help="Data bank for absolute operands")
+    parser.add_argument("--seed", type=lambda v: int(v, 0), default=0, help="State to draw from")
+    parser.add_argument("--draws", type=int, default=16, help="Draws to print")
+    parser.add_argument("--jump", type=lambda v: int(v, 0), help="Also print the state this many steps ahead")
+    parser.add_argument("--benchmark", type=int, default=0, help="Advance this many seeds in one batch and time it")
+    args = parser.parse_args()
+
+    p_flags = (0 if args.m16 else FLAG_M) | (0 if args.x16 else FLAG_X)
+    addresses = [int(address, 0) for address in args.state.split(",")]
+    try:
+        model = model_from_rom(open_rom_image(args.rom_file).data, args.offset, addresses, p_flags,
+                               data_bank=args.data_bank)
+    except ValueError as e:
+        print(f"❌ Error: {e}")
+        sys.exit(1)
+
+    print(f"🎲 {model.kind} model, {model.bits}-bit state")
+    print(json.dumps(model.describe(), indent=2))
+    try:
+        values, state = model.stream(args.seed, args.draws)
+        print(f"   Draws from 0x{args.seed:X}: {' '.join(f'{value:02X}' for value in values)}")
+    except ValueError as e:
+        # No output slice to show, so show the states the draws leave behind
+        states, state = [], args.seed
+        for _ in range(args.draws):
+            state = model.step(state)
+            states.append(state)
+        print(f"   {e}; states from 0x{args.seed:X}: {' '.join(f'{value:X}' for value in states)}")
+    if args.jump is not None:
+        print(f"   State after {args.jump:,} steps: 0x{model.advance(args.seed, args.jump):X}")
+    if args.benchmark:
+        seeds = list(range(args.benchmark))
+        start_time = time.time()
+        model.advance_many(seeds, 1)
+        elapsed = time.time() - start_time
+        print(f"⚡ Stepped {len(seeds):,} seeds in {elapsed * 1000:.1f}ms ({len(seeds) / max(elapsed, 1e-9):,.0f} states/s)")
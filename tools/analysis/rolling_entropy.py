@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Rolling Entropy Kernel
+=========================================
+
+Shannon entropy over a window sliding across the ROM. A 256-bin histogram
+and the running sum of c*log2(c) are updated incrementally as bytes leave
+and enter the window, so each step costs only the bins it touches instead of
+a fresh frequency count.
+"""
+
+import math
+from array import array
+from collections import Counter
+from functools import lru_cache
+from typing import List, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+# Resynchronize the running sum from the histogram this often to bound float drift
+RESYNC_INTERVAL = 4096
+
+# Strides above window/8 touch so many bins per step that counting each window afresh
+# (Counter runs in C) beats updating bins one by one
+ROLLING_STRIDE_RATIO = 8
+
+
+@lru_cache(maxsize=16)
+def _count_log_table(size: int) -> List[float]:
+    """c*log2(c) for every count 0..size"""
+    return [0.0] + [count * math.log2(count) for count in range(1, size + 1)]
+
+
+def shannon_entropy(data: Buffer) -> float:
+    """Entropy of data in bits per byte (0.0 for empty input)"""
+    size = len(data)
+    if not size:
+        return 0.0
+    count_log = _count_log_table(size).__getitem__ if size <= 0x10000 else lambda count: count * math.log2(count)
+    return max(0.0, math.log2(size) - sum(map(count_log, Counter(bytes(data)).values())) / size)
+
+
+def prefers_rolling(window_size: int, stride: int) -> bool:
+    """Whether sliding the histogram is cheaper than recounting each window"""
+    return stride * ROLLING_STRIDE_RATIO <= window_size
+
+
+class RollingEntropy:
+    """
+    Histogram of a fixed-size window with O(1) entropy updates per byte moved
+    entropy = log2(n) - sum(c*log2(c)) / n, with the sum kept current as bins change.
+    """
+
+    def __init__(self, window_size: int):
+        if window_size <= 0:
+            raise ValueError(f"Invalid window size: {window_size}")
+
+        self.window_size = window_size
+        self.histogram = [0] * 256
+        self._count_log = _count_log_table(window_size)
+        self._log_size = math.log2(window_size)
+        self._sum = 0.0
+        self._steps = 0
+
+    def reset(self, window: Buffer) -> float:
+        """Start over from a full window"""
+        if len(window) != self.window_size:
+            raise ValueError(f"Window is {len(window)} bytes, expected {self.window_size}")
+
+        self.histogram = [0] * 256
+        for value, count in Counter(bytes(window)).items():
+            self.histogram[value] = count
+        self._resync()
+        return self.entropy
+
+    def slide(self, leaving: Buffer, entering: Buffer) -> float:
+        """Drop leaving from the front of the window and append entering (same length)"""
+        if len(leaving) != len(entering):
+            raise ValueError("Window must slide by equal leaving and entering lengths")
+
+        if len(entering) == 1:
+            self._move(leaving[0], entering[0])
+        else:
+            delta = Counter(bytes(entering))
+            delta.subtract(Counter(bytes(leaving)))
+            histogram = self.histogram
+            count_log = self._count_log
+            for value, change in delta.items():
+                if change:
+                    old = histogram[value]
+                    histogram[value] = old + change
+                    self._sum += count_log[old + change] - count_log[old]
+
+        self._steps += 1
+        if self._steps % RESYNC_INTERVAL == 0:
+            self._resync()
+        return self.entropy
+
+    def _move(self, leaving: int, entering: int):
+        """Single-byte slide: two bin updates"""
+        if leaving == entering:
+            return
+        histogram = self.histogram
+        count_log = self._count_log
+        old = histogram[leaving]
+        histogram[leaving] = old - 1
+        self._sum += count_log[old - 1] - count_log[old]
+        old = histogram[entering]
+        histogram[entering] = old + 1
+        self._sum += count_log[old + 1] - count_log[old]
+
+    def _resync(self):
+        count_log = self._count_log
+        self._sum = sum(count_log[count] for count in self.histogram if count)
+
+    @property
+    def entropy(self) -> float:
+        return max(0.0, self._log_size - self._sum / self.window_size)
+
+
+def entropy_profile(data: Buffer, window_size: int = 256, stride: int = 1) -> array:
+    """
+    Entropy of every window data[i:i + window_size] for i = 0, stride, 2*stride, ...
+    (float32, one value per window). Small strides slide one shared histogram; large
+    strides count each window directly.
+    """
+    if stride <= 0:
+        raise ValueError(f"Invalid stride: {stride}")
+
+    data = bytes(data)
+    profile = array("f")
+    last_start = len(data) - window_size
+    if last_start < 0:
+        return profile
+
+    if not prefers_rolling(window_size, stride):
+        for start in range(0, last_start + 1, stride):
+            profile.append(shannon_entropy(data[start : start + window_size]))
+        return profile
+
+    rolling = RollingEntropy(window_size)
+    profile.append(rolling.reset(data[:window_size]))
+
+    if stride == 1:
+        # Per-offset: two bin updates per byte
+        move = rolling._move
+        count = 0
+        for leaving, entering in zip(data, data[window_size:]):
+            move(leaving, entering)
+            profile.append(rolling.entropy)
+            count += 1
+            if count % RESYNC_INTERVAL == 0:
+                rolling._resync()
+        return profile
+
+    for start in range(stride, last_start + 1, stride):
+        end = start + window_size
+        profile.append(rolling.slide(data[start - stride : start], data[end - stride : end]))
+    return profile
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+    from pathlib import Path
+
+    parser = argparse.ArgumentParser(description="Sliding-window entropy profile of a file")
+    parser.add_argument("input_file", help="File to profile")
+    parser.add_argument("--window", type=int, default=256, help="Window size in bytes")
+    parser.add_argument("--stride", type=int, default=64, help="Window stride in bytes")
+    args = parser.parse_args()
+
+    data = Path(args.input_file).read_bytes()
+
+    start_time = time.time()
+    profile = entropy_profile(data, args.window, args.stride)
+    elapsed = time.time() - start_time
+
+    print(f"📊 {len(profile):,} windows in {elapsed:.2f}s")
+    if profile:
+        print(f"   Min: {min(profile):.3f}  Max: {max(profile):.3f}  Mean: {sum(profile) / len(profile):.3f}")
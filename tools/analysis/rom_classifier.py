@@ -0,0 +1,416 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Single-Pass ROM Classifier
+=============================================
+
+Scores every window of the ROM for entropy, 65816 code density, tile
+patterns, BRR headers, text bytes and pointer density in one streaming
+pass, and classifies each stride block into a per-byte region map that the
+coverage analyzers, asset extractor and disassemblers all read instead of
+sweeping the ROM with their own heuristics.
+"""
+
+import hashlib
+import os
+import re
+import struct
+import time
+from array import array
+from collections import Counter
+from pathlib import Path
+from typing import BinaryIO, Dict, List, Optional, Tuple, Union
+
+from rolling_entropy import RollingEntropy, prefers_rolling, shannon_entropy
+import stage_trace
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+CLASSIFIER_VERSION = 2
+
+DEFAULT_WINDOW = 256
+DEFAULT_STRIDE = 64
+
+# Region type codes stored in the region map
+REGION_UNKNOWN = 0
+REGION_FILL = 1
+REGION_CODE = 2
+REGION_GRAPHICS = 3
+REGION_AUDIO = 4
+REGION_TEXT = 5
+REGION_POINTERS = 6
+REGION_COMPRESSED = 7
+
+REGION_NAMES = ("unknown", "fill", "code", "graphics", "audio", "text", "pointers", "compressed")
+
+SCORE_COLUMNS = ("entropy", "code", "tile", "brr", "text", "pointer")
+
+# Classification thresholds (scores are fractions of the window unless noted)
+FILL_ENTROPY = 1.0  # bits per byte
+COMPRESSED_ENTROPY = 6.9  # uniform random bytes score about 7.2 in a 256-byte window
+TEXT_THRESHOLD = 0.85
+CODE_THRESHOLD = 0.22
+POINTER_THRESHOLD = 0.6
+TILE_THRESHOLD = 0.35
+BRR_THRESHOLD = 0.95
+BRR_MIN_ENTROPY = 5.0
+
+# Opcodes that dominate real 65816 code: LDA/LDX/LDY/CMP/AND/ORA/EOR/ADC/SBC immediate,
+# absolute loads/stores, STZ, JSR/JSL/JMP, RTS/RTL, branches, REP/SEP, CLC/SEC, shifts.
+# Random data hits them about 11% of the time.
+CODE_SIGNATURE_OPCODES = frozenset(
+    [
+        0xA9, 0xA2, 0xA0, 0xC9, 0xE0, 0xC0, 0x29, 0x09, 0x49, 0x69, 0xE9,
+        0xAD, 0x8D, 0x8E, 0x8C, 0x9C, 0x64, 0x85, 0xA5,
+        0x20, 0x22, 0x4C, 0x60, 0x6B,
+        0xF0, 0xD0, 0x90, 0xB0, 0x80,
+        0xC2, 0xE2, 0x18, 0x38, 0x0A, 0x4A,
+    ]
+)
+
+# Printable ASCII, line breaks, terminators and half-width katakana
+TEXT_BYTES = frozenset(list(range(0x20, 0x7F)) + [0x00, 0x0A, 0x0D] + list(range(0xA1, 0xE0)))
+
+
+def _flag_table(predicate) -> bytes:
+    """translate() table mapping bytes that satisfy predicate to 1, others to 0"""
+    return bytes(1 if predicate(value) else 0 for value in range(256))
+
+
+CODE_TABLE = _flag_table(CODE_SIGNATURE_OPCODES.__contains__)
+TEXT_TABLE = _flag_table(TEXT_BYTES.__contains__)
+# BRR header: shift 0-12, end flag clear (only a sample's last block sets it)
+BRR_TABLE = _flag_table(lambda header: (header >> 4) <= 12 and not header & 0x01)
+# High byte of a 16-bit ROM pointer, bucketed to 2KB pages; non-ROM values map to 0
+POINTER_PAGE_TABLE = bytes(value >> 3 if value >= 0x80 else 0 for value in range(256))
+# Bank byte of a 24-bit pointer into the ROM banks ($80-$FF); others map to 0
+POINTER_BANK_TABLE = bytes(value if value >= 0x80 else 0 for value in range(256))
+
+
+class ROMClassification:
+    """
+    Per-window score columns plus the per-byte region map
+    Window i starts at i * stride and spans window_size bytes; its class is written to
+    the stride block it starts.
+    """
+
+    def __init__(
+        self,
+        rom_size: int,
+        window_size: int,
+        stride: int,
+        columns: Dict[str, array],
+        window_classes: bytearray,
+    ):
+        self.rom_size = rom_size
+        self.window_size = window_size
+        self.stride = stride
+        self.columns = columns
+        self.window_classes = window_classes
+        self.region_map = self._expand_region_map()
+
+    def _expand_region_map(self) -> bytearray:
+        """Per-byte region map from the per-window classes"""
+        region_map = bytearray(self.rom_size)
+        for index, region_type in enumerate(self.window_classes):
+            if region_type:
+                start = index * self.stride
+                region_map[start : start + self.stride] = bytes([region_type]) * self.stride
+        # The last window's class also covers the tail it spans
+        if self.window_classes:
+            last_start = (len(self.window_classes) - 1) * self.stride
+            tail = self.rom_size - last_start
+            region_map[last_start:] = bytes([self.window_classes[-1]]) * tail
+        del region_map[self.rom_size :]
+        return region_map
+
+    @property
+    def window_count(self) -> int:
+        return len(self.window_classes)
+
+    def window_index(self, offset: int) -> int:
+        """Window whose stride block contains offset"""
+        return min(offset // self.stride, self.window_count - 1)
+
+    def window_offsets(self) -> range:
+        return range(0, self.window_count * self.stride, self.stride)
+
+    def scores_at(self, offset: int) -> Dict[str, float]:
+        """All scores of the window covering offset"""
+        index = self.window_index(offset)
+        return {name: self.columns[name][index] for name in SCORE_COLUMNS}
+
+    def region_at(self, offset: int) -> str:
+        return REGION_NAMES[self.region_map[offset]]
+
+    def entropy_map(self) -> Dict[int, float]:
+        """Window offset -> entropy, the shape the coverage analyzers keep"""
+        return dict(zip(self.window_offsets(), self.columns["entropy"]))
+
+    def regions(self, region_type: Optional[int] = None, min_size: int = 0) -> List[Tuple[int, int, int]]:
+        """Runs of the region map as (start, end, type), optionally filtered by type and size"""
+        if region_type is not None:
+            pattern = re.compile(re.escape(bytes([region_type])) + b"+")
+        else:
+            pattern = re.compile(rb"(.)\1*", re.DOTALL)
+        runs = []
+        for match in pattern.finditer(self.region_map):
+            if match.end() - match.start() >= min_size:
+                runs.append((match.start(), match.end(), self.region_map[match.start()]))
+        return runs
+
+    def summarize(self, start: int, end: int) -> Dict[str, object]:
+        """Mean scores and dominant region type over [start, end)"""
+        end = min(end, self.rom_size)
+        if start >= end or not self.window_count:
+            return {"type": "unknown", "size": 0}
+
+        first = self.window_index(start)
+        last = self.window_index(end - 1) + 1
+        summary: Dict[str, object] = {
+            name: sum(self.columns[name][first:last]) / (last - first) for name in SCORE_COLUMNS
+        }
+        counts = Counter(self.region_map[start:end])
+        dominant, count = counts.most_common(1)[0]
+        summary["type"] = REGION_NAMES[dominant]
+        summary["type_fraction"] = count / (end - start)
+        summary["size"] = end - start
+        return summary
+
+    def byte_counts(self) -> Dict[str, int]:
+        """Bytes per region type"""
+        counts = Counter(self.region_map)
+        return {REGION_NAMES[code]: counts.get(code, 0) for code in range(len(REGION_NAMES))}
+
+    # Binary cache format: header, one float32 column per score, then window classes
+    _HEADER = struct.Struct("<4sIIIII")
+    _MAGIC = b"DQ3C"
+
+    def save(self, path: Path):
+        """Write atomically so concurrent tools never read a partial file"""
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        temp_path = path.with_suffix(f".{os.getpid()}.tmp")
+        with open(temp_path, "wb") as f:
+            f.write(
+                self._HEADER.pack(
+                    self._MAGIC, CLASSIFIER_VERSION, self.rom_size, self.window_size, self.stride, self.window_count
+                )
+            )
+            for name in SCORE_COLUMNS:
+                f.write(self.columns[name].tobytes())
+            f.write(self.window_classes)
+        os.replace(temp_path, path)
+
+    @classmethod
+    def load(cls, path: Path) -> Optional["ROMClassification"]:
+        """Read a saved classification; None if missing, stale or truncated"""
+        try:
+            data = Path(path).read_bytes()
+            magic, version, rom_size, window_size, stride, count = cls._HEADER.unpack_from(data)
+        except (OSError, struct.error):
+            return None
+        if magic != cls._MAGIC or version != CLASSIFIER_VERSION:
+            return None
+
+        offset = cls._HEADER.size
+        columns = {}
+        for name in SCORE_COLUMNS:
+            column = array("f")
+            column.frombytes(data[offset : offset + count * column.itemsize])
+            if len(column) != count:
+                return None
+            columns[name] = column
+            offset += count * column.itemsize
+        window_classes = bytearray(data[offset : offset + count])
+        if len(window_classes) != count:
+            return None
+        return cls(rom_size, window_size, stride, columns, window_classes)
+
+
+class ROMClassifier:
+    """
+    Streaming classifier: feed() ROM bytes in any chunk size, then finish()
+    Each window is scored once for every metric; nothing rescans the ROM.
+    """
+
+    def __init__(self, window_size: int = DEFAULT_WINDOW, stride: int = DEFAULT_STRIDE):
+        if window_size < 32 or stride <= 0 or stride > window_size:
+            raise ValueError(f"Invalid window/stride: {window_size}/{stride}")
+
+        self.window_size = window_size
+        self.stride = stride
+        self.columns = {name: array("f") for name in SCORE_COLUMNS}
+        self.window_classes = bytearray()
+        self._pending = bytearray()
+        self._fed = 0
+        self._entropy = RollingEntropy(window_size) if prefers_rolling(window_size, stride) else None
+
+    def feed(self, chunk: Buffer):
+        """Score every complete window now available"""
+        self._pending += chunk
+        self._fed += len(chunk)
+        window_size = self.window_size
+        stride = self.stride
+
+        # Once a window has been scored, _pending starts at that window so the bytes
+        # leaving the rolling histogram are still at hand
+        offset = stride if self.window_classes else 0
+        while offset + window_size <= len(self._pending):
+            window = bytes(self._pending[offset : offset + window_size])
+            if self._entropy is None:
+                entropy = shannon_entropy(window)
+            elif self.window_classes:
+                entropy = self._entropy.slide(self._pending[offset - stride : offset], window[-stride:])
+            else:
+                entropy = self._entropy.reset(window)
+            self._score_window(window, entropy)
+            offset += stride
+
+        if self.window_classes:
+            del self._pending[: offset - stride]
+
+    def finish(self) -> ROMClassification:
+        """Build the region map; input shorter than one window is scored as a single window"""
+        if not self.window_classes and len(self._pending) >= 32:
+            self._score_window(bytes(self._pending), shannon_entropy(self._pending))
+        return ROMClassification(self._fed, self.window_size, self.stride, self.columns, self.window_classes)
+
+    def _score_window(self, window: bytes, entropy: float):
+        size = len(window)
+
+        code = window.translate(CODE_TABLE).count(1) / size
+        text = window.translate(TEXT_TABLE).count(1) / size
+
+        # Planar tiles repeat plane bytes on adjacent rows: bytes two apart match
+        row_match = (int.from_bytes(window[:-2], "little") ^ int.from_bytes(window[2:], "little")).to_bytes(
+            size - 2, "little"
+        ).count(0)
+        tile = row_match / (size - 2)
+
+        # Best BRR block phase: headers every 9 bytes with a legal shift and no end flag
+        brr_flags = window.translate(BRR_TABLE)
+        brr = max(brr_flags[phase::9].count(1) / len(brr_flags[phase::9]) for phase in range(min(9, size)))
+
+        # Pointer tables: consecutive 16-bit entries in the same ROM page, or 24-bit entries
+        # in the same bank
+        pointer = 0.0
+        for step, table in ((2, POINTER_PAGE_TABLE), (3, POINTER_BANK_TABLE)):
+            for phase in range(step):
+                pointer = max(pointer, _same_neighbor_fraction(window[phase + step - 1 :: step].translate(table)))
+
+        scores = (entropy, code, tile, brr, text, pointer)
+        for name, value in zip(SCORE_COLUMNS, scores):
+            self.columns[name].append(value)
+        self.window_classes.append(classify_scores(*scores))
+
+
+def _same_neighbor_fraction(values: bytes) -> float:
+    """Fraction of adjacent pairs with equal nonzero values"""
+    pairs = len(values) - 1
+    if pairs <= 0:
+        return 0.0
+    first = int.from_bytes(values[:-1], "little")
+    second = int.from_bytes(values[1:], "little")
+    same = (first ^ second).to_bytes(pairs, "little").count(0)
+    both_zero = (first | second).to_bytes(pairs, "little").count(0)
+    return (same - both_zero) / pairs
+
+
+def classify_scores(entropy: float, code: float, tile: float, brr: float, text: float, pointer: float) -> int:
+    """Region type for one window's scores (first matching rule wins)"""
+    if entropy < FILL_ENTROPY:
+        return REGION_FILL
+    if text >= TEXT_THRESHOLD:
+        return REGION_TEXT
+    if pointer >= POINTER_THRESHOLD:
+        return REGION_POINTERS
+    if brr >= BRR_THRESHOLD and entropy >= BRR_MIN_ENTROPY:
+        return REGION_AUDIO
+    if entropy > COMPRESSED_ENTROPY:
+        return REGION_COMPRESSED
+    if code >= CODE_THRESHOLD:
+        return REGION_CODE
+    if tile >= TILE_THRESHOLD:
+        return REGION_GRAPHICS
+    return REGION_UNKNOWN
+
+
+def classify_stream(stream: BinaryIO, window_size: int = DEFAULT_WINDOW, stride: int = DEFAULT_STRIDE,
+                    chunk_size: int = 0x10000) -> ROMClassification:
+    """Classify a file object without holding more than one chunk plus a window"""
+    classifier = ROMClassifier(window_size, stride)
+    while True:
+        chunk = stream.read(chunk_size)
+        if not chunk:
+            break
+        classifier.feed(chunk)
+    return classifier.finish()
+
+
+def classify_rom(
+    rom_data: Buffer,
+    window_size: int = DEFAULT_WINDOW,
+    stride: int = DEFAULT_STRIDE,
+    use_cache: bool = True,
+    cache_dir: Optional[Union[str, Path]] = None,
+) -> ROMClassification:
+    """
+    Classification of rom_data, shared through a content-addressed cache so every tool in
+    the pipeline reuses the first tool's pass over the same ROM
+    """
+    cache_path = None
+    if use_cache:
+        cache_dir = Path(cache_dir) if cache_dir else Path(__file__).parent.parent.parent / "cache" / "classifier"
+        key = hashlib.blake2b(digest_size=16)
+        key.update(struct.pack("<III", CLASSIFIER_VERSION, window_size, stride))
+        key.update(rom_data)
+        cache_path = cache_dir / f"{key.hexdigest()}.bin"
+        cached = ROMClassification.load(cache_path)
+        if cached is not None and cached.rom_size == len(rom_data):
+            stage_trace.count("classifier.cache_hits")
+            return cached
+
+    stage_trace.count("classifier.bytes_scanned", len(rom_data))
+    classifier = ROMClassifier(window_size, stride)
+    classifier.feed(rom_data)
+    classification = classifier.finish()
+
+    if cache_path is not None:
+        try:
+            classification.save(cache_path)
+        except OSError:
+            pass  # Read-only checkouts still classify, just without sharing
+
+    return classification
+
+
+def main():
+    """Command-line interface"""
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Single-pass ROM region classifier")
+    parser.add_argument("rom_file", help="ROM file to classify")
+    parser.add_argument("--window", type=int, default=DEFAULT_WINDOW, help="Window size in bytes")
+    parser.add_argument("--stride", type=int, default=DEFAULT_STRIDE, help="Window stride in bytes")
+    parser.add_argument("--no-cache", action="store_true", help="Always reclassify")
+    parser.add_argument("--regions", action="store_true", help="List every region run")
+    args = parser.parse_args()
+
+    rom_data = Path(args.rom_file).read_bytes()
+
+    start_time = time.time()
+    classification = classify_rom(rom_data, args.window, args.stride, use_cache=not args.no_cache)
+    elapsed = time.time() - start_time
+
+    print(f"📊 Classified {len(rom_data):,} bytes ({classification.window_count:,} windows) in {elapsed:.2f}s")
+    for name, count in classification.byte_counts().items():
+        if count:
+            print(f"   {name:<11} {count:>9,} bytes ({count / len(rom_data) * 100:5.1f}%)")
+
+    if args.regions:
+        for start, end, region_type in classification.regions(min_size=args.stride):
+            print(f"   ${start:06X}-${end - 1:06X} {REGION_NAMES[region_type]}")
+
+
+if __name__ == "__main__":
+    main()
@@ -13,6 +13,8 @@ from pathlib import Path
 from typing import Dict, List, Tuple, Any
 from dataclasses import dataclass
 
+from rom_image import open_rom_image
+
 
 @dataclass
 class SNESHeader:
@@ -47,8 +49,8 @@ class DQ3ROMHeaderAnalyzer:
     def __init__(self, rom_path: str):
         self.rom_path = Path(rom_path)
 
-        with open(self.rom_path, "rb") as f:
-            self.rom_data = f.read()
+        self.rom = open_rom_image(self.rom_path)
+        self.rom_data = self.rom.data
 
         self.rom_size = len(self.rom_data)
         self.header = None
@@ -189,22 +191,8 @@ class DQ3ROMHeaderAnalyzer:
         return analysis
 
     def _snes_to_rom_address(self, snes_addr: int) -> int:
-        """Convert SNES address to ROM file offset"""
-        # For LoROM mapping
-        bank = (snes_addr >> 16) & 0xFF
-        offset = snes_addr & 0xFFFF
-
-        if bank < 0x80:
-            # Banks 00-7F: direct mapping for ROM areas
-            if offset >= 0x8000:
-                return (bank * 0x8000) + (offset - 0x8000)
-        else:
-            # Banks 80-FF: mirror of 00-7F
-            bank = bank - 0x80
-            if offset >= 0x8000:
-                return (bank * 0x8000) + (offset - 0x8000)
-
-        return 0  # Invalid address
+        """Convert SNES address to ROM file offset (0 when it maps no ROM)"""
+        return self.rom.to_offset(snes_addr) or 0
 
     def _analyze_interrupt_handler(self, vector_name: str, handler_code: bytes) -> str:
         """Analyze interrupt handler code to determine purpose"""
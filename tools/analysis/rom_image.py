@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Shared ROM Image
+===================================
+
+One read-only memory map of the ROM file per process, shared by every
+analyzer that opens the same path. Views by file offset or SNES address
+are memoryview slices of the map (no copies), the copier header is
+skipped once, and the LoROM/HiROM/ExHiROM mapping is resolved once into
+the shared bank tables (see address_map). Images pickle as their path, so worker processes
+map the same file (and share the OS page cache) instead of receiving a
+copy of the data.
+"""
+
+import mmap
+import os
+from pathlib import Path
+from typing import Dict, Optional, Union
+
+from address_map import EXHIROM, HIROM, LOROM, AddressMap, address_map_for
+
+COPIER_HEADER_SIZE = 0x200
+
+# Internal header location and expected map mode (low nibble) for each mapping
+HEADER_LOCATIONS = {LOROM: (0x7FC0, 0x00), HIROM: (0xFFC0, 0x01), EXHIROM: (0x40FFC0, 0x05)}
+
+# Images opened in this process, by resolved path
+_open_images: Dict[str, "ROMImage"] = {}
+
+
+def _score_header(data: memoryview, location: int, map_mode: int) -> int:
+    """How much the 64 bytes at location look like the internal header of this mapping"""
+    if len(data) < location + 0x40:
+        return 0
+
+    header = data[location : location + 0x40]
+    score = 0
+
+    checksum = header[0x1E] | (header[0x1F] << 8)
+    complement = header[0x1C] | (header[0x1D] << 8)
+    if checksum ^ complement == 0xFFFF:
+        score += 4
+
+    # Map mode $2x with the FastROM bit (4) ignored
+    if (header[0x15] & 0xEF) == (0x20 | map_mode):
+        score += 2
+
+    if sum(1 for value in header[:21] if 0x20 <= value <= 0x7E) >= 18:
+        score += 1
+
+    reset_vector = header[0x3C] | (header[0x3D] << 8)
+    if reset_vector >= 0x8000:
+        score += 1
+
+    return score
+
+
+def detect_mapping(data: memoryview) -> str:
+    """The mapping whose internal header scores highest (LoROM, then HiROM, on a tie)"""
+    scores = {mapping: _score_header(data, *location) for mapping, location in HEADER_LOCATIONS.items()}
+    return max(scores, key=scores.get)
+
+
+class ROMImage:
+    """
+    Memory-mapped ROM with the copier header skipped
+    data is a memoryview over the whole image; slice it (or use view/snes_view) for
+    zero-copy windows.
+    """
+
+    def __init__(self, path: Union[str, Path]):
+        self.path = Path(path).resolve()
+        if not self.path.exists():
+            raise FileNotFoundError(f"ROM file not found: {path}")
+
+        self._file = open(self.path, "rb")
+        file_size = os.fstat(self._file.fileno()).st_size
+        if file_size:
+            self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+            raw = memoryview(self._map)
+        else:
+            self._map = None  # mmap cannot map empty files
+            raw = memoryview(b"")
+
+        self.header_size = COPIER_HEADER_SIZE if file_size % 1024 == COPIER_HEADER_SIZE else 0
+        self.data = raw[self.header_size :]
+        self.size = len(self.data)
+
+        self.mapping = detect_mapping(self.data)
+        self.address_map: AddressMap = address_map_for(self.mapping, self.size)
+
+    def __len__(self) -> int:
+        return self.size
+
+    def __getitem__(self, key):
+        return self.data[key]
+
+    def __reduce__(self):
+        # Workers re-map the file by path rather than unpickling the bytes
+        return open_rom_image, (str(self.path),)
+
+    def view(self, offset: int, size: int) -> memoryview:
+        """Zero-copy window of up to size bytes at a file offset (header excluded)"""
+        offset = max(0, offset)
+        return self.data[offset : offset + size]
+
+    def to_offset(self, address: int) -> Optional[int]:
+        """ROM offset of a 24-bit SNES address, or None when it maps no ROM"""
+        return self.address_map.to_offset(address)
+
+    def to_snes(self, offset: int) -> int:
+        """Canonical 24-bit SNES address of a ROM offset"""
+        return self.address_map.to_snes(offset)
+
+    def snes_view(self, address: int, size: int) -> Optional[memoryview]:
+        """Zero-copy window at a SNES address, or None when it maps no ROM"""
+        offset = self.to_offset(address)
+        if offset is None:
+            return None
+        return self.data[offset : offset + size]
+
+    def tobytes(self) -> bytes:
+        """Independent copy of the image (for callers that must mutate or outlive it)"""
+        return self.data.tobytes()
+
+
+def open_rom_image(path: Union[str, Path]) -> ROMImage:
+    """The process-wide image for path, mapping the file on first use"""
+    key = str(Path(path).resolve())
+    image = _open_images.get(key)
+    if image is None:
+        image = ROMImage(key)
+        _open_images[key] = image
+    return image
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Show how a ROM image maps")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("addresses", nargs="*", type=lambda v: int(v, 0), help="SNES addresses to resolve")
+    args = parser.parse_args()
+
+    image = open_rom_image(args.rom_file)
+    print(f"ROM: {image.path.name} ({image.size:,} bytes, {image.mapping}, header {image.header_size} bytes)")
+    for address in args.addresses:
+        offset = image.to_offset(address)
+        print(f"   ${address:06X} -> " + (f"${offset:06X}" if offset is not None else "unmapped"))
@@ -0,0 +1,485 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Search Index
+===============================
+
+Persistent indexes for finding which bytes, strings or disassembly lines
+contain a phrase, without grepping the Markdown/ASM output:
+
+- suffix arrays over the ROM bytes and over their byte-to-byte deltas
+  (exact and wildcard byte patterns, and relative search for text under
+  an unknown table encoding)
+- a suffix array over the decoded script (the text_strings table, or the
+  maximum_analysis CSV when no table is stored)
+- a trigram index over src/ultimate/dq3_ultimate.asm, line granular,
+  with the region header or label each hit falls under
+
+The suffix arrays are ordered by each suffix's first SORT_PREFIX bytes and
+then by position. That is enough for binary search, and longer patterns
+are checked against the data inside the matching prefix range. Building
+them takes no per-suffix string slicing: the prefix and the position are
+packed into one 64-bit integer per suffix, whole arrays at a time, and a
+single sort of those integers is the build. Everything is written to the
+analysis store (cache/store) and keyed by the digest of the ROM or ASM
+file, so a query against a current index costs milliseconds.
+"""
+
+import re
+import sys
+from array import array
+from bisect import bisect_left, bisect_right
+from collections import defaultdict
+from itertools import chain
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Tuple, Union
+
+from analysis_store import AnalysisStore, rom_digest
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+# Bytes of each suffix the arrays are sorted on (the rest of a 64-bit key holds the position)
+SORT_PREFIX = 5
+POSITION_BITS = 24
+
+TEXT_CSV = Path("docs/maximum_analysis/text_strings.csv")
+DEFAULT_ASM = Path(__file__).parent.parent.parent / "src" / "ultimate" / "dq3_ultimate.asm"
+
+# Store tables (one schema each)
+ROM_SUFFIXES = "search_rom_suffixes"
+DELTA_SUFFIXES = "search_delta_suffixes"
+SCRIPT_SUFFIXES = "search_script_suffixes"
+SCRIPT_STRINGS = "search_script_strings"
+ASM_GRAMS = "search_asm_grams"
+ASM_POSTINGS = "search_asm_postings"
+ASM_LINES = "search_asm_lines"
+ASM_CONTEXT = "search_asm_context"
+
+POSITIONS = {"position": "I"}
+STRINGS = {"offset": "I", "start": "I", "text": "s"}
+GRAMS = {"gram": "s", "start": "I", "count": "I"}
+LINES = {"offset": "I"}
+CONTEXT = {"line": "I"}
+
+# ASM lines that name what follows them: region banners, bank directives and labels
+CONTEXT_LINE = re.compile(rb"^(?:; (?:DATA )?REGION|; Region:|\.BANK|[A-Za-z_@][\w@.]*:(?:\s|$))", re.IGNORECASE)
+
+
+# ---------------------------------------------------------------------- suffix arrays
+
+
+def build_suffix_array(data: Buffer) -> array:
+    """Positions of data ordered by their SORT_PREFIX-byte prefix (zero padded), then by position"""
+    size = len(data)
+    if size >= 1 << POSITION_BITS:
+        raise ValueError(f"{size:,} bytes is too large for {POSITION_BITS}-bit positions")
+    if not size:
+        return array("I")
+
+    padded = bytes(data) + bytes(16)
+    order = sys.byteorder
+    prefix_mask = ((1 << (8 * SORT_PREFIX)) - 1) << (64 - 8 * SORT_PREFIX)
+    keys = []
+    for phase in range(8):
+        # Every eighth position at once: its 8-byte window read big-endian, so integer order
+        # is byte order, with the bytes past the prefix replaced by the position
+        count = len(range(phase, size, 8))
+        windows = array("Q")
+        windows.frombytes(padded[phase : phase + 8 * count])
+        if order == "little":
+            windows.byteswap()
+        lanes = int.from_bytes(windows.tobytes(), order)
+        mask = int.from_bytes(array("Q", [prefix_mask]).tobytes() * count, order)
+        positions = int.from_bytes(array("Q", range(phase, size, 8)).tobytes(), order)
+        packed = array("Q")
+        packed.frombytes(((lanes & mask) | positions).to_bytes(8 * count, order))
+        keys.append(packed)
+
+    ordered = array("Q", sorted(chain.from_iterable(keys)))
+    if order != "little":
+        return array("I", (key & ((1 << POSITION_BITS) - 1) for key in ordered))
+    raw = ordered.tobytes()
+    result = bytearray(4 * size)
+    for byte in range(POSITION_BITS // 8):
+        result[byte::4] = raw[byte::8]
+    return array("I", bytes(result))
+
+
+class SuffixIndex:
+    """Substring search over one buffer through its prefix-sorted suffix array"""
+
+    def __init__(self, data: Buffer, suffixes: Sequence[int]):
+        self.data = bytes(data)
+        self.padded = self.data + bytes(SORT_PREFIX)
+        self.suffixes = suffixes
+
+    @classmethod
+    def build(cls, data: Buffer) -> "SuffixIndex":
+        return cls(data, build_suffix_array(data))
+
+    def _range(self, prefix: bytes) -> Tuple[int, int]:
+        padded = self.padded
+        width = len(prefix)
+
+        def key(position: int) -> bytes:
+            return padded[position : position + width]
+
+        return (bisect_left(self.suffixes, prefix, key=key), bisect_right(self.suffixes, prefix, key=key))
+
+    def find(self, pattern: bytes, limit: Optional[int] = None) -> List[int]:
+        """Sorted start positions of pattern"""
+        if not pattern:
+            return []
+        low, high = self._range(pattern[:SORT_PREFIX])
+        data, width, size = self.data, len(pattern), len(self.data)
+        candidates = self.suffixes[low:high]
+        if width > SORT_PREFIX:
+            hits = [position for position in candidates if data[position : position + width] == pattern]
+        else:
+            hits = [position for position in candidates if position + width <= size]
+        hits.sort()
+        return hits[:limit] if limit else hits
+
+    def count(self, pattern: bytes) -> int:
+        if 0 < len(pattern) <= SORT_PREFIX:
+            low, high = self._range(pattern)
+            return high - low - sum(1 for position in self.suffixes[low:high] if position + len(pattern) > len(self.data))
+        return len(self.find(pattern))
+
+
+def parse_byte_pattern(text: str) -> List[Optional[int]]:
+    """'A9 ?? 8D' -> [0xA9, None, 0x8D]"""
+    pattern = []
+    for token in text.replace(",", " ").split():
+        pattern.append(None if token in ("?", "??") else int(token, 16))
+    if not any(value is not None for value in pattern):
+        raise ValueError("Byte pattern needs at least one literal byte")
+    return pattern
+
+
+def relative_deltas(values: Buffer) -> bytes:
+    """Difference of each byte from the one before it (mod 256)"""
+    return bytes((after - before) & 0xFF for before, after in zip(values, values[1:]))
+
+
+class ROMSearch:
+    """Byte pattern and relative search over the ROM"""
+
+    def __init__(self, data: Buffer, suffixes: Sequence[int], delta_suffixes: Sequence[int]):
+        self.bytes = SuffixIndex(data, suffixes)
+        self._delta_suffixes = delta_suffixes
+        self._deltas: Optional[SuffixIndex] = None
+
+    @property
+    def deltas(self) -> SuffixIndex:
+        # Recomputing the delta stream costs a pass over the ROM, so only relative search pays it
+        if self._deltas is None:
+            self._deltas = SuffixIndex(relative_deltas(self.bytes.data), self._delta_suffixes)
+        return self._deltas
+
+    def find_pattern(self, pattern: Sequence[Optional[int]], limit: Optional[int] = None) -> List[int]:
+        """Offsets matching pattern (None matches any byte), anchored on its longest literal run"""
+        runs, start = [], None
+        for index, value in enumerate(list(pattern) + [None]):
+            if value is not None and start is None:
+                start = index
+            elif value is None and start is not None:
+                runs.append((index - start, start))
+                start = None
+        length, anchor = max(runs)
+        literal = bytes(pattern[anchor : anchor + length])
+
+        data = self.bytes.data
+        hits = []
+        for position in self.bytes.find(literal):
+            offset = position - anchor
+            if offset < 0 or offset + len(pattern) > len(data):
+                continue
+            if all(value is None or data[offset + index] == value for index, value in enumerate(pattern)):
+                hits.append(offset)
+                if limit and len(hits) >= limit:
+                    break
+        return hits
+
+    def relative_search(self, text: str, limit: Optional[int] = None) -> List[Tuple[int, int]]:
+        """
+        (offset, shift) of each place the ROM spells text in some table that keeps the letters
+        in ASCII order, where byte = ord(character) + shift (mod 256)
+        """
+        if len(text) < 2:
+            raise ValueError("Relative search needs at least two characters")
+        codes = [ord(character) for character in text]
+        pattern = bytes((after - before) & 0xFF for before, after in zip(codes, codes[1:]))
+        data = self.bytes.data
+        return [(position, (data[position] - codes[0]) & 0xFF) for position in self.deltas.find(pattern, limit)]
+
+
+class ScriptSearch:
+    """Phrase search over the decoded text strings (case-insensitive)"""
+
+    def __init__(self, offsets: Sequence[int], starts: Sequence[int], texts: Sequence[str], suffixes: Sequence[int]):
+        self.offsets = offsets
+        self.starts = starts
+        self.texts = texts
+        self.index = SuffixIndex(self.corpus(texts), suffixes)
+
+    @staticmethod
+    def corpus(texts: Sequence[str]) -> bytes:
+        return b"\n".join(text.lower().encode("utf-8") for text in texts)
+
+    @staticmethod
+    def string_starts(texts: Sequence[str]) -> array:
+        starts, position = array("I"), 0
+        for text in texts:
+            starts.append(position)
+            position += len(text.lower().encode("utf-8")) + 1
+        return starts
+
+    def find(self, phrase: str, limit: Optional[int] = None) -> List[Tuple[int, str]]:
+        """(ROM offset, text) of each string containing phrase"""
+        seen, results = set(), []
+        for position in self.index.find(phrase.lower().encode("utf-8")):
+            row = bisect_right(self.starts, position) - 1
+            if row in seen:
+                continue
+            seen.add(row)
+            results.append((self.offsets[row], self.texts[row]))
+            if limit and len(results) >= limit:
+                break
+        return results
+
+
+class AsmSearch:
+    """Trigram index over disassembly lines (case-insensitive)"""
+
+    def __init__(self, text: bytes, line_offsets: Sequence[int], grams: Dict[str, Tuple[int, int]],
+                 postings: Sequence[int], context_lines: Sequence[int]):
+        self.text = text
+        self.line_offsets = line_offsets
+        self.grams = grams
+        self.postings = postings
+        self.context_lines = context_lines
+
+    def line(self, number: int) -> str:
+        end = self.line_offsets[number + 1] if number + 1 < len(self.line_offsets) else len(self.text)
+        return self.text[self.line_offsets[number] : end].decode("utf-8", errors="replace").rstrip("\r\n")
+
+    def context(self, number: int) -> Optional[str]:
+        """The nearest region banner, bank or label at or above a line"""
+        index = bisect_right(self.context_lines, number) - 1
+        return self.line(self.context_lines[index]).strip() if index >= 0 else None
+
+    def _posting(self, gram: str) -> Sequence[int]:
+        entry = self.grams.get(gram)
+        return self.postings[entry[0] : entry[0] + entry[1]] if entry else ()
+
+    def find(self, phrase: str, limit: Optional[int] = None) -> List[Tuple[int, str, Optional[str]]]:
+        """(line number, line, context) of each line containing phrase"""
+        needle = phrase.lower()
+        grams = {needle[i : i + 3] for i in range(len(needle) - 2)}
+        if grams:
+            lists = sorted((self._posting(gram) for gram in grams), key=len)
+            candidates = set(lists[0])
+            for posting in lists[1:]:
+                if len(candidates) < 64:
+                    break  # Cheaper to check the few left than to intersect further
+                candidates.intersection_update(posting)
+            candidates = sorted(candidates)
+        else:
+            candidates = range(len(self.line_offsets))
+
+        results = []
+        for number in candidates:
+            line = self.line(number)
+            if needle in line.lower():
+                results.append((number + 1, line, self.context(number)))
+                if limit and len(results) >= limit:
+                    break
+        return results
+
+
+def build_asm_index(text: bytes) -> Tuple[array, Dict[str, array], array]:
+    """Line offsets, trigram postings and context lines of an ASM listing"""
+    line_offsets, context_lines = array("I"), array("I")
+    postings: Dict[str, array] = defaultdict(lambda: array("I"))
+    position = 0
+    for number, raw in enumerate(text.splitlines(keepends=True)):
+        line_offsets.append(position)
+        position += len(raw)
+        if CONTEXT_LINE.match(raw):
+            context_lines.append(number)
+        line = raw.decode("utf-8", errors="replace").lower()
+        for gram in {line[i : i + 3] for i in range(len(line.rstrip()) - 2)}:
+            postings[gram].append(number)
+    return line_offsets, postings, context_lines
+
+
+# ---------------------------------------------------------------------- persistence
+
+
+class SearchIndex:
+    """Every index over one ROM (and its disassembly), built on first use and kept in the store"""
+
+    def __init__(self, rom_data: Buffer, store: Optional[AnalysisStore] = None, asm_path: Optional[Path] = None):
+        self.rom_data = rom_data
+        self.store = store or AnalysisStore()
+        self.digest = rom_digest(rom_data)
+        self.asm_path = Path(asm_path) if asm_path else DEFAULT_ASM
+        self._rom: Optional[ROMSearch] = None
+        self._script: Optional[ScriptSearch] = None
+        self._asm: Optional[AsmSearch] = None
+
+    def _positions(self, name: str, data: Buffer, digest: bytes) -> Sequence[int]:
+        table = self.store.read(name, digest)
+        if table is not None:
+            return table["position"]
+        suffixes = build_suffix_array(data)
+        self.store.write(name, POSITIONS, {"position": suffixes}, digest)
+        return suffixes
+
+    def rom(self) -> ROMSearch:
+        if self._rom is None:
+            data = bytes(self.rom_data)
+            suffixes = self._positions(ROM_SUFFIXES, data, self.digest)
+            delta_suffixes = self._positions(DELTA_SUFFIXES, relative_deltas(data), self.digest)
+            self._rom = ROMSearch(data, suffixes, delta_suffixes)
+        return self._rom
+
+    def _script_strings(self) -> Tuple[List[int], List[str]]:
+        """Decoded strings by offset: the stored text_strings table, else the analysis CSV"""
+        table = self.store.read("text_strings", self.digest)
+        if table is not None:
+            rows = sorted(zip(table["offset"], table["text"]))
+        else:
+            import csv
+
+            rows = []
+            if TEXT_CSV.exists():
+                with open(TEXT_CSV, "r", encoding="utf-8") as f:
+                    for row in csv.DictReader(f):
+                        try:
+                            rows.append((int(row["Offset"][1:], 16), row["Text"]))
+                        except (KeyError, ValueError):
+                            continue
+            rows.sort()
+        return [offset for offset, _ in rows], [text for _, text in rows]
+
+    def script(self) -> ScriptSearch:
+        if self._script is None:
+            table = self.store.read(SCRIPT_STRINGS, self.digest)
+            if table is None:
+                offsets, texts = self._script_strings()
+                starts = ScriptSearch.string_starts(texts)
+                self.store.write(SCRIPT_STRINGS, STRINGS, {"offset": offsets, "start": starts, "text": texts},
+                                 self.digest)
+            else:
+                offsets, starts, texts = table["offset"], table["start"], list(table["text"])
+            corpus = ScriptSearch.corpus(texts)
+            suffixes = self._positions(SCRIPT_SUFFIXES, corpus, self.digest)
+            self._script = ScriptSearch(offsets, starts, texts, suffixes)
+        return self._script
+
+    def asm(self) -> AsmSearch:
+        if self._asm is None:
+            if not self.asm_path.exists():
+                raise FileNotFoundError(f"Disassembly not found: {self.asm_path}")
+            text = self.asm_path.read_bytes()
+            digest = rom_digest(text)
+            tables = [self.store.read(name, digest) for name in (ASM_LINES, ASM_GRAMS, ASM_POSTINGS, ASM_CONTEXT)]
+            if all(table is not None for table in tables):
+                lines, gram_table, postings, context = tables
+                grams = {gram: (start, count) for gram, start, count in
+                         zip(gram_table["gram"], gram_table["start"], gram_table["count"])}
+                self._asm = AsmSearch(text, lines["offset"], grams, postings["line"], context["line"])
+            else:
+                line_offsets, gram_postings, context_lines = build_asm_index(text)
+                grams, flat = {}, array("I")
+                for gram in sorted(gram_postings):
+                    grams[gram] = (len(flat), len(gram_postings[gram]))
+                    flat.extend(gram_postings[gram])
+                names = sorted(grams)
+                self.store.write(ASM_LINES, LINES, {"offset": line_offsets}, digest)
+                self.store.write(ASM_GRAMS, GRAMS, {
+                    "gram": names,
+                    "start": [grams[gram][0] for gram in names],
+                    "count": [grams[gram][1] for gram in names],
+                }, digest)
+                self.store.write(ASM_POSTINGS, {"line": "I"}, {"line": flat}, digest)
+                self.store.write(ASM_CONTEXT, CONTEXT, {"line": context_lines}, digest)
+                self._asm = AsmSearch(text, line_offsets, grams, flat, context_lines)
+        return self._asm
+
+    def build(self):
+        """Build (or validate) every index now"""
+        self.rom()
+        self.script()
+        if self.asm_path.exists():
+            self.asm()
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Search the ROM, the decoded script and the disassembly")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("--build", action="store_true", help="Build every index before querying")
+    parser.add_argument("--bytes", dest="byte_pattern", help="Hex byte pattern, ?? for any byte (e.g. 'A9 ?? 8D')")
+    parser.add_argument("--relative", help="Relative search for a word under an unknown table")
+    parser.add_argument("--text", help="Phrase in the decoded script")
+    parser.add_argument("--asm", help="Phrase in the disassembly")
+    parser.add_argument("--asm-file", help="Disassembly to index (default: src/ultimate/dq3_ultimate.asm)")
+    parser.add_argument("--store", help="Store directory (default: cache/store)")
+    parser.add_argument("--limit", type=int, default=20, help="Results to print per query")
+    args = parser.parse_args()
+
+    image = open_rom_image(args.rom_file)
+    index = SearchIndex(image.data, AnalysisStore(args.store), args.asm_file)
+
+    try:
+        if args.build:
+            start_time = time.time()
+            index.build()
+            print(f"✅ Indexes ready in {time.time() - start_time:.1f}s")
+
+        if args.byte_pattern:
+            search = index.rom()
+            start_time = time.time()
+            hits = search.find_pattern(parse_byte_pattern(args.byte_pattern))
+            print(f"🔍 {len(hits):,} matches for {args.byte_pattern} ({(time.time() - start_time) * 1000:.1f}ms)")
+            for offset in hits[: args.limit]:
+                print(f"   0x{offset:06X}  ${image.to_snes(offset):06X}")
+
+        if args.relative:
+            search = index.rom()
+            start_time = time.time()
+            hits = search.relative_search(args.relative)
+            print(f"🔍 {len(hits):,} relative matches for '{args.relative}' ({(time.time() - start_time) * 1000:.1f}ms)")
+            shifts: Dict[int, int] = defaultdict(int)
+            for _, shift in hits:
+                shifts[shift] += 1
+            for offset, shift in hits[: args.limit]:
+                print(f"   0x{offset:06X}  '{args.relative[0]}' = ${(ord(args.relative[0]) + shift) & 0xFF:02X}")
+            if shifts:
+                shift = max(shifts, key=shifts.get)
+                print(f"   Most common table: 'A' = ${(ord('A') + shift) & 0xFF:02X} ({shifts[shift]} matches)")
+
+        if args.text:
+            search = index.script()
+            start_time = time.time()
+            hits = search.find(args.text)
+            print(f"🔍 {len(hits):,} strings contain '{args.text}' ({(time.time() - start_time) * 1000:.1f}ms)")
+            for offset, text in hits[: args.limit]:
+                print(f"   ${offset:06X}  {text[:70]}")
+
+        if args.asm:
+            search = index.asm()
+            start_time = time.time()
+            hits = search.find(args.asm)
+            print(f"🔍 {len(hits):,} lines contain '{args.asm}' ({(time.time() - start_time) * 1000:.1f}ms)")
+            for number, line, context in hits[: args.limit]:
+                print(f"   {number:7}: {line.strip()[:60]:60}  [{context or ''}]")
+    except (OSError, ValueError) as e:
+        print(f"❌ Error: {e}")
+        sys.exit(1)
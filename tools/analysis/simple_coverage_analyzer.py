@@ -18,6 +18,10 @@ import json
 from collections import defaultdict, Counter
 import os
 
+from rom_classifier import classify_rom
+from rom_image import open_rom_image
+from xref_index import build_xref_index
+
 @dataclass
 class CoverageRegion:
     """Represents a region of ROM with coverage analysis"""
@@ -53,10 +57,9 @@ class SimpleCoverageAnalyzer:
         print(f"ROM: {self.rom_path.name}")
         print(f"Size: {self.rom_size:,} bytes ({self.rom_size / 1024 / 1024:.1f} MB)")
 
-    def _load_rom(self) -> bytes:
-        """Load ROM data into memory"""
-        with open(self.rom_path, 'rb') as f:
-            return f.read()
+    def _load_rom(self) -> memoryview:
+        """ROM data as a view of the shared memory-mapped image"""
+        return open_rom_image(self.rom_path).data
 
     def calculate_entropy(self, window_size: int = 256) -> Dict[int, float]:
         """
@@ -70,22 +73,10 @@ class SimpleCoverageAnalyzer:
         """
         print(f"\nANALYZING: Calculating byte entropy with window size {window_size}...")
 
-        entropy_map = {}
-
-        for offset in range(0, self.rom_size - window_size + 1, window_size // 4):
-            window = self.rom_data[offset:offset + window_size]
-
-            # Count byte frequencies
-            byte_counts = Counter(window)
-            entropy = 0.0
-
-            for count in byte_counts.values():
-                probability = count / len(window)
-                if probability > 0:
-                    entropy -= probability * math.log2(probability)
-
-            entropy_map[offset] = entropy
+        # Entropy column of the shared single-pass classification
+        entropy_map = classify_rom(self.rom_data, window_size, window_size // 4).entropy_map()
 
+        for offset, entropy in entropy_map.items():
             # Classify based on entropy
             if entropy > 7.5:
                 self._mark_region_type(offset, offset + window_size, "compressed_data")
@@ -113,34 +104,12 @@ class SimpleCoverageAnalyzer:
         """
         print(f"\nANALYZING: Detecting pointers...")
 
-        pointer_map = {}
+        # 16-bit (bank 0) and 24-bit pointer candidates, indexed by target (see xref_index)
+        self.xref_index = build_xref_index(self.rom_data, open_rom_image(self.rom_path).address_map)
 
-        # Scan for 16-bit pointers (little-endian)
-        for offset in range(0, self.rom_size - 2):
-            if offset + 1 < self.rom_size:
-                value = struct.unpack('<H', self.rom_data[offset:offset+2])[0]
-
-                # Check if this could be a valid ROM address
-                if 0x8000 <= value <= 0xFFFF:
-                    # Convert to ROM offset (assuming LoROM mapping)
-                    rom_offset = ((value - 0x8000) % 0x8000)
-                    if rom_offset < self.rom_size:
-                        if offset not in pointer_map:
-                            pointer_map[offset] = []
-                        pointer_map[offset].append(rom_offset)
-
-        # Scan for 24-bit pointers
-        for offset in range(0, self.rom_size - 4):
-            if offset + 3 < self.rom_size:
-                value = struct.unpack('<I', self.rom_data[offset:offset+4])[0] & 0xFFFFFF
-
-                # Check for valid SNES address format
-                if (value & 0x8000) and (value < 0x400000):
-                    rom_offset = ((value & 0x3F0000) >> 1) + (value & 0x7FFF)
-                    if rom_offset < self.rom_size:
-                        if offset not in pointer_map:
-                            pointer_map[offset] = []
-                        pointer_map[offset].append(rom_offset)
+        pointer_map = {}
+        for target, offset, _ in self.xref_index.entries():
+            pointer_map.setdefault(offset, []).append(target)
 
         print(f"Found {len(pointer_map):,} potential pointers")
         self.pointer_map = pointer_map
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Snapshot Differ
+==================================
+
+Batch diff of WRAM/SRAM snapshots (raw dumps, or a fixed window of save-
+state files) against the documented structure layouts, to surface the
+fields nobody has named yet.
+
+Each file is memory-mapped and turned into one integer, so a whole
+snapshot pair is XORed in a single operation. The differing bytes and
+each of their bits are then counted with bytes.translate into one-byte
+lanes of running integer sums, and those sums are moved into the per-address
+histograms every 255 pairs, before a lane can overflow. Changed
+addresses are finally mapped onto the fields and gaps of
+dq3_structures.json (DataStructure.get_gaps), so unknown bytes and bits
+that change come out ranked.
+"""
+
+import mmap
+import re
+import sys
+from array import array
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence
+
+sys.path.append(str(Path(__file__).parent.parent / "documentation"))
+from structure_parser import DataStructure, DQ3StructureParser
+
+DEFAULT_STRUCTURES = Path(__file__).parent.parent.parent / "documentation" / "dq3_structures" / "dq3_structures.json"
+
+# Pairs accumulated in one-byte lanes before they are drained
+LANE_LIMIT = 255
+
+# Regions this small get per-bit change counts in the report
+BIT_DETAIL_SIZE = 4
+
+NONZERO_TABLE = bytes([0] + [1] * 255)
+BIT_TABLES = [bytes((value >> bit) & 1 for value in range(256)) for bit in range(8)]
+_NONZERO_BYTE = re.compile(b"[^\x00]")
+
+
+def map_snapshot(path: Path, offset: int = 0, length: Optional[int] = None) -> int:
+    """Snapshot window as one little-endian integer"""
+    with open(path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+            end = len(mapped) if length is None else offset + length
+            if end > len(mapped):
+                raise ValueError(f"{path} is {len(mapped)} bytes, window needs {end}")
+            with memoryview(mapped)[offset:end] as window:
+                return int.from_bytes(window, "little")
+
+
+class ChangeHistogram:
+    """How often each byte, and each bit of each byte, changed across snapshot pairs"""
+
+    def __init__(self, length: int):
+        self.length = length
+        self.pairs = 0
+        self.byte_counts = array("I", bytes(4 * length))
+        self.bit_counts = [array("I", bytes(4 * length)) for _ in range(8)]
+        self._pending = 0
+        self._byte_lanes = 0
+        self._bit_lanes = [0] * 8
+
+    def add(self, before: int, after: int):
+        """Count the differences of one pair of snapshot integers"""
+        self.pairs += 1
+        changed = before ^ after
+        if not changed:
+            return
+
+        diff = changed.to_bytes(self.length, "little")
+        self._byte_lanes += int.from_bytes(diff.translate(NONZERO_TABLE), "little")
+        for bit, table in enumerate(BIT_TABLES):
+            self._bit_lanes[bit] += int.from_bytes(diff.translate(table), "little")
+        self._pending += 1
+        if self._pending == LANE_LIMIT:
+            self.flush()
+
+    @staticmethod
+    def _drain(lanes: int, counts: array, length: int):
+        data = lanes.to_bytes(length, "little")
+        for match in _NONZERO_BYTE.finditer(data):
+            counts[match.start()] += data[match.start()]
+
+    def flush(self):
+        """Move the lane sums into the histograms"""
+        if not self._pending:
+            return
+        self._drain(self._byte_lanes, self.byte_counts, self.length)
+        for bit in range(8):
+            self._drain(self._bit_lanes[bit], self.bit_counts[bit], self.length)
+        self._pending = 0
+        self._byte_lanes = 0
+        self._bit_lanes = [0] * 8
+
+    def merge(self, other: "ChangeHistogram"):
+        self.flush()
+        other.flush()
+        self.pairs += other.pairs
+        for mine, theirs in zip([self.byte_counts] + self.bit_counts, [other.byte_counts] + other.bit_counts):
+            for index, count in enumerate(theirs):
+                if count:
+                    mine[index] += count
+
+    def changed_offsets(self) -> List[int]:
+        self.flush()
+        return [offset for offset, count in enumerate(self.byte_counts) if count]
+
+    def __getstate__(self):
+        self.flush()
+        return self.__dict__
+
+
+def _histogram_worker(paths: Sequence[str], reference: Optional[str], offset: int, length: int) -> ChangeHistogram:
+    """Pairs within paths: each against reference, or each against the one before it"""
+    histogram = ChangeHistogram(length)
+    base = map_snapshot(Path(reference), offset, length) if reference else None
+    previous = None
+    for path in paths:
+        current = map_snapshot(Path(path), offset, length)
+        if base is not None:
+            histogram.add(base, current)
+        elif previous is not None:
+            histogram.add(previous, current)
+        previous = current
+    histogram.flush()
+    return histogram
+
+
+def diff_snapshots(paths: Sequence[Path], offset: int = 0, length: Optional[int] = None, baseline: bool = False,
+                   workers: int = 1) -> ChangeHistogram:
+    """
+    Change histogram of the snapshots, in order
+    Sequential pairs (each file against the previous one) by default, or every file against
+    the first with baseline. Workers take contiguous runs of files; runs share their edge
+    file so no sequential pair is lost.
+    """
+    if len(paths) < 2:
+        raise ValueError("Need at least two snapshots")
+    names = [str(path) for path in paths]
+    if length is None:
+        length = min(Path(path).stat().st_size for path in paths) - offset
+
+    reference = names[0] if baseline else None
+    targets = names[1:] if baseline else names
+    workers = max(1, min(workers, len(targets) // 2 or 1))
+    if workers == 1:
+        return _histogram_worker(targets, reference, offset, length)
+
+    chunk = -(-len(targets) // workers)
+    runs = []
+    for start in range(0, len(targets), chunk):
+        first = start if baseline or start == 0 else start - 1
+        runs.append(targets[first : start + chunk])
+    histogram = ChangeHistogram(length)
+    with ProcessPoolExecutor(max_workers=workers) as executor:
+        for partial in executor.map(_histogram_worker, runs, [reference] * len(runs), [offset] * len(runs),
+                                    [length] * len(runs)):
+            histogram.merge(partial)
+    return histogram
+
+
+# ---------------------------------------------------------------------- structure mapping
+
+
+@dataclass
+class Region:
+    """A documented field, or a gap between fields, at absolute WRAM addresses"""
+
+    structure: str
+    name: Optional[str]  # None for a gap
+    start: int
+    size: int
+    description: str = ""
+
+    @property
+    def label(self) -> str:
+        if self.name is None:
+            return f"{self.structure}.gap_{self.start:04X}"
+        return f"{self.structure}.{self.name}"
+
+
+def build_regions(structures: Dict[str, DataStructure]) -> List[Region]:
+    """Fields and gaps of every structure, ordered by address"""
+    regions = []
+    for structure in structures.values():
+        for field in structure.fields:
+            regions.append(Region(structure.name, field.name, structure.base_address + field.offset, field.size,
+                                  field.description))
+        for gap_start, gap_end in structure.get_gaps():
+            regions.append(Region(structure.name, None, structure.base_address + gap_start, gap_end - gap_start + 1))
+    regions.sort(key=lambda region: (region.start, region.name is None))
+    return regions
+
+
+def change_report(histogram: ChangeHistogram, regions: Sequence[Region], address: int = 0) -> Dict[str, object]:
+    """Changes per region and per unmapped run; address is the WRAM address of histogram offset 0"""
+    pairs = max(histogram.pairs, 1)
+    changed = set(histogram.changed_offsets())
+    covered = set()
+    report_regions = []
+
+    for region in regions:
+        offsets = range(region.start - address, region.start - address + region.size)
+        covered.update(offsets)
+        hits = [offset for offset in offsets if offset in changed]
+        if not hits:
+            continue
+        entry = {
+            "region": region.label,
+            "known": region.name is not None,
+            "address": f"${region.start:04X}",
+            "size": region.size,
+            "changed_bytes": len(hits),
+            "max_changes": max(histogram.byte_counts[offset] for offset in hits),
+            "change_rate": round(max(histogram.byte_counts[offset] for offset in hits) / pairs, 4),
+        }
+        if region.size <= BIT_DETAIL_SIZE:
+            entry["bit_changes"] = [histogram.bit_counts[bit][offset] for offset in offsets for bit in range(8)]
+        report_regions.append(entry)
+
+    unmapped = []
+    for offset in sorted(changed - covered):
+        if unmapped and unmapped[-1]["end"] == offset - 1:
+            run = unmapped[-1]
+            run["end"] = offset
+            run["max_changes"] = max(run["max_changes"], histogram.byte_counts[offset])
+        else:
+            unmapped.append({"start": offset, "end": offset, "max_changes": histogram.byte_counts[offset]})
+
+    unknown = [entry for entry in report_regions if not entry["known"]]
+    unknown.sort(key=lambda entry: -entry["max_changes"])
+    return {
+        "pairs": histogram.pairs,
+        "changed_bytes": len(changed),
+        "regions": report_regions,
+        "unknown_regions": [entry["region"] for entry in unknown],
+        "unmapped_runs": [
+            {"address": f"${run['start'] + address:05X}", "size": run["end"] - run["start"] + 1,
+             "max_changes": run["max_changes"]}
+            for run in unmapped
+        ],
+        "addresses": {
+            f"${offset + address:05X}": {
+                "changes": histogram.byte_counts[offset],
+                "bits": [histogram.bit_counts[bit][offset] for bit in range(8)],
+            }
+            for offset in sorted(changed)
+        },
+    }
+
+
+if __name__ == "__main__":
+    import argparse
+    import json
+    import time
+
+    parser = argparse.ArgumentParser(description="Diff many WRAM/SRAM snapshots against the structure layouts")
+    parser.add_argument("snapshots", nargs="+", help="Snapshot files (or directories of them), in order")
+    parser.add_argument("--offset", type=lambda v: int(v, 0), default=0, help="Offset of the memory window in each file")
+    parser.add_argument("--length", type=lambda v: int(v, 0), help="Window size (default: the smallest file)")
+    parser.add_argument("--address", type=lambda v: int(v, 0), default=0, help="WRAM address of the window's first byte")
+    parser.add_argument("--baseline", action="store_true", help="Diff every snapshot against the first")
+    parser.add_argument("--structures", default=str(DEFAULT_STRUCTURES), help="dq3_structures.json layout export")
+    parser.add_argument("--workers", type=int, default=1, help="Worker processes")
+    parser.add_argument("--top", type=int, default=20, help="Unknown regions to print")
+    parser.add_argument("--output", "-o", help="Write the JSON report here")
+    args = parser.parse_args()
+
+    paths: List[Path] = []
+    for name in args.snapshots:
+        entry = Path(name)
+        paths.extend(sorted(p for p in entry.iterdir() if p.is_file()) if entry.is_dir() else [entry])
+
+    try:
+        start_time = time.time()
+        histogram = diff_snapshots(paths, args.offset, args.length, args.baseline, args.workers)
+        elapsed = time.time() - start_time
+        regions = build_regions(DQ3StructureParser().load_json_export(args.structures))
+        report = change_report(histogram, regions, args.address)
+    except (OSError, ValueError) as e:
+        print(f"❌ Error: {e}")
+        sys.exit(1)
+
+    print(f"🔍 {len(paths)} snapshots, {report['pairs']} pairs in {elapsed:.2f}s: {report['changed_bytes']:,} bytes changed")
+    by_label = {entry["region"]: entry for entry in report["regions"]}
+    for label in report["unknown_regions"][: args.top]:
+        entry = by_label[label]
+        print(f"   {label:32} {entry['address']} +{entry['size']:<4} {entry['changed_bytes']:4} bytes, "
+              f"rate {entry['change_rate']:.3f}")
+    if report["unmapped_runs"]:
+        print(f"   {len(report['unmapped_runs'])} changed runs outside any structure")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent="\t")
+        print(f"✅ Report written to {args.output}")
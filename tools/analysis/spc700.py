@@ -0,0 +1,773 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - SPC700 Core
+==============================
+
+The sound CPU: every SPC700 opcode, 64KB of audio RAM, the three timers,
+the four I/O ports shared with the main CPU and the IPL boot ROM. The DSP
+is attached through its address/data register pair (see spc_dsp); run()
+executes a number of CPU cycles so the caller can interleave DSP output.
+
+Drivers spend most of their time spinning on a timer counter, so a second
+read of an empty counter from the same instruction jumps the clock to the
+timer's next tick instead of executing the spin.
+"""
+
+from typing import Callable, List, Optional
+
+# Processor status bits
+FLAG_N = 0x80
+FLAG_V = 0x40
+FLAG_P = 0x20
+FLAG_B = 0x10
+FLAG_H = 0x08
+FLAG_I = 0x04
+FLAG_Z = 0x02
+FLAG_C = 0x01
+
+# 1.024 MHz CPU clock; timers 0/1 tick every 128 cycles (8 kHz), timer 2 every 16 (64 kHz)
+CPU_CLOCK = 1024000
+TIMER_PERIODS = (128, 128, 16)
+
+IPL_ROM = bytes.fromhex(
+    "CDEFBDE800C61DD0FC8FAAF48FBBF578"
+    "CCF4D0FB2F19EBF4D0FC7EF4D00BE4F5"
+    "CBF4D700FCD0F3AB0110EF7EF410EBBA"
+    "F6DA00BAF4C4F4DD5DD0DB1F0000C0FF"
+)
+IPL_BASE = 0xFFC0
+
+# Base cycles per opcode (taken branches add 2)
+CYCLES = bytes([
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 4, 6, 8,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 6, 5, 2, 2, 4, 6,
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 4, 5, 4,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 6, 5, 2, 2, 3, 8,
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 4, 6, 6,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 4, 5, 2, 2, 4, 3,
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 4, 5, 5,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 3, 6,
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 6, 5, 4, 5, 2, 4, 5,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 12, 5,
+    3, 8, 4, 5, 3, 4, 3, 6, 2, 6, 4, 4, 5, 2, 4, 4,
+    2, 8, 4, 5, 4, 5, 5, 6, 5, 5, 5, 5, 2, 2, 3, 4,
+    3, 8, 4, 5, 4, 5, 4, 7, 2, 5, 6, 4, 5, 2, 4, 9,
+    2, 8, 4, 5, 5, 6, 6, 7, 4, 5, 5, 5, 2, 2, 6, 3,
+    2, 8, 4, 5, 3, 4, 3, 6, 2, 4, 5, 3, 4, 3, 4, 3,
+    2, 8, 4, 5, 4, 5, 5, 6, 3, 4, 5, 4, 2, 2, 4, 3,
+])
+
+
+class SPC700:
+    """
+    SPC700 CPU with its memory map
+    ports_in holds what the main CPU last wrote to $2140-$2143 (read at $F4-$F7);
+    ports_out what the SPC700 wrote back. dsp is any object with read(register) and
+    write(register, value).
+    """
+
+    def __init__(self, dsp=None):
+        self.ram = bytearray(0x10000)
+        self.dsp = dsp
+        self.a = self.x = self.y = 0
+        self.sp = 0xEF
+        self.pc = IPL_BASE
+        self.n = self.v = self.p = self.b = self.h = self.i = self.c = 0
+        self.z = False
+
+        self.cycles = 0
+        self.stopped = False
+        self.ports_in = bytearray(4)
+        self.ports_out = bytearray(4)
+
+        self.control = 0x80
+        self.dsp_address = 0
+        self.timer_targets = [256, 256, 256]
+        self.timer_stages = [0, 0, 0]
+        self.timer_counters = [0, 0, 0]
+        self._timer_cycles = [0, 0, 0]
+        self._poll_pc = -1
+        self._run_target = 0
+
+        self._ops: List[Callable[[], int]] = self._build_opcode_table()
+
+    # ------------------------------------------------------------------ state
+
+    @property
+    def psw(self) -> int:
+        return (
+            (FLAG_N if self.n else 0) | (FLAG_V if self.v else 0) | (FLAG_P if self.p else 0)
+            | (FLAG_B if self.b else 0) | (FLAG_H if self.h else 0) | (FLAG_I if self.i else 0)
+            | (FLAG_Z if self.z else 0) | (FLAG_C if self.c else 0)
+        )
+
+    @psw.setter
+    def psw(self, value: int):
+        self.n = value & FLAG_N
+        self.v = value & FLAG_V
+        self.p = value & FLAG_P
+        self.b = value & FLAG_B
+        self.h = value & FLAG_H
+        self.i = value & FLAG_I
+        self.z = bool(value & FLAG_Z)
+        self.c = value & FLAG_C
+
+    def load_state(self, ram: bytes, pc: int, a: int = 0, x: int = 0, y: int = 0, psw: int = 0, sp: int = 0xEF):
+        """Start from a RAM image and register set (e.g. an .spc snapshot)"""
+        self.ram[:] = ram[:0x10000].ljust(0x10000, b"\0")
+        self.pc, self.a, self.x, self.y, self.sp = pc, a, x, y, sp
+        self.psw = psw
+        self.stopped = False
+
+        # I/O registers come back from the RAM image
+        self.control = self.ram[0xF1]
+        self.dsp_address = self.ram[0xF2]
+        for timer in range(3):
+            target = self.ram[0xFA + timer]
+            self.timer_targets[timer] = target or 256
+            self.timer_counters[timer] = self.ram[0xFD + timer] & 0x0F
+        self.ports_in[:] = self.ram[0xF4:0xF8]
+        self.ports_out[:] = self.ram[0xF4:0xF8]
+
+    # ------------------------------------------------------------------ timers and I/O
+
+    def _update_timers(self):
+        for timer in range(3):
+            elapsed = self.cycles - self._timer_cycles[timer]
+            ticks = elapsed // TIMER_PERIODS[timer]
+            if not ticks:
+                continue
+            self._timer_cycles[timer] += ticks * TIMER_PERIODS[timer]
+            if self.control & (1 << timer):
+                stage = self.timer_stages[timer] + ticks
+                target = self.timer_targets[timer]
+                self.timer_counters[timer] = (self.timer_counters[timer] + stage // target) & 0x0F
+                self.timer_stages[timer] = stage % target
+
+    def _skip_to_tick(self, timer: int):
+        """Advance the clock to the cycle where timer next counts (or to the end of the run)"""
+        wake = self._run_target
+        if self.control & (1 << timer):
+            remaining = self.timer_targets[timer] - self.timer_stages[timer]
+            wake = min(wake, self._timer_cycles[timer] + remaining * TIMER_PERIODS[timer])
+        if wake > self.cycles:
+            self.cycles = wake
+
+    def _io_read(self, address: int) -> int:
+        if address == 0xF3:
+            return self.dsp.read(self.dsp_address & 0x7F) if self.dsp else 0
+        if address == 0xF2:
+            return self.dsp_address
+        if 0xF4 <= address <= 0xF7:
+            return self.ports_in[address - 0xF4]
+        if address >= 0xFD:
+            self._update_timers()
+            timer = address - 0xFD
+            value = self.timer_counters[timer]
+            self.timer_counters[timer] = 0
+            if value:
+                self._poll_pc = -1
+            elif self.pc == self._poll_pc:
+                self._skip_to_tick(timer)
+            else:
+                self._poll_pc = self.pc
+            return value
+        if address in (0xF8, 0xF9):
+            return self.ram[address]
+        return 0  # TEST, CONTROL and timer targets read back as 0
+
+    def _io_write(self, address: int, value: int):
+        if address == 0xF1:
+            self._update_timers()
+            for timer in range(3):
+                if value & (1 << timer) and not self.control & (1 << timer):
+                    self.timer_stages[timer] = 0
+                    self.timer_counters[timer] = 0
+            if value & 0x10:
+                self.ports_in[0] = self.ports_in[1] = 0
+            if value & 0x20:
+                self.ports_in[2] = self.ports_in[3] = 0
+            self.control = value
+        elif address == 0xF2:
+            self.dsp_address = value
+        elif address == 0xF3:
+            if self.dsp and self.dsp_address < 0x80:
+                self.dsp.write(self.dsp_address, value)
+        elif 0xF4 <= address <= 0xF7:
+            self.ports_out[address - 0xF4] = value
+        elif 0xFA <= address <= 0xFC:
+            self._update_timers()
+            self.timer_targets[address - 0xFA] = value or 256
+
+    # ------------------------------------------------------------------ memory
+
+    def read(self, address: int) -> int:
+        if 0xF0 <= address <= 0xFF:
+            return self._io_read(address)
+        if address >= IPL_BASE and self.control & 0x80:
+            return IPL_ROM[address - IPL_BASE]
+        return self.ram[address]
+
+    def write(self, address: int, value: int):
+        self.ram[address] = value
+        if 0xF0 <= address <= 0xFF:
+            self._io_write(address, value)
+
+    def read16(self, address: int) -> int:
+        return self.read(address) | (self.read((address + 1) & 0xFFFF) << 8)
+
+    def read_dp16(self, offset: int) -> int:
+        """Word in the direct page (the high byte wraps within the page)"""
+        page = 0x100 if self.p else 0
+        return self.read(page | offset) | (self.read(page | ((offset + 1) & 0xFF)) << 8)
+
+    def write_dp16(self, offset: int, value: int):
+        page = 0x100 if self.p else 0
+        self.write(page | offset, value & 0xFF)
+        self.write(page | ((offset + 1) & 0xFF), value >> 8)
+
+    def fetch(self) -> int:
+        value = self.read(self.pc)
+        self.pc = (self.pc + 1) & 0xFFFF
+        return value
+
+    def fetch16(self) -> int:
+        low = self.fetch()
+        return low | (self.fetch() << 8)
+
+    def push(self, value: int):
+        self.ram[0x100 | self.sp] = value
+        self.sp = (self.sp - 1) & 0xFF
+
+    def pop(self) -> int:
+        self.sp = (self.sp + 1) & 0xFF
+        return self.ram[0x100 | self.sp]
+
+    # ------------------------------------------------------------------ execution
+
+    def run(self, cycles: int) -> int:
+        """Execute at least cycles CPU cycles (or until STOP/SLEEP); returns cycles used"""
+        target = self.cycles + cycles
+        self._run_target = target
+        ops = self._ops
+        fetch = self.fetch
+        while self.cycles < target:
+            if self.stopped:
+                self.cycles = target
+                break
+            # Separate statement: the opcode may move the clock itself (timer spin skip)
+            used = ops[fetch()]()
+            self.cycles += used
+        self._update_timers()
+        return self.cycles - target + cycles
+
+    def step(self) -> int:
+        """Execute one instruction; returns its cycles"""
+        used = self._ops[self.fetch()]()
+        self.cycles += used
+        return used
+
+    # ------------------------------------------------------------------ opcode helpers
+
+    def _set_nz(self, value: int) -> int:
+        self.n = value & 0x80
+        self.z = not value
+        return value
+
+    def _branch(self, condition, opcode: int) -> int:
+        offset = self.fetch()
+        if condition:
+            self.pc = (self.pc + offset - (0x100 if offset & 0x80 else 0)) & 0xFFFF
+            return CYCLES[opcode] + 2
+        return CYCLES[opcode]
+
+    def _bra(self) -> int:
+        """BRA: always taken, so its table cost already includes the jump"""
+        offset = self.fetch()
+        self.pc = (self.pc + offset - (0x100 if offset & 0x80 else 0)) & 0xFFFF
+        return CYCLES[0x2F]
+
+    def _adc(self, a: int, b: int) -> int:
+        result = a + b + (1 if self.c else 0)
+        self.c = result > 0xFF
+        self.h = (a ^ b ^ result) & 0x10
+        self.v = ~(a ^ b) & (a ^ result) & 0x80
+        return self._set_nz(result & 0xFF)
+
+    def _sbc(self, a: int, b: int) -> int:
+        return self._adc(a, b ^ 0xFF)
+
+    def _cmp(self, a: int, b: int) -> int:
+        result = a - b
+        self.c = result >= 0
+        self._set_nz(result & 0xFF)
+        return a
+
+    def _or(self, a: int, b: int) -> int:
+        return self._set_nz(a | b)
+
+    def _and(self, a: int, b: int) -> int:
+        return self._set_nz(a & b)
+
+    def _eor(self, a: int, b: int) -> int:
+        return self._set_nz(a ^ b)
+
+    def _asl(self, value: int) -> int:
+        self.c = value & 0x80
+        return self._set_nz((value << 1) & 0xFF)
+
+    def _rol(self, value: int) -> int:
+        carry = 1 if self.c else 0
+        self.c = value & 0x80
+        return self._set_nz(((value << 1) | carry) & 0xFF)
+
+    def _lsr(self, value: int) -> int:
+        self.c = value & 0x01
+        return self._set_nz(value >> 1)
+
+    def _ror(self, value: int) -> int:
+        carry = 0x80 if self.c else 0
+        self.c = value & 0x01
+        return self._set_nz((value >> 1) | carry)
+
+    def _inc(self, value: int) -> int:
+        return self._set_nz((value + 1) & 0xFF)
+
+    def _dec(self, value: int) -> int:
+        return self._set_nz((value - 1) & 0xFF)
+
+    # Addressing modes: each consumes its operand bytes and returns the effective address
+
+    def _dp(self) -> int:
+        return (0x100 if self.p else 0) | self.fetch()
+
+    def _dp_x(self) -> int:
+        return (0x100 if self.p else 0) | ((self.fetch() + self.x) & 0xFF)
+
+    def _dp_y(self) -> int:
+        return (0x100 if self.p else 0) | ((self.fetch() + self.y) & 0xFF)
+
+    def _abs(self) -> int:
+        return self.fetch16()
+
+    def _abs_x(self) -> int:
+        return (self.fetch16() + self.x) & 0xFFFF
+
+    def _abs_y(self) -> int:
+        return (self.fetch16() + self.y) & 0xFFFF
+
+    def _ind_x(self) -> int:
+        return (0x100 if self.p else 0) | self.x
+
+    def _ind_y(self) -> int:
+        return (0x100 if self.p else 0) | self.y
+
+    def _dp_x_ind(self) -> int:
+        return self.read_dp16((self.fetch() + self.x) & 0xFF)
+
+    def _dp_ind_y(self) -> int:
+        return (self.read_dp16(self.fetch()) + self.y) & 0xFFFF
+
+    def _mem_bit(self):
+        operand = self.fetch16()
+        return operand & 0x1FFF, operand >> 13
+
+    # ------------------------------------------------------------------ opcode table
+
+    def _build_opcode_table(self) -> List[Callable[[], int]]:
+        ops: List[Optional[Callable[[], int]]] = [None] * 256
+
+        def op(code: int):
+            def register(function):
+                cycles = CYCLES[code]
+                ops[code] = (lambda: function() or cycles)
+                return function
+            return register
+
+        # ALU rows: OR AND EOR CMP ADC SBC across the eight operand forms
+        alu = [self._or, self._and, self._eor, self._cmp, self._adc, self._sbc]
+        a_modes = {0x04: self._dp, 0x05: self._abs, 0x06: self._ind_x, 0x07: self._dp_x_ind,
+                   0x14: self._dp_x, 0x15: self._abs_x, 0x16: self._abs_y, 0x17: self._dp_ind_y}
+        for row, function in enumerate(alu):
+            base = row << 5
+            is_cmp = function == self._cmp
+            for column, mode in a_modes.items():
+                def a_mem(function=function, mode=mode, is_cmp=is_cmp):
+                    result = function(self.a, self.read(mode()))
+                    if not is_cmp:
+                        self.a = result
+                op(base + column)(a_mem)
+
+            def a_imm(function=function, is_cmp=is_cmp):
+                result = function(self.a, self.fetch())
+                if not is_cmp:
+                    self.a = result
+            op(base + 0x08)(a_imm)
+
+            def dp_dp(function=function, is_cmp=is_cmp):
+                source = self.read(self._dp())
+                target = self._dp()
+                result = function(self.read(target), source)
+                if not is_cmp:
+                    self.write(target, result)
+            op(base + 0x09)(dp_dp)
+
+            def dp_imm(function=function, is_cmp=is_cmp):
+                value = self.fetch()
+                target = self._dp()
+                result = function(self.read(target), value)
+                if not is_cmp:
+                    self.write(target, result)
+            op(base + 0x18)(dp_imm)
+
+            def x_y(function=function, is_cmp=is_cmp):
+                value = self.read(self._ind_y())
+                target = self._ind_x()
+                result = function(self.read(target), value)
+                if not is_cmp:
+                    self.write(target, result)
+            op(base + 0x19)(x_y)
+
+        # Shifts and increments on memory and A
+        shifts = {0x00: self._asl, 0x20: self._rol, 0x40: self._lsr, 0x60: self._ror, 0x80: self._dec, 0xA0: self._inc}
+        for base, function in shifts.items():
+            for column, mode in ((0x0B, self._dp), (0x1B, self._dp_x), (0x0C, self._abs)):
+                def modify(function=function, mode=mode):
+                    address = mode()
+                    self.write(address, function(self.read(address)))
+                op(base + column)(modify)
+
+            def modify_a(function=function):
+                self.a = function(self.a)
+            op(base + 0x1C)(modify_a)
+
+        # Branches on flags
+        branches = {
+            0x10: lambda: not self.n, 0x30: lambda: self.n, 0x50: lambda: not self.v, 0x70: lambda: self.v,
+            0x90: lambda: not self.c, 0xB0: lambda: self.c, 0xD0: lambda: not self.z, 0xF0: lambda: self.z,
+        }
+        for code, condition in branches.items():
+            ops[code] = (lambda code=code, condition=condition: self._branch(condition(), code))
+        ops[0x2F] = self._bra
+
+        # TCALL n, SET1/CLR1 dp.bit, BBS/BBC dp.bit
+        for n in range(16):
+            def tcall(n=n):
+                self.push(self.pc >> 8)
+                self.push(self.pc & 0xFF)
+                self.pc = self.read16(0xFFDE - 2 * n)
+            op((n << 4) | 0x01)(tcall)
+
+            bit = n >> 1
+            if n & 1:
+                def clr1(bit=bit):
+                    address = self._dp()
+                    self.write(address, self.read(address) & ~(1 << bit) & 0xFF)
+                op((n << 4) | 0x02)(clr1)
+                code = (n << 4) | 0x03
+                ops[code] = (lambda bit=bit, code=code: self._branch_bit(bit, False, code))
+            else:
+                def set1(bit=bit):
+                    address = self._dp()
+                    self.write(address, self.read(address) | (1 << bit))
+                op((n << 4) | 0x02)(set1)
+                code = (n << 4) | 0x03
+                ops[code] = (lambda bit=bit, code=code: self._branch_bit(bit, True, code))
+
+        # Loads and stores
+        for code, mode in ((0xE4, self._dp), (0xF4, self._dp_x), (0xE5, self._abs), (0xF5, self._abs_x),
+                           (0xE6, self._ind_x), (0xF6, self._abs_y), (0xE7, self._dp_x_ind), (0xF7, self._dp_ind_y)):
+            op(code)(lambda mode=mode: setattr(self, "a", self._set_nz(self.read(mode()))))
+        for code, mode in ((0xC4, self._dp), (0xD4, self._dp_x), (0xC5, self._abs), (0xD5, self._abs_x),
+                           (0xC6, self._ind_x), (0xD6, self._abs_y), (0xC7, self._dp_x_ind), (0xD7, self._dp_ind_y)):
+            op(code)(lambda mode=mode: self.write(mode(), self.a))
+        for code, mode in ((0xF8, self._dp), (0xF9, self._dp_y), (0xE9, self._abs)):
+            op(code)(lambda mode=mode: setattr(self, "x", self._set_nz(self.read(mode()))))
+        for code, mode in ((0xEB, self._dp), (0xFB, self._dp_x), (0xEC, self._abs)):
+            op(code)(lambda mode=mode: setattr(self, "y", self._set_nz(self.read(mode()))))
+        for code, mode in ((0xD8, self._dp), (0xD9, self._dp_y), (0xC9, self._abs)):
+            op(code)(lambda mode=mode: self.write(mode(), self.x))
+        for code, mode in ((0xCB, self._dp), (0xDB, self._dp_x), (0xCC, self._abs)):
+            op(code)(lambda mode=mode: self.write(mode(), self.y))
+
+        op(0xE8)(lambda: setattr(self, "a", self._set_nz(self.fetch())))
+        op(0xCD)(lambda: setattr(self, "x", self._set_nz(self.fetch())))
+        op(0x8D)(lambda: setattr(self, "y", self._set_nz(self.fetch())))
+        op(0x5D)(lambda: setattr(self, "x", self._set_nz(self.a)))
+        op(0x7D)(lambda: setattr(self, "a", self._set_nz(self.x)))
+        op(0xDD)(lambda: setattr(self, "a", self._set_nz(self.y)))
+        op(0xFD)(lambda: setattr(self, "y", self._set_nz(self.a)))
+        op(0x9D)(lambda: setattr(self, "x", self._set_nz(self.sp)))
+        op(0xBD)(lambda: setattr(self, "sp", self.x))
+
+        def mov_xinc_a():
+            self.write(self._ind_x(), self.a)
+            self.x = (self.x + 1) & 0xFF
+        op(0xAF)(mov_xinc_a)
+
+        def mov_a_xinc():
+            self.a = self._set_nz(self.read(self._ind_x()))
+            self.x = (self.x + 1) & 0xFF
+        op(0xBF)(mov_a_xinc)
+
+        def mov_dp_dp():
+            value = self.read(self._dp())
+            self.write(self._dp(), value)
+        op(0xFA)(mov_dp_dp)
+
+        def mov_dp_imm():
+            value = self.fetch()
+            self.write(self._dp(), value)
+        op(0x8F)(mov_dp_imm)
+
+        # Compares on X and Y
+        for code, register, mode in ((0xC8, "x", None), (0x3E, "x", self._dp), (0x1E, "x", self._abs),
+                                     (0xAD, "y", None), (0x7E, "y", self._dp), (0x5E, "y", self._abs)):
+            def compare(register=register, mode=mode):
+                value = self.fetch() if mode is None else self.read(mode())
+                self._cmp(getattr(self, register), value)
+            op(code)(compare)
+
+        # Register increments
+        op(0x1D)(lambda: setattr(self, "x", self._dec(self.x)))
+        op(0x3D)(lambda: setattr(self, "x", self._inc(self.x)))
+        op(0xDC)(lambda: setattr(self, "y", self._dec(self.y)))
+        op(0xFC)(lambda: setattr(self, "y", self._inc(self.y)))
+
+        # 16-bit operations
+        def incw():
+            offset = self.fetch()
+            value = (self.read_dp16(offset) + 1) & 0xFFFF
+            self.write_dp16(offset, value)
+            self.n, self.z = value & 0x8000, not value
+        op(0x3A)(incw)
+
+        def decw():
+            offset = self.fetch()
+            value = (self.read_dp16(offset) - 1) & 0xFFFF
+            self.write_dp16(offset, value)
+            self.n, self.z = value & 0x8000, not value
+        op(0x1A)(decw)
+
+        def addw():
+            ya = (self.y << 8) | self.a
+            value = self.read_dp16(self.fetch())
+            result = ya + value
+            self.c = result > 0xFFFF
+            self.h = (ya ^ value ^ result) & 0x1000
+            self.v = ~(ya ^ value) & (ya ^ result) & 0x8000
+            result &= 0xFFFF
+            self.y, self.a = result >> 8, result & 0xFF
+            self.n, self.z = result & 0x8000, not result
+        op(0x7A)(addw)
+
+        def subw():
+            ya = (self.y << 8) | self.a
+            value = self.read_dp16(self.fetch())
+            result = ya - value
+            self.c = result >= 0
+            self.h = not ((ya ^ value ^ result) & 0x1000)
+            self.v = (ya ^ value) & (ya ^ result) & 0x8000
+            result &= 0xFFFF
+            self.y, self.a = result >> 8, result & 0xFF
+            self.n, self.z = result & 0x8000, not result
+        op(0x9A)(subw)
+
+        def cmpw():
+            ya = (self.y << 8) | self.a
+            result = ya - self.read_dp16(self.fetch())
+            self.c = result >= 0
+            result &= 0xFFFF
+            self.n, self.z = result & 0x8000, not result
+        op(0x5A)(cmpw)
+
+        def movw_ya_dp():
+            value = self.read_dp16(self.fetch())
+            self.y, self.a = value >> 8, value & 0xFF
+            self.n, self.z = value & 0x8000, not value
+        op(0xBA)(movw_ya_dp)
+
+        op(0xDA)(lambda: self.write_dp16(self.fetch(), (self.y << 8) | self.a))
+
+        def mul():
+            result = self.y * self.a
+            self.y, self.a = result >> 8, result & 0xFF
+            self._set_nz(self.y)
+        op(0xCF)(mul)
+
+        def div():
+            ya = (self.y << 8) | self.a
+            x = self.x
+            self.h = (self.y & 0x0F) >= (x & 0x0F)
+            self.v = self.y >= x
+            # Hardware algorithm, including its results for quotients over 255
+            if self.y < (x << 1):
+                quotient, remainder = (ya // x, ya % x) if x else (0xFF, ya & 0xFF)
+            else:
+                quotient = 255 - (ya - (x << 9)) // (256 - x)
+                remainder = x + (ya - (x << 9)) % (256 - x)
+            self.a = quotient & 0xFF
+            self.y = remainder & 0xFF
+            self._set_nz(self.a)
+        op(0x9E)(div)
+
+        def daa():
+            if self.c or self.a > 0x99:
+                self.a = (self.a + 0x60) & 0xFF
+                self.c = 1
+            if self.h or (self.a & 0x0F) > 0x09:
+                self.a = (self.a + 0x06) & 0xFF
+            self._set_nz(self.a)
+        op(0xDF)(daa)
+
+        def das():
+            if not self.c or self.a > 0x99:
+                self.a = (self.a - 0x60) & 0xFF
+                self.c = 0
+            if not self.h or (self.a & 0x0F) > 0x09:
+                self.a = (self.a - 0x06) & 0xFF
+            self._set_nz(self.a)
+        op(0xBE)(das)
+
+        op(0x9F)(lambda: setattr(self, "a", self._set_nz(((self.a >> 4) | (self.a << 4)) & 0xFF)))
+
+        # Bit operations on mem.bit
+        def or1(invert: bool):
+            address, bit = self._mem_bit()
+            value = (self.read(address) >> bit) & 1
+            self.c = 1 if self.c or (value ^ invert) else 0
+        op(0x0A)(lambda: or1(False))
+        op(0x2A)(lambda: or1(True))
+
+        def and1(invert: bool):
+            address, bit = self._mem_bit()
+            value = (self.read(address) >> bit) & 1
+            self.c = 1 if self.c and (value ^ invert) else 0
+        op(0x4A)(lambda: and1(False))
+        op(0x6A)(lambda: and1(True))
+
+        def eor1():
+            address, bit = self._mem_bit()
+            self.c = (1 if self.c else 0) ^ ((self.read(address) >> bit) & 1)
+        op(0x8A)(eor1)
+
+        def mov1_c():
+            address, bit = self._mem_bit()
+            self.c = (self.read(address) >> bit) & 1
+        op(0xAA)(mov1_c)
+
+        def mov1_mem():
+            address, bit = self._mem_bit()
+            value = self.read(address) & ~(1 << bit) & 0xFF
+            self.write(address, value | ((1 if self.c else 0) << bit))
+        op(0xCA)(mov1_mem)
+
+        def not1():
+            address, bit = self._mem_bit()
+            self.write(address, self.read(address) ^ (1 << bit))
+        op(0xEA)(not1)
+
+        def tset1():
+            address = self._abs()
+            value = self.read(address)
+            self._set_nz((self.a - value) & 0xFF)
+            self.write(address, value | self.a)
+        op(0x0E)(tset1)
+
+        def tclr1():
+            address = self._abs()
+            value = self.read(address)
+            self._set_nz((self.a - value) & 0xFF)
+            self.write(address, value & ~self.a & 0xFF)
+        op(0x4E)(tclr1)
+
+        # Loops
+        def cbne(mode):
+            value = self.read(mode())
+            return self._branch(value != self.a, 0x2E if mode == self._dp else 0xDE)
+        ops[0x2E] = lambda: cbne(self._dp)
+        ops[0xDE] = lambda: cbne(self._dp_x)
+
+        def dbnz_dp():
+            address = self._dp()
+            value = (self.read(address) - 1) & 0xFF
+            self.write(address, value)
+            return self._branch(value != 0, 0x6E)
+        ops[0x6E] = dbnz_dp
+
+        def dbnz_y():
+            self.y = (self.y - 1) & 0xFF
+            return self._branch(self.y != 0, 0xFE)
+        ops[0xFE] = dbnz_y
+
+        # Flow control
+        op(0x5F)(lambda: setattr(self, "pc", self._abs()))
+        op(0x1F)(lambda: setattr(self, "pc", self.read16(self._abs_x())))
+
+        def call():
+            target = self._abs()
+            self.push(self.pc >> 8)
+            self.push(self.pc & 0xFF)
+            self.pc = target
+        op(0x3F)(call)
+
+        def pcall():
+            target = 0xFF00 | self.fetch()
+            self.push(self.pc >> 8)
+            self.push(self.pc & 0xFF)
+            self.pc = target
+        op(0x4F)(pcall)
+
+        def ret():
+            low = self.pop()
+            self.pc = low | (self.pop() << 8)
+        op(0x6F)(ret)
+
+        def reti():
+            self.psw = self.pop()
+            low = self.pop()
+            self.pc = low | (self.pop() << 8)
+        op(0x7F)(reti)
+
+        def brk():
+            self.push(self.pc >> 8)
+            self.push(self.pc & 0xFF)
+            self.push(self.psw)
+            self.b, self.i = 1, 0
+            self.pc = self.read16(0xFFDE)
+        op(0x0F)(brk)
+
+        # Stack
+        op(0x0D)(lambda: self.push(self.psw))
+        op(0x2D)(lambda: self.push(self.a))
+        op(0x4D)(lambda: self.push(self.x))
+        op(0x6D)(lambda: self.push(self.y))
+        op(0x8E)(lambda: setattr(self, "psw", self.pop()))
+        op(0xAE)(lambda: setattr(self, "a", self.pop()))
+        op(0xCE)(lambda: setattr(self, "x", self.pop()))
+        op(0xEE)(lambda: setattr(self, "y", self.pop()))
+
+        # Flags and misc
+        op(0x00)(lambda: None)
+        op(0x20)(lambda: setattr(self, "p", 0))
+        op(0x40)(lambda: setattr(self, "p", FLAG_P))
+        op(0x60)(lambda: setattr(self, "c", 0))
+        op(0x80)(lambda: setattr(self, "c", 1))
+        op(0xA0)(lambda: setattr(self, "i", FLAG_I))
+        op(0xC0)(lambda: setattr(self, "i", 0))
+        op(0xE0)(lambda: (setattr(self, "v", 0), setattr(self, "h", 0)) and None)
+        op(0xED)(lambda: setattr(self, "c", 0 if self.c else 1))
+
+        def halt():
+            self.stopped = True
+        op(0xEF)(halt)
+        op(0xFF)(halt)
+
+        missing = [code for code, function in enumerate(ops) if function is None]
+        if missing:
+            raise RuntimeError(f"Unimplemented SPC700 opcodes: {', '.join(f'${code:02X}' for code in missing)}")
+        return ops
+
+    def _branch_bit(self, bit: int, when_set: bool, opcode: int) -> int:
+        value = self.read(self._dp())
+        return self._branch(bool(value & (1 << bit)) == when_set, opcode)
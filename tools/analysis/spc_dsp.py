@@ -0,0 +1,429 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - S-DSP Voice Renderer
+=======================================
+
+The sound chip behind the SPC700: eight BRR voices with pitch (and pitch
+modulation), Gaussian interpolation, ADSR/GAIN envelopes, the noise
+generator, volume mixing and the echo unit with its 8-tap FIR, reading
+samples and the echo buffer straight from the shared audio RAM.
+
+render() produces a block of 32 kHz stereo samples at a time, voice by
+voice, from the register values at the start of the block; the caller
+runs the CPU for the matching 32 cycles per sample in between. Register
+writes therefore land on block boundaries rather than on the exact sample,
+which is inaudible at the default block of 16 samples (0.5 ms).
+"""
+
+from array import array
+from typing import List, Tuple
+
+from brr_codec import BLOCK_SIZE, FLAG_END, FLAG_LOOP, decode_brr
+
+SAMPLE_RATE = 32000
+CYCLES_PER_SAMPLE = 32
+
+# Global registers
+REG_MVOLL = 0x0C
+REG_MVOLR = 0x1C
+REG_EVOLL = 0x2C
+REG_EVOLR = 0x3C
+REG_KON = 0x4C
+REG_KOFF = 0x5C
+REG_FLG = 0x6C
+REG_ENDX = 0x7C
+REG_EFB = 0x0D
+REG_PMON = 0x2D
+REG_NON = 0x3D
+REG_EON = 0x4D
+REG_DIR = 0x5D
+REG_ESA = 0x6D
+REG_EDL = 0x7D
+
+# Per-voice registers (voice number in the high nibble)
+V_VOLL, V_VOLR, V_PITCHL, V_PITCHH, V_SRCN, V_ADSR1, V_ADSR2, V_GAIN, V_ENVX, V_OUTX = range(10)
+
+FLG_RESET = 0x80
+FLG_MUTE = 0x40
+FLG_ECHO_OFF = 0x20
+
+ATTACK, DECAY, SUSTAIN, RELEASE = range(4)
+
+# Samples between envelope/noise steps for each rate (0 = never), and each rate's phase
+RATE_PERIODS = (
+    0, 2048, 1536, 1280, 1024, 768, 640, 512, 384, 320, 256, 192, 160, 128, 96, 80,
+    64, 48, 40, 32, 24, 20, 16, 12, 10, 8, 6, 5, 4, 3, 2, 1,
+)
+RATE_OFFSETS = (
+    1, 0, 1040, 536, 0, 1040, 536, 0, 1040, 536, 0, 1040, 536, 0, 1040, 536,
+    0, 1040, 536, 0, 1040, 536, 0, 1040, 536, 0, 1040, 536, 0, 1040, 0, 0,
+)
+
+
+# Interpolation weights by distance from the output point, 256 steps per sample: the S-DSP's
+# own table, ascending to the peak; the four taps of any offset sum to 2047-2049 (unity 2048)
+GAUSSIAN = (
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+    2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 5,
+    6, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 10,
+    11, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15, 15, 16, 16, 17, 17,
+    18, 19, 19, 20, 20, 21, 21, 22, 23, 23, 24, 24, 25, 26, 27, 27,
+    28, 29, 29, 30, 31, 32, 32, 33, 34, 35, 36, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56,
+    58, 59, 60, 61, 62, 64, 65, 66, 67, 69, 70, 71, 73, 74, 76, 77,
+    78, 80, 81, 83, 84, 86, 87, 89, 90, 92, 94, 95, 97, 99, 100, 102,
+    104, 106, 107, 109, 111, 113, 115, 117, 118, 120, 122, 124, 126, 128, 130, 132,
+    134, 137, 139, 141, 143, 145, 147, 150, 152, 154, 156, 159, 161, 163, 166, 168,
+    171, 173, 175, 178, 180, 183, 186, 188, 191, 193, 196, 199, 201, 204, 207, 210,
+    212, 215, 218, 221, 224, 227, 230, 233, 236, 239, 242, 245, 248, 251, 254, 257,
+    260, 263, 267, 270, 273, 276, 280, 283, 286, 290, 293, 297, 300, 304, 307, 311,
+    314, 318, 321, 325, 328, 332, 336, 339, 343, 347, 351, 354, 358, 362, 366, 370,
+    374, 378, 381, 385, 389, 393, 397, 401, 405, 410, 414, 418, 422, 426, 430, 434,
+    439, 443, 447, 451, 456, 460, 464, 469, 473, 477, 482, 486, 491, 495, 499, 504,
+    508, 513, 517, 522, 527, 531, 536, 540, 545, 550, 554, 559, 563, 568, 573, 577,
+    582, 587, 592, 596, 601, 606, 611, 615, 620, 625, 630, 635, 640, 644, 649, 654,
+    659, 664, 669, 674, 678, 683, 688, 693, 698, 703, 708, 713, 718, 723, 728, 732,
+    737, 742, 747, 752, 757, 762, 767, 772, 777, 782, 787, 792, 797, 802, 806, 811,
+    816, 821, 826, 831, 836, 841, 846, 851, 855, 860, 865, 870, 875, 880, 884, 889,
+    894, 899, 904, 908, 913, 918, 923, 927, 932, 937, 941, 946, 951, 955, 960, 965,
+    969, 974, 978, 983, 988, 992, 997, 1001, 1005, 1010, 1014, 1019, 1023, 1027, 1032, 1036,
+    1040, 1045, 1049, 1053, 1057, 1061, 1066, 1070, 1074, 1078, 1082, 1086, 1090, 1094, 1098, 1102,
+    1106, 1109, 1113, 1117, 1121, 1125, 1128, 1132, 1136, 1139, 1143, 1146, 1150, 1153, 1157, 1160,
+    1164, 1167, 1170, 1174, 1177, 1180, 1183, 1186, 1190, 1193, 1196, 1199, 1202, 1205, 1207, 1210,
+    1213, 1216, 1219, 1221, 1224, 1227, 1229, 1232, 1234, 1237, 1239, 1241, 1244, 1246, 1248, 1251,
+    1253, 1255, 1257, 1259, 1261, 1263, 1265, 1267, 1269, 1270, 1272, 1274, 1275, 1277, 1279, 1280,
+    1282, 1283, 1284, 1286, 1287, 1288, 1290, 1291, 1292, 1293, 1294, 1295, 1296, 1297, 1297, 1298,
+    1299, 1300, 1300, 1301, 1302, 1302, 1303, 1303, 1303, 1304, 1304, 1304, 1304, 1304, 1305, 1305,
+)
+
+
+def _signed(value: int) -> int:
+    return value - 0x100 if value & 0x80 else value
+
+
+def _clamp16(value: int) -> int:
+    return 32767 if value > 32767 else -32768 if value < -32768 else value
+
+
+def _wrap16(value: int) -> int:
+    return ((value + 0x8000) & 0xFFFF) - 0x8000
+
+
+class Voice:
+    """Playback state of one voice"""
+
+    def __init__(self):
+        self.buffer: List[int] = [0, 0, 0]
+        self.position = 0  # 4.12 fixed point into buffer
+        self.address = 0  # Next BRR block
+        self.history = (0, 0)
+        self.envelope = 0
+        self.hidden_envelope = 0
+        self.mode = RELEASE
+        self.playing = False
+        self.output = 0
+
+    def key_on(self, address: int):
+        self.buffer = [0, 0, 0]
+        self.position = 0
+        self.address = address
+        self.history = (0, 0)
+        self.envelope = 0
+        self.hidden_envelope = 0
+        self.mode = ATTACK
+        self.playing = True
+
+
+class SDSP:
+    """S-DSP registers and voices over a shared audio RAM"""
+
+    def __init__(self, ram: bytearray):
+        self.ram = ram
+        self.regs = bytearray(128)
+        self.regs[REG_FLG] = FLG_RESET | FLG_MUTE | FLG_ECHO_OFF
+        self.voices = [Voice() for _ in range(8)]
+        self._key_on = 0
+        self.counter = 0  # Samples rendered (drives envelope and noise rates)
+        self.noise = 0x4000
+        self.echo_offset = 0
+        self.echo_history = ([0] * 8, [0] * 8)
+
+    # ------------------------------------------------------------------ register interface
+
+    def read(self, register: int) -> int:
+        return self.regs[register & 0x7F]
+
+    def write(self, register: int, value: int):
+        self.regs[register] = value
+        if register == REG_KON:
+            self._key_on |= value
+        elif register == REG_ENDX:
+            self.regs[REG_ENDX] = 0
+
+    def load_registers(self, registers: bytes):
+        """Restore a register snapshot; voices with a live envelope resume from their source start"""
+        self.regs[:] = registers[:128]
+        self._key_on = 0
+        for index, voice in enumerate(self.voices):
+            if registers[(index << 4) | V_ENVX]:
+                voice.key_on(self._source_address(index, 0))
+                voice.mode = SUSTAIN if registers[(index << 4) | V_ADSR1] & 0x80 else ATTACK
+                voice.envelope = voice.hidden_envelope = registers[(index << 4) | V_ENVX] << 4
+
+    # ------------------------------------------------------------------ sample sources
+
+    def _source_address(self, voice: int, entry: int) -> int:
+        """Start (entry 0) or loop (entry 2) address of a voice's sample from the directory"""
+        directory = (self.regs[REG_DIR] << 8) + self.regs[(voice << 4) | V_SRCN] * 4 + entry
+        return self.ram[directory & 0xFFFF] | (self.ram[(directory + 1) & 0xFFFF] << 8)
+
+    def _decode_block(self, index: int, voice: Voice) -> bool:
+        """Append the voice's next BRR block to its buffer; False once a non-looping sample ends"""
+        address = voice.address
+        if address + BLOCK_SIZE <= 0x10000:
+            block = decode_brr(self.ram, address, 1, voice.history)
+        else:
+            wrapped = bytes(self.ram[address:]) + bytes(self.ram[: BLOCK_SIZE])
+            block = decode_brr(wrapped, 0, 1, voice.history)
+        header = self.ram[address]
+        voice.buffer.extend(block.pcm)
+        voice.history = (block.pcm[-1], block.pcm[-2])
+        voice.address = (address + BLOCK_SIZE) & 0xFFFF
+
+        if header & FLAG_END:
+            self.regs[REG_ENDX] |= 1 << index
+            if not header & FLAG_LOOP:
+                return False
+            voice.address = self._source_address(index, 2)
+        return True
+
+    def _noise_samples(self, count: int) -> List[int]:
+        rate = self.regs[REG_FLG] & 0x1F
+        period, offset = RATE_PERIODS[rate], RATE_OFFSETS[rate]
+        noise = self.noise
+        samples = []
+        for step in range(self.counter, self.counter + count):
+            if period and (step + offset) % period == 0:
+                feedback = (noise << 13) ^ (noise << 14)
+                noise = (feedback & 0x4000) ^ (noise >> 1)
+            samples.append(((noise << 1) & 0xFFFF) - (0x10000 if noise & 0x4000 else 0))
+        self.noise = noise
+        return samples
+
+    # ------------------------------------------------------------------ rendering
+
+    def _render_voice(self, index: int, count: int, noise, modulator) -> List[int]:
+        """The voice's output for count samples (envelope applied, before volume)"""
+        voice = self.voices[index]
+        regs = self.regs
+        base = index << 4
+        pitch = (regs[base | V_PITCHL] | (regs[base | V_PITCHH] << 8)) & 0x3FFF
+        adsr1, adsr2, gain = regs[base | V_ADSR1], regs[base | V_ADSR2], regs[base | V_GAIN]
+        use_noise = regs[REG_NON] & (1 << index)
+        modulated = index and regs[REG_PMON] & (1 << index)
+        sustain_level = adsr2 >> 5
+
+        buffer = voice.buffer
+        position = voice.position
+        envelope = voice.envelope
+        hidden = voice.hidden_envelope
+        mode = voice.mode
+        playing = voice.playing
+        gaussian = GAUSSIAN
+        counter = self.counter
+        outputs = []
+
+        for step in range(count):
+            if mode == RELEASE and envelope == 0:
+                playing = False
+                outputs.extend([0] * (count - step))
+                break
+
+            sample_index = position >> 12
+            while playing and sample_index + 3 >= len(buffer):
+                if not self._decode_block(index, voice):
+                    playing = False
+                    mode, envelope = RELEASE, 0
+            if sample_index + 3 >= len(buffer):
+                outputs.append(0)
+                continue
+
+            if use_noise:
+                sample = noise[step]
+            else:
+                offset = (position >> 4) & 0xFF
+                sample = (gaussian[255 - offset] * buffer[sample_index]) >> 11
+                sample += (gaussian[511 - offset] * buffer[sample_index + 1]) >> 11
+                sample += (gaussian[256 + offset] * buffer[sample_index + 2]) >> 11
+                sample = ((sample + 0x8000) & 0xFFFF) - 0x8000
+                sample += (gaussian[offset] * buffer[sample_index + 3]) >> 11
+                sample = _clamp16(sample) & ~1
+
+            # Envelope
+            if mode == RELEASE:
+                envelope = max(0, envelope - 8)
+                hidden = envelope
+            else:
+                if adsr1 & 0x80:
+                    if mode >= DECAY:
+                        candidate = envelope - 1 - ((envelope - 1) >> 8)
+                        rate = (adsr2 & 0x1F) if mode == SUSTAIN else ((adsr1 >> 3) & 0x0E) + 0x10
+                    else:
+                        rate = ((adsr1 & 0x0F) << 1) + 1
+                        candidate = envelope + (0x400 if rate == 31 else 0x20)
+                elif not gain & 0x80:
+                    candidate = (gain & 0x7F) << 4
+                    rate = 31
+                else:
+                    rate = gain & 0x1F
+                    gain_mode = (gain >> 5) & 3
+                    if gain_mode == 0:
+                        candidate = envelope - 0x20
+                    elif gain_mode == 1:
+                        candidate = envelope - 1 - ((envelope - 1) >> 8)
+                    elif gain_mode == 2:
+                        candidate = envelope + 0x20
+                    else:
+                        candidate = envelope + (8 if hidden >= 0x600 else 0x20)
+
+                if mode == DECAY and (candidate >> 8) == sustain_level:
+                    mode = SUSTAIN
+                hidden = candidate
+                if candidate < 0 or candidate > 0x7FF:
+                    candidate = 0 if candidate < 0 else 0x7FF
+                    if mode == ATTACK:
+                        mode = DECAY
+                period = RATE_PERIODS[rate]
+                if period and (counter + step + RATE_OFFSETS[rate]) % period == 0:
+                    envelope = candidate
+
+            outputs.append(((sample * envelope) >> 11) & ~1)
+
+            step_pitch = pitch
+            if modulated:
+                step_pitch = min(0x7FFF, max(0, pitch + (((modulator[step] >> 5) * pitch) >> 10)))
+            position += step_pitch
+
+        # Drop played samples, keeping the three the next interpolation needs
+        played = position >> 12
+        if played > 64:
+            del buffer[:played]
+            position -= played << 12
+
+        voice.position = position
+        voice.envelope = envelope
+        voice.hidden_envelope = hidden
+        voice.mode = mode
+        voice.playing = playing
+        voice.output = outputs[-1] if outputs else 0
+        regs[base | V_ENVX] = envelope >> 4
+        regs[base | V_OUTX] = (voice.output >> 8) & 0xFF
+        return outputs
+
+    def render(self, count: int) -> Tuple[array, array]:
+        """count stereo samples as (left, right) int16 arrays"""
+        regs = self.regs
+
+        # Key on/off and soft reset apply at the start of the block
+        key_on, self._key_on = self._key_on, 0
+        key_off = regs[REG_KOFF]
+        for index, voice in enumerate(self.voices):
+            bit = 1 << index
+            if key_on & bit:
+                voice.key_on(self._source_address(index, 0))
+                regs[REG_ENDX] &= ~bit
+            elif key_off & bit and voice.mode != RELEASE:
+                voice.mode = RELEASE
+        if regs[REG_FLG] & FLG_RESET:
+            for voice in self.voices:
+                voice.mode, voice.envelope, voice.playing = RELEASE, 0, False
+
+        noise = self._noise_samples(count) if regs[REG_NON] else None
+        dry_left = [0] * count
+        dry_right = [0] * count
+        wet_left = [0] * count
+        wet_right = [0] * count
+        echo_voices = regs[REG_EON]
+        previous = [0] * count
+
+        for index in range(8):
+            voice = self.voices[index]
+            if not voice.playing and voice.envelope == 0:
+                previous = [0] * count
+                continue
+            outputs = self._render_voice(index, count, noise, previous)
+            previous = outputs
+            volume_left = _signed(regs[(index << 4) | V_VOLL])
+            volume_right = _signed(regs[(index << 4) | V_VOLR])
+            # The hardware saturates the dry and echo sums as each voice is added
+            for step, output in enumerate(outputs):
+                dry_left[step] = _clamp16(dry_left[step] + ((output * volume_left) >> 7))
+                dry_right[step] = _clamp16(dry_right[step] + ((output * volume_right) >> 7))
+            if echo_voices & (1 << index):
+                for step, output in enumerate(outputs):
+                    wet_left[step] = _clamp16(wet_left[step] + ((output * volume_left) >> 7))
+                    wet_right[step] = _clamp16(wet_right[step] + ((output * volume_right) >> 7))
+
+        left, right = self._mix(count, dry_left, dry_right, wet_left, wet_right)
+        self.counter += count
+        return left, right
+
+    def _mix(self, count: int, dry_left, dry_right, wet_left, wet_right) -> Tuple[array, array]:
+        """Main volume, echo read/FIR/feedback/write, mute"""
+        regs = self.regs
+        ram = self.ram
+        main_left, main_right = _signed(regs[REG_MVOLL]), _signed(regs[REG_MVOLR])
+        echo_left, echo_right = _signed(regs[REG_EVOLL]), _signed(regs[REG_EVOLR])
+        feedback = _signed(regs[REG_EFB])
+        fir = [_signed(regs[(tap << 4) | 0x0F]) for tap in range(8)]
+        flags = regs[REG_FLG]
+        echo_base = regs[REG_ESA] << 8
+        echo_length = (regs[REG_EDL] & 0x0F) * 0x800 or 4
+        history_left, history_right = self.echo_history
+        offset = self.echo_offset
+        write_echo = not flags & FLG_ECHO_OFF
+
+        left = array("h", bytes(2 * count))
+        right = array("h", bytes(2 * count))
+        if not write_echo and (flags & FLG_MUTE or not (echo_left or echo_right)):
+            # Echo neither heard nor written: only the buffer position moves
+            self.echo_offset = (offset + 4 * count) % echo_length
+            if not flags & FLG_MUTE:
+                for step in range(count):
+                    left[step] = _clamp16((dry_left[step] * main_left) >> 7)
+                    right[step] = _clamp16((dry_right[step] * main_right) >> 7)
+            return left, right
+
+        for step in range(count):
+            address = (echo_base + offset) & 0xFFFF
+            stored_left = ram[address] | (ram[(address + 1) & 0xFFFF] << 8)
+            stored_right = ram[(address + 2) & 0xFFFF] | (ram[(address + 3) & 0xFFFF] << 8)
+            history_left.append((stored_left - (0x10000 if stored_left & 0x8000 else 0)) >> 1)
+            history_right.append((stored_right - (0x10000 if stored_right & 0x8000 else 0)) >> 1)
+            del history_left[0], history_right[0]
+
+            # Taps 0-6 wrap to 16 bits; only adding the last (newest) tap saturates
+            fir_left = _wrap16(sum((history_left[tap] * fir[tap]) >> 6 for tap in range(7)))
+            fir_right = _wrap16(sum((history_right[tap] * fir[tap]) >> 6 for tap in range(7)))
+            fir_left = _clamp16(fir_left + ((history_left[7] * fir[7]) >> 6)) & ~1
+            fir_right = _clamp16(fir_right + ((history_right[7] * fir[7]) >> 6)) & ~1
+
+            if not flags & FLG_MUTE:
+                left[step] = _clamp16(((dry_left[step] * main_left) >> 7) + ((fir_left * echo_left) >> 7))
+                right[step] = _clamp16(((dry_right[step] * main_right) >> 7) + ((fir_right * echo_right) >> 7))
+
+            if write_echo:
+                in_left = _clamp16(wet_left[step] + ((fir_left * feedback) >> 7)) & ~1
+                in_right = _clamp16(wet_right[step] + ((fir_right * feedback) >> 7)) & ~1
+                ram[address] = in_left & 0xFF
+                ram[(address + 1) & 0xFFFF] = (in_left >> 8) & 0xFF
+                ram[(address + 2) & 0xFFFF] = in_right & 0xFF
+                ram[(address + 3) & 0xFFFF] = (in_right >> 8) & 0xFF
+
+            offset += 4
+            if offset >= echo_length:
+                offset = 0
+
+        self.echo_offset = offset
+        return left, right
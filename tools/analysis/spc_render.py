@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Headless SPC Renderer
+========================================
+
+Runs the game's sound driver on the SPC700 core and S-DSP and records the
+output, so music and sound effects can be rendered to PCM/WAV in bulk
+without an emulator front end.
+
+The driver comes either from an .spc snapshot or straight from the ROM:
+the main CPU uploads it through the IPL boot protocol as a list of blocks
+(size, APU address, bytes) ended by a zero size and the entry address, and
+that list is copied into audio RAM directly. Tracks are then started the way
+the game starts them, by timed writes to the four APU ports. Each track
+renders from a fresh boot in its own worker process.
+"""
+
+import os
+import struct
+import sys
+import wave
+from array import array
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import List, Optional, Sequence, Tuple, Union
+
+from spc700 import SPC700
+from spc_dsp import CYCLES_PER_SAMPLE, SAMPLE_RATE, SDSP
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+SPC_SIGNATURE = b"SNES-SPC700 Sound File Data"
+SPC_RAM_OFFSET = 0x100
+SPC_DSP_OFFSET = 0x10100
+SPC_EXTRA_RAM_OFFSET = 0x101C0
+SPC_FILE_SIZE = 0x10200
+
+# Samples rendered per CPU/DSP interleave step
+BLOCK_SAMPLES = 16
+
+# Upload lists worth reporting as a sound driver
+MIN_UPLOAD_SIZE = 0x400
+MAX_UPLOAD_BLOCKS = 32
+
+# Peak below which output counts as silence
+SILENCE_LEVEL = 16
+
+
+@dataclass
+class PortWrite:
+    """Value the main CPU writes to an APU port ($2140 + port) at a point in time"""
+
+    time: float
+    port: int
+    value: int
+
+
+@dataclass
+class TrackRequest:
+    """One render: the port writes that start it and how long to record"""
+
+    name: str
+    commands: List[PortWrite] = field(default_factory=list)
+    seconds: float = 30.0
+    stop_after_silence: Optional[float] = None
+
+
+@dataclass
+class UploadStream:
+    """A driver upload list found in the ROM"""
+
+    offset: int
+    blocks: List[Tuple[int, bytes]]  # (APU address, data)
+    entry: int
+
+    @property
+    def size(self) -> int:
+        return sum(len(data) for _, data in self.blocks)
+
+    @property
+    def end(self) -> int:
+        """ROM offset just past the list"""
+        return self.offset + sum(4 + len(data) for _, data in self.blocks) + 4
+
+
+def _walk_upload(data: Buffer, offset: int, max_blocks: int = MAX_UPLOAD_BLOCKS):
+    """(blocks as (address, size, data offset), entry) of the list at offset, or None"""
+    blocks = []
+    position = offset
+    end = len(data)
+    while len(blocks) <= max_blocks:
+        if position + 4 > end:
+            return None
+        size, address = struct.unpack_from("<HH", data, position)
+        position += 4
+        if size == 0:
+            if blocks and any(start <= address < start + length for start, length, _ in blocks):
+                return blocks, address
+            return None
+        if address + size > 0x10000 or position + size > end:
+            return None
+        # Real lists never upload the same APU memory twice
+        for start, length, _ in blocks:
+            if address < start + length and start < address + size:
+                return None
+        blocks.append((address, size, position))
+        position += size
+    return None
+
+
+def read_upload_stream(data: Buffer, offset: int) -> UploadStream:
+    """Parse the upload list at offset; ValueError if it is not one"""
+    walked = _walk_upload(data, offset, max_blocks=0x100)
+    if walked is None:
+        raise ValueError(f"No driver upload list at 0x{offset:06X}")
+    blocks, entry = walked
+    return UploadStream(offset, [(address, bytes(data[start : start + size])) for address, size, start in blocks], entry)
+
+
+def find_upload_streams(data: Buffer, min_size: int = MIN_UPLOAD_SIZE, strict: bool = True) -> List[UploadStream]:
+    """
+    Upload lists of at least min_size bytes, up to MAX_UPLOAD_BLOCKS blocks with disjoint APU
+    ranges, whose entry point lies in what they upload (strict: is the start of a block, as
+    when the main CPU jumps to the driver's load address). Chains that run into a list
+    part-way share its terminator; of those only the one with the most blocks is kept.
+    """
+    data = bytes(data)
+    by_end = {}
+    limit = len(data) - 8
+    walk = _walk_upload
+    for offset in range(limit):
+        walked = walk(data, offset)
+        if not walked:
+            continue
+        blocks, entry = walked
+        if sum(size for _, size, _ in blocks) < min_size:
+            continue
+        if strict and not any(address == entry for address, _, _ in blocks):
+            continue
+        end = blocks[-1][2] + blocks[-1][1]
+        if end not in by_end or len(blocks) > len(by_end[end][1]):
+            by_end[end] = (offset, blocks)
+
+    streams = []
+    claimed = -1
+    for end, (offset, blocks) in sorted(by_end.items(), key=lambda item: item[1][0]):
+        if offset >= claimed:
+            streams.append(read_upload_stream(data, offset))
+            claimed = end + 4
+    return streams
+
+
+class APU:
+    """SPC700, S-DSP and their shared RAM"""
+
+    def __init__(self):
+        self.cpu = SPC700()
+        self.dsp = SDSP(self.cpu.ram)
+        self.cpu.dsp = self.dsp
+
+    @classmethod
+    def from_spc(cls, snapshot: Buffer) -> "APU":
+        """Restore an .spc snapshot (CPU registers, RAM, DSP registers)"""
+        if bytes(snapshot[: len(SPC_SIGNATURE)]) != SPC_SIGNATURE or len(snapshot) < SPC_DSP_OFFSET + 128:
+            raise ValueError("Not an SPC snapshot")
+        pc, a, x, y, psw, sp = struct.unpack_from("<HBBBBB", snapshot, 0x25)
+        apu = cls()
+        ram = bytearray(snapshot[SPC_RAM_OFFSET : SPC_RAM_OFFSET + 0x10000])
+        if len(snapshot) >= SPC_FILE_SIZE:
+            # RAM under the IPL ROM is stored separately
+            ram[0xFFC0:] = snapshot[SPC_EXTRA_RAM_OFFSET:SPC_FILE_SIZE]
+        apu.cpu.load_state(ram, pc, a, x, y, psw, sp)
+        apu.dsp.load_registers(bytes(snapshot[SPC_DSP_OFFSET : SPC_DSP_OFFSET + 128]))
+        return apu
+
+    @classmethod
+    def from_upload(cls, stream: UploadStream) -> "APU":
+        """State right after the IPL has received stream and jumped to its entry point"""
+        apu = cls()
+        for address, data in stream.blocks:
+            apu.cpu.ram[address : address + len(data)] = data
+        apu.cpu.pc = stream.entry
+        apu.cpu.sp = 0xEF
+        apu.cpu.control = 0x80
+        return apu
+
+    @classmethod
+    def boot(cls, source: Union[Buffer, UploadStream]) -> "APU":
+        return cls.from_upload(source) if isinstance(source, UploadStream) else cls.from_spc(source)
+
+    def write_port(self, port: int, value: int):
+        self.cpu.ports_in[port & 3] = value & 0xFF
+
+    def read_port(self, port: int) -> int:
+        return self.cpu.ports_out[port & 3]
+
+    def render(self, seconds: float, commands: Sequence[PortWrite] = (),
+               stop_after_silence: Optional[float] = None) -> Tuple[array, array]:
+        """
+        Run for seconds, applying each port write at its time; returns (left, right) int16
+        With stop_after_silence, ends early once the output has been silent that long after
+        the last write.
+        """
+        total = int(seconds * SAMPLE_RATE)
+        pending = sorted(commands, key=lambda command: command.time)
+        last_command = int(pending[-1].time * SAMPLE_RATE) if pending else 0
+        silence_limit = int(stop_after_silence * SAMPLE_RATE) if stop_after_silence else 0
+        left, right = array("h"), array("h")
+        silent = 0
+        next_command = 0
+
+        for start in range(0, total, BLOCK_SAMPLES):
+            while next_command < len(pending) and pending[next_command].time * SAMPLE_RATE <= start:
+                command = pending[next_command]
+                self.write_port(command.port, command.value)
+                next_command += 1
+
+            count = min(BLOCK_SAMPLES, total - start)
+            self.cpu.run(count * CYCLES_PER_SAMPLE)
+            block_left, block_right = self.dsp.render(count)
+            left.extend(block_left)
+            right.extend(block_right)
+
+            if silence_limit and start >= last_command:
+                loud = max(max(map(abs, block_left)), max(map(abs, block_right))) >= SILENCE_LEVEL
+                silent = 0 if loud else silent + count
+                if silent >= silence_limit:
+                    break
+        return left, right
+
+
+def write_stereo_wav(path: Union[str, Path], left: array, right: array, sample_rate: int = SAMPLE_RATE):
+    """16-bit stereo WAV from separate channels"""
+    frames = array("h", bytes(4 * len(left)))
+    frames[0::2] = left
+    frames[1::2] = right
+    if sys.byteorder != "little":
+        frames.byteswap()
+    with wave.open(str(path), "wb") as wav:
+        wav.setnchannels(2)
+        wav.setsampwidth(2)
+        wav.setframerate(sample_rate)
+        wav.writeframes(frames.tobytes())
+
+
+# Driver source handed to each render worker once
+_worker_source: Union[bytes, UploadStream] = b""
+
+
+def _init_render_worker(source):
+    global _worker_source
+    _worker_source = source
+
+
+def _render_track(source, track: TrackRequest) -> Tuple[str, array, array]:
+    left, right = APU.boot(source).render(track.seconds, track.commands, track.stop_after_silence)
+    return track.name, left, right
+
+
+def _render_worker(track: TrackRequest) -> Tuple[str, array, array]:
+    return _render_track(_worker_source, track)
+
+
+def render_tracks(source: Union[Buffer, UploadStream], tracks: Sequence[TrackRequest],
+                  workers: Optional[int] = None) -> List[Tuple[str, array, array]]:
+    """(name, left, right) per track, in order; tracks render in parallel from fresh boots"""
+    source = source if isinstance(source, UploadStream) else bytes(source)
+    workers = workers or os.cpu_count() or 1
+    if workers == 1 or len(tracks) <= 1:
+        return [_render_track(source, track) for track in tracks]
+    with ProcessPoolExecutor(max_workers=min(workers, len(tracks)),
+                             initializer=_init_render_worker, initargs=(source,)) as executor:
+        return list(executor.map(_render_worker, tracks))
+
+
+def parse_track(spec: str, seconds: float, stop_after_silence: Optional[float] = None) -> TrackRequest:
+    """
+    Track from "name=time:port:value,..." (times in seconds, numbers in any base),
+    e.g. "overture=0.5:0:0x01" writes $01 to port 0 half a second after boot
+    """
+    name, _, writes = spec.partition("=")
+    commands = []
+    for write in filter(None, writes.split(",")):
+        time_text, port_text, value_text = write.split(":")
+        commands.append(PortWrite(float(time_text), int(port_text, 0), int(value_text, 0)))
+    return TrackRequest(name or "track", commands, seconds, stop_after_silence)
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Render SPC700 music and sound effects offline")
+    parser.add_argument("source", help=".spc snapshot or ROM file")
+    parser.add_argument("--upload", type=lambda v: int(v, 0), help="ROM offset of the driver upload list")
+    parser.add_argument("--find-uploads", action="store_true", help="List upload lists found in the ROM")
+    parser.add_argument("--min-size", type=lambda v: int(v, 0), default=MIN_UPLOAD_SIZE, help="Smallest upload list to report")
+    parser.add_argument("--track", action="append", default=[], help="name=time:port:value,... (repeatable)")
+    parser.add_argument("--seconds", type=float, default=30.0, help="Length of each render")
+    parser.add_argument("--stop-after-silence", type=float, help="End a render after this many silent seconds")
+    parser.add_argument("--workers", type=int, help="Render worker processes (default: one per core)")
+    parser.add_argument("--output", "-o", default="spc_renders", help="Output directory for WAV files")
+    args = parser.parse_args()
+
+    source_path = Path(args.source)
+    if source_path.suffix.lower() == ".spc":
+        source = source_path.read_bytes()
+    else:
+        rom = open_rom_image(source_path).data
+        if args.find_uploads or args.upload is None:
+            streams = find_upload_streams(rom, args.min_size)
+            print(f"🔍 {len(streams)} driver upload lists")
+            for stream in streams:
+                print(f"   0x{stream.offset:06X}: {len(stream.blocks)} blocks, {stream.size:,} bytes, entry ${stream.entry:04X}")
+            if args.upload is None:
+                sys.exit(0 if streams else 1)
+        try:
+            source = read_upload_stream(rom, args.upload)
+        except ValueError as e:
+            print(f"❌ Error: {e}")
+            sys.exit(1)
+
+    tracks = [parse_track(spec, args.seconds, args.stop_after_silence) for spec in args.track]
+    if not tracks:
+        tracks = [TrackRequest(source_path.stem, [], args.seconds, args.stop_after_silence)]
+
+    output_dir = Path(args.output)
+    output_dir.mkdir(parents=True, exist_ok=True)
+    start_time = time.time()
+    rendered = render_tracks(source, tracks, args.workers)
+    elapsed = time.time() - start_time
+
+    audio_seconds = 0.0
+    for name, left, right in rendered:
+        path = output_dir / f"{name}.wav"
+        write_stereo_wav(path, left, right)
+        audio_seconds += len(left) / SAMPLE_RATE
+        print(f"🎵 {path} ({len(left) / SAMPLE_RATE:.1f}s)")
+    print(f"✅ Rendered {audio_seconds:.1f}s of audio in {elapsed:.1f}s ({audio_seconds / max(elapsed, 1e-9):.2f}x real time)")
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Stage Tracing
+================================
+
+Scoped timers and counters for the build and automation pipeline, cheap
+enough to leave on in production runs.
+
+Every thread records into its own buffer (a threading.local registered
+once in a module list), so a span or counter is a plain list append or
+dict update with no lock taken. Readers take the buffers only between
+runs: export_chrome_trace writes Chrome trace-event JSON (chrome://tracing,
+Perfetto) and summary() folds the buffers into per-stage timings, counter
+totals and peak RSS for the build report.
+
+Recording is off until enable() is called, or when DQ3R_TRACE names a
+file: any tool importing this module then traces and writes that file at
+exit. Disabled spans and counters return immediately.
+"""
+
+import atexit
+import itertools
+import json
+import os
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Any, Dict, List, Union
+
+try:
+    import resource
+except ImportError:  # Windows
+    resource = None
+
+_ORIGIN_NS = time.perf_counter_ns()
+_local = threading.local()
+_buffers: List["ThreadBuffer"] = []
+_thread_ids = itertools.count(1)
+_enabled = False
+
+
+class ThreadBuffer:
+    """Events and counter totals recorded by one thread"""
+
+    def __init__(self):
+        thread = threading.current_thread()
+        self.tid = next(_thread_ids)
+        self.name = thread.name
+        self.ident = thread.ident
+        self.spans: List[tuple] = []  # (name, category, start_ns, duration_ns, args)
+        self.samples: List[tuple] = []  # (name, timestamp_ns, running total)
+        self.counters: Dict[str, int] = {}
+
+    def clear(self):
+        self.spans = []
+        self.samples = []
+        self.counters = {}
+
+
+def _buffer() -> ThreadBuffer:
+    buffer = getattr(_local, "buffer", None)
+    if buffer is None:
+        buffer = _local.buffer = ThreadBuffer()
+        _buffers.append(buffer)
+    return buffer
+
+
+def peak_rss_kb(children: bool = False) -> int:
+    """Peak resident set size of this process (or of its finished children) in KiB, 0 if unknown"""
+    if resource is None:
+        return 0
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN if children else resource.RUSAGE_SELF)
+    # ru_maxrss is bytes on macOS, KiB elsewhere
+    return usage.ru_maxrss // 1024 if sys.platform == "darwin" else usage.ru_maxrss
+
+
+class Span:
+    """One timed scope; set() attaches arguments shown with the event"""
+
+    __slots__ = ("name", "category", "args", "start")
+
+    def __init__(self, name: str, category: str, args: Dict[str, Any]):
+        self.name = name
+        self.category = category
+        self.args = args
+        self.start = 0
+
+    def set(self, **args):
+        self.args.update(args)
+
+    def __enter__(self) -> "Span":
+        self.start = time.perf_counter_ns()
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        end = time.perf_counter_ns()
+        if exc_type is not None:
+            self.args["error"] = exc_type.__name__
+        buffer = _buffer()
+        buffer.spans.append((self.name, self.category, self.start - _ORIGIN_NS, end - self.start, self.args))
+        buffer.samples.append(("peak_rss_kb", end - _ORIGIN_NS, peak_rss_kb()))
+        return False
+
+
+class _NullSpan:
+    __slots__ = ()
+
+    def set(self, **args):
+        pass
+
+    def __enter__(self) -> "_NullSpan":
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        return False
+
+
+_NULL_SPAN = _NullSpan()
+
+
+def span(name: str, category: str = "stage", **args) -> Union[Span, _NullSpan]:
+    """Context manager timing its body as one trace event"""
+    if not _enabled:
+        return _NULL_SPAN
+    return Span(name, category, args)
+
+
+def count(name: str, value: int = 1):
+    """Add value to a counter (bytes scanned, instructions decoded, cache hits, ...)"""
+    if not _enabled:
+        return
+    buffer = _buffer()
+    total = buffer.counters.get(name, 0) + value
+    buffer.counters[name] = total
+    buffer.samples.append((name, time.perf_counter_ns() - _ORIGIN_NS, total))
+
+
+def enable(on: bool = True):
+    global _enabled
+    _enabled = on
+
+
+def enabled() -> bool:
+    return _enabled
+
+
+def reset():
+    """Drop everything recorded so far, and the buffers of threads that have exited"""
+    alive = {thread.ident for thread in threading.enumerate()}
+    _buffers[:] = [buffer for buffer in _buffers if buffer.ident in alive]
+    for buffer in _buffers:
+        buffer.clear()
+
+
+def chrome_trace() -> Dict[str, Any]:
+    """Recorded spans and counter samples as a Chrome trace-event document"""
+    pid = os.getpid()
+    events: List[Dict[str, Any]] = []
+    for buffer in list(_buffers):
+        events.append({"ph": "M", "name": "thread_name", "pid": pid, "tid": buffer.tid, "args": {"name": buffer.name}})
+        for name, category, start, duration, args in buffer.spans:
+            events.append({"ph": "X", "name": name, "cat": category, "pid": pid, "tid": buffer.tid,
+                           "ts": start / 1000, "dur": duration / 1000, "args": args})
+        # Counter tracks are per process, so each thread is one series of the track
+        for name, timestamp, total in buffer.samples:
+            events.append({"ph": "C", "name": name, "pid": pid, "tid": buffer.tid, "ts": timestamp / 1000,
+                           "args": {buffer.name: total}})
+    events.sort(key=lambda event: event.get("ts", -1))
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def export_chrome_trace(path: Union[str, Path]) -> Path:
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump(chrome_trace(), f, default=str)
+    return path
+
+
+def summary() -> Dict[str, Any]:
+    """Per-span timings, counter totals and peak RSS, for build reports"""
+    stages: Dict[str, Dict[str, Any]] = {}
+    counters: Dict[str, int] = {}
+    first, last = None, 0
+    for buffer in list(_buffers):
+        for name, _category, start, duration, _args in buffer.spans:
+            entry = stages.setdefault(name, {"calls": 0, "total_ms": 0.0, "max_ms": 0.0})
+            entry["calls"] += 1
+            entry["total_ms"] += duration / 1e6
+            entry["max_ms"] = max(entry["max_ms"], duration / 1e6)
+            first = start if first is None else min(first, start)
+            last = max(last, start + duration)
+        for name, total in buffer.counters.items():
+            counters[name] = counters.get(name, 0) + total
+
+    for entry in stages.values():
+        entry["mean_ms"] = round(entry["total_ms"] / entry["calls"], 3)
+        entry["total_ms"] = round(entry["total_ms"], 3)
+        entry["max_ms"] = round(entry["max_ms"], 3)
+    return {
+        "wall_ms": round((last - first) / 1e6, 3) if first is not None else 0.0,
+        "stages": dict(sorted(stages.items(), key=lambda item: -item[1]["total_ms"])),
+        "counters": dict(sorted(counters.items())),
+        "peak_rss_kb": peak_rss_kb(),
+        "children_peak_rss_kb": peak_rss_kb(children=True),
+    }
+
+
+def format_summary(report: Dict[str, Any]) -> List[str]:
+    """summary() as table lines"""
+    lines = [f"{'stage':36} {'calls':>6} {'total ms':>11} {'mean ms':>10} {'max ms':>10}"]
+    for name, entry in report["stages"].items():
+        lines.append(f"{name[:36]:36} {entry['calls']:6} {entry['total_ms']:11.1f} {entry['mean_ms']:10.2f} "
+                     f"{entry['max_ms']:10.2f}")
+    for name, total in report["counters"].items():
+        lines.append(f"{name[:36]:36} {total:>40,}")
+    lines.append(f"{'peak RSS (KiB)':36} {report['peak_rss_kb']:>40,}")
+    if report.get("children_peak_rss_kb"):
+        lines.append(f"{'child peak RSS (KiB)':36} {report['children_peak_rss_kb']:>40,}")
+    return lines
+
+
+_TRACE_FILE = os.environ.get("DQ3R_TRACE")
+if _TRACE_FILE:
+    enable()
+    atexit.register(export_chrome_trace, _TRACE_FILE)
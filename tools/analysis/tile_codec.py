@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - SNES Tile Codec
+==================================
+
+Run-at-a-time planar <-> chunky conversion for 2bpp/4bpp/8bpp tiles and
+Mode 7 character data. Whole runs of tiles are transposed with byte
+translation tables and strided slice copies, so the work is done per
+bitplane and pixel column rather than per pixel.
+"""
+
+from array import array
+from typing import Dict, List, Optional, Union
+
+import stage_trace
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+TILE_PIXELS = 64
+
+# Bytes per 8x8 tile for each planar depth
+TILE_SIZES = {2: 16, 4: 32, 8: 64}
+
+
+def _build_decode_tables() -> Dict[int, List[bytes]]:
+    """DECODE_TABLES[plane][x]: plane byte -> that pixel column's bit, weighted by the plane"""
+    tables = {}
+    for plane in range(8):
+        tables[plane] = [bytes(((value >> (7 - x)) & 1) << plane for value in range(256)) for x in range(8)]
+    return tables
+
+
+def _build_encode_tables() -> Dict[int, List[bytes]]:
+    """ENCODE_TABLES[plane][x]: pixel index -> its plane bit at column x of the plane byte"""
+    tables = {}
+    for plane in range(8):
+        tables[plane] = [bytes(((value >> plane) & 1) << (7 - x) for value in range(256)) for x in range(8)]
+    return tables
+
+
+DECODE_TABLES = _build_decode_tables()
+ENCODE_TABLES = _build_encode_tables()
+
+
+def tile_count(data: Buffer, bpp: int) -> int:
+    """Number of whole tiles in data"""
+    return len(data) // TILE_SIZES[bpp]
+
+
+def _plane_rows(data: bytes, bpp: int) -> List[bytes]:
+    """
+    Split planar tile data into one row stream per bitplane (8 bytes per tile, tile-major)
+    SNES tiles store plane pairs as 16-byte blocks of interleaved rows: plane 2q at even bytes
+    and plane 2q+1 at odd bytes of block q.
+    """
+    if bpp == 2:
+        return [data[0::2], data[1::2]]
+
+    pairs = bpp // 2
+    planes = []
+    for parity in range(2):
+        # One 64-bit word holds all eight rows of one plane of one tile
+        words = array("Q")
+        words.frombytes(data[parity::2])
+        planes.append([words[pair::pairs].tobytes() for pair in range(pairs)])
+
+    return [planes[plane & 1][plane >> 1] for plane in range(bpp)]
+
+
+def decode_tiles(
+    data: Buffer, bpp: int, out: Optional[Union[bytearray, memoryview]] = None, out_offset: int = 0
+) -> Union[bytearray, memoryview]:
+    """
+    Decode every whole tile in data into 8-bit pixel indices (64 per tile, row-major)
+    Results go into out at out_offset when given (no intermediate per-tile buffers),
+    otherwise into a new bytearray.
+    """
+    if bpp not in TILE_SIZES:
+        raise ValueError(f"Unsupported bit depth: {bpp}")
+
+    tiles = tile_count(data, bpp)
+    size = tiles * TILE_PIXELS
+    if out is None:
+        out = bytearray(size)
+        out_offset = 0
+    elif len(out) < out_offset + size:
+        raise ValueError(f"Output buffer too small: need {out_offset + size} bytes, have {len(out)}")
+
+    if not tiles:
+        return out
+    stage_trace.count("tiles.decoded", tiles)
+
+    planes = _plane_rows(bytes(data[: tiles * TILE_SIZES[bpp]]), bpp)
+    column_size = tiles * 8
+
+    for x in range(8):
+        column = 0
+        for plane, rows in enumerate(planes):
+            column |= int.from_bytes(rows.translate(DECODE_TABLES[plane][x]), "little")
+        out[out_offset + x : out_offset + size : 8] = column.to_bytes(column_size, "little")
+
+    return out
+
+
+def encode_tiles(
+    pixels: Buffer, bpp: int, out: Optional[Union[bytearray, memoryview]] = None, out_offset: int = 0
+) -> Union[bytearray, memoryview]:
+    """
+    Planarize 8-bit pixel indices (64 per tile, row-major) into SNES tile data
+    Index bits above bpp are dropped. Inverse of decode_tiles.
+    """
+    if bpp not in TILE_SIZES:
+        raise ValueError(f"Unsupported bit depth: {bpp}")
+
+    tiles = len(pixels) // TILE_PIXELS
+    size = tiles * TILE_SIZES[bpp]
+    if out is None:
+        out = bytearray(size)
+        out_offset = 0
+    elif len(out) < out_offset + size:
+        raise ValueError(f"Output buffer too small: need {out_offset + size} bytes, have {len(out)}")
+
+    if not tiles:
+        return out
+    stage_trace.count("tiles.encoded", tiles)
+
+    pixels = bytes(pixels[: tiles * TILE_PIXELS])
+    columns = [pixels[x::8] for x in range(8)]
+    row_size = tiles * 8
+
+    planes = []
+    for plane in range(bpp):
+        rows = 0
+        for x in range(8):
+            rows |= int.from_bytes(columns[x].translate(ENCODE_TABLES[plane][x]), "little")
+        planes.append(rows.to_bytes(row_size, "little"))
+
+    if bpp == 2:
+        out[out_offset : out_offset + size : 2] = planes[0]
+        out[out_offset + 1 : out_offset + size : 2] = planes[1]
+        return out
+
+    pairs = bpp // 2
+    for parity in range(2):
+        words = array("Q", bytes(row_size * pairs))
+        for pair in range(pairs):
+            words[pair::pairs] = array("Q", planes[pair * 2 + parity])
+        out[out_offset + parity : out_offset + size : 2] = words.tobytes()
+
+    return out
+
+
+def decode_mode7(
+    data: Buffer,
+    interleaved: bool = True,
+    out: Optional[Union[bytearray, memoryview]] = None,
+    out_offset: int = 0,
+) -> Union[bytearray, memoryview]:
+    """
+    Mode 7 character data to pixel indices (already chunky, 64 bytes per tile)
+    interleaved=True takes the high (odd) bytes of VRAM words, where Mode 7 keeps character
+    data beside the tilemap in the low bytes.
+    """
+    chars = bytes(data[1::2] if interleaved else data)
+    size = (len(chars) // TILE_PIXELS) * TILE_PIXELS
+
+    if out is None:
+        return bytearray(chars[:size])
+    if len(out) < out_offset + size:
+        raise ValueError(f"Output buffer too small: need {out_offset + size} bytes, have {len(out)}")
+    out[out_offset : out_offset + size] = chars[:size]
+    return out
+
+
+def encode_mode7(pixels: Buffer, tilemap: Optional[Buffer] = None) -> bytearray:
+    """Pixel indices back to Mode 7 VRAM words (tilemap bytes in the low half, zero if not given)"""
+    size = (len(pixels) // TILE_PIXELS) * TILE_PIXELS
+    out = bytearray(size * 2)
+    out[1::2] = bytes(pixels[:size])
+    if tilemap is not None:
+        low = bytes(tilemap[:size])
+        out[0 : len(low) * 2 : 2] = low
+    return out
+
+
+def decode_tile(tile_data: Buffer, bpp: int) -> List[int]:
+    """Single tile as a flat list of 64 pixel indices"""
+    if len(tile_data) != TILE_SIZES[bpp]:
+        return [0] * TILE_PIXELS
+    return list(decode_tiles(tile_data, bpp))
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+    from pathlib import Path
+
+    parser = argparse.ArgumentParser(description="SNES tile codec - decode/encode round-trip check")
+    parser.add_argument("tile_file", help="Planar tile data")
+    parser.add_argument("--bpp", type=int, default=4, choices=sorted(TILE_SIZES), help="Bits per pixel")
+    args = parser.parse_args()
+
+    data = Path(args.tile_file).read_bytes()
+
+    start_time = time.time()
+    pixels = decode_tiles(data, args.bpp)
+    decode_time = time.time() - start_time
+
+    start_time = time.time()
+    planar = encode_tiles(pixels, args.bpp)
+    encode_time = time.time() - start_time
+
+    whole = tile_count(data, args.bpp) * TILE_SIZES[args.bpp]
+    print(f"Tiles: {tile_count(data, args.bpp):,} ({args.bpp}bpp)")
+    print(f"Decode: {decode_time * 1000:.1f} ms, encode: {encode_time * 1000:.1f} ms")
+    print(f"Round trip: {'OK' if bytes(planar) == data[:whole] else 'MISMATCH'}")
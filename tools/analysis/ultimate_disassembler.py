@@ -9,15 +9,47 @@ cross-references, and detailed commentary on every code region.
 """
 
 import struct
+import sys
 import os
+import io
 import json
 import csv
 import time
+from bisect import bisect_left, bisect_right
+from concurrent.futures import ProcessPoolExecutor
 from pathlib import Path
 from typing import Dict, List, Tuple, Any, Optional, Set
 from dataclasses import dataclass
 from collections import defaultdict, Counter
 import hashlib
+import re
+
+# Shared 65816 opcode table
+sys.path.append(str(Path(__file__).parent.parent / "disassembly"))
+from decoder65816 import opcode_definitions, format_operand
+from rom_image import open_rom_image
+from address_map import LOROM, address_map_for
+from xref_index import CODE_KINDS, XrefIndex, build_xref_index
+from analysis_store import INSTRUCTIONS, LABELS, XREFS, AnalysisStore, rom_digest
+from diz_parser import DataType
+
+# Per-byte code/data marks that take precedence over the region map
+MARK_NONE, MARK_CODE, MARK_OPERAND, MARK_DATA = 0, 1, 2, 3
+_MARKED = re.compile(b"[^\x00]")
+_NOT_CODE_MARK = re.compile(b"[^\x01\x02]")
+_NOT_DATA_MARK = re.compile(b"[^\x03]")
+
+# DiztinGUIsh DataType value -> mark; UNREACHED, LABEL and unknown values leave the region map in charge
+_DIZ_MARKS = bytearray(256)
+for _data_type in DataType:
+    if _data_type in (DataType.OPCODE, DataType.INSTRUCTION):
+        _DIZ_MARKS[_data_type.value] = MARK_CODE
+    elif _data_type is DataType.OPERAND:
+        _DIZ_MARKS[_data_type.value] = MARK_OPERAND
+    elif _data_type not in (DataType.UNREACHED, DataType.LABEL):
+        _DIZ_MARKS[_data_type.value] = MARK_DATA
+_DIZ_MARKS = bytes(_DIZ_MARKS)
+
 
 @dataclass
 class AnnotatedInstruction:
@@ -42,15 +74,62 @@ class UltimateDisassembler:
     Creates the ultimate annotated assembly source
     """
 
-    def __init__(self, rom_path: str):
+    # LoROM bank size used for bank-parallel generation (matches src/bank_NN.asm)
+    BANK_SIZE = 0x8000
+
+    # Bump when bank rendering changes so incremental caches are discarded
+    RENDER_VERSION = 3
+
+    # Default instruction cap of the sequential walk (bank mode has none)
+    SEQUENTIAL_LIMIT = 20000
+
+    HW_REGISTERS = {
+        "INIDISP": 0x2100,
+        "OBJSEL": 0x2101,
+        "OAMADDL": 0x2102,
+        "OAMADDH": 0x2103,
+        "OAMDATA": 0x2104,
+        "BGMODE": 0x2105,
+        "APUIO0": 0x2140,
+        "APUIO1": 0x2141,
+        "APUIO2": 0x2142,
+        "APUIO3": 0x2143,
+    }
+
+    # Control-flow opcodes whose direct targets get labels in bank mode
+    BRANCH_OPCODES = {0x10, 0x30, 0x50, 0x70, 0x80, 0x90, 0xB0, 0xD0, 0xF0}
+    LONG_BRANCH_OPCODES = {0x82}  # BRL, 16-bit displacement
+    ABSOLUTE_TARGET_OPCODES = {0x20, 0x4C}
+    LONG_TARGET_OPCODES = {0x22, 0x5C}
+
+    def __init__(self, rom_path: str, verbose: bool = True):
         self.rom_path = Path(rom_path)
         self.rom_data = self._load_rom()
         self.rom_size = len(self.rom_data)
+        # Banks are rendered as 32KB LoROM banks throughout
+        self.address_map = address_map_for(LOROM, self.rom_size)
 
-        # Load analysis data
+        # Load analysis data (binary store first, then the docs/maximum_analysis exports)
+        self.store = AnalysisStore()
+        self.rom_digest = rom_digest(self.rom_data)
         self.text_strings = self._load_text_strings()
         self.data_tables = self._load_data_tables()
-        self.region_map = self._load_region_map()
+        self.region_map = sorted(self._load_region_map(), key=lambda region: region['start'])
+        self._region_starts = [region['start'] for region in self.region_map]
+
+        # Symbols added to src/ultimate/symbols.inc by hand (used for operand names)
+        self.user_symbols = self._load_user_symbols(Path("src/ultimate/symbols.inc"))
+        self._symbol_lookups: Optional[Dict[int, Optional[str]]] = None
+
+        # Code labels and comments applied when banks are merged (labels.inc, .diz projects)
+        self.code_labels: Dict[int, str] = {}
+        self.code_comments: Dict[int, str] = {}
+        self.diz_project = None  # Streamed .diz project (per-byte DataType marks and labels)
+
+        # Instruction starts and M/X-aware sizes from a cfg_engine block table
+        self.block_table_path: Optional[Path] = None
+        self.block_sizes: Dict[int, int] = {}
+        self._block_starts: List[int] = []
 
         # Analysis results
         self.annotated_instructions = []
@@ -60,19 +139,23 @@ class UltimateDisassembler:
         # Complete opcode set with enhanced analysis
         self.opcodes = self._init_ultimate_opcodes()
 
-        print(f"INIT: Ultimate Disassembler")
-        print(f"ROM: {self.rom_path.name} ({self.rom_size:,} bytes)")
-        print(f"Text strings loaded: {len(self.text_strings)}")
-        print(f"Data tables loaded: {len(self.data_tables)}")
-        print(f"Regions loaded: {len(self.region_map)}")
+        if verbose:
+            print(f"INIT: Ultimate Disassembler")
+            print(f"ROM: {self.rom_path.name} ({self.rom_size:,} bytes)")
+            print(f"Text strings loaded: {len(self.text_strings)}")
+            print(f"Data tables loaded: {len(self.data_tables)}")
+            print(f"Regions loaded: {len(self.region_map)}")
 
-    def _load_rom(self) -> bytes:
-        """Load ROM data"""
-        with open(self.rom_path, 'rb') as f:
-            return f.read()
+    def _load_rom(self) -> memoryview:
+        """ROM data as a view of the shared memory-mapped image"""
+        return open_rom_image(self.rom_path).data
 
     def _load_text_strings(self) -> Dict[int, str]:
         """Load text strings from analysis"""
+        table = self.store.read("text_strings", self.rom_digest)
+        if table is not None:
+            return dict(zip(table['offset'], table['text']))
+
         strings = {}
         csv_path = Path("docs/maximum_analysis/text_strings.csv")
 
@@ -90,6 +173,13 @@ class UltimateDisassembler:
 
     def _load_data_tables(self) -> Dict[int, Dict[str, Any]]:
         """Load data table information"""
+        table = self.store.read("data_tables", self.rom_digest)
+        if table is not None:
+            return {
+                row['offset']: dict(row, offset=f"${row['offset']:06X}")
+                for row in table.iter_rows()
+            }
+
         tables = {}
         json_path = Path("docs/maximum_analysis/data_tables.json")
 
@@ -107,6 +197,15 @@ class UltimateDisassembler:
 
     def _load_region_map(self) -> List[Dict[str, Any]]:
         """Load region classification map"""
+        table = self.store.read("regions", self.rom_digest)
+        if table is not None:
+            return [
+                {'start': start, 'end': end, 'type': region_type, 'confidence': confidence, 'description': description}
+                for start, end, region_type, confidence, description in zip(
+                    table['start'], table['end'], table['type'], table['confidence'], table['description']
+                )
+            ]
+
         regions = []
         csv_path = Path("docs/maximum_analysis/region_map.csv")
 
@@ -361,17 +460,160 @@ class UltimateDisassembler:
                 'analysis': analysis
             }
 
+        # Fill every opcode the curated list leaves out from the shared decoder table
+        control_types = {"subroutine_call": "call", "return": "return"}
+        for opcode_val, definition in opcode_definitions().items():
+            if opcode_val in opcodes:
+                continue
+            shared = definition['analysis']
+            analysis = {"function": "control_flow" if "control_flow" in shared else "misc",
+                        "affects_flags": [], "reads": [], "writes": []}
+            if shared.get("control_flow") in control_types:
+                analysis["control_type"] = control_types[shared["control_flow"]]
+            definition['analysis'] = analysis
+            opcodes[opcode_val] = definition
+
         return opcodes
 
+    def _generated_symbols(self) -> List[Tuple[str, int]]:
+        """Symbols this tool writes to symbols.inc itself"""
+        symbols = list(self.HW_REGISTERS.items())
+        for offset, table in list(self.data_tables.items())[:20]:  # First 20 tables
+            bank, addr = self._rom_offset_to_snes_address(offset)
+            symbols.append((f"DATA_{table['type'].upper()}_{bank:02X}_{addr:04X}", addr))
+        return symbols
+
+    def _load_user_symbols(self, symbols_path: Path) -> Dict[int, str]:
+        """Hand-added .DEFINEs in symbols.inc (anything the generator does not produce itself)"""
+        symbols = {}
+        if not symbols_path.exists():
+            return symbols
+
+        generated = {name for name, _ in self._generated_symbols()}
+        pattern = re.compile(r'^\.DEFINE\s+(\w+)\s+\$([0-9A-Fa-f]{1,4})\b')
+        with open(symbols_path, 'r', encoding='utf-8') as f:
+            for line in f:
+                match = pattern.match(line.strip())
+                if match and match.group(1) not in generated:
+                    symbols.setdefault(int(match.group(2), 16), match.group(1))
+        return symbols
+
+    def load_code_annotations(self, labels_path: Optional[Path] = None, diz_path: Optional[Path] = None):
+        """Code labels from labels.inc (FUNCTION_xxxxxx = ROM offset); marks, labels and comments from a .diz project"""
+        self.code_labels = {}
+        self.code_comments = {}
+
+        if labels_path and Path(labels_path).exists():
+            pattern = re.compile(r'^\.DEFINE\s+(FUNCTION_([0-9A-Fa-f]{6}))\b')
+            with open(labels_path, 'r', encoding='utf-8') as f:
+                for line in f:
+                    match = pattern.match(line.strip())
+                    if match:
+                        self.code_labels[int(match.group(2), 16)] = match.group(1)
+
+        if diz_path and Path(diz_path).exists():
+            from diz_stream import load_diz
+
+            # Streamed: labels come from the project's string arena, decoded one at a time
+            self.diz_project = load_diz(diz_path)
+            for address, name, comment in self.diz_project.labels:
+                # DiztinGUIsh keys labels by SNES address
+                bank, addr = (address >> 16) & 0x7F, address & 0xFFFF
+                if addr < 0x8000:
+                    continue
+                offset = bank * self.BANK_SIZE + (addr - 0x8000)
+                if name:
+                    self.code_labels[offset] = name
+                if comment:
+                    self.code_comments[offset] = comment
+
+    def load_block_table(self, block_table_path: Path) -> int:
+        """Instructions of a cfg_engine block table (cfg_blocks.json); they mark code in the walks"""
+        self.block_table_path = None
+        self.block_sizes = {}
+        if not Path(block_table_path).exists():
+            return 0
+
+        with open(block_table_path, 'r', encoding='utf-8') as f:
+            report = json.load(f)
+        for block in report.get('block_table', []):
+            for offset, size in block['instructions']:
+                self.block_sizes.setdefault(offset, size)
+        self._block_starts = sorted(self.block_sizes)
+        self.block_table_path = Path(block_table_path)
+        return len(self.block_sizes)
+
+    @property
+    def mark_sources(self) -> List[str]:
+        sources = []
+        if self.diz_project is not None:
+            sources.append(".diz project")
+        if self.block_sizes:
+            sources.append("CFG block table")
+        return sources
+
+    def _code_marks(self, start: int, end: int) -> Optional[bytearray]:
+        """
+        Marks for ROM bytes start..end (None when nothing is marked): CFG instructions are code,
+        and bytes the .diz project marks override them
+        """
+        if not self.block_sizes and self.diz_project is None:
+            return None
+
+        marks = bytearray(end - start)
+        first = bisect_left(self._block_starts, start)
+        last = bisect_left(self._block_starts, end)
+        for offset in self._block_starts[first:last]:
+            operand_end = min(offset + self.block_sizes[offset], end)
+            marks[offset + 1 - start : operand_end - start] = bytes([MARK_OPERAND]) * (operand_end - offset - 1)
+        for offset in self._block_starts[first:last]:
+            marks[offset - start] = MARK_CODE
+
+        if self.diz_project is not None:
+            diz_marks = self.diz_project.flags[start:end].tobytes().translate(_DIZ_MARKS)
+            diz_marks += bytes(end - start - len(diz_marks))
+            if self.block_sizes:
+                # Keep the CFG's mark wherever the project leaves a byte unmarked
+                marks = bytearray(diz or cfg for diz, cfg in zip(diz_marks, marks))
+            else:
+                marks = bytearray(diz_marks)
+        return marks
+
+    def _marked_size(self, marks: Optional[bytearray], offset: int, base: int = 0) -> Optional[int]:
+        """Size of the instruction marked at offset (its operand marks), None to use the opcode table's"""
+        if marks is None or marks[offset - base] != MARK_CODE:
+            return None
+        index = offset - base + 1
+        while index < len(marks) and index - (offset - base) < 4 and marks[index] == MARK_OPERAND:
+            index += 1
+        if index == len(marks):
+            # Operands run past the marked range; only the CFG knows this instruction's size
+            return self.block_sizes.get(offset)
+        return index - (offset - base)
+
     def find_region_at_offset(self, offset: int) -> Optional[Dict[str, Any]]:
         """Find region containing the given offset"""
-        for region in self.region_map:
-            if region['start'] <= offset < region['end']:
-                return region
+        index = bisect_right(self._region_starts, offset) - 1
+        if index >= 0 and offset < self.region_map[index]['end']:
+            return self.region_map[index]
         return None
 
-    def generate_ultimate_assembly(self, max_instructions: int = 20000):
-        """Generate ultimate annotated assembly source"""
+    def generate_ultimate_assembly(self, max_instructions: Optional[int] = None, by_bank: bool = False,
+                                   workers: Optional[int] = None, incremental: bool = False,
+                                   cache_dir: Optional[Path] = None):
+        """
+        Generate ultimate annotated assembly source
+        With by_bank, each 32KB bank is disassembled independently (in parallel across workers)
+        and merged in bank order, so the whole ROM is covered without an instruction cap and the
+        output is identical for any worker count. max_instructions only caps the sequential walk
+        (SEQUENTIAL_LIMIT when not given). incremental (implies by_bank) keeps rendered
+        banks in cache_dir and only re-renders banks whose ROM bytes, regions, text/table entries
+        or referenced symbols changed. The unit of that cache is the bank: a changed bank is
+        rendered again whole, and label and comment edits re-render nothing but rewrite the
+        merged dq3_ultimate.asm and cross_references.md from the cached pieces (labels sit
+        between pieces, so no per-line index is needed). The merge time is printed and kept in
+        annotation_index.json as the cost of an annotation edit.
+        """
         print("\nSTARTING: Ultimate Assembly Generation")
         print("=" * 70)
 
@@ -384,58 +626,28 @@ class UltimateDisassembler:
         # Main assembly file
         main_asm = asm_dir / "dq3_ultimate.asm"
 
+        xrefs = None
+        labels: Set[int] = set()
+
         with open(main_asm, 'w', encoding='utf-8') as f:
             # Write header
             self._write_assembly_header(f)
 
-            # Process code regions in order
-            instruction_count = 0
-            current_offset = 0
-
-            while current_offset < self.rom_size and instruction_count < max_instructions:
-                region = self.find_region_at_offset(current_offset)
-
-                if region and region['type'] in ['text_or_code']:
-                    # Disassemble code region
-                    region_end = min(region['end'], current_offset + 2048)  # Max 2KB per region
-
-                    f.write(f"\n; ==========================================\n")
-                    f.write(f"; Region: ${current_offset:06X} - ${region_end:06X}\n")
-                    f.write(f"; Type: {region['type']} (confidence: {region['confidence']:.2f})\n")
-                    f.write(f"; {region['description']}\n")
-                    f.write(f"; ==========================================\n\n")
-
-                    while current_offset < region_end:
-                        instruction = self._disassemble_annotated_instruction(current_offset)
-                        if instruction:
-                            self._write_annotated_instruction(f, instruction)
-                            current_offset += instruction.bytes_data[0] if len(instruction.bytes_data) == 1 else max(1, len(instruction.bytes_data))
-                            instruction_count += 1
-
-                            if instruction_count >= max_instructions:
-                                break
-                        else:
-                            current_offset += 1
-                else:
-                    # Skip non-code regions but add comments
-                    if region:
-                        f.write(f"\n; DATA REGION: ${current_offset:06X} - ${region['end']:06X} ({region['type']})\n")
-                        if current_offset in self.text_strings:
-                            f.write(f"; Text: \"{self.text_strings[current_offset][:50]}...\"\n")
-                        if current_offset in self.data_tables:
-                            table = self.data_tables[current_offset]
-                            f.write(f"; Data table: {table['type']} with {table['entry_count']} entries\n")
-                        f.write("\n")
-
-                    # Skip to next interesting region
-                    next_offset = region['end'] if region else current_offset + 1024
-                    current_offset = min(next_offset, current_offset + 1024)
+            if by_bank or incremental:
+                if incremental and cache_dir is None:
+                    cache_dir = Path("cache/ultimate")
+                instruction_count, xrefs, labels = self._write_banks_parallel(
+                    f, workers, cache_dir if incremental else None
+                )
+            else:
+                limit = self.SEQUENTIAL_LIMIT if max_instructions is None else max_instructions
+                instruction_count = self._write_sequential(f, limit)
 
         # Generate symbol table
         self._generate_symbol_table(asm_dir)
 
         # Generate cross-reference documentation
-        self._generate_cross_ref_docs(asm_dir)
+        self._generate_cross_ref_docs(asm_dir, xrefs, labels)
 
         generation_time = time.time() - start_time
         print(f"\nULTIMATE ASSEMBLY GENERATION COMPLETE!")
@@ -444,6 +656,393 @@ class UltimateDisassembler:
         print(f"Main file: {main_asm}")
         print(f"Total lines: {self._count_lines(main_asm)}")
 
+    def _write_sequential(self, f, max_instructions: int) -> int:
+        """Original single-pass walk over the region map, stopping at max_instructions"""
+        # Process code regions in order
+        instruction_count = 0
+        current_offset = 0
+        marks = self._code_marks(0, self.rom_size)
+
+        while current_offset < self.rom_size and instruction_count < max_instructions:
+            is_code, run_end, region, marked = self._next_run(current_offset, self.rom_size, marks)
+
+            if is_code:
+                # Disassemble code region
+                self._write_code_run_header(f, current_offset, run_end, region, marked)
+                stop = self._run_stop(marks, run_end, self.rom_size, marked)
+
+                while current_offset < run_end:
+                    instruction = self._disassemble_annotated_instruction(
+                        current_offset, self._marked_size(marks, current_offset), stop
+                    )
+                    if instruction:
+                        self._write_annotated_instruction(f, instruction)
+                        current_offset += len(instruction.bytes_data)
+                        instruction_count += 1
+
+                        if instruction_count >= max_instructions:
+                            break
+                    else:
+                        current_offset += 1
+            else:
+                # Skip non-code regions but add comments
+                self._write_data_run_comment(f, current_offset, run_end, region, marked)
+                current_offset = run_end
+
+        return instruction_count
+
+    def _next_run(self, offset: int, limit: int, marks: Optional[bytearray] = None,
+                  base: int = 0) -> Tuple[bool, int, Optional[Dict[str, Any]], bool]:
+        """
+        (is_code, end, region, marked) for the run of bytes starting at offset, ending by limit
+        Bytes carrying a code/data mark (see _code_marks) are decided by it; the region map
+        decides the unmarked ones, and a region-decided run stops at the next marked byte.
+        Code runs span at most 2KB and data runs 1KB, as the region walk always has.
+        """
+        region = self.find_region_at_offset(offset)
+        mark = marks[offset - base] if marks is not None else MARK_NONE
+
+        if mark != MARK_NONE:
+            is_code = mark != MARK_DATA
+            end = min(limit, offset + (2048 if is_code else 1024))
+            match = (_NOT_CODE_MARK if is_code else _NOT_DATA_MARK).search(marks, offset - base, end - base)
+            return is_code, match.start() + base if match else end, region, True
+
+        is_code = bool(region and region['type'] in ['text_or_code'])
+        if is_code:
+            end = min(region['end'], offset + 2048)  # Max 2KB per region
+        else:
+            end = min(region['end'] if region else offset + 1024, offset + 1024)
+        end = min(end, limit)
+        if marks is not None:
+            match = _MARKED.search(marks, offset - base + 1, end - base)
+            if match:
+                end = match.start() + base
+        return is_code, end, region, False
+
+    def _run_stop(self, marks: Optional[bytearray], run_end: int, limit: int, marked: bool,
+                  base: int = 0) -> Optional[int]:
+        """End of a region-decided code run that a marked byte cut short; its instructions must not cross it"""
+        if marked or marks is None or run_end >= limit or marks[run_end - base] == MARK_NONE:
+            return None
+        return run_end
+
+    def _write_code_run_header(self, out, start: int, end: int, region: Optional[Dict[str, Any]], marked: bool):
+        out.write(f"\n; ==========================================\n")
+        out.write(f"; Region: ${start:06X} - ${end:06X}\n")
+        if marked:
+            out.write(f"; Type: code (marked by {', '.join(self.mark_sources)})\n")
+        else:
+            out.write(f"; Type: {region['type']} (confidence: {region['confidence']:.2f})\n")
+        if region:
+            out.write(f"; {region['description']}\n")
+        out.write(f"; ==========================================\n\n")
+
+    def _write_data_run_comment(self, out, start: int, end: int, region: Optional[Dict[str, Any]],
+                                marked: bool) -> bool:
+        """Comment for a skipped data run; False when there is nothing to say about it"""
+        if marked:
+            out.write(f"\n; DATA REGION: ${start:06X} - ${end:06X} (marked by {', '.join(self.mark_sources)})\n")
+        elif region:
+            out.write(f"\n; DATA REGION: ${start:06X} - ${region['end']:06X} ({region['type']})\n")
+        else:
+            return False
+        if start in self.text_strings:
+            out.write(f"; Text: \"{self.text_strings[start][:50]}...\"\n")
+        if start in self.data_tables:
+            table = self.data_tables[start]
+            out.write(f"; Data table: {table['type']} with {table['entry_count']} entries\n")
+        out.write("\n")
+        return True
+
+    def _write_banks_parallel(self, f, workers: Optional[int],
+                              cache_dir: Optional[Path] = None) -> Tuple[int, XrefIndex, Set[int]]:
+        """
+        Disassemble every bank (in worker processes when workers != 1) and merge in bank order;
+        returns the instruction count, the code references and the labelled targets
+        """
+        bank_count = (self.rom_size + self.BANK_SIZE - 1) // self.BANK_SIZE
+        workers = workers or os.cpu_count() or 1
+
+        results: List[Optional[Dict[str, Any]]] = [None] * bank_count
+        input_hashes = [self._bank_input_hash(bank) for bank in range(bank_count)] if cache_dir else []
+        if cache_dir:
+            for bank in range(bank_count):
+                results[bank] = self._load_cached_bank(cache_dir, bank, input_hashes[bank])
+
+        stale = [bank for bank in range(bank_count) if results[bank] is None]
+        if workers == 1 or len(stale) <= 1:
+            for bank in stale:
+                results[bank] = self._render_bank(bank)
+        else:
+            block_table = str(self.block_table_path) if self.block_table_path else None
+            diz_path = str(self.diz_project.path) if self.diz_project is not None else None
+            tasks = [(str(self.rom_path), block_table, diz_path, bank) for bank in stale]
+            with ProcessPoolExecutor(max_workers=min(workers, len(stale))) as executor:
+                for bank, result in zip(stale, executor.map(_bank_worker, tasks)):
+                    results[bank] = result
+
+        if cache_dir:
+            for bank in stale:
+                self._store_cached_bank(cache_dir, bank, input_hashes[bank], results[bank])
+            print(f"Banks re-rendered: {len(stale)} of {bank_count}")
+
+        # Resolve references once every bank's instruction starts are known
+        merge_start = time.time()
+        instruction_starts = set()
+        references = []
+        for result in results:
+            instruction_starts.update(result['instruction_starts'])
+            references.extend(result['references'])
+
+        xrefs = build_xref_index(self.rom_data, self.address_map, code_references=references, pointers=False)
+        labels = {target for target in xrefs.distinct_targets() if target in instruction_starts}
+
+        instruction_count = 0
+        for result in results:
+            f.write(f"\n; ==========================================\n")
+            f.write(f"; Bank ${result['bank']:02X}\n")
+            f.write(f"; ==========================================\n")
+            for offset, text in result['pieces']:
+                if offset in self.code_comments:
+                    f.write(f"; {self.code_comments[offset]}\n")
+                if offset in self.code_labels:
+                    f.write(f"{self.code_labels[offset]}:\n")
+                if offset in labels:
+                    f.write(f"{self._label_for_offset(offset)}:\n")
+                f.write(text)
+            instruction_count += len(result['instruction_starts'])
+
+        self._write_analysis_store(sorted(instruction_starts), labels, xrefs)
+
+        if cache_dir:
+            self._update_annotation_index(cache_dir, results, references, time.time() - merge_start, len(stale))
+
+        return instruction_count, xrefs, labels
+
+    def _write_analysis_store(self, instruction_starts: List[int], labels: Set[int], xrefs: XrefIndex):
+        """Instruction starts, labels and code references as binary tables for later stages"""
+        named = {offset: self._label_for_offset(offset) for offset in labels}
+        named.update(self.code_labels)
+        label_offsets = sorted(named)
+
+        try:
+            self.store.write("instructions", INSTRUCTIONS, {'offset': instruction_starts}, self.rom_digest)
+            self.store.write("labels", LABELS, {
+                'offset': label_offsets,
+                'name': [named[offset] for offset in label_offsets],
+            }, self.rom_digest)
+            self.store.write("xrefs", XREFS, {
+                'target': xrefs.targets, 'source': xrefs.sources, 'kind': xrefs.kinds,
+            }, self.rom_digest)
+        except OSError as e:
+            print(f"WARNING: Analysis store not updated: {e}")
+
+    def _render_bank(self, bank: int) -> Dict[str, Any]:
+        """
+        Render one bank as (offset, text) pieces plus its instruction starts and direct
+        control-flow references; the walk never looks outside the bank, so banks are independent
+        """
+        bank_start = bank * self.BANK_SIZE
+        bank_end = min(bank_start + self.BANK_SIZE, self.rom_size)
+
+        pieces: List[Tuple[int, str]] = []
+        instruction_starts: List[int] = []
+        references: List[Tuple[int, int]] = []
+        self._symbol_lookups = {}
+
+        marks = self._code_marks(bank_start, bank_end)
+        current_offset = bank_start
+        while current_offset < bank_end:
+            is_code, run_end, region, marked = self._next_run(current_offset, bank_end, marks, bank_start)
+            out = io.StringIO()
+
+            if is_code:
+                self._write_code_run_header(out, current_offset, run_end, region, marked)
+                pieces.append((-1, out.getvalue()))
+                stop = self._run_stop(marks, run_end, bank_end, marked, bank_start)
+
+                while current_offset < run_end:
+                    instruction = self._disassemble_annotated_instruction(
+                        current_offset, self._marked_size(marks, current_offset, bank_start), stop
+                    )
+                    if instruction is None:
+                        current_offset += 1
+                        continue
+
+                    out = io.StringIO()
+                    self._write_annotated_instruction(out, instruction)
+                    pieces.append((current_offset, out.getvalue()))
+                    instruction_starts.append(current_offset)
+
+                    target = self._direct_target_offset(current_offset, instruction.bytes_data)
+                    if target is not None:
+                        references.append((current_offset, target))
+
+                    current_offset += len(instruction.bytes_data)
+            else:
+                if self._write_data_run_comment(out, current_offset, run_end, region, marked):
+                    pieces.append((-1, out.getvalue()))
+                current_offset = run_end
+
+        symbol_refs, self._symbol_lookups = self._symbol_lookups, None
+
+        return {
+            'bank': bank,
+            'pieces': pieces,
+            'instruction_starts': instruction_starts,
+            'references': references,
+            'symbol_refs': symbol_refs,
+        }
+
+    def _bank_input_hash(self, bank: int) -> str:
+        """Digest of everything a bank render reads apart from symbol names"""
+        bank_start = bank * self.BANK_SIZE
+        bank_end = min(bank_start + self.BANK_SIZE, self.rom_size)
+
+        if not hasattr(self, '_opcodes_digest'):
+            self._opcodes_digest = hashlib.blake2b(
+                json.dumps(self.opcodes, sort_keys=True, default=str).encode('utf-8'), digest_size=16
+            ).hexdigest()
+
+        inputs = {
+            'version': self.RENDER_VERSION,
+            'opcodes': self._opcodes_digest,
+            'regions': [region for region in self.region_map
+                        if region['start'] < bank_end and region['end'] > bank_start],
+            'text': sorted((offset, text) for offset, text in self.text_strings.items()
+                           if bank_start <= offset < bank_end),
+            'tables': sorted((offset, table['type'], table['entry_count']) for offset, table in self.data_tables.items()
+                             if bank_start <= offset < bank_end),
+            'blocks': [(offset, self.block_sizes[offset]) for offset in
+                       self._block_starts[bisect_left(self._block_starts, bank_start):
+                                          bisect_left(self._block_starts, bank_end)]],
+        }
+
+        digest = hashlib.blake2b(digest_size=16)
+        digest.update(json.dumps(inputs, sort_keys=True).encode('utf-8'))
+        if self.diz_project is not None:
+            digest.update(b'diz')
+            digest.update(self.diz_project.flags[bank_start:bank_end])
+        # Instructions at the end of the bank read up to 3 bytes past it
+        digest.update(self.rom_data[bank_start:bank_end + 3])
+        return digest.hexdigest()
+
+    def _load_cached_bank(self, cache_dir: Path, bank: int, input_hash: str) -> Optional[Dict[str, Any]]:
+        """Cached render when its inputs and every symbol it looked up are unchanged"""
+        cache_file = Path(cache_dir) / f"bank_{bank:02X}.json"
+        if not cache_file.exists():
+            return None
+
+        try:
+            with open(cache_file, 'r', encoding='utf-8') as f:
+                entry = json.load(f)
+        except (OSError, json.JSONDecodeError):
+            return None
+
+        if entry.get('input_hash') != input_hash:
+            return None
+        for address, name in entry['symbol_refs'].items():
+            if self._resolve_symbol(int(address)) != name:
+                return None
+
+        return {
+            'bank': bank,
+            'pieces': [tuple(piece) for piece in entry['pieces']],
+            'instruction_starts': entry['instruction_starts'],
+            'references': [tuple(reference) for reference in entry['references']],
+            'symbol_refs': {int(address): name for address, name in entry['symbol_refs'].items()},
+        }
+
+    def _store_cached_bank(self, cache_dir: Path, bank: int, input_hash: str, result: Dict[str, Any]):
+        cache_dir = Path(cache_dir)
+        cache_dir.mkdir(parents=True, exist_ok=True)
+        entry = {
+            'input_hash': input_hash,
+            'symbol_refs': {str(address): name for address, name in result['symbol_refs'].items()},
+            'pieces': result['pieces'],
+            'instruction_starts': result['instruction_starts'],
+            'references': result['references'],
+        }
+        temp_file = cache_dir / f"bank_{bank:02X}.json.tmp"
+        with open(temp_file, 'w', encoding='utf-8') as f:
+            json.dump(entry, f)
+        os.replace(temp_file, cache_dir / f"bank_{bank:02X}.json")
+
+    def _update_annotation_index(self, cache_dir: Path, results: List[Dict[str, Any]],
+                                 references: List[Tuple[int, int]], merge_time: float, rendered: int):
+        """
+        Record label/comment -> bank and symbol -> bank dependencies, and report which banks the
+        annotation edits since the previous run touched and how long the merge they cost took
+        """
+        index_file = Path(cache_dir) / "annotation_index.json"
+        previous = {}
+        if index_file.exists():
+            try:
+                with open(index_file, 'r', encoding='utf-8') as f:
+                    previous = json.load(f)
+            except (OSError, json.JSONDecodeError):
+                previous = {}
+
+        annotations = {str(offset): name for offset, name in self.code_labels.items()}
+        comments = {str(offset): text for offset, text in self.code_comments.items()}
+
+        changed = set()
+        for key in ('labels', 'comments'):
+            old = previous.get(key, {})
+            new = annotations if key == 'labels' else comments
+            changed.update(offset for offset in set(old) | set(new) if old.get(offset) != new.get(offset))
+
+        symbol_index: Dict[str, List[int]] = defaultdict(list)
+        for result in results:
+            for address in result['symbol_refs']:
+                symbol_index[str(address)].append(result['bank'])
+
+        index = {
+            'labels': annotations,
+            'comments': comments,
+            'label_banks': {offset: int(offset) // self.BANK_SIZE for offset in sorted(set(annotations) | set(comments))},
+            'symbol_banks': dict(symbol_index),
+            'referenced_targets': sorted({target for _, target in references}),
+            'last_run': {'annotation_edits': len(changed), 'banks_rendered': rendered,
+                         'merge_seconds': round(merge_time, 3)},
+        }
+        with open(index_file, 'w', encoding='utf-8') as f:
+            json.dump(index, f)
+
+        if changed:
+            banks = sorted({int(offset) // self.BANK_SIZE for offset in changed})
+            print(f"Annotations changed: {len(changed)} (banks: {', '.join(f'${bank:02X}' for bank in banks)}), "
+                  f"merge {merge_time:.2f}s")
+
+    def _direct_target_offset(self, offset: int, bytes_data: List[int]) -> Optional[int]:
+        """ROM offset targeted by a branch/JSR/JMP/JSL/JML at offset, if it lands in ROM"""
+        opcode = bytes_data[0]
+        bank, address = self._rom_offset_to_snes_address(offset)
+
+        if opcode in self.BRANCH_OPCODES and len(bytes_data) >= 2:
+            displacement = bytes_data[1] - 0x100 if bytes_data[1] >= 0x80 else bytes_data[1]
+            target_bank, target_address = bank, (address + 2 + displacement) & 0xFFFF
+        elif opcode in self.LONG_BRANCH_OPCODES and len(bytes_data) >= 3:
+            displacement = bytes_data[1] | (bytes_data[2] << 8)
+            displacement -= 0x10000 if displacement >= 0x8000 else 0
+            target_bank, target_address = bank, (address + 3 + displacement) & 0xFFFF
+        elif opcode in self.ABSOLUTE_TARGET_OPCODES and len(bytes_data) >= 3:
+            target_bank, target_address = bank, bytes_data[1] | (bytes_data[2] << 8)
+        elif opcode in self.LONG_TARGET_OPCODES and len(bytes_data) >= 4:
+            target_bank, target_address = bytes_data[3] & 0x7F, bytes_data[1] | (bytes_data[2] << 8)
+        else:
+            return None
+
+        if target_address < 0x8000:
+            return None
+        target = target_bank * self.BANK_SIZE + (target_address - 0x8000)
+        return target if target < self.rom_size else None
+
+    def _label_for_offset(self, offset: int) -> str:
+        bank, address = self._rom_offset_to_snes_address(offset)
+        return f"label_{bank:02X}_{address:04X}"
+
     def _write_assembly_header(self, f):
         """Write comprehensive assembly file header"""
         f.write("""; =============================================================================
@@ -496,8 +1095,33 @@ VERSION $00
     timestamp=time.strftime("%Y-%m-%d %H:%M:%S")
 ))
 
-    def _disassemble_annotated_instruction(self, offset: int) -> Optional[AnnotatedInstruction]:
-        """Disassemble instruction with full annotation"""
+    def _data_byte(self, offset: int, description: str, comment: str) -> AnnotatedInstruction:
+        """One ROM byte written as DB inside a code run"""
+        opcode = self.rom_data[offset]
+        bank, addr = self._rom_offset_to_snes_address(offset)
+        return AnnotatedInstruction(
+            offset=offset,
+            bank=bank,
+            address=addr,
+            opcode=opcode,
+            mnemonic="DB",
+            operands=f"${opcode:02X}",
+            bytes_data=[opcode],
+            cycles=1,
+            description=description,
+            comments=[comment],
+            cross_refs=[],
+            data_refs=[],
+            function_context="unknown",
+            region_info="data"
+        )
+
+    def _disassemble_annotated_instruction(self, offset: int, size: Optional[int] = None,
+                                           stop: Optional[int] = None) -> Optional[AnnotatedInstruction]:
+        """
+        Disassemble instruction with full annotation (size overrides the table's, e.g. from the CFG);
+        an instruction that would run past stop (a marked byte) is written as a data byte instead
+        """
         if offset >= self.rom_size:
             return None
 
@@ -505,26 +1129,14 @@ VERSION $00
 
         if opcode not in self.opcodes:
             # Unknown opcode - treat as data
-            bank, addr = self._rom_offset_to_snes_address(offset)
-            return AnnotatedInstruction(
-                offset=offset,
-                bank=bank,
-                address=addr,
-                opcode=opcode,
-                mnemonic="DB",
-                operands=f"${opcode:02X}",
-                bytes_data=[opcode],
-                cycles=1,
-                description=f"Unknown opcode ${opcode:02X}",
-                comments=[f"Unknown instruction - treated as data"],
-                cross_refs=[],
-                data_refs=[],
-                function_context="unknown",
-                region_info="data"
-            )
+            return self._data_byte(offset, f"Unknown opcode ${opcode:02X}", "Unknown instruction - treated as data")
 
         opcode_info = self.opcodes[opcode]
-        size = opcode_info['size']
+        if size is None:
+            size = opcode_info['size']
+        if stop is not None and offset + size > stop:
+            return self._data_byte(offset, f"Truncated ${opcode:02X} instruction",
+                                   f"Instruction would run into marked bytes at ${stop:06X} - treated as data")
 
         # Read instruction bytes
         bytes_data = []
@@ -606,34 +1218,29 @@ VERSION $00
                 return f"${addr:06X}"
             return "$??????"
         else:
-            return "???"
+            operand = int.from_bytes(bytes(bytes_data[1:]), "little")
+            _, addr = self._rom_offset_to_snes_address(offset)
+            return format_operand(bytes_data[0], operand, len(bytes_data), addr)
 
     def _rom_offset_to_snes_address(self, offset: int) -> Tuple[int, int]:
         """Convert ROM offset to SNES bank:address"""
-        bank = offset // 0x8000
-        address = 0x8000 + (offset % 0x8000)
-        return bank, address
+        address = self.address_map.to_snes(offset)
+        return address >> 16, address & 0xFFFF
 
     def _get_address_symbol(self, address: int) -> Optional[str]:
         """Get symbol name for address if known"""
-        # Check for hardware registers
-        hw_registers = {
-            0x2100: "INIDISP",
-            0x2101: "OBJSEL",
-            0x2102: "OAMADDL",
-            0x2103: "OAMADDH",
-            0x2104: "OAMDATA",
-            0x2105: "BGMODE",
-            0x2140: "APUIO0",
-            0x2141: "APUIO1",
-            0x2142: "APUIO2",
-            0x2143: "APUIO3",
-        }
+        symbol = self._resolve_symbol(address)
+        if self._symbol_lookups is not None:
+            self._symbol_lookups[address] = symbol
+        return symbol
 
-        if address in hw_registers:
-            return hw_registers[address]
+    def _resolve_symbol(self, address: int) -> Optional[str]:
+        # Check for hardware registers, then hand-added symbols
+        for name, addr in self.HW_REGISTERS.items():
+            if addr == address:
+                return name
 
-        return None
+        return self.user_symbols.get(address)
 
     def _generate_instruction_comments(self, offset: int, opcode_info: Dict[str, Any], operands: str) -> List[str]:
         """Generate comprehensive comments for instruction"""
@@ -748,37 +1355,35 @@ VERSION $00
             f.write("; Dragon Quest III - Symbol Definitions\n")
             f.write("; =============================================================================\n\n")
 
+            generated = self._generated_symbols()
+            hw_count = len(self.HW_REGISTERS)
+
             # Hardware registers
             f.write("; SNES Hardware Registers\n")
-            hw_registers = {
-                "INIDISP": 0x2100,
-                "OBJSEL": 0x2101,
-                "OAMADDL": 0x2102,
-                "OAMADDH": 0x2103,
-                "OAMDATA": 0x2104,
-                "BGMODE": 0x2105,
-                "APUIO0": 0x2140,
-                "APUIO1": 0x2141,
-                "APUIO2": 0x2142,
-                "APUIO3": 0x2143,
-            }
-
-            for name, addr in hw_registers.items():
+            for name, addr in generated[:hw_count]:
                 f.write(f".DEFINE {name:<12} ${addr:04X}\n")
 
             f.write("\n")
 
             # Game-specific symbols from data tables
             f.write("; Game Data Structures\n")
-            for offset, table in list(self.data_tables.items())[:20]:  # First 20 tables
-                bank, addr = self._rom_offset_to_snes_address(offset)
-                name = f"DATA_{table['type'].upper()}_{bank:02X}_{addr:04X}"
+            for name, addr in generated[hw_count:]:
                 f.write(f".DEFINE {name:<20} ${addr:04X}\n")
 
+            # Hand-added symbols are kept across regenerations
+            if self.user_symbols:
+                f.write("\n; Project Symbols\n")
+                for addr, name in self.user_symbols.items():
+                    f.write(f".DEFINE {name:<20} ${addr:04X}\n")
+
         print(f"Symbol table generated: {symbols_file}")
 
-    def _generate_cross_ref_docs(self, asm_dir: Path):
-        """Generate cross-reference documentation"""
+    def _generate_cross_ref_docs(self, asm_dir: Path, xrefs: Optional[XrefIndex] = None,
+                                 labels: Optional[Set[int]] = None):
+        """
+        Generate cross-reference documentation (and the binary index beside it in bank mode)
+        Cross-bank references are listed by source, for targets that got a label
+        """
         xref_file = asm_dir / "cross_references.md"
 
         with open(xref_file, 'w') as f:
@@ -797,8 +1402,25 @@ VERSION $00
                 bank, addr = self._rom_offset_to_snes_address(offset)
                 f.write(f"- `${bank:02X}:{addr:04X}` - {table['type']}: {table['entry_count']} entries\n")
 
+            if xrefs:
+                f.write("\n## Most Referenced Locations\n\n")
+                for target, count in xrefs.most_referenced(20, CODE_KINDS):
+                    f.write(f"- `{self._label_for_offset(target)}` - {count} references\n")
+
+                f.write("\n## Cross-Bank Calls and Jumps\n\n")
+                cross_bank_refs = sorted(
+                    (source, target) for target, source, _ in xrefs.entries(CODE_KINDS)
+                    if target in (labels or ()) and source // self.BANK_SIZE != target // self.BANK_SIZE
+                )
+                for source, target in cross_bank_refs:
+                    bank, addr = self._rom_offset_to_snes_address(source)
+                    f.write(f"- `${bank:02X}:{addr:04X}` -> `{self._label_for_offset(target)}`\n")
+
         print(f"Cross-reference docs generated: {xref_file}")
 
+        if xrefs is not None:
+            xrefs.save(asm_dir / "cross_references.xref")
+
     def _count_lines(self, file_path: Path) -> int:
         """Count lines in a file"""
         try:
@@ -807,6 +1429,26 @@ VERSION $00
         except:
             return 0
 
+_worker_disassemblers: Dict[str, UltimateDisassembler] = {}
+
+
+def _bank_worker(task: Tuple[str, Optional[str], Optional[str], int]) -> Dict[str, Any]:
+    """Render one bank of a by_bank generation run"""
+    rom_path, block_table, diz_path, bank = task
+
+    key = f"{rom_path}|{block_table}|{diz_path}"
+    if key not in _worker_disassemblers:
+        disassembler = UltimateDisassembler(rom_path, verbose=False)
+        if block_table:
+            disassembler.load_block_table(Path(block_table))
+        if diz_path:
+            # Only the marks matter here; labels and comments are applied when banks are merged
+            disassembler.load_code_annotations(diz_path=Path(diz_path))
+        _worker_disassemblers[key] = disassembler
+
+    return _worker_disassemblers[key]._render_bank(bank)
+
+
 def main():
     """Main entry point"""
     print("STARTING: Dragon Quest III - Ultimate Disassembly Generation")
@@ -829,9 +1471,31 @@ def main():
         print("ERROR: No ROM file found!")
         return
 
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Dragon Quest III - Ultimate Disassembly Generation")
+    parser.add_argument("--by-bank", action="store_true", help="Disassemble every bank in parallel (no instruction cap)")
+    parser.add_argument("--workers", type=int, help="Worker processes for --by-bank (default: CPU count)")
+    parser.add_argument("--max-instructions", type=int,
+                        help="Instruction cap for the sequential walk (default 50000; --by-bank has none)")
+    parser.add_argument("--incremental", action="store_true", help="Reuse cached banks; re-render only what changed")
+    parser.add_argument("--labels", default="src/labels.inc", help="labels.inc applied to bank-mode output")
+    parser.add_argument("--diz", help="DiztinGUIsh project whose marks decide code/data (labels/comments: bank mode)")
+    parser.add_argument("--blocks", default="analysis/cfg_blocks.json",
+                        help="cfg_engine block table whose instructions mark code (and their M/X sizes)")
+    args = parser.parse_args()
+
     # Generate ultimate assembly
     disassembler = UltimateDisassembler(rom_path)
-    disassembler.generate_ultimate_assembly(max_instructions=50000)  # Generate up to 50K instructions
+    if disassembler.load_block_table(Path(args.blocks)):
+        print(f"Block table: {len(disassembler.block_sizes):,} instructions from {args.blocks}")
+    if args.by_bank or args.incremental or args.diz:
+        disassembler.load_code_annotations(Path(args.labels), Path(args.diz) if args.diz else None)
+    max_instructions = args.max_instructions
+    if max_instructions is None and not (args.by_bank or args.incremental):
+        max_instructions = 50000
+    disassembler.generate_ultimate_assembly(max_instructions=max_instructions, by_bank=args.by_bank,
+                                            workers=args.workers, incremental=args.incremental)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+"""
+Dragon Quest III - Cross-Reference Index
+========================================
+
+Every reference into ROM (branches, jumps and calls from the decoded
+instruction stream, plus 16/24-bit pointer candidates in the raw data)
+collected in one pass into a compact target -> source table. Entries are
+three parallel arrays sorted by (target, source), so "who references
+$C0/8000" and range queries are binary searches, and the index persists
+as a flat binary file that loads back through mmap without parsing.
+"""
+
+import mmap
+import os
+import struct
+import sys
+from array import array
+from bisect import bisect_left
+from collections import Counter
+from pathlib import Path
+from typing import Dict, Iterable, Iterator, List, Optional, Sequence, Tuple, Union
+
+from address_map import AddressMap
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+XREF_MAGIC = b"DQ3X"
+XREF_VERSION = 1
+HEADER_FORMAT = "<4sHHI"  # magic, version, reserved, entry count
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+# Reference kinds (one byte per entry)
+KIND_BRANCH = 0
+KIND_JUMP = 1
+KIND_CALL = 2
+KIND_POINTER16 = 3
+KIND_POINTER24 = 4
+
+KIND_NAMES = {
+    KIND_BRANCH: "branch",
+    KIND_JUMP: "jump",
+    KIND_CALL: "call",
+    KIND_POINTER16: "pointer16",
+    KIND_POINTER24: "pointer24",
+}
+
+CODE_KINDS = frozenset((KIND_BRANCH, KIND_JUMP, KIND_CALL))
+POINTER_KINDS = frozenset((KIND_POINTER16, KIND_POINTER24))
+
+# Target operand forms and their sizes
+TARGET_RELATIVE = 1  # rel8 displacement
+TARGET_RELATIVE_LONG = 2  # rel16 displacement (BRL)
+TARGET_ABSOLUTE = 3  # 16-bit address in the current bank
+TARGET_LONG = 4  # 24-bit address
+
+OPERAND_SIZES = {TARGET_RELATIVE: 1, TARGET_RELATIVE_LONG: 2, TARGET_ABSOLUTE: 2, TARGET_LONG: 3}
+
+# Direct-target control flow: opcode -> (kind, operand form)
+DIRECT_TARGETS = {
+    **{opcode: (KIND_BRANCH, TARGET_RELATIVE) for opcode in (0x10, 0x30, 0x50, 0x70, 0x80, 0x90, 0xB0, 0xD0, 0xF0)},
+    0x82: (KIND_BRANCH, TARGET_RELATIVE_LONG),
+    0x4C: (KIND_JUMP, TARGET_ABSOLUTE),
+    0x5C: (KIND_JUMP, TARGET_LONG),
+    0x20: (KIND_CALL, TARGET_ABSOLUTE),
+    0x22: (KIND_CALL, TARGET_LONG),
+}
+
+# Sort key packing: target | source | kind in one int, so a single sort orders everything
+_SOURCE_BITS = 32
+_KIND_BITS = 4
+
+
+class XrefIndex:
+    """Sorted (target, source, kind) table"""
+
+    def __init__(self, targets: Sequence[int], sources: Sequence[int], kinds: Buffer):
+        if not len(targets) == len(sources) == len(kinds):
+            raise ValueError("Cross-reference columns differ in length")
+
+        self.targets = targets
+        self.sources = sources
+        self.kinds = kinds
+        self._map = None
+
+    def __len__(self) -> int:
+        return len(self.targets)
+
+    def _span(self, start: int, end: int) -> Tuple[int, int]:
+        """Entry positions whose targets fall in [start, end)"""
+        return bisect_left(self.targets, start), bisect_left(self.targets, end)
+
+    def references_to(self, target: int, kinds: Optional[Iterable[int]] = None) -> List[Tuple[int, int]]:
+        """(source, kind) of every reference to target, sources ascending"""
+        low, high = self._span(target, target + 1)
+        return self._select(low, high, kinds, lambda i: (self.sources[i], self.kinds[i]))
+
+    def sources_of(self, target: int, kinds: Optional[Iterable[int]] = None) -> List[int]:
+        """Offsets that reference target"""
+        low, high = self._span(target, target + 1)
+        if kinds is None:
+            return list(self.sources[low:high])
+        return self._select(low, high, kinds, self.sources.__getitem__)
+
+    def references_in(
+        self, start: int, end: int, kinds: Optional[Iterable[int]] = None
+    ) -> List[Tuple[int, int, int]]:
+        """(target, source, kind) of every reference landing in [start, end)"""
+        low, high = self._span(start, end)
+        return self._select(low, high, kinds, lambda i: (self.targets[i], self.sources[i], self.kinds[i]))
+
+    def _select(self, low: int, high: int, kinds: Optional[Iterable[int]], item) -> list:
+        if kinds is None:
+            return [item(i) for i in range(low, high)]
+        wanted = frozenset(kinds)
+        entry_kinds = self.kinds
+        return [item(i) for i in range(low, high) if entry_kinds[i] in wanted]
+
+    def entries(self, kinds: Optional[Iterable[int]] = None) -> Iterator[Tuple[int, int, int]]:
+        """Every (target, source, kind), targets ascending"""
+        if kinds is None:
+            return zip(self.targets, self.sources, self.kinds)
+        wanted = frozenset(kinds)
+        return ((t, s, k) for t, s, k in zip(self.targets, self.sources, self.kinds) if k in wanted)
+
+    def distinct_targets(self, kinds: Optional[Iterable[int]] = None) -> List[int]:
+        """Referenced offsets, ascending"""
+        if kinds is None:
+            return sorted(set(self.targets))
+        return sorted({target for target, _, _ in self.entries(kinds)})
+
+    def most_referenced(self, count: int = 20, kinds: Optional[Iterable[int]] = None) -> List[Tuple[int, int]]:
+        """(target, reference count) for the most referenced targets"""
+        if kinds is None:
+            counts = Counter(self.targets)
+        else:
+            counts = Counter(target for target, _, _ in self.entries(kinds))
+        return counts.most_common(count)
+
+    def as_dict(self, kinds: Optional[Iterable[int]] = None) -> Dict[int, List[int]]:
+        """target -> sources, for callers that want plain containers"""
+        grouped: Dict[int, List[int]] = {}
+        for target, source, _ in self.entries(kinds):
+            grouped.setdefault(target, []).append(source)
+        return grouped
+
+    def kind_counts(self) -> Dict[str, int]:
+        return {KIND_NAMES[kind]: count for kind, count in sorted(Counter(self.kinds).items())}
+
+    def save(self, path: Union[str, Path]):
+        """Write the flat binary form (header, targets u32, sources u32, kinds u8), atomically"""
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+
+        columns = [array("I", self.targets), array("I", self.sources)]
+        if sys.byteorder != "little":
+            for column in columns:
+                column.byteswap()
+
+        temp_path = path.with_suffix(path.suffix + ".tmp")
+        with open(temp_path, "wb") as f:
+            f.write(struct.pack(HEADER_FORMAT, XREF_MAGIC, XREF_VERSION, 0, len(self)))
+            for column in columns:
+                f.write(column.tobytes())
+            f.write(bytes(self.kinds))
+        os.replace(temp_path, path)
+
+    @classmethod
+    def load(cls, path: Union[str, Path]) -> Optional["XrefIndex"]:
+        """Map a saved index (columns are views of the file), or None if missing or stale"""
+        try:
+            with open(path, "rb") as f:
+                if os.fstat(f.fileno()).st_size < HEADER_SIZE:
+                    return None
+                mapped = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except (OSError, ValueError):
+            return None
+
+        magic, version, _, count = struct.unpack_from(HEADER_FORMAT, mapped)
+        if magic != XREF_MAGIC or version != XREF_VERSION or len(mapped) != HEADER_SIZE + count * 9:
+            mapped.close()
+            return None
+
+        view = memoryview(mapped)
+        columns = []
+        for index in range(2):
+            start = HEADER_SIZE + index * count * 4
+            column = view[start : start + count * 4]
+            if sys.byteorder == "little":
+                columns.append(column.cast("I"))
+            else:
+                columns.append(array("I", struct.unpack(f"<{count}I", column)))
+
+        index = cls(columns[0], columns[1], view[HEADER_SIZE + count * 8 :])
+        index._map = mapped
+        return index
+
+
+class XrefBuilder:
+    """Collects references in any order; build() sorts them once"""
+
+    def __init__(self):
+        self._keys: List[int] = []
+
+    def __len__(self) -> int:
+        return len(self._keys)
+
+    def add(self, source: int, target: int, kind: int):
+        self._keys.append((((target << _SOURCE_BITS) | source) << _KIND_BITS) | kind)
+
+    def add_many(self, sources: Iterable[int], targets: Iterable[int], kind: int):
+        """Bulk add with one kind (e.g. the arrays from AddressMap.scan_pointers)"""
+        self._keys.extend(
+            (((target << _SOURCE_BITS) | source) << _KIND_BITS) | kind for source, target in zip(sources, targets)
+        )
+
+    def add_instructions(self, data: Buffer, decoded, address_map: AddressMap):
+        """Direct branch/jump/call targets of a decoded instruction stream (decoder65816.DecodedInstructions)"""
+        to_snes = address_map.to_snes
+        to_offset = address_map.to_offset
+        append = self._keys.append
+
+        for offset, opcode in zip(decoded.offsets, decoded.opcodes):
+            direct = DIRECT_TARGETS.get(opcode)
+            if direct is None:
+                continue
+            kind, form = direct
+            if offset + 1 + OPERAND_SIZES[form] > len(data):
+                continue
+
+            address = to_snes(offset)
+            if form == TARGET_RELATIVE:
+                displacement = data[offset + 1]
+                displacement -= 0x100 if displacement >= 0x80 else 0
+                target_address = (address & 0xFF0000) | ((address + 2 + displacement) & 0xFFFF)
+            elif form == TARGET_RELATIVE_LONG:
+                displacement = data[offset + 1] | (data[offset + 2] << 8)
+                displacement -= 0x10000 if displacement >= 0x8000 else 0
+                target_address = (address & 0xFF0000) | ((address + 3 + displacement) & 0xFFFF)
+            elif form == TARGET_ABSOLUTE:
+                target_address = (address & 0xFF0000) | data[offset + 1] | (data[offset + 2] << 8)
+            else:
+                target_address = data[offset + 1] | (data[offset + 2] << 8) | (data[offset + 3] << 16)
+
+            target = to_offset(target_address)
+            if target is not None:
+                append((((target << _SOURCE_BITS) | offset) << _KIND_BITS) | kind)
+
+    def build(self) -> XrefIndex:
+        keys = sorted(set(self._keys))
+        source_mask = (1 << _SOURCE_BITS) - 1
+        kind_mask = (1 << _KIND_BITS) - 1
+        targets = array("I", [key >> (_SOURCE_BITS + _KIND_BITS) for key in keys])
+        sources = array("I", [(key >> _KIND_BITS) & source_mask for key in keys])
+        kinds = bytes(key & kind_mask for key in keys)
+        return XrefIndex(targets, sources, kinds)
+
+
+def kind_for_opcode(opcode: int) -> Optional[int]:
+    """Reference kind of a direct control-flow opcode"""
+    direct = DIRECT_TARGETS.get(opcode)
+    return direct[0] if direct else None
+
+
+def build_xref_index(
+    data: Buffer,
+    address_map: AddressMap,
+    decoded=None,
+    code_references: Optional[Iterable[Tuple[int, int]]] = None,
+    pointers: bool = True,
+) -> XrefIndex:
+    """
+    One index over the instruction stream and the raw data
+    decoded is a DecodedInstructions stream whose direct targets are resolved here;
+    code_references are (source, target) pairs a disassembler already resolved, typed by
+    the opcode at source; pointers adds every 16/24-bit pointer candidate in data.
+    """
+    builder = XrefBuilder()
+
+    if decoded is not None:
+        builder.add_instructions(data, decoded, address_map)
+
+    if code_references is not None:
+        for source, target in code_references:
+            kind = kind_for_opcode(data[source])
+            builder.add(source, target, KIND_JUMP if kind is None else kind)
+
+    if pointers:
+        for width, kind in ((2, KIND_POINTER16), (3, KIND_POINTER24)):
+            sources, targets = address_map.scan_pointers(data, width)
+            builder.add_many(sources, targets, kind)
+
+    return builder.build()
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+
+    sys.path.append(str(Path(__file__).parent.parent / "disassembly"))
+    from decoder65816 import decode_linear
+    from rom_image import open_rom_image
+
+    parser = argparse.ArgumentParser(description="Build or query the ROM cross-reference index")
+    parser.add_argument("rom_file", help="ROM file")
+    parser.add_argument("--index", help="Index file to load, or to write after building")
+    parser.add_argument("--who", action="append", type=lambda v: int(v, 0), default=[],
+                        help="SNES address to list references to (repeatable)")
+    args = parser.parse_args()
+
+    image = open_rom_image(args.rom_file)
+    index = XrefIndex.load(args.index) if args.index else None
+    if index is None:
+        start_time = time.time()
+        index = build_xref_index(image.data, image.address_map, decode_linear(image.data))
+        print(f"🔗 Built {len(index):,} references in {time.time() - start_time:.2f}s: {index.kind_counts()}")
+        if args.index:
+            index.save(args.index)
+            print(f"Index saved to {args.index}")
+    else:
+        print(f"🔗 Loaded {len(index):,} references from {args.index}")
+
+    for address in args.who:
+        offset = image.to_offset(address)
+        if offset is None:
+            print(f"${address:06X}: not in ROM")
+            continue
+        references = index.references_to(offset)
+        print(f"${address:06X} (offset ${offset:06X}): {len(references)} references")
+        for source, kind in references[:20]:
+            print(f"   ${image.to_snes(source):06X} {KIND_NAMES[kind]}")
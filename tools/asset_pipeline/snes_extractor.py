@@ -14,6 +14,20 @@ import json
 from dataclasses import dataclass
 import time
 
+# Shared region classifier
+sys.path.append(str(Path(__file__).parent.parent / "analysis"))
+from rom_classifier import REGION_AUDIO, REGION_GRAPHICS, REGION_NAMES, REGION_TEXT, classify_rom
+from rolling_entropy import entropy_profile, shannon_entropy
+from rom_image import open_rom_image
+from brr_codec import DEFAULT_SAMPLE_RATE, BRRSample, decode_brr, scan_brr_samples, write_wav
+
+# Speculative stream probe
+sys.path.append(str(Path(__file__).parent.parent / "compression"))
+from compression_probe import probe_ranges
+
+# 4KB chunks above this entropy (bits per byte) are probed for compressed streams
+COMPRESSED_CHUNK_ENTROPY = 7.0
+
 # Import our compression engine
 try:
     sys.path.append(str(Path(__file__).parent.parent))
@@ -87,6 +101,8 @@ class SNESROMAnalyzer:
     def __init__(self, rom_path: Path):
         self.rom_path = rom_path
         self.rom_data = self._load_rom()
+        self._classification = None
+        self._brr_samples: Optional[List[BRRSample]] = None
         self.compression_engine = get_compression_engine()
 
         # DQ3 specific memory layout
@@ -120,22 +136,20 @@ class SNESROMAnalyzer:
         self.logs_dir = Path(__file__).parent.parent / "logs"
         self.logs_dir.mkdir(exist_ok=True)
 
-    def _load_rom(self) -> bytes:
+    def _load_rom(self) -> memoryview:
         """Load ROM data with validation"""
         try:
-            with open(self.rom_path, "rb") as f:
-                data = f.read()
+            # Shared memory-mapped image; the 0x200 byte copier header is skipped there
+            image = open_rom_image(self.rom_path)
 
             # Basic SNES ROM validation
-            if len(data) < 0x200000:  # Minimum expected size for DQ3
-                raise ValueError(f"ROM file too small: {len(data)} bytes")
+            if image.size < 0x200000:  # Minimum expected size for DQ3
+                raise ValueError(f"ROM file too small: {image.size} bytes")
 
-            # Check for header (0x200 byte header sometimes present)
-            if len(data) % 1024 == 512:
+            if image.header_size:
                 print("ROM has 512-byte header, removing...")
-                data = data[512:]
 
-            return data
+            return image.data
 
         except Exception as e:
             raise RuntimeError(f"Could not load ROM {self.rom_path}: {e}")
@@ -169,57 +183,39 @@ class SNESROMAnalyzer:
         """Detect regions that might contain compressed data"""
         compressed_regions = []
 
-        # Look for patterns indicative of compression
-        chunk_size = 0x1000  # 4KB chunks
-
-        for offset in range(0, len(self.rom_data) - chunk_size, chunk_size):
-            chunk = self.rom_data[offset : offset + chunk_size]
-
-            # Calculate entropy to detect compressed data
-            entropy = self._calculate_entropy(chunk)
-
-            # High entropy (> 7.0) often indicates compression
-            if entropy > 7.0:
-                # Try decompression with our algorithms
-                for algorithm in ["basic_ring400", "simple_tail_window"]:
-                    try:
-                        decompressed = self.compression_engine.decompress(chunk, algorithm)
-                        if len(decompressed) > len(chunk):
-                            compressed_regions.append(
-                                {
-                                    "offset": offset,
-                                    "size": chunk_size,
-                                    "algorithm": algorithm,
-                                    "entropy": entropy,
-                                    "decompressed_size": len(decompressed),
-                                }
-                            )
-                            break
-                    except:
-                        continue
+        # Only probe chunks dense enough to be compressed
+        chunk_size = 0x1000
+        chunk_entropy = entropy_profile(self.rom_data, chunk_size, chunk_size)
+
+        ranges = []
+        for index, entropy in enumerate(chunk_entropy):
+            if entropy <= COMPRESSED_CHUNK_ENTROPY:
+                continue
+            offset = index * chunk_size
+            if ranges and ranges[-1][1] == offset:
+                ranges[-1][1] = offset + chunk_size
+            else:
+                ranges.append([offset, offset + chunk_size])
+
+        # Speculative decode at every candidate offset of those chunks
+        for stream in probe_ranges(open_rom_image(self.rom_path), ranges):
+            compressed_regions.append(
+                {
+                    "offset": stream.offset,
+                    "size": stream.consumed,
+                    "algorithm": stream.algorithm,
+                    "entropy": chunk_entropy[stream.offset // chunk_size],
+                    "decompressed_size": stream.output_size,
+                    "ratio": round(stream.ratio, 3),
+                }
+            )
 
+        compressed_regions.sort(key=lambda region: region["offset"])
         return compressed_regions
 
     def _calculate_entropy(self, data: bytes) -> float:
         """Calculate Shannon entropy of data"""
-        if not data:
-            return 0.0
-
-        # Count byte frequencies
-        frequencies = {}
-        for byte in data:
-            frequencies[byte] = frequencies.get(byte, 0) + 1
-
-        # Calculate entropy
-        entropy = 0.0
-        data_len = len(data)
-
-        for count in frequencies.values():
-            probability = count / data_len
-            if probability > 0:
-                entropy -= probability * (probability.bit_length() - 1)
-
-        return entropy
+        return shannon_entropy(data)
 
     def _identify_data_regions(self) -> List[Dict[str, Any]]:
         """Identify different types of data regions in ROM"""
@@ -239,164 +235,40 @@ class SNESROMAnalyzer:
 
         return regions
 
-    def _find_graphics_regions(self) -> List[Dict[str, Any]]:
-        """Find graphics data regions"""
-        graphics_regions = []
-
-        # Look for 4bpp tile patterns (common in SNES)
-        for offset in range(0x100000, min(len(self.rom_data), 0x400000), 0x1000):
-            chunk = self.rom_data[offset : offset + 0x1000]
-
-            # Check for tile-like patterns
-            if self._appears_to_be_graphics(chunk):
-                graphics_regions.append(
-                    {
-                        "type": "graphics",
-                        "offset": offset,
-                        "size": 0x1000,
-                        "confidence": 0.8,
-                        "format": "4bpp_tiles",
-                    }
-                )
-
-        return graphics_regions
-
-    def _appears_to_be_graphics(self, data: bytes) -> bool:
-        """Heuristic to detect graphics data"""
-        if len(data) < 32:
-            return False
+    @property
+    def classification(self):
+        """Shared single-pass region classification of the ROM (see rom_classifier)"""
+        if self._classification is None:
+            self._classification = classify_rom(self.rom_data)
+        return self._classification
 
-        # Check for patterns common in 4bpp graphics
-        zero_count = data.count(0)
-
-        # Graphics often have many zero bytes (transparency)
-        if zero_count > len(data) * 0.3:
-            # Check for non-random distribution
-            byte_variety = len(set(data))
-            if byte_variety < 128:  # Not too random
-                return True
+    def _classified_regions(self, region_type: int, score: str, **fields) -> List[Dict[str, Any]]:
+        """Classifier runs of one type as region dicts, scored by the mean of one column"""
+        regions = []
+        for start, end, _ in self.classification.regions(region_type):
+            summary = self.classification.summarize(start, end)
+            regions.append(
+                {
+                    "type": REGION_NAMES[region_type],
+                    "offset": start,
+                    "size": end - start,
+                    "confidence": round(min(1.0, summary[score]), 3),
+                    **fields,
+                }
+            )
+        return regions
 
-        return False
+    def _find_graphics_regions(self) -> List[Dict[str, Any]]:
+        """Find graphics data regions"""
+        return self._classified_regions(REGION_GRAPHICS, "tile", format="4bpp_tiles")
 
     def _find_audio_regions(self) -> List[Dict[str, Any]]:
         """Find audio data regions (BRR samples)"""
-        audio_regions = []
-
-        # BRR samples have specific header patterns
-        for offset in range(0, len(self.rom_data) - 9, 0x100):
-            chunk = self.rom_data[offset : offset + 9]
-
-            # Check for BRR header pattern
-            if self._appears_to_be_brr(chunk):
-                # Estimate BRR sample size
-                sample_size = self._estimate_brr_size(offset)
-                audio_regions.append(
-                    {
-                        "type": "audio",
-                        "offset": offset,
-                        "size": sample_size,
-                        "confidence": 0.7,
-                        "format": "brr",
-                    }
-                )
-
-        return audio_regions
-
-    def _appears_to_be_brr(self, data: bytes) -> bool:
-        """Check if data appears to be BRR audio"""
-        if len(data) < 9:
-            return False
-
-        # BRR blocks are 9 bytes: 1 byte header + 8 bytes data
-        header = data[0]
-
-        # Valid BRR header patterns
-        filter_val = (header >> 2) & 0x03
-        shift_val = header >> 4
-
-        return filter_val <= 3 and shift_val <= 12
-
-    def _estimate_brr_size(self, offset: int) -> int:
-        """Estimate size of BRR sample"""
-        size = 0
-        pos = offset
-
-        while pos + 9 <= len(self.rom_data):
-            header = self.rom_data[pos]
-
-            # Check end flag
-            if header & 0x01:  # End flag set
-                return size + 9
-
-            size += 9
-            pos += 9
-
-            # Safety limit
-            if size > 0x10000:  # 64KB max
-                break
-
-        return size
+        return self._classified_regions(REGION_AUDIO, "brr", format="brr")
 
     def _find_text_regions(self) -> List[Dict[str, Any]]:
         """Find text/dialog regions"""
-        text_regions = []
-
-        # Look for Shift-JIS or ASCII text
-        for offset in range(0, len(self.rom_data) - 0x100, 0x100):
-            chunk = self.rom_data[offset : offset + 0x100]
-
-            if self._appears_to_be_text(chunk):
-                text_size = self._estimate_text_size(offset)
-                text_regions.append(
-                    {
-                        "type": "text",
-                        "offset": offset,
-                        "size": text_size,
-                        "confidence": 0.6,
-                        "encoding": "shift-jis",
-                    }
-                )
-
-        return text_regions
-
-    def _appears_to_be_text(self, data: bytes) -> bool:
-        """Check if data appears to be text"""
-        try:
-            # Try to decode as Shift-JIS
-            text = data.decode("shift-jis", errors="ignore")
-
-            # Check for printable characters
-            printable_count = sum(1 for c in text if c.isprintable())
-
-            return printable_count > len(text) * 0.7
-
-        except:
-            return False
-
-    def _estimate_text_size(self, offset: int) -> int:
-        """Estimate size of text block"""
-        size = 0
-        pos = offset
-
-        while pos < len(self.rom_data):
-            byte = self.rom_data[pos]
-
-            # Common text terminators
-            if byte in [0x00, 0xFF]:
-                return size
-
-            # Check if still looks like text
-            if byte < 0x20 and byte not in [0x0A, 0x0D]:  # Not printable/newline
-                break
-
-            size += 1
-            pos += 1
-
-            # Safety limit
-            if size > 0x1000:
-                break
-
-        return size
+        return self._classified_regions(REGION_TEXT, "text", encoding="shift-jis")
 
     def extract_dq3_assets(self) -> List[AssetInfo]:
         """Extract known DQ3 assets using layout information"""
@@ -418,6 +290,10 @@ class SNESROMAnalyzer:
         graphics_assets = self._extract_graphics_assets()
         assets.extend(graphics_assets)
 
+        # Extract BRR samples
+        audio_assets = self._extract_audio_assets()
+        assets.extend(audio_assets)
+
         return assets
 
     def _extract_character_classes(self) -> List[AssetInfo]:
@@ -567,6 +443,38 @@ class SNESROMAnalyzer:
 
         return graphics_assets
 
+    @property
+    def brr_samples(self) -> List[BRRSample]:
+        """Decoded BRR samples found anywhere in the ROM (see brr_codec)"""
+        if self._brr_samples is None:
+            self._brr_samples = scan_brr_samples(open_rom_image(self.rom_path))
+        return self._brr_samples
+
+    def _extract_audio_assets(self) -> List[AudioAsset]:
+        """Extract BRR sample assets"""
+        audio_assets = []
+
+        for i, sample in enumerate(self.brr_samples):
+            asset = AudioAsset(
+                name=f"brr_sample_{i:03d}",
+                offset=sample.offset,
+                size=sample.size,
+                asset_type="audio",
+                sample_rate=DEFAULT_SAMPLE_RATE,
+                channels=1,
+                format="brr",
+                metadata={
+                    "blocks": sample.blocks,
+                    "pcm_samples": len(sample.pcm),
+                    "loops": sample.loops,
+                    "peak": sample.peak,
+                },
+            )
+
+            audio_assets.append(asset)
+
+        return audio_assets
+
     def _estimate_graphics_dimensions(self, graphics_data: bytes) -> Dict[str, int]:
         """Estimate graphics dimensions from data size"""
         data_size = len(graphics_data)
@@ -591,8 +499,9 @@ class SNESROMAnalyzer:
 
     def export_assets(self, output_dir: Path, assets: List[AssetInfo]) -> Dict[str, Any]:
         """Export extracted assets to files"""
-        output_dir.mkdir(exist_ok=True)
+        output_dir.mkdir(parents=True, exist_ok=True)
         export_results = {"exported_count": 0, "failed_count": 0, "exports": []}
+        decoded_samples = {sample.offset: sample for sample in self._brr_samples or []}
 
         for asset in assets:
             try:
@@ -608,6 +517,12 @@ class SNESROMAnalyzer:
                 with open(raw_file, "wb") as f:
                     f.write(raw_data)
 
+                # BRR samples also export as playable WAV
+                if isinstance(asset, AudioAsset) and asset.format == "brr":
+                    decoded = decoded_samples.get(asset.offset)
+                    pcm = decoded.pcm if decoded else decode_brr(self.rom_data, asset.offset, asset.size // 9).pcm
+                    write_wav(asset_dir / f"{asset.name}.wav", pcm, asset.sample_rate or DEFAULT_SAMPLE_RATE)
+
                 # Export metadata
                 metadata_file = asset_dir / f"{asset.name}.json"
                 metadata = {
@@ -0,0 +1,372 @@
+#!/usr/bin/env python3
+"""
+DQ3R Benchmark Suite
+Times every hot path of the pipeline on the real ROM (codecs, 65816 decode and CFG, tiles,
+entropy and classification sweeps, pointer indexing, and optionally the full
+run_automation.py pipeline), writes the timings as JSON, and compares them against a saved
+baseline so a slowdown in any stage fails the run.
+"""
+
+import argparse
+import fnmatch
+import json
+import platform
+import statistics
+import subprocess
+import sys
+import time
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+TOOLS_DIR = Path(__file__).parent.parent
+PROJECT_ROOT = TOOLS_DIR.parent
+for folder in ("analysis", "disassembly", "compression"):
+    sys.path.append(str(TOOLS_DIR / folder))
+
+from analysis_store import rom_digest
+from rom_image import open_rom_image
+
+DEFAULT_BASELINE = Path(__file__).parent / "baseline.json"
+DEFAULT_RESULTS = PROJECT_ROOT / "logs" / "benchmarks" / "latest.json"
+
+ROM_CANDIDATES = [
+    "static/Dragon Quest III - english (patched).smc",
+    "static/Dragon Quest III - english.smc",
+    "static/Dragon Quest III - Soshite Densetsu he... (J).smc",
+]
+
+# A benchmark regresses when its best time exceeds the baseline's by this factor...
+DEFAULT_THRESHOLD = 1.25
+# ...and by at least this many seconds (timer noise on very short runs)
+NOISE_FLOOR = 0.005
+
+# Sample sizes for the byte-oriented benchmarks
+CODEC_SAMPLE = 0x4000
+TILE_SAMPLE = 0x10000
+SWEEP_SAMPLE = 0x40000
+
+
+class BenchContext:
+    """The ROM under test and deterministic samples of it"""
+
+    def __init__(self, rom_path: Path):
+        self.rom_path = rom_path
+        self.image = open_rom_image(rom_path)
+        self.data = self.image.data
+
+    def sample(self, size: int) -> bytes:
+        """size bytes from the middle of the ROM (the same bytes on every run)"""
+        start = max(0, (len(self.data) - size) // 2)
+        return self.data[start : start + size].tobytes()
+
+
+@dataclass
+class Benchmark:
+    """
+    setup(ctx) returns the timed callable, the number of bytes one call processes and,
+    optionally, a dict of details copied into the result
+    """
+
+    name: str
+    stage: str
+    setup: Callable[[BenchContext], Tuple[Callable[[], Any], int]]
+    repeat: int = 5
+    opt_in: bool = False  # Only run when asked for (side effects or minutes of runtime)
+
+
+BENCHMARKS: List[Benchmark] = []
+
+
+def benchmark(name: str, stage: str, repeat: int = 5, opt_in: bool = False):
+    def register(setup):
+        BENCHMARKS.append(Benchmark(name, stage, setup, repeat, opt_in))
+        return setup
+
+    return register
+
+
+def _codec_pair(codec_factory, sample_size: int = CODEC_SAMPLE):
+    def compress(ctx: BenchContext):
+        data = ctx.sample(sample_size)
+        codec = codec_factory()
+        return (lambda: codec.compress(data)), len(data)
+
+    def decompress(ctx: BenchContext):
+        data = ctx.sample(sample_size)
+        codec = codec_factory()
+        packed = codec.compress(data)
+        # Reported rather than raised: a lossy round trip is a codec bug, not a slowdown
+        details = {"round_trip": codec.decompress(packed) == data, "compressed_size": len(packed)}
+        return (lambda: codec.decompress(packed)), len(data), details
+
+    return compress, decompress
+
+
+def _register_codecs():
+    from compression_engine import BasicRing400, SimpleTailWindowCompression
+
+    for name, factory in (("basic_ring400", BasicRing400), ("tail_window", SimpleTailWindowCompression)):
+        compress, decompress = _codec_pair(factory)
+        benchmark(f"codec.{name}.compress", "codecs", repeat=3)(compress)
+        benchmark(f"codec.{name}.decompress", "codecs")(decompress)
+
+
+_register_codecs()
+
+
+def _dialog_lines(limit: int = 5000) -> List[str]:
+    """Decoded strings from the analysis CSV, or generated lines when it is absent"""
+    import csv
+
+    csv_path = PROJECT_ROOT / "docs" / "maximum_analysis" / "text_strings.csv"
+    lines = []
+    if csv_path.exists():
+        with open(csv_path, "r", encoding="utf-8") as f:
+            for row in csv.DictReader(f):
+                lines.append(row.get("Text", ""))
+                if len(lines) >= limit:
+                    break
+    if not lines:
+        lines = [f"Welcome to Aliahan, traveler number {index}!" for index in range(limit)]
+    return lines
+
+
+@benchmark("codec.huffman.encode", "codecs")
+def _huffman_encode(ctx: BenchContext):
+    from huffman_codec import DialogBank
+
+    lines = _dialog_lines()
+    bank = DialogBank.build(lines)
+    return (lambda: DialogBank.build(lines, bank.code)), sum(len(line.encode("utf-8")) for line in lines)
+
+
+@benchmark("codec.huffman.decode", "codecs")
+def _huffman_decode(ctx: BenchContext):
+    from huffman_codec import DialogBank
+
+    lines = _dialog_lines()
+    bank = DialogBank.build(lines)
+    if list(bank) != lines:
+        raise ValueError("Huffman round trip failed")
+    return (lambda: list(bank)), sum(len(line.encode("utf-8")) for line in lines)
+
+
+@benchmark("decoder.linear_sweep", "disassembly")
+def _linear_sweep(ctx: BenchContext):
+    from decoder65816 import decode_linear
+
+    data = ctx.sample(SWEEP_SAMPLE)
+    return (lambda: decode_linear(data)), len(data)
+
+
+@benchmark("decoder.cfg", "disassembly", repeat=1)
+def _cfg(ctx: BenchContext):
+    from cfg_engine import build_control_flow_graph
+    from snes_disasm import create_snes_disassembler
+
+    labels = PROJECT_ROOT / "src" / "labels.inc"
+
+    def run():
+        disassembler = create_snes_disassembler(str(ctx.rom_path))
+        return build_control_flow_graph(disassembler, labels if labels.exists() else None)
+
+    return run, len(ctx.data)
+
+
+@benchmark("tiles.decode_4bpp", "graphics")
+def _tiles(ctx: BenchContext):
+    from tile_codec import decode_tiles
+
+    data = ctx.sample(TILE_SAMPLE)
+    out = bytearray(len(data) * 2)  # 32 bytes per 4bpp tile -> 64 pixels
+    return (lambda: decode_tiles(data, 4, out)), len(data)
+
+
+@benchmark("entropy.profile", "classification")
+def _entropy(ctx: BenchContext):
+    from rolling_entropy import entropy_profile
+
+    data = ctx.sample(SWEEP_SAMPLE)
+    return (lambda: entropy_profile(data, 256, 16)), len(data)
+
+
+@benchmark("classify.rom", "classification", repeat=1)
+def _classify(ctx: BenchContext):
+    from rom_classifier import classify_rom
+
+    return (lambda: classify_rom(ctx.data, use_cache=False)), len(ctx.data)
+
+
+@benchmark("pointers.xref_index", "pointers", repeat=1)
+def _pointers(ctx: BenchContext):
+    from xref_index import build_xref_index
+
+    return (lambda: build_xref_index(ctx.data, ctx.image.address_map, pointers=True)), len(ctx.data)
+
+
+@benchmark("pipeline.run_automation", "pipeline", repeat=1, opt_in=True)
+def _pipeline(ctx: BenchContext):
+    # Formats files and refreshes logs in the working tree, hence opt-in
+    def run():
+        completed = subprocess.run([sys.executable, "run_automation.py"], cwd=str(PROJECT_ROOT),
+                                   capture_output=True, text=True)
+        if completed.returncode != 0:
+            raise RuntimeError(f"run_automation.py exited with {completed.returncode}")
+
+    return run, len(ctx.data)
+
+
+def run_benchmark(bench: Benchmark, ctx: BenchContext, repeat: Optional[int] = None) -> Dict[str, Any]:
+    """Best and median wall time over the repeats (after one untimed warm-up for repeated runs)"""
+    function, size, *details = bench.setup(ctx)
+    count = repeat or bench.repeat
+    if count > 1:
+        function()
+
+    times = []
+    for _ in range(count):
+        start = time.perf_counter()
+        function()
+        times.append(time.perf_counter() - start)
+
+    best = min(times)
+    result = {
+        "stage": bench.stage,
+        "best": best,
+        "median": statistics.median(times),
+        "runs": times,
+        "bytes": size,
+        "throughput_mb_s": size / best / 1e6 if best > 0 else 0.0,
+    }
+    for extra in details:
+        result.update(extra)
+    return result
+
+
+def compare_to_baseline(results: Dict[str, Any], baseline: Dict[str, Any], threshold: float) -> List[Dict[str, Any]]:
+    """Benchmarks slower than the baseline beyond their threshold"""
+    regressions = []
+    thresholds = baseline.get("thresholds", {})
+    for name, result in results["benchmarks"].items():
+        reference = baseline.get("benchmarks", {}).get(name)
+        if not reference or "best" not in reference or "best" not in result:
+            continue
+        limit = thresholds.get(name, thresholds.get(result["stage"], threshold))
+        allowed = reference["best"] * limit
+        if result["best"] > allowed and result["best"] - reference["best"] > NOISE_FLOOR:
+            regressions.append({
+                "benchmark": name,
+                "baseline": reference["best"],
+                "current": result["best"],
+                "ratio": result["best"] / reference["best"],
+                "threshold": limit,
+            })
+    return regressions
+
+
+def find_rom() -> Optional[Path]:
+    for candidate in ROM_CANDIDATES:
+        path = PROJECT_ROOT / candidate
+        if path.exists():
+            return path
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="DQ3R benchmark suite and regression check")
+    parser.add_argument("rom_file", nargs="?", help="ROM to benchmark on (default: the ROM under static/)")
+    parser.add_argument("--only", action="append", help="Benchmark or stage name pattern (repeatable, e.g. 'codec.*')")
+    parser.add_argument("--pipeline", action="store_true", help="Also time run_automation.py (rewrites the tree)")
+    parser.add_argument("--repeat", type=int, help="Override every benchmark's repeat count")
+    parser.add_argument("--baseline", default=str(DEFAULT_BASELINE), help="Baseline JSON to compare against")
+    parser.add_argument("--save-baseline", action="store_true", help="Store these results as the new baseline")
+    parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD, help="Allowed slowdown factor")
+    parser.add_argument("--output", "-o", default=str(DEFAULT_RESULTS), help="Results JSON")
+    parser.add_argument("--list", action="store_true", help="List the benchmarks and exit")
+    args = parser.parse_args()
+
+    if args.list:
+        for bench in BENCHMARKS:
+            print(f"   {bench.name:32} {bench.stage:15} {'(opt-in)' if bench.opt_in else ''}")
+        return
+
+    rom_path = Path(args.rom_file) if args.rom_file else find_rom()
+    if rom_path is None or not rom_path.exists():
+        print("❌ No ROM found; pass the ROM path")
+        sys.exit(1)
+
+    ctx = BenchContext(rom_path)
+    selected = []
+    for bench in BENCHMARKS:
+        if args.only:
+            if not any(fnmatch.fnmatch(bench.name, pattern) or bench.stage == pattern for pattern in args.only):
+                continue
+        elif bench.opt_in and not (args.pipeline and bench.stage == "pipeline"):
+            continue
+        selected.append(bench)
+
+    results = {
+        "timestamp": time.strftime("%Y-%m-%d %H:%M:%S"),
+        "rom": str(rom_path),
+        "rom_digest": rom_digest(ctx.data).hex(),
+        "python": platform.python_version(),
+        "machine": platform.machine(),
+        "benchmarks": {},
+    }
+
+    print(f"⏱️ Benchmarking {len(selected)} hot paths on {rom_path.name}")
+    for bench in selected:
+        try:
+            result = run_benchmark(bench, ctx, args.repeat)
+        except Exception as e:
+            results["benchmarks"][bench.name] = {"stage": bench.stage, "error": str(e)}
+            print(f"   ❌ {bench.name:32} {e}")
+            continue
+        results["benchmarks"][bench.name] = result
+        print(f"   {bench.name:32} {result['best'] * 1000:10.1f}ms  {result['throughput_mb_s']:8.2f} MB/s")
+        if result.get("round_trip") is False:
+            print(f"   ⚠️ {bench.name} does not reproduce its input")
+
+    regressions = []
+    baseline_path = Path(args.baseline)
+    if baseline_path.exists():
+        with open(baseline_path, "r", encoding="utf-8") as f:
+            baseline = json.load(f)
+        if baseline.get("rom_digest") != results["rom_digest"]:
+            print("⚠️ Baseline was recorded on a different ROM; skipping the regression check")
+        else:
+            regressions = compare_to_baseline(results, baseline, args.threshold)
+    elif not args.save_baseline:
+        print(f"⚠️ No baseline at {baseline_path}; run with --save-baseline to record one")
+    results["regressions"] = regressions
+
+    output_path = Path(args.output)
+    output_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(output_path, "w", encoding="utf-8") as f:
+        json.dump(results, f, indent=2)
+    print(f"💾 Results saved to {output_path}")
+
+    if args.save_baseline:
+        previous = {}
+        if baseline_path.exists():
+            with open(baseline_path, "r", encoding="utf-8") as f:
+                previous = json.load(f)
+        baseline = dict(results, thresholds=previous.get("thresholds", {}))
+        baseline["benchmarks"] = {name: result for name, result in results["benchmarks"].items() if "error" not in result}
+        baseline.pop("regressions", None)
+        with open(baseline_path, "w", encoding="utf-8") as f:
+            json.dump(baseline, f, indent=2)
+        print(f"📌 Baseline saved to {baseline_path}")
+
+    failed = [name for name, result in results["benchmarks"].items() if "error" in result]
+    for regression in regressions:
+        print(f"❌ {regression['benchmark']}: {regression['current'] * 1000:.1f}ms vs "
+              f"{regression['baseline'] * 1000:.1f}ms ({regression['ratio']:.2f}x, limit {regression['threshold']:.2f}x)")
+    if regressions or failed:
+        sys.exit(1)
+    print("✅ No regressions")
+
+
+if __name__ == "__main__":
+    main()
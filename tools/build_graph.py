@@ -0,0 +1,332 @@
+#!/usr/bin/env python3
+"""
+Incremental Build Graph for DQ3R Project
+Build steps declare the files they read and write; a step reruns only when the content of its
+inputs, its outputs, or the outputs of a step it depends on changed since its last run.
+Steps with no pending dependencies run in parallel, and watch mode rebuilds only the steps a
+file change reaches, recording the latency of each rebuild for the build report.
+"""
+
+import hashlib
+import json
+import os
+import sys
+import threading
+import time
+from concurrent.futures import FIRST_COMPLETED, ThreadPoolExecutor, wait
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Tuple, Union
+
+sys.path.append(str(Path(__file__).parent / "analysis"))
+import stage_trace
+
+PathSource = Union[Iterable[Path], Callable[[], Iterable[Path]]]
+
+# Result statuses that mean the step did not produce its outputs (rerun next time)
+FAILED_STATUSES = ("error",)
+
+
+@dataclass
+class BuildNode:
+    """One build step: action() returns a JSON-serializable result dict"""
+
+    name: str
+    action: Callable[[], Dict[str, Any]]
+    inputs: PathSource = ()
+    outputs: PathSource = ()
+    depends: List[str] = field(default_factory=list)
+    in_place: bool = False  # The action rewrites its inputs (formatters)
+    always: bool = False  # Runs whenever any other step ran (session logs, git status)
+
+    def input_paths(self) -> List[Path]:
+        return sorted(set(Path(p) for p in (self.inputs() if callable(self.inputs) else self.inputs)))
+
+    def output_paths(self) -> List[Path]:
+        return sorted(set(Path(p) for p in (self.outputs() if callable(self.outputs) else self.outputs)))
+
+
+class ContentHasher:
+    """BLAKE2 digests of files, recomputed only when a file's size or mtime moves"""
+
+    def __init__(self, known: Optional[Dict[str, List]] = None):
+        self.known: Dict[str, List] = dict(known or {})  # path -> [size, mtime_ns, digest]
+        self._lock = threading.Lock()
+
+    def digest(self, path: Path) -> Optional[str]:
+        try:
+            stat = path.stat()
+        except OSError:
+            return None
+        if not path.is_file():
+            return None
+
+        key = str(path)
+        with self._lock:
+            entry = self.known.get(key)
+        if entry and entry[0] == stat.st_size and entry[1] == stat.st_mtime_ns:
+            stage_trace.count("build.hash_cache_hits")
+            return entry[2]
+        stage_trace.count("build.bytes_hashed", stat.st_size)
+
+        hasher = hashlib.blake2b(digest_size=16)
+        with open(path, "rb") as f:
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                hasher.update(chunk)
+        digest = hasher.hexdigest()
+        with self._lock:
+            self.known[key] = [stat.st_size, stat.st_mtime_ns, digest]
+        return digest
+
+    def digests(self, paths: Iterable[Path]) -> Dict[str, Optional[str]]:
+        return {str(path): self.digest(path) for path in paths}
+
+
+def _fingerprint(digests: Dict[str, Optional[str]]) -> str:
+    hasher = hashlib.blake2b(digest_size=16)
+    for path in sorted(digests):
+        hasher.update(f"{path}\0{digests[path]}\n".encode("utf-8"))
+    return hasher.hexdigest()
+
+
+class BuildGraph:
+    """Build steps, their recorded state, and the scheduler that runs the out-of-date ones"""
+
+    def __init__(self, state_file: Path, log: Optional[Callable[[str, str], None]] = None):
+        self.state_file = Path(state_file)
+        self.nodes: Dict[str, BuildNode] = {}
+        self.log = log or (lambda message, level="INFO": print(f"[GRAPH] {message}"))
+
+        state = {}
+        if self.state_file.exists():
+            try:
+                with open(self.state_file, "r", encoding="utf-8") as f:
+                    state = json.load(f)
+            except (OSError, ValueError):
+                state = {}
+        self.records: Dict[str, Dict[str, Any]] = state.get("nodes", {})
+        self.hasher = ContentHasher(state.get("hashes", {}))
+        self._lock = threading.Lock()
+
+    def add(self, node: BuildNode) -> BuildNode:
+        self.nodes[node.name] = node
+        return node
+
+    def _save_state(self):
+        self.state_file.parent.mkdir(parents=True, exist_ok=True)
+        temp_path = self.state_file.with_suffix(f".{os.getpid()}.tmp")
+        with open(temp_path, "w", encoding="utf-8") as f:
+            json.dump({"nodes": self.records, "hashes": self.hasher.known}, f, indent=2)
+        os.replace(temp_path, self.state_file)
+
+    def order(self) -> List[str]:
+        """Steps in dependency order (ValueError on unknown dependencies or cycles)"""
+        ordered, visiting, done = [], set(), set()
+
+        def visit(name: str):
+            if name in done:
+                return
+            if name in visiting:
+                raise ValueError(f"Dependency cycle through {name}")
+            if name not in self.nodes:
+                raise ValueError(f"Unknown build step: {name}")
+            visiting.add(name)
+            for dependency in self.nodes[name].depends:
+                visit(dependency)
+            visiting.discard(name)
+            done.add(name)
+            ordered.append(name)
+
+        for name in self.nodes:
+            visit(name)
+        return ordered
+
+    def dependents(self, names: Iterable[str]) -> Set[str]:
+        """names and every step downstream of them"""
+        reached = set(names)
+        changed = True
+        while changed:
+            changed = False
+            for node in self.nodes.values():
+                if node.name not in reached and any(dependency in reached for dependency in node.depends):
+                    reached.add(node.name)
+                    changed = True
+        return reached
+
+    def why_dirty(self, name: str) -> Optional[str]:
+        """Reason the step must run, or None when it is up to date"""
+        node = self.nodes[name]
+        record = self.records.get(name)
+        if record is None:
+            return "never built"
+        if record.get("status") in FAILED_STATUSES:
+            return f"last run {record.get('status')}"
+
+        inputs = self.hasher.digests(node.input_paths())
+        if _fingerprint(inputs) != record.get("inputs"):
+            stored = record.get("input_paths", [])
+            added = sorted(set(inputs) - set(stored))
+            return f"inputs changed ({len(inputs)} files{', new: ' + added[0] if added else ''})"
+
+        outputs = self.hasher.digests(node.output_paths())
+        if _fingerprint(outputs) != record.get("outputs"):
+            return "outputs deleted or modified"
+
+        for dependency in node.depends:
+            upstream = self.records.get(dependency, {}).get("outputs")
+            if record.get("dependencies", {}).get(dependency) != upstream:
+                return f"{dependency} outputs changed"
+        return None
+
+    def _execute(self, name: str) -> Dict[str, Any]:
+        node = self.nodes[name]
+        # Inputs as the step saw them, so an edit made mid-step still counts as a change;
+        # formatters rewrite their inputs instead, so theirs are taken after the run
+        inputs = None if node.in_place else self.hasher.digests(node.input_paths())
+        started = time.time()
+        with stage_trace.span(name, "build") as scope:
+            try:
+                result = node.action()
+            except Exception as e:
+                result = {"status": "error", "error": str(e)}
+            scope.set(status=result.get("status", "success"))
+        elapsed = time.time() - started
+
+        if inputs is None:
+            inputs = self.hasher.digests(node.input_paths())
+        outputs = self.hasher.digests(node.output_paths())
+        with self._lock:
+            self.records[name] = {
+                "status": result.get("status", "success"),
+                "inputs": _fingerprint(inputs),
+                "input_paths": sorted(inputs),
+                "outputs": _fingerprint(outputs),
+                "dependencies": {dependency: self.records.get(dependency, {}).get("outputs")
+                                 for dependency in node.depends},
+                "result": result,
+                "time": elapsed,
+                "built_at": time.strftime("%Y-%m-%d %H:%M:%S"),
+            }
+        return result
+
+    def run(self, workers: int = 4, only: Optional[Set[str]] = None, force: bool = False) -> Dict[str, Any]:
+        """
+        Run every out-of-date step (all of them with force), limited to only when given;
+        steps are started as soon as their dependencies finish
+        """
+        run_start = time.time()
+        order = self.order()
+        selected = set(order) if only is None else self.dependents(only)
+        regular = [name for name in order if name in selected and not self.nodes[name].always]
+        status: Dict[str, Dict[str, Any]] = {}
+        finished: Set[str] = set(name for name in order if name not in regular)
+
+        with ThreadPoolExecutor(max_workers=max(1, workers)) as executor:
+            running: Dict[Any, str] = {}
+            pending = list(regular)
+            while pending or running:
+                for name in list(pending):
+                    node = self.nodes[name]
+                    if not all(dependency in finished for dependency in node.depends):
+                        continue
+                    pending.remove(name)
+                    blocked = [d for d in node.depends if status.get(d, {}).get("state") == "failed"]
+                    if blocked:
+                        status[name] = {"state": "blocked", "reason": f"{blocked[0]} failed", "time": 0.0}
+                        finished.add(name)
+                        continue
+                    reason = "forced" if force else self.why_dirty(name)
+                    if reason is None:
+                        status[name] = {"state": "up_to_date", "time": 0.0}
+                        finished.add(name)
+                        continue
+                    self.log(f"Building {name} ({reason})", "INFO")
+                    status[name] = {"state": "running", "reason": reason}
+                    running[executor.submit(self._execute, name)] = name
+
+                if not running:
+                    continue
+                done, _ = wait(list(running), return_when=FIRST_COMPLETED)
+                for future in done:
+                    name = running.pop(future)
+                    record = self.records[name]
+                    state = "failed" if record["status"] in FAILED_STATUSES else "built"
+                    status[name].update(state=state, time=record["time"])
+                    finished.add(name)
+
+            # Bookkeeping steps follow the real work, and only when there was some
+            if any(entry["state"] in ("built", "failed") for entry in status.values()) or force:
+                for name in order:
+                    if self.nodes[name].always:
+                        self._execute(name)
+                        status[name] = {"state": "built", "reason": "after build", "time": self.records[name]["time"]}
+
+        latency = time.time() - run_start
+
+        # A step that is dirty again right after building will rebuild forever (usually two
+        # steps rewriting each other's files); report it instead of failing silently
+        built = [name for name in order if status.get(name, {}).get("state") == "built"]
+        unsettled = {}
+        for name in built:
+            if not self.nodes[name].always:
+                reason = self.why_dirty(name)
+                if reason is not None:
+                    unsettled[name] = reason
+
+        self._save_state()
+        return {
+            "nodes": status,
+            "results": {name: self.records.get(name, {}).get("result", {}) for name in order},
+            "built": built,
+            "up_to_date": [name for name in order if status.get(name, {}).get("state") == "up_to_date"],
+            "failed": [name for name in order if status.get(name, {}).get("state") in ("failed", "blocked")],
+            "unsettled": unsettled,
+            "latency": latency,
+        }
+
+    def _snapshot(self) -> Dict[str, Tuple[str, ...]]:
+        """Stat signature of every step's inputs, cheap enough to poll"""
+        snapshot = {}
+        for node in self.nodes.values():
+            if node.always:
+                continue
+            entries = []
+            for path in node.input_paths():
+                try:
+                    stat = path.stat()
+                    entries.append(f"{path}:{stat.st_size}:{stat.st_mtime_ns}")
+                except OSError:
+                    entries.append(f"{path}:missing")
+            snapshot[node.name] = tuple(entries)
+        return snapshot
+
+    def watch(self, interval: float = 2.0, workers: int = 4, max_rebuilds: Optional[int] = None,
+              on_rebuild: Optional[Callable[[Dict[str, Any]], None]] = None) -> List[Dict[str, Any]]:
+        """Poll the inputs and rebuild the affected subgraph after each change; returns the rebuilds"""
+        rebuilds: List[Dict[str, Any]] = []
+        initial = self.run(workers)
+        if on_rebuild:
+            on_rebuild(initial)
+        previous = self._snapshot()
+
+        while max_rebuilds is None or len(rebuilds) < max_rebuilds:
+            time.sleep(interval)
+            current = self._snapshot()
+            touched = {name for name in current if current[name] != previous.get(name)}
+            previous = current
+            if not touched:
+                continue
+
+            detected = time.time()
+            self.log(f"Change detected in inputs of {', '.join(sorted(touched))}", "INFO")
+            result = self.run(workers, only=touched)
+            result.update(
+                touched=sorted(touched),
+                affected=sorted(self.dependents(touched)),
+                latency=time.time() - detected,
+            )
+            rebuilds.append(result)
+            previous = self._snapshot()  # Our own outputs and in-place rewrites are not changes
+            if on_rebuild:
+                on_rebuild(result)
+        return rebuilds
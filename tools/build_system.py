@@ -9,7 +9,7 @@ import subprocess
 import sys
 import json
 import time
-from typing import Dict, Any, List
+from typing import Dict, Any, List, Optional
 import argparse
 
 # Import our modules
@@ -19,6 +19,7 @@ try:
     from formatting.auto_formatter import CodeFormatter, run_automated_formatting
     from compression.compression_engine import get_compression_engine
     from asset_pipeline.snes_extractor import create_asset_pipeline
+    from build_graph import BuildGraph, BuildNode
 except ImportError as e:
     print(f"Setting up import paths...")
     # Ensure all tool modules are in path
@@ -30,12 +31,16 @@ except ImportError as e:
         from formatting.auto_formatter import CodeFormatter, run_automated_formatting
         from compression.compression_engine import get_compression_engine
         from asset_pipeline.snes_extractor import create_asset_pipeline
+        from build_graph import BuildGraph, BuildNode
 
         print("✅ All modules imported successfully")
     except ImportError as e2:
         print(f"❌ Import error: {e2}")
         sys.exit(1)
 
+sys.path.append(str(Path(__file__).parent / "analysis"))
+import stage_trace
+
 
 class DQ3RBuildSystem:
     """Comprehensive build system for DQ3R project"""
@@ -56,14 +61,22 @@ class DQ3RBuildSystem:
 
         self.build_log = self.logs_dir / "build_system.log"
 
+        # Per-step input/output hashes from the last build (see build_graph)
+        self.graph_state = self.project_root / "cache" / "build_graph.json"
+
         # Build configuration
         self.config = {
             "auto_format": True,
             "session_logging": True,
             "asset_extraction": True,
             "compression_analysis": True,
+            "rom_assembly": True,
             "git_integration": True,
             "max_token_utilization": True,
+            "workers": 4,
+            "watch_interval": 2.0,
+            "trace": True,
+            "traces_kept": 10,  # Newest build traces kept in logs/traces (0 keeps every one)
         }
 
     def log_build_action(self, message: str, level: str = "INFO"):
@@ -76,9 +89,64 @@ class DQ3RBuildSystem:
 
         print(f"[BUILD] {message}")
 
-    def run_comprehensive_build(self) -> Dict[str, Any]:
-        """Run complete build process with all systems"""
+    def create_build_graph(self) -> BuildGraph:
+        """The enabled build steps with the files each one reads and writes"""
+        graph = BuildGraph(self.graph_state, log=self.log_build_action)
+        generated = (self.logs_dir, self.graph_state.parent)  # Written by every build, never inputs
+
+        def project_files(paths: List[Path]) -> List[Path]:
+            return [path for path in paths if not any(folder in path.parents for folder in generated)]
+
+        main_source, output_rom = self._assembly_paths()
+        build_dir = self.project_root / "build"
+        assets_dir = build_dir / "extracted_assets"
+
+        def formatting_inputs() -> List[Path]:
+            # Reformatting another step's outputs (the exported asset JSON) would make that step
+            # dirty again on every build, and the two could run over the same files at once
+            produced = set()
+            for node in graph.nodes.values():
+                if node.name != "formatting":
+                    produced.update(node.output_paths())
+            return [path for path in project_files(self.code_formatter.find_files_to_format())
+                    if build_dir not in path.parents and path not in produced]
+
+        if self.config["auto_format"]:
+            graph.add(BuildNode(
+                "formatting", lambda: self._run_formatting(formatting_inputs()),
+                inputs=formatting_inputs,
+                in_place=True,
+            ))
+        if self.config["rom_assembly"]:
+            graph.add(BuildNode(
+                "rom_assembly", self._assemble_rom,
+                inputs=lambda: [main_source] + sorted((self.project_root / "src").glob("*.asm"))
+                + sorted((self.project_root / "src").glob("*.inc")),
+                outputs=[output_rom],
+            ))
+        if self.config["asset_extraction"]:
+            graph.add(BuildNode(
+                "asset_extraction", self._extract_assets,
+                inputs=lambda: self.project_root.rglob("*.smc"),
+                outputs=lambda: [path for path in assets_dir.rglob("*") if path.is_file()],
+            ))
+        if self.config["compression_analysis"]:
+            graph.add(BuildNode(
+                "compression_analysis", self._analyze_compression,
+                inputs=lambda: project_files(self._find_compression_candidates()),
+                depends=["asset_extraction"] if self.config["asset_extraction"] else [],
+            ))
+        if self.config["session_logging"]:
+            graph.add(BuildNode("session_update", self._update_session_logs, always=True))
+        if self.config["git_integration"]:
+            graph.add(BuildNode("git_status", self._update_git_status, always=True))
+        return graph
+
+    def run_comprehensive_build(self, force: bool = False) -> Dict[str, Any]:
+        """Run every out-of-date build step (all of them with force), independent steps in parallel"""
         build_start = time.time()
+        stage_trace.enable(self.config["trace"])
+        stage_trace.reset()
 
         self.log_build_action("Starting comprehensive DQ3R build process...")
 
@@ -86,47 +154,24 @@ class DQ3RBuildSystem:
             "start_time": time.strftime("%Y-%m-%d %H:%M:%S"),
             "session_update": {},
             "formatting": {},
+            "rom_assembly": {},
             "compression_analysis": {},
             "asset_extraction": {},
             "git_status": {},
+            "graph": {},
             "errors": [],
             "success": False,
             "build_time": 0.0,
         }
 
         try:
-            # 1. Update session logs
-            if self.config["session_logging"]:
-                self.log_build_action("Updating session logs...")
-                session_result = self._update_session_logs()
-                build_results["session_update"] = session_result
-
-            # 2. Run automated formatting
-            if self.config["auto_format"]:
-                self.log_build_action("Running automated code formatting...")
-                formatting_result = self._run_formatting()
-                build_results["formatting"] = formatting_result
-
-            # 3. Analyze and compress assets
-            if self.config["compression_analysis"]:
-                self.log_build_action("Analyzing compression opportunities...")
-                compression_result = self._analyze_compression()
-                build_results["compression_analysis"] = compression_result
-
-            # 4. Extract ROM assets
-            if self.config["asset_extraction"]:
-                self.log_build_action("Extracting ROM assets...")
-                asset_result = self._extract_assets()
-                build_results["asset_extraction"] = asset_result
-
-            # 5. Git integration and status
-            if self.config["git_integration"]:
-                self.log_build_action("Updating git status...")
-                git_result = self._update_git_status()
-                build_results["git_status"] = git_result
-
-            build_results["success"] = True
-            self.log_build_action("Build process completed successfully!")
+            graph = self.create_build_graph()
+            with stage_trace.span("build", "build", force=force):
+                run = graph.run(self.config["workers"], force=force)
+            self._record_graph_run(build_results, run)
+            build_results["success"] = not build_results["errors"]
+            if build_results["success"]:
+                self.log_build_action("Build process completed successfully!")
 
         except Exception as e:
             error_msg = f"Build process failed: {e}"
@@ -137,9 +182,98 @@ class DQ3RBuildSystem:
         build_results["build_time"] = time.time() - build_start
         build_results["end_time"] = time.strftime("%Y-%m-%d %H:%M:%S")
 
+        self._record_trace(build_results)
         self._save_build_report(build_results)
         return build_results
 
+    def _record_graph_run(self, build_results: Dict[str, Any], run: Dict[str, Any]):
+        """Copy a graph run into a build report (up-to-date steps keep their last result)"""
+        for name, result in run["results"].items():
+            build_results[name] = result
+        build_results["graph"] = {
+            "nodes": run["nodes"],
+            "built": run["built"],
+            "up_to_date": run["up_to_date"],
+            "failed": run["failed"],
+            "rebuild_latency": run["latency"],
+            "unsettled": run["unsettled"],
+        }
+        for name in run["failed"]:
+            reason = build_results[name].get("error") or run["nodes"][name].get("reason", "failed")
+            build_results["errors"].append(f"{name}: {reason}")
+
+        for name, reason in run["unsettled"].items():
+            self.log_build_action(f"{name} is out of date straight after building ({reason})", "WARNING")
+
+        self.log_build_action(
+            f"Graph: {len(run['built'])} built, {len(run['up_to_date'])} up to date, "
+            f"{len(run['failed'])} failed in {run['latency']:.2f}s"
+        )
+
+    def _record_trace(self, build_results: Dict[str, Any]):
+        """Add the stage timings and counters to a build report and write its Chrome trace"""
+        if not stage_trace.enabled():
+            return
+        summary = stage_trace.summary()
+        try:
+            trace_dir = self.logs_dir / "traces"
+            trace_file = trace_dir / f"build_trace_{time.time_ns() // 1_000_000}.json"
+            summary["trace_file"] = str(stage_trace.export_chrome_trace(trace_file))
+            # Millisecond stamps of one width, so name order is age order
+            for old_trace in sorted(trace_dir.glob("build_trace_*.json"))[: -self.config["traces_kept"]]:
+                old_trace.unlink()
+        except OSError as e:
+            self.log_build_action(f"Could not write build trace: {e}", "WARNING")
+        build_results["trace"] = summary
+
+        for line in stage_trace.format_summary(summary):
+            self.log_build_action(line)
+
+    def _assembly_paths(self) -> tuple:
+        """Main source and output ROM from build.config.json (as build.ps1 uses them)"""
+        main_source, output_rom = "src/dq3_main.asm", "build/dq3r-rebuilt.sfc"
+        config_path = self.project_root / "build.config.json"
+        if config_path.exists():
+            try:
+                with open(config_path, "r", encoding="utf-8") as f:
+                    build_config = json.load(f).get("build", {})
+                main_source = build_config.get("mainSource", main_source).replace("\\", "/")
+                output_rom = build_config.get("outputRom", output_rom).replace("\\", "/")
+            except (OSError, ValueError):
+                pass
+        main_path = self.project_root / main_source
+        if not main_path.exists():
+            main_path = self.project_root / "src" / "dq3_main.asm"
+        return main_path, self.project_root / output_rom
+
+    def _assemble_rom(self) -> Dict[str, Any]:
+        """Assemble the ROM from the disassembly with Asar, when it is installed"""
+        import shutil
+
+        main_source, output_rom = self._assembly_paths()
+        assembler = shutil.which("asar")
+        if not assembler:
+            return {"status": "skipped", "reason": "Asar not found on PATH"}
+        if not main_source.exists():
+            return {"status": "skipped", "reason": f"Main source not found: {main_source}"}
+
+        try:
+            output_rom.parent.mkdir(parents=True, exist_ok=True)
+            completed = subprocess.run(
+                [assembler, str(main_source), str(output_rom)],
+                capture_output=True, text=True, cwd=str(self.project_root),
+            )
+            if completed.returncode != 0:
+                return {"status": "error", "error": completed.stderr.strip() or completed.stdout.strip()}
+            return {
+                "status": "success",
+                "output_rom": str(output_rom),
+                "rom_size": output_rom.stat().st_size if output_rom.exists() else 0,
+            }
+
+        except Exception as e:
+            return {"status": "error", "error": str(e)}
+
     def _update_session_logs(self) -> Dict[str, Any]:
         """Update session logging system"""
         try:
@@ -178,11 +312,11 @@ class DQ3RBuildSystem:
         except Exception as e:
             return {"status": "error", "error": str(e), "session_updated": False}
 
-    def _run_formatting(self) -> Dict[str, Any]:
-        """Run automated code formatting"""
+    def _run_formatting(self, files: Optional[List[Path]] = None) -> Dict[str, Any]:
+        """Run automated code formatting (on files only, when given)"""
         try:
             # Use the existing automated formatter
-            formatting_summary = run_automated_formatting()
+            formatting_summary = run_automated_formatting(self.code_formatter, files)
 
             # Run EditorConfig compliance check
             compliance = self.code_formatter.check_editorconfig_compliance()
@@ -269,9 +403,12 @@ class DQ3RBuildSystem:
 
         # Look for binary files that might compress well
         patterns = ["*.bin", "*.dat", "*.smc", "*.rom"]
+        generated = (self.logs_dir, self.graph_state.parent)  # Cache entries are .bin files too
 
         for pattern in patterns:
             for file_path in self.project_root.rglob(pattern):
+                if any(folder in file_path.parents for folder in generated):
+                    continue
                 if file_path.is_file() and file_path.stat().st_size > 1024:  # At least 1KB
                     candidates.append(file_path)
 
@@ -298,14 +435,19 @@ class DQ3RBuildSystem:
             pipeline = create_asset_pipeline(str(rom_file))
 
             # Analyze ROM structure
-            analysis = pipeline.analyze_rom_structure()
+            with stage_trace.span("assets.analyze", rom=rom_file.name):
+                analysis = pipeline.analyze_rom_structure()
 
             # Extract known assets
-            assets = pipeline.extract_dq3_assets()
+            with stage_trace.span("assets.extract") as scope:
+                assets = pipeline.extract_dq3_assets()
+                scope.set(assets=len(assets))
 
             # Export assets to build directory
             assets_dir = self.project_root / "build" / "extracted_assets"
-            export_results = pipeline.export_assets(assets_dir, assets)
+            with stage_trace.span("assets.export"):
+                export_results = pipeline.export_assets(assets_dir, assets)
+            stage_trace.count("assets.exported", export_results["exported_count"])
 
             return {
                 "status": "success",
@@ -355,31 +497,33 @@ class DQ3RBuildSystem:
             self.log_build_action(f"Could not save build report: {e}", "WARNING")
 
     def continuous_development_mode(self):
-        """Run in continuous development mode with token maximization"""
+        """Watch the step inputs and rebuild only the affected steps after each change"""
         self.log_build_action("Starting continuous development mode...")
 
-        iteration = 0
-        max_iterations = 10  # Prevent infinite loops
-
-        while iteration < max_iterations:
-            iteration += 1
-            self.log_build_action(f"Continuous development iteration {iteration}")
-
-            # Run full build process
-            build_results = self.run_comprehensive_build()
-
-            if not build_results["success"]:
-                self.log_build_action("Build failed, stopping continuous mode", "ERROR")
-                break
-
-            # Check if we should continue
-            if self.config["max_token_utilization"]:
-                self.log_build_action("Maximizing token utilization - continuing development...")
-                time.sleep(1)  # Brief pause between iterations
-            else:
-                break
-
-        self.log_build_action(f"Continuous development mode completed after {iteration} iterations")
+        max_iterations = 10 if self.config["max_token_utilization"] else 1  # Prevent infinite loops
+        graph = self.create_build_graph()
+        stage_trace.enable(self.config["trace"])
+        stage_trace.reset()
+
+        def report(run: Dict[str, Any]):
+            build_results = {"start_time": time.strftime("%Y-%m-%d %H:%M:%S"), "errors": [], "watch": {
+                "touched": run.get("touched", []),
+                "affected": run.get("affected", []),
+            }}
+            self._record_graph_run(build_results, run)
+            build_results["success"] = not build_results["errors"]
+            build_results["build_time"] = run["latency"]
+            self._record_trace(build_results)
+            self._save_build_report(build_results)
+            stage_trace.reset()  # One trace per rebuild
+
+        rebuilds = graph.watch(self.config["watch_interval"], self.config["workers"], max_iterations, report)
+        latencies = [run["latency"] for run in rebuilds]
+        if latencies:
+            self.log_build_action(
+                f"Rebuild latency: mean {sum(latencies) / len(latencies):.2f}s, max {max(latencies):.2f}s"
+            )
+        self.log_build_action(f"Continuous development mode completed after {len(rebuilds)} rebuilds")
 
 
 def main():
@@ -395,6 +539,9 @@ def main():
     parser.add_argument("--no-session", action="store_true", help="Skip session logging")
     parser.add_argument("--no-assets", action="store_true", help="Skip asset extraction")
     parser.add_argument("--project-root", default=".", help="Project root directory")
+    parser.add_argument("--force", action="store_true", help="Rebuild every step, even if up to date")
+    parser.add_argument("--workers", type=int, default=4, help="Build steps run in parallel")
+    parser.add_argument("--no-trace", action="store_true", help="Skip stage timings and the Chrome trace")
 
     args = parser.parse_args()
 
@@ -409,6 +556,8 @@ def main():
         build_system.config["session_logging"] = False
     if args.no_assets:
         build_system.config["asset_extraction"] = False
+    build_system.config["workers"] = args.workers
+    build_system.config["trace"] = not args.no_trace
 
     try:
         if args.continuous:
@@ -416,11 +565,14 @@ def main():
             build_system.continuous_development_mode()
         else:
             # Run single build
-            results = build_system.run_comprehensive_build()
+            results = build_system.run_comprehensive_build(force=args.force)
 
             if results["success"]:
                 print("✅ Build completed successfully!")
                 print(f"⏱️  Build time: {results['build_time']:.2f} seconds")
+                print(f"🔁 Up to date: {', '.join(results['graph']['up_to_date']) or 'none'}")
+                for name, reason in results["graph"].get("unsettled", {}).items():
+                    print(f"⚠️  {name} will rebuild on every run: {reason}")
             else:
                 print("❌ Build failed!")
                 for error in results["errors"]:
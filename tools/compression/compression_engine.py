@@ -7,14 +7,24 @@ Integrates BasicRing400, SimpleTailWindowCompression, and Huffman text compressi
 
 import struct
 import os
+import hashlib
+import tempfile
 import sys
 import time
+from concurrent.futures import ProcessPoolExecutor, as_completed
 from pathlib import Path
 from typing import List, Dict, Any, Optional, Tuple, Union
 from dataclasses import dataclass
-from collections import deque
+from collections import Counter, deque
 import json
 
+# Sibling codec modules, also when imported as compression.compression_engine
+sys.path.append(str(Path(__file__).parent))
+from huffman_codec import CanonicalHuffmanCode
+
+sys.path.append(str(Path(__file__).parent.parent / "analysis"))
+import stage_trace
+
 
 @dataclass
 class CompressionStats:
@@ -25,6 +35,7 @@ class CompressionStats:
     compression_ratio: float
     algorithm: str
     time_taken: float = 0.0
+    cache_hit: bool = False
 
     def __post_init__(self):
         if self.original_size > 0:
@@ -33,6 +44,126 @@ class CompressionStats:
             self.compression_ratio = 0.0
 
 
+# Parse effort levels shared by the ring/window compressors:
+#   0 - greedy longest-match (the original packers, byte-identical output)
+#   1 - shortest-path parse choosing between a literal and the longest match at each position
+#   2 - shortest-path parse over every match length, optimal for the format's token costs
+PARSE_EFFORT_LEVELS = (0, 1, 2)
+
+
+def shortest_path_parse(
+    longest_matches: List[Optional[Tuple[int, int]]],
+    literal_cost: int,
+    match_cost: int,
+    min_match: int,
+    effort: int,
+) -> List[Tuple[int, int]]:
+    """
+    Minimize encoded size over per-position match candidates
+    longest_matches[i] is (reference, length) for the longest match starting at i, or None.
+    Any shorter length down to min_match is valid with the same reference, so effort 2 tries
+    them all. Returns the chosen tokens as (position, length) with length 0 for literals.
+    """
+    size = len(longest_matches)
+    cost = [0] * (size + 1)
+    choice = [0] * size
+
+    for pos in range(size - 1, -1, -1):
+        best_cost = cost[pos + 1] + literal_cost
+        best_length = 0
+        match = longest_matches[pos]
+
+        if match:
+            longest = match[1]
+            shortest = min_match if effort >= 2 else longest
+            for length in range(longest, shortest - 1, -1):
+                candidate = cost[pos + length] + match_cost
+                if candidate < best_cost:
+                    best_cost = candidate
+                    best_length = length
+
+        cost[pos] = best_cost
+        choice[pos] = best_length
+
+    tokens = []
+    pos = 0
+    while pos < size:
+        tokens.append((pos, choice[pos]))
+        pos += choice[pos] or 1
+
+    return tokens
+
+
+class Ring400MatchIndex:
+    """
+    Hash-chain match finder over the BasicRing400 ring buffer
+    Buckets every ring address by the 3 bytes starting there (with wrap-around), so only
+    addresses that already satisfy MIN_COPY_SIZE are ever compared. Each ring write re-keys
+    the 3 addresses whose prefix it touches, keeping updates O(1) per byte.
+    """
+
+    def __init__(self, ring_buffer: bytearray, min_copy: int, max_copy: int):
+        self.ring = ring_buffer
+        self.size = len(ring_buffer)
+        self.mask = self.size - 1
+        self.min_copy = min_copy
+        self.max_copy = max_copy
+        self.keys = [self._key_at(addr) for addr in range(self.size)]
+        self.chains: Dict[int, set] = {}
+
+        for addr, key in enumerate(self.keys):
+            self.chains.setdefault(key, set()).add(addr)
+
+    def _key_at(self, addr: int) -> int:
+        ring = self.ring
+        mask = self.mask
+        return (ring[addr] << 16) | (ring[(addr + 1) & mask] << 8) | ring[(addr + 2) & mask]
+
+    def update(self, ring_pos: int):
+        """Re-key the addresses whose 3-byte prefix includes ring_pos (call after writing it)"""
+        for back in (2, 1, 0):
+            addr = (ring_pos - back) & self.mask
+            new_key = self._key_at(addr)
+            old_key = self.keys[addr]
+            if new_key == old_key:
+                continue
+
+            chain = self.chains[old_key]
+            chain.discard(addr)
+            if not chain:
+                del self.chains[old_key]
+
+            self.chains.setdefault(new_key, set()).add(addr)
+            self.keys[addr] = new_key
+
+    def find(self, data: bytes, pos: int) -> Optional[Dict[str, int]]:
+        """Longest match at pos; ties resolve to the lowest ring address like the exhaustive search"""
+        max_length = min(self.max_copy, len(data) - pos)
+        if max_length < self.min_copy:
+            return None
+
+        key = (data[pos] << 16) | (data[pos + 1] << 8) | data[pos + 2]
+        chain = self.chains.get(key)
+        if not chain:
+            return None
+
+        ring = self.ring
+        mask = self.mask
+        best_match = None
+
+        for ring_addr in sorted(chain):
+            match_length = self.min_copy
+            while match_length < max_length and data[pos + match_length] == ring[(ring_addr + match_length) & mask]:
+                match_length += 1
+
+            if not best_match or match_length > best_match["length"]:
+                best_match = {"address": ring_addr, "length": match_length}
+                if match_length == max_length:
+                    break
+
+        return best_match
+
+
 class BasicRing400:
     """
     BasicRing400 compression algorithm from logsmall
@@ -44,23 +175,44 @@ class BasicRing400:
     MAX_COPY_SIZE = 63  # 6-bit field max value
     MIN_COPY_SIZE = 3  # Minimum bytes to make compression worthwhile
 
-    def __init__(self):
+    # "hash_chain" uses Ring400MatchIndex; "exhaustive" is the original scan of all 1024 addresses.
+    # Both produce byte-identical output.
+    MATCH_FINDERS = ("hash_chain", "exhaustive")
+
+    def __init__(self, match_finder: str = "hash_chain", effort: int = 0):
+        if match_finder not in self.MATCH_FINDERS:
+            raise ValueError(f"Unknown match finder: {match_finder}")
+        if effort not in PARSE_EFFORT_LEVELS:
+            raise ValueError(f"Unknown parse effort: {effort}")
+
+        self.match_finder = match_finder
+        self.effort = effort
         self.ring_buffer = bytearray(self.RING_SIZE)
         self.ring_pos = 0
+        self._match_index: Optional[Ring400MatchIndex] = None
 
     def compress(self, data: bytes) -> bytes:
         """Compress data using BasicRing400 algorithm"""
         if not data:
             return b""
 
+        if self.effort > 0:
+            return self._compress_optimal(data)
+
         compressed = bytearray()
         data_pos = 0
         self.ring_pos = 0
         self.ring_buffer = bytearray(self.RING_SIZE)
 
+        if self.match_finder == "hash_chain":
+            self._match_index = Ring400MatchIndex(self.ring_buffer, self.MIN_COPY_SIZE, self.MAX_COPY_SIZE)
+            find_match = self._match_index.find
+        else:
+            find_match = self._find_best_match
+
         while data_pos < len(data):
             # Find best match in ring buffer
-            best_match = self._find_best_match(data, data_pos)
+            best_match = find_match(data, data_pos)
 
             if best_match and best_match["length"] >= self.MIN_COPY_SIZE:
                 # Use compression
@@ -90,6 +242,36 @@ class BasicRing400:
                 self._add_to_ring(data[data_pos])
                 data_pos += 1
 
+        self._match_index = None
+        return bytes(compressed)
+
+    def _compress_optimal(self, data: bytes) -> bytes:
+        """Shortest-path parse: 1 byte per literal, 2 bytes per copy
+
+        Ring contents at any position are just the preceding input bytes, independent of how
+        earlier bytes were encoded, so longest matches can be collected in one forward pass.
+        """
+        self.ring_pos = 0
+        self.ring_buffer = bytearray(self.RING_SIZE)
+        index = Ring400MatchIndex(self.ring_buffer, self.MIN_COPY_SIZE, self.MAX_COPY_SIZE)
+
+        longest_matches: List[Optional[Tuple[int, int]]] = []
+        for data_pos in range(len(data)):
+            match = index.find(data, data_pos)
+            longest_matches.append((match["address"], match["length"]) if match else None)
+
+            self.ring_buffer[self.ring_pos] = data[data_pos]
+            index.update(self.ring_pos)
+            self.ring_pos = (self.ring_pos + 1) % self.RING_SIZE
+
+        compressed = bytearray()
+        for data_pos, length in shortest_path_parse(longest_matches, 1, 2, self.MIN_COPY_SIZE, self.effort):
+            if length:
+                match_addr = longest_matches[data_pos][0]
+                compressed.extend([(match_addr >> 2) & 0xFF, ((match_addr & 0x03) << 6) | (length & 0x3F)])
+            else:
+                compressed.append(data[data_pos] | 0x80)
+
         return bytes(compressed)
 
     def decompress(self, compressed_data: bytes) -> bytes:
@@ -165,9 +347,61 @@ class BasicRing400:
     def _add_to_ring(self, byte: int):
         """Add byte to ring buffer at current position"""
         self.ring_buffer[self.ring_pos] = byte
+        if self._match_index:
+            self._match_index.update(self.ring_pos)
         self.ring_pos = (self.ring_pos + 1) % self.RING_SIZE
 
 
+class TailWindowMatchIndex:
+    """
+    Hash-chain match finder for SimpleTailWindowCompression
+    Chains every inserted position by its 3-byte prefix and walks them newest-first, so the
+    first longest match found has the smallest offset, as in the exhaustive backward scan.
+    """
+
+    def __init__(self, data: bytes, window_size: int, min_match: int, max_match: int):
+        self.data = data
+        self.window_size = window_size
+        self.min_match = min_match
+        self.max_match = max_match
+        self.chains: Dict[bytes, List[int]] = {}
+
+    def insert(self, pos: int):
+        """Make pos available as a match source for later positions"""
+        if pos + self.min_match <= len(self.data):
+            self.chains.setdefault(self.data[pos : pos + self.min_match], []).append(pos)
+
+    def find(self, pos: int) -> Optional[Dict[str, int]]:
+        """Longest non-overlapping match for pos among inserted positions within the window"""
+        data = self.data
+        max_length = min(self.max_match, len(data) - pos)
+        if max_length < self.min_match:
+            return None
+
+        chain = self.chains.get(data[pos : pos + self.min_match])
+        if not chain:
+            return None
+
+        best_match = None
+        window_start = pos - self.window_size
+
+        for search_pos in reversed(chain):
+            if search_pos < window_start:
+                break
+
+            limit = min(max_length, pos - search_pos)
+            match_length = self.min_match
+            while match_length < limit and data[pos + match_length] == data[search_pos + match_length]:
+                match_length += 1
+
+            if match_length <= limit and (not best_match or match_length > best_match["length"]):
+                best_match = {"offset": pos - search_pos, "length": match_length}
+                if match_length == max_length:
+                    break
+
+        return best_match
+
+
 class SimpleTailWindowCompression:
     """
     SimpleTailWindowCompression algorithm from logsmall
@@ -175,8 +409,12 @@ class SimpleTailWindowCompression:
     Command + data format with word-based offset addressing
     """
 
-    def __init__(self, window_size: int = 0x1000):
+    def __init__(self, window_size: int = 0x1000, effort: int = 0):
+        if effort not in PARSE_EFFORT_LEVELS:
+            raise ValueError(f"Unknown parse effort: {effort}")
+
         self.window_size = window_size
+        self.effort = effort
         self.min_match = 3
         self.max_match = 255 + self.min_match
 
@@ -185,12 +423,17 @@ class SimpleTailWindowCompression:
         if not data:
             return b""
 
+        index = TailWindowMatchIndex(data, self.window_size, self.min_match, self.max_match)
+
+        if self.effort > 0:
+            return self._compress_optimal(data, index)
+
         compressed = bytearray()
         pos = 0
 
         while pos < len(data):
             # Look for matches in previous data
-            best_match = self._find_match(data, pos)
+            best_match = index.find(pos)
 
             if best_match and best_match["length"] >= self.min_match:
                 # Compression command
@@ -201,14 +444,34 @@ class SimpleTailWindowCompression:
                 command = struct.pack("<HB", offset, length - self.min_match)
                 compressed.extend(command)
 
+                for covered in range(pos, pos + length):
+                    index.insert(covered)
                 pos += length
             else:
                 # Literal byte
                 compressed.append(data[pos])
+                index.insert(pos)
                 pos += 1
 
         return bytes(compressed)
 
+    def _compress_optimal(self, data: bytes, index: TailWindowMatchIndex) -> bytes:
+        """Shortest-path parse: 1 byte per literal, 3 bytes per copy command"""
+        longest_matches: List[Optional[Tuple[int, int]]] = []
+        for pos in range(len(data)):
+            match = index.find(pos)
+            longest_matches.append((match["offset"], match["length"]) if match else None)
+            index.insert(pos)
+
+        compressed = bytearray()
+        for pos, length in shortest_path_parse(longest_matches, 1, 3, self.min_match, self.effort):
+            if length:
+                compressed.extend(struct.pack("<HB", longest_matches[pos][0], length - self.min_match))
+            else:
+                compressed.append(data[pos])
+
+        return bytes(compressed)
+
     def decompress(self, compressed_data: bytes) -> bytes:
         """Decompress SimpleTailWindow compressed data"""
         if not compressed_data:
@@ -278,187 +541,376 @@ class SimpleTailWindowCompression:
 class HuffmanDialogCompression:
     """
     Huffman text compression for game dialog
-    Optimized for common text patterns in RPG dialog
+    Canonical codes with table-driven decoding (see huffman_codec). After train(), every blob
+    uses the one code trained on the whole corpus instead of carrying its own table.
     """
 
-    def __init__(self):
-        self.frequency_table = {}
-        self.huffman_tree = None
-        self.codes = {}
+    # Blob layouts: mode byte, code table (embedded mode only), bit length, packed bits
+    EMBEDDED_TABLE = 0
+    SHARED_TABLE = 1
+
+    def __init__(self, shared_code: Optional[CanonicalHuffmanCode] = None):
+        self.shared_code = shared_code
+
+    @property
+    def dictionary_id(self) -> Optional[str]:
+        """Identifies the shared code (part of the compression cache key)"""
+        if self.shared_code is None:
+            return None
+        return hashlib.blake2b(self.shared_code.to_bytes(), digest_size=8).hexdigest()
+
+    def train(self, corpus: List[str]) -> CanonicalHuffmanCode:
+        """Share one code trained on every line of the dialog corpus"""
+        self.shared_code = CanonicalHuffmanCode.train(corpus)
+        return self.shared_code
 
     def build_frequency_table(self, text: str) -> Dict[str, int]:
         """Build character frequency table from text"""
-        frequency = {}
-        for char in text:
-            frequency[char] = frequency.get(char, 0) + 1
-        return frequency
+        return dict(Counter(text))
 
     def build_huffman_tree(self, frequency: Dict[str, int]) -> Dict[str, str]:
-        """Build Huffman tree and generate codes"""
-        import heapq
-
+        """Canonical Huffman codes (as bit strings) for a frequency table"""
         if not frequency:
             return {}
+        return CanonicalHuffmanCode.from_frequencies(frequency).bit_strings()
 
-        # Create priority queue
-        heap = [[weight, char] for char, weight in frequency.items()]
-        heapq.heapify(heap)
+    def compress_text(self, text: str) -> bytes:
+        """Compress text using Huffman encoding"""
+        if not text:
+            return b""
 
-        # Build tree
-        while len(heap) > 1:
-            left = heapq.heappop(heap)
-            right = heapq.heappop(heap)
+        if self.shared_code is not None and self.shared_code.covers(text):
+            code = self.shared_code
+            header = bytes([self.SHARED_TABLE])
+        else:
+            code = CanonicalHuffmanCode.from_frequencies(Counter(text))
+            header = bytes([self.EMBEDDED_TABLE]) + code.to_bytes()
 
-            merged = [left[0] + right[0], left, right]
-            heapq.heappush(heap, merged)
+        writer = code.encode(text)
+        return header + struct.pack("<I", writer.bit_position) + writer.getvalue()
 
-        # Generate codes
-        codes = {}
+    def decompress_text(self, compressed_data: bytes) -> str:
+        """Decompress Huffman encoded text"""
+        if not compressed_data:
+            return ""
 
-        def generate_codes(node, code=""):
-            if isinstance(node[1], str):  # Leaf node
-                codes[node[1]] = code or "0"  # Handle single character case
-            else:
-                generate_codes(node[1], code + "0")
-                generate_codes(node[2], code + "1")
+        mode = compressed_data[0]
+        pos = 1
+        if mode == self.SHARED_TABLE:
+            if self.shared_code is None:
+                raise ValueError("Blob uses a shared dialog code, but none is loaded")
+            code = self.shared_code
+        elif mode == self.EMBEDDED_TABLE:
+            code, size = CanonicalHuffmanCode.from_bytes(compressed_data[pos:])
+            pos += size
+        else:
+            raise ValueError(f"Unknown Huffman blob mode: {mode}")
 
-        if heap:
-            generate_codes(heap[0])
+        bit_length = struct.unpack("<I", compressed_data[pos : pos + 4])[0]
+        pos += 4
+        return code.decode(compressed_data, pos * 8, pos * 8 + bit_length)
 
-        return codes
 
-    def compress_text(self, text: str) -> bytes:
-        """Compress text using Huffman encoding"""
-        if not text:
-            return b""
+class CompressionCache:
+    """
+    Content-addressed on-disk cache of compression results
+    Entries are keyed by a hash of the input bytes, algorithm name and every parameter that
+    affects the output. Each entry is written to a temp file and atomically renamed into place,
+    so parallel build workers sharing one cache directory never see partial entries.
+    """
 
-        # Build frequency table and Huffman codes
-        frequency = self.build_frequency_table(text)
-        codes = self.build_huffman_tree(frequency)
+    FORMAT_VERSION = 2
 
-        # Encode text
-        bit_string = "".join(codes[char] for char in text)
+    def __init__(self, cache_dir: Path):
+        self.cache_dir = Path(cache_dir)
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
 
-        # Convert bit string to bytes
-        compressed = bytearray()
+    def key(self, data: Union[bytes, str], algorithm: str, params: Dict[str, Any]) -> str:
+        """Cache key for one (input, algorithm, parameters) combination"""
+        digest = hashlib.blake2b(digest_size=20)
+        header = {"version": self.FORMAT_VERSION, "algorithm": algorithm, "params": params, "text": isinstance(data, str)}
+        digest.update(json.dumps(header, sort_keys=True).encode("utf-8"))
+        digest.update(b"\0")
+        digest.update(data.encode("utf-8") if isinstance(data, str) else data)
+        return digest.hexdigest()
 
-        # Store frequency table for decompression
-        freq_data = json.dumps(frequency).encode("utf-8")
-        compressed.extend(struct.pack("<H", len(freq_data)))
-        compressed.extend(freq_data)
+    def _entry_path(self, key: str) -> Path:
+        return self.cache_dir / key[:2] / f"{key}.bin"
 
-        # Store compressed data
-        bit_length = len(bit_string)
-        compressed.extend(struct.pack("<I", bit_length))
+    def get(self, key: str) -> Optional[Tuple[bytes, CompressionStats]]:
+        """Cached (compressed, stats) for key, or None on a miss or unreadable entry"""
+        try:
+            entry = self._entry_path(key).read_bytes()
+            meta_length = struct.unpack("<I", entry[:4])[0]
+            meta = json.loads(entry[4 : 4 + meta_length].decode("utf-8"))
+            compressed = entry[4 + meta_length :]
+        except (OSError, ValueError, struct.error):
+            return None
 
-        # Pack bits into bytes
-        for i in range(0, len(bit_string), 8):
-            byte_bits = bit_string[i : i + 8].ljust(8, "0")
-            byte_value = int(byte_bits, 2)
-            compressed.append(byte_value)
+        if len(compressed) != meta["compressed_size"]:
+            return None
 
-        return bytes(compressed)
+        stats = CompressionStats(
+            original_size=meta["original_size"],
+            compressed_size=meta["compressed_size"],
+            compression_ratio=0.0,
+            algorithm=meta["algorithm"],
+            time_taken=meta["time_taken"],
+        )
+        return compressed, stats
 
-    def decompress_text(self, compressed_data: bytes) -> str:
-        """Decompress Huffman encoded text"""
-        if not compressed_data:
-            return ""
+    def put(self, key: str, compressed: bytes, stats: CompressionStats):
+        """Store a result; concurrent writers of the same key simply race to an identical file"""
+        path = self._entry_path(key)
+        path.parent.mkdir(exist_ok=True)
+
+        meta = json.dumps(
+            {
+                "algorithm": stats.algorithm,
+                "original_size": stats.original_size,
+                "compressed_size": stats.compressed_size,
+                "time_taken": stats.time_taken,
+            }
+        ).encode("utf-8")
+
+        fd, temp_path = tempfile.mkstemp(dir=path.parent, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                f.write(struct.pack("<I", len(meta)))
+                f.write(meta)
+                f.write(compressed)
+            os.replace(temp_path, path)
+        except OSError:
+            if os.path.exists(temp_path):
+                os.remove(temp_path)
+            raise
 
-        pos = 0
 
-        # Read frequency table
-        freq_length = struct.unpack("<H", compressed_data[pos : pos + 2])[0]
-        pos += 2
+def _create_algorithms(ring_match_finder: str, parse_effort: int, dialog_code: Optional[bytes] = None) -> Dict[str, Any]:
+    """Instantiate every codec for one engine configuration (dialog_code: a serialized shared Huffman code)"""
+    return {
+        "basic_ring400": BasicRing400(match_finder=ring_match_finder, effort=parse_effort),
+        "simple_tail_window": SimpleTailWindowCompression(effort=parse_effort),
+        "huffman_dialog": HuffmanDialogCompression(CanonicalHuffmanCode.from_bytes(dialog_code)[0] if dialog_code else None),
+    }
 
-        freq_data = compressed_data[pos : pos + freq_length].decode("utf-8")
-        frequency = json.loads(freq_data)
-        pos += freq_length
 
-        # Rebuild Huffman codes
-        codes = self.build_huffman_tree(frequency)
+def _run_compression(algorithms: Dict[str, Any], data: Union[bytes, str], algorithm: str) -> Tuple[bytes, CompressionStats]:
+    """Compress with an already-resolved algorithm and time it"""
+    original_bytes = data.encode("utf-8") if isinstance(data, str) else data
 
-        # Create reverse lookup
-        reverse_codes = {code: char for char, code in codes.items()}
+    start_time = time.time()
 
-        # Read bit length
-        bit_length = struct.unpack("<I", compressed_data[pos : pos + 4])[0]
-        pos += 4
+    if algorithm == "huffman_dialog":
+        compressed = algorithms[algorithm].compress_text(data if isinstance(data, str) else data.decode("utf-8"))
+    else:
+        compressed = algorithms[algorithm].compress(original_bytes)
+
+    end_time = time.time()
+
+    stats = CompressionStats(
+        original_size=len(original_bytes),
+        compressed_size=len(compressed),
+        compression_ratio=(len(compressed) / len(original_bytes) if original_bytes else 0.0),
+        algorithm=algorithm,
+        time_taken=end_time - start_time,
+    )
+
+    return compressed, stats
 
-        # Convert bytes back to bit string
-        bit_string = ""
-        remaining_bytes = compressed_data[pos:]
 
-        for byte_value in remaining_bytes:
-            bit_string += format(byte_value, "08b")
+# Codecs cached per engine configuration inside each batch worker process
+_worker_algorithms: Dict[Tuple[str, int, Optional[bytes]], Dict[str, Any]] = {}
 
-        # Truncate to actual bit length
-        bit_string = bit_string[:bit_length]
 
-        # Decode using Huffman tree
-        decoded_text = ""
-        code_buffer = ""
+def _batch_worker(task: Tuple[Tuple[str, int, Optional[bytes]], int, Union[bytes, str], str]) -> Tuple[int, bytes, CompressionStats]:
+    """Run one (asset, algorithm) trial of a compress_batch call"""
+    config, index, data, algorithm = task
 
-        for bit in bit_string:
-            code_buffer += bit
-            if code_buffer in reverse_codes:
-                decoded_text += reverse_codes[code_buffer]
-                code_buffer = ""
+    if config not in _worker_algorithms:
+        _worker_algorithms[config] = _create_algorithms(*config)
 
-        return decoded_text
+    compressed, stats = _run_compression(_worker_algorithms[config], data, algorithm)
+    return index, compressed, stats
 
 
 class CompressionEngine:
     """Main compression engine integrating all algorithms"""
 
-    def __init__(self):
-        self.algorithms = {
-            "basic_ring400": BasicRing400(),
-            "simple_tail_window": SimpleTailWindowCompression(),
-            "huffman_dialog": HuffmanDialogCompression(),
-        }
-
-        self.stats_log = Path(__file__).parent.parent.parent / "logs" / "compression_stats.json"
+    def __init__(
+        self,
+        ring_match_finder: str = "hash_chain",
+        parse_effort: int = 0,
+        use_cache: bool = True,
+        cache_dir: Optional[Union[str, Path]] = None,
+    ):
+        self.config = (ring_match_finder, parse_effort, None)
+        self.algorithms = _create_algorithms(ring_match_finder, parse_effort)
+
+        project_root = Path(__file__).parent.parent.parent
+        self.stats_log = project_root / "logs" / "compression_stats.json"
         self.stats_log.parent.mkdir(exist_ok=True)
 
+        self.cache = CompressionCache(cache_dir or project_root / "cache" / "compression") if use_cache else None
+        self.cache_hits = 0
+        self.cache_misses = 0
+
+    def train_dialog_code(self, corpus: List[str]) -> CanonicalHuffmanCode:
+        """Train one Huffman code on the whole dialog corpus and use it for every dialog blob"""
+        code = self.algorithms["huffman_dialog"].train(corpus)
+        self.config = self.config[:2] + (code.to_bytes(),)
+        return code
+
     def compress(self, data: Union[bytes, str], algorithm: str = "auto") -> Tuple[bytes, CompressionStats]:
         """Compress data using specified algorithm"""
-        import time
+        algorithm = self._resolve_algorithm(data, algorithm)
+        stage_trace.count("compression.bytes_in", len(data.encode("utf-8") if isinstance(data, str) else data))
 
-        if isinstance(data, str):
-            # Text data - use Huffman for dialog
-            if algorithm == "auto":
-                algorithm = "huffman_dialog"
-            original_bytes = data.encode("utf-8")
+        cached = self._cache_lookup(data, algorithm)
+        if cached:
+            compressed, stats = cached
         else:
-            original_bytes = data
+            compressed, stats = _run_compression(self.algorithms, data, algorithm)
+            self._cache_store(data, compressed, stats)
 
-        if algorithm == "auto":
-            # Auto-select best algorithm for binary data
-            algorithm = self._select_best_algorithm(original_bytes)
+        self._log_stats(stats)
+        return compressed, stats
 
-        if algorithm not in self.algorithms:
-            raise ValueError(f"Unknown algorithm: {algorithm}")
+    def compress_batch(
+        self,
+        items: List[Union[bytes, str]],
+        algorithm: Union[str, List[str]] = "auto",
+        workers: Optional[int] = None,
+    ) -> List[Tuple[bytes, CompressionStats]]:
+        """
+        Compress many assets in parallel, returning results in input order
+        algorithm may be a single name or a list of candidates; every candidate is tried and the
+        smallest output is kept, first listed wins ties. "auto" stands for every codec that accepts
+        the item, with compress()'s heuristic pick first so it wins ties.
+        Each (asset, candidate) trial is a separate task, largest first, handed to worker processes
+        one at a time so idle workers keep pulling work until the batch drains.
+        """
+        candidates = algorithm if isinstance(algorithm, list) else [algorithm]
+
+        tasks = []
+        for index, data in enumerate(items):
+            names: List[str] = []
+            for candidate in candidates:
+                expanded = self._auto_candidates(data) if candidate == "auto" else [self._resolve_algorithm(data, candidate)]
+                names.extend(name for name in expanded if name not in names)
+            for name in names:
+                tasks.append((self.config, index, data, name))
+
+        # Candidate order per item decides ties, so remember it before reordering for scheduling
+        rank = {(task[1], task[3]): order for order, task in enumerate(tasks)}
+        tasks.sort(key=lambda task: len(task[2]), reverse=True)
+
+        best: Dict[int, Tuple[int, bytes, CompressionStats]] = {}
+
+        def keep_best(index: int, compressed: bytes, stats: CompressionStats):
+            order = rank[(index, stats.algorithm)]
+            current = best.get(index)
+            if not current or (len(compressed), order) < (len(current[1]), current[0]):
+                best[index] = (order, compressed, stats)
+
+        # Only cache misses are handed to the workers
+        pending = []
+        for task in tasks:
+            _, index, data, task_algorithm = task
+            cached = self._cache_lookup(data, task_algorithm)
+            if cached:
+                keep_best(index, *cached)
+            else:
+                pending.append(task)
 
-        start_time = time.time()
+        def finish(index: int, compressed: bytes, stats: CompressionStats):
+            self._cache_store(items[index], compressed, stats)
+            keep_best(index, compressed, stats)
 
-        if isinstance(data, str) and algorithm == "huffman_dialog":
-            compressed = self.algorithms[algorithm].compress_text(data)
+        workers = workers or os.cpu_count() or 1
+        if workers == 1 or len(pending) <= 1:
+            for task in pending:
+                finish(*_batch_worker(task))
         else:
-            compressed = self.algorithms[algorithm].compress(original_bytes)
+            with ProcessPoolExecutor(max_workers=min(workers, len(pending))) as executor:
+                futures = [executor.submit(_batch_worker, task) for task in pending]
+                for future in as_completed(futures):
+                    finish(*future.result())
+
+        results = [(best[index][1], best[index][2]) for index in range(len(items))]
+
+        self._log_stats_batch([stats for _, stats in results])
+        return results
+
+    def _cache_key(self, data: Union[bytes, str], algorithm: str) -> str:
+        codec = self.algorithms[algorithm]
+        params = {
+            "effort": getattr(codec, "effort", None),
+            "window_size": getattr(codec, "window_size", None),
+            "dictionary": getattr(codec, "dictionary_id", None),
+        }
+        return self.cache.key(data, algorithm, params)
 
-        end_time = time.time()
+    def _cache_lookup(self, data: Union[bytes, str], algorithm: str) -> Optional[Tuple[bytes, CompressionStats]]:
+        """Cached result marked as a hit (with the lookup as its time), or None"""
+        if not self.cache:
+            return None
 
-        stats = CompressionStats(
-            original_size=len(original_bytes),
-            compressed_size=len(compressed),
-            compression_ratio=(len(compressed) / len(original_bytes) if original_bytes else 0.0),
-            algorithm=algorithm,
-            time_taken=end_time - start_time,
-        )
+        start_time = time.time()
+        cached = self.cache.get(self._cache_key(data, algorithm))
+        if not cached:
+            self.cache_misses += 1
+            stage_trace.count("compression.cache_misses")
+            return None
 
-        self._log_stats(stats)
+        compressed, stats = cached
+        stats.cache_hit = True
+        stats.time_taken = time.time() - start_time
+        self.cache_hits += 1
+        stage_trace.count("compression.cache_hits")
         return compressed, stats
 
+    def _cache_store(self, data: Union[bytes, str], compressed: bytes, stats: CompressionStats):
+        if not self.cache:
+            return
+
+        try:
+            self.cache.put(self._cache_key(data, stats.algorithm), compressed, stats)
+        except OSError as e:
+            print(f"Warning: Could not write compression cache entry: {e}")
+
+    def _resolve_algorithm(self, data: Union[bytes, str], algorithm: str) -> str:
+        """Turn "auto" into a concrete algorithm name and validate it"""
+        if algorithm == "auto":
+            if isinstance(data, str):
+                # Text data - use Huffman for dialog
+                algorithm = "huffman_dialog"
+            else:
+                # Auto-select best algorithm for binary data
+                algorithm = self._select_best_algorithm(data)
+
+        if algorithm not in self.algorithms:
+            raise ValueError(f"Unknown algorithm: {algorithm}")
+
+        return algorithm
+
+    def _auto_candidates(self, data: Union[bytes, str]) -> List[str]:
+        """Every codec that accepts data, the heuristic's choice first"""
+        candidates = [self._resolve_algorithm(data, "auto")]
+        raw = data.encode("utf-8") if isinstance(data, str) else data
+        # BasicRing400 literals carry 7 bits, so it only competes for 7-bit data
+        if "basic_ring400" not in candidates and raw.isascii():
+            candidates.append("basic_ring400")
+        if "simple_tail_window" not in candidates:
+            candidates.append("simple_tail_window")
+        if "huffman_dialog" not in candidates:
+            try:
+                raw.decode("utf-8")
+                candidates.append("huffman_dialog")
+            except UnicodeDecodeError:
+                pass
+        return candidates
+
     def decompress(self, compressed_data: bytes, algorithm: str) -> bytes:
         """Decompress data using specified algorithm"""
         if algorithm not in self.algorithms:
@@ -469,6 +921,35 @@ class CompressionEngine:
         else:
             return self.algorithms[algorithm].decompress(compressed_data)
 
+    def benchmark_parse_modes(
+        self, banks: Dict[str, bytes], efforts: Tuple[int, ...] = PARSE_EFFORT_LEVELS
+    ) -> Dict[str, Dict[str, List[Dict[str, Any]]]]:
+        """Compare compressed size and time of each parse effort per bank and algorithm"""
+        codecs = {
+            "basic_ring400": lambda effort: BasicRing400(effort=effort),
+            "simple_tail_window": lambda effort: SimpleTailWindowCompression(effort=effort),
+        }
+
+        results = {}
+        for bank_name, bank_data in banks.items():
+            results[bank_name] = {}
+            for algorithm, make_codec in codecs.items():
+                runs = []
+                for effort in efforts:
+                    start_time = time.time()
+                    compressed = make_codec(effort).compress(bank_data)
+                    runs.append(
+                        {
+                            "effort": effort,
+                            "original_size": len(bank_data),
+                            "compressed_size": len(compressed),
+                            "time_taken": time.time() - start_time,
+                        }
+                    )
+                results[bank_name][algorithm] = runs
+
+        return results
+
     def _select_best_algorithm(self, data: bytes) -> str:
         """Auto-select best compression algorithm based on data characteristics"""
         # Small data - use BasicRing400
@@ -508,6 +989,10 @@ class CompressionEngine:
 
     def _log_stats(self, stats: CompressionStats):
         """Log compression statistics"""
+        self._log_stats_batch([stats])
+
+    def _log_stats_batch(self, stats_list: List[CompressionStats]):
+        """Log several compression results with a single read/write of the stats file"""
         try:
             if self.stats_log.exists():
                 with open(self.stats_log, "r") as f:
@@ -515,16 +1000,21 @@ class CompressionEngine:
             else:
                 all_stats = []
 
-            all_stats.append(
-                {
-                    "timestamp": time.strftime("%Y-%m-%d %H:%M:%S"),
-                    "algorithm": stats.algorithm,
-                    "original_size": stats.original_size,
-                    "compressed_size": stats.compressed_size,
-                    "compression_ratio": stats.compression_ratio,
-                    "time_taken": stats.time_taken,
-                }
-            )
+            timestamp = time.strftime("%Y-%m-%d %H:%M:%S")
+            for stats in stats_list:
+                all_stats.append(
+                    {
+                        "timestamp": timestamp,
+                        "algorithm": stats.algorithm,
+                        "original_size": stats.original_size,
+                        "compressed_size": stats.compressed_size,
+                        "compression_ratio": stats.compression_ratio,
+                        "time_taken": stats.time_taken,
+                        "cache_hit": stats.cache_hit,
+                        "cache_hits": self.cache_hits,
+                        "cache_misses": self.cache_misses,
+                    }
+                )
 
             with open(self.stats_log, "w") as f:
                 json.dump(all_stats, f, indent=2)
@@ -534,12 +1024,59 @@ class CompressionEngine:
 
 
 # Factory function for easy usage
-def get_compression_engine() -> CompressionEngine:
+def get_compression_engine(ring_match_finder: str = "hash_chain", parse_effort: int = 0) -> CompressionEngine:
     """Get a configured compression engine instance"""
-    return CompressionEngine()
+    return CompressionEngine(ring_match_finder=ring_match_finder, parse_effort=parse_effort)
+
+
+def run_parse_benchmark(rom_path: str, bank_size: int, max_banks: Optional[int], output: Optional[str]):
+    """Benchmark greedy vs optimal parsing on the ROM's banks and print a summary"""
+    rom_data = Path(rom_path).read_bytes()
+
+    # Skip a 512-byte copier header if present
+    if len(rom_data) % 1024 == 512:
+        rom_data = rom_data[512:]
+
+    banks = {}
+    for bank_num, start in enumerate(range(0, len(rom_data), bank_size)):
+        if max_banks is not None and bank_num >= max_banks:
+            break
+        banks[f"bank_{bank_num:02X}"] = rom_data[start : start + bank_size]
+
+    engine = get_compression_engine()
+    results = engine.benchmark_parse_modes(banks)
+
+    print(f"{'Bank':<10} {'Algorithm':<20} {'Effort':>6} {'Size':>8} {'Saved':>7} {'Time':>8}")
+    for bank_name, algorithms in results.items():
+        for algorithm, runs in algorithms.items():
+            greedy_size = runs[0]["compressed_size"]
+            for run in runs:
+                saved = greedy_size - run["compressed_size"]
+                print(
+                    f"{bank_name:<10} {algorithm:<20} {run['effort']:>6} {run['compressed_size']:>8} "
+                    f"{saved:>7} {run['time_taken']:>7.2f}s"
+                )
+
+    if output:
+        with open(output, "w") as f:
+            json.dump(results, f, indent=2)
+        print(f"Benchmark results saved to {output}")
 
 
 if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="DQ3R compression engine")
+    parser.add_argument("--benchmark", metavar="ROM", help="Benchmark parse efforts on each bank of ROM")
+    parser.add_argument("--bank-size", type=lambda v: int(v, 0), default=0x10000, help="Bank size in bytes")
+    parser.add_argument("--banks", type=int, help="Only benchmark the first N banks")
+    parser.add_argument("--output", "-o", help="Write benchmark results as JSON")
+    args = parser.parse_args()
+
+    if args.benchmark:
+        run_parse_benchmark(args.benchmark, args.bank_size, args.banks, args.output)
+        sys.exit(0)
+
     # Example usage and testing
     engine = get_compression_engine()
 
@@ -0,0 +1,343 @@
+#!/usr/bin/env python3
+"""
+Speculative Decompression Probe
+Tries the BasicRing400 and SimpleTailWindow decoders at every candidate offset of a ROM
+range, stopping each attempt as soon as the stream stops looking like real compressed
+data, and ranks the streams that expand well
+"""
+
+import os
+import re
+import time
+import json
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, asdict
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple, Union
+
+from compression_engine import BasicRing400, SimpleTailWindowCompression
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+# A stream ends after this many literals in a row: the encoders emit copies whenever a
+# 3-byte match exists, so a long literal run means the bytes are no longer compressed
+MAX_LITERAL_RUN = 32
+
+# Stop decoding a candidate once it has produced this much output
+MAX_OUTPUT = 0x10000
+
+# Streams worth reporting; a handful of bytes expands by chance in any data
+MIN_INPUT = 16
+MIN_COPIES = 4
+MIN_OUTPUT = 64
+MIN_RATIO = 1.5
+
+# Offsets per worker task
+PROBE_CHUNK = 0x4000
+
+
+@dataclass
+class ProbeResult:
+    """One candidate compressed stream"""
+
+    offset: int
+    algorithm: str
+    consumed: int  # Compressed bytes up to the end of the last copy command
+    output_size: int
+    copies: int
+    stop_reason: str
+
+    @property
+    def ratio(self) -> float:
+        return self.output_size / self.consumed if self.consumed else 0.0
+
+    @property
+    def savings(self) -> int:
+        return self.output_size - self.consumed
+
+    def to_dict(self) -> Dict[str, object]:
+        result = asdict(self)
+        result["ratio"] = round(self.ratio, 3)
+        return result
+
+
+def probe_ring400(data: Buffer, offset: int, max_output: int = MAX_OUTPUT) -> ProbeResult:
+    """
+    Decode BasicRing400 at offset until the stream turns invalid
+    Invalid: a copy shorter than MIN_COPY_SIZE (never emitted), a copy that reads ring
+    bytes nothing has written yet, or MAX_LITERAL_RUN literals in a row.
+    """
+    ring_size = BasicRing400.RING_SIZE
+    min_copy = BasicRing400.MIN_COPY_SIZE
+    end = len(data)
+    pos = offset
+    written = 0
+    literal_run = 0
+    copies = 0
+    last_copy_end = offset
+    output_at_copy = 0
+    reason = "end_of_data"
+
+    while pos + 1 < end:
+        byte1 = data[pos]
+        if byte1 & 0x80:
+            literal_run += 1
+            if literal_run > MAX_LITERAL_RUN:
+                reason = "literal_run"
+                break
+            written += 1
+            pos += 1
+            continue
+
+        length = data[pos + 1] & 0x3F
+        if length < min_copy:
+            reason = "short_copy"
+            break
+        address = ((byte1 << 2) | (data[pos + 1] >> 6)) & 0x3FF
+        # Until the ring has wrapped only [0, written) holds output. The encoder may match
+        # the zero-initialized slots too, but the lowest such address is the first empty one.
+        if written < ring_size and address > written:
+            reason = "unwritten_ring"
+            break
+
+        written += length
+        pos += 2
+        copies += 1
+        literal_run = 0
+        last_copy_end = pos
+        output_at_copy = written
+        if written >= max_output:
+            reason = "max_output"
+            break
+
+    return ProbeResult(offset, "basic_ring400", last_copy_end - offset, output_at_copy, copies, reason)
+
+
+def probe_tail_window(data: Buffer, offset: int, max_output: int = MAX_OUTPUT) -> ProbeResult:
+    """
+    Decode SimpleTailWindow at offset (same command rule as decompress()) until
+    MAX_LITERAL_RUN literals in a row or a copy from beyond the encoder's window; every byte
+    sequence decodes, so those are the only stops
+    """
+    min_match = 3
+    window_size = SimpleTailWindowCompression().window_size
+    end = len(data)
+    pos = offset
+    written = 0
+    literal_run = 0
+    copies = 0
+    last_copy_end = offset
+    output_at_copy = 0
+    reason = "end_of_data"
+
+    while pos < end:
+        if pos + 2 < end:
+            distance = data[pos] | (data[pos + 1] << 8)
+            if 0 < distance <= written:
+                if distance > window_size:
+                    reason = "far_copy"
+                    break
+                written += data[pos + 2] + min_match
+                pos += 3
+                copies += 1
+                literal_run = 0
+                last_copy_end = pos
+                output_at_copy = written
+                if written >= max_output:
+                    reason = "max_output"
+                    break
+                continue
+
+        literal_run += 1
+        if literal_run > MAX_LITERAL_RUN:
+            reason = "literal_run"
+            break
+        written += 1
+        pos += 1
+
+    return ProbeResult(offset, "simple_tail_window", last_copy_end - offset, output_at_copy, copies, reason)
+
+
+PROBES = {
+    "basic_ring400": probe_ring400,
+    "simple_tail_window": probe_tail_window,
+}
+
+# A tail-window copy needs a distance no larger than the output so far, and before the
+# first copy that is at most MAX_LITERAL_RUN literals
+_TAIL_FIRST_COPY = re.compile(rb"(?=[\x01-%s]\x00)" % re.escape(bytes([MAX_LITERAL_RUN])))
+
+
+def candidate_offsets(data: Buffer, algorithm: str, start: int, end: int) -> List[int]:
+    """Offsets in [start, end) where a stream of this format could begin"""
+    if algorithm == "basic_ring400":
+        # Nothing is in the ring yet, so the first command must be a literal
+        return [offset for offset in range(start, end) if data[offset] & 0x80]
+
+    if algorithm == "simple_tail_window":
+        candidates = set()
+        window = bytes(data[start : min(len(data), end + MAX_LITERAL_RUN + 2)])
+        for match in _TAIL_FIRST_COPY.finditer(window):
+            copy_pos = start + match.start()
+            distance = window[match.start()]
+            # The first copy's distance must fit in the literals before it
+            candidates.update(range(max(start, copy_pos - MAX_LITERAL_RUN), min(end, copy_pos - distance + 1)))
+        return sorted(candidates)
+
+    raise ValueError(f"Unknown algorithm: {algorithm}")
+
+
+def probe_range(
+    data: Buffer,
+    start: int,
+    end: int,
+    algorithms: Optional[List[str]] = None,
+    min_output: int = MIN_OUTPUT,
+    min_ratio: float = MIN_RATIO,
+) -> List[ProbeResult]:
+    """Every stream starting in [start, end) that expands past the thresholds"""
+    results = []
+    for algorithm in algorithms or list(PROBES):
+        probe = PROBES[algorithm]
+        for offset in candidate_offsets(data, algorithm, start, end):
+            result = probe(data, offset)
+            if (
+                result.consumed >= MIN_INPUT
+                and result.copies >= MIN_COPIES
+                and result.output_size >= min_output
+                and result.ratio >= min_ratio
+            ):
+                results.append(result)
+    return results
+
+
+def rank_streams(results: List[ProbeResult], overlapping: bool = False) -> List[ProbeResult]:
+    """
+    Best streams first (most bytes saved, then ratio, then lowest offset); unless overlapping
+    is set, a stream is dropped when it overlaps a better one already kept
+    """
+    ordered = sorted(results, key=lambda r: (-r.savings, -r.ratio, r.offset, r.algorithm))
+    if overlapping:
+        return ordered
+
+    kept = []
+    claimed: List[Tuple[int, int]] = []
+    for result in ordered:
+        stream_end = result.offset + result.consumed
+        if any(result.offset < other_end and other_start < stream_end for other_start, other_end in claimed):
+            continue
+        kept.append(result)
+        claimed.append((result.offset, stream_end))
+    return kept
+
+
+# ROM image handed to each probe worker process once, not per task
+_worker_data: Buffer = b""
+
+
+def _init_probe_worker(shared):
+    global _worker_data
+    _worker_data = memoryview(getattr(shared, "data", shared))
+
+
+def _probe_worker(task: Tuple[int, int, List[str], int, float]) -> List[ProbeResult]:
+    """Probe one slice of offsets in a worker process"""
+    start, end, algorithms, min_output, min_ratio = task
+    return probe_range(_worker_data, start, end, algorithms, min_output, min_ratio)
+
+
+def probe_streams(
+    data: Buffer,
+    start: int = 0,
+    end: Optional[int] = None,
+    algorithms: Optional[List[str]] = None,
+    workers: Optional[int] = None,
+    min_output: int = MIN_OUTPUT,
+    min_ratio: float = MIN_RATIO,
+    overlapping: bool = False,
+) -> List[ProbeResult]:
+    """Ranked candidate streams starting anywhere in [start, end)"""
+    end = len(data) if end is None else min(end, len(data))
+    return probe_ranges(data, [(start, end)], algorithms, workers, min_output, min_ratio, overlapping)
+
+
+def probe_ranges(
+    data: Buffer,
+    ranges: List[Tuple[int, int]],
+    algorithms: Optional[List[str]] = None,
+    workers: Optional[int] = None,
+    min_output: int = MIN_OUTPUT,
+    min_ratio: float = MIN_RATIO,
+    overlapping: bool = False,
+) -> List[ProbeResult]:
+    """
+    Ranked candidate streams starting in any of the [start, end) ranges
+    Offsets are split into PROBE_CHUNK slices probed across one pool of worker processes;
+    data may be a shared ROM image, which workers map themselves.
+    """
+    # A shared ROM image pickles as its path, so workers map the file instead of copying it
+    shared = data if hasattr(data, "data") else bytes(data)
+    data = memoryview(getattr(shared, "data", shared))
+    algorithms = algorithms or list(PROBES)
+
+    tasks = [
+        (chunk_start, min(chunk_start + PROBE_CHUNK, end, len(data)), algorithms, min_output, min_ratio)
+        for start, end in ranges
+        for chunk_start in range(start, min(end, len(data)), PROBE_CHUNK)
+    ]
+
+    workers = workers or os.cpu_count() or 1
+    results: List[ProbeResult] = []
+    if workers == 1 or len(tasks) <= 1:
+        for task in tasks:
+            results.extend(probe_range(data, *task))
+    else:
+        with ProcessPoolExecutor(
+            max_workers=min(workers, len(tasks)), initializer=_init_probe_worker, initargs=(shared,)
+        ) as executor:
+            for chunk_results in executor.map(_probe_worker, tasks):
+                results.extend(chunk_results)
+
+    return rank_streams(results, overlapping)
+
+
+def main():
+    """Command-line interface"""
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Probe a ROM for compressed streams at every offset")
+    parser.add_argument("rom_file", help="ROM file to probe")
+    parser.add_argument("--start", type=lambda v: int(v, 0), default=0, help="First offset to probe")
+    parser.add_argument("--end", type=lambda v: int(v, 0), help="Offset to stop probing at")
+    parser.add_argument("--algorithm", "-a", action="append", choices=sorted(PROBES), help="Only probe this format")
+    parser.add_argument("--workers", type=int, help="Worker processes (default: one per core)")
+    parser.add_argument("--min-output", type=int, default=MIN_OUTPUT, help="Smallest decompressed size to report")
+    parser.add_argument("--min-ratio", type=float, default=MIN_RATIO, help="Smallest expansion ratio to report")
+    parser.add_argument("--top", type=int, default=20, help="Streams to print")
+    parser.add_argument("--output", "-o", help="Write every ranked stream as JSON")
+    args = parser.parse_args()
+
+    data = Path(args.rom_file).read_bytes()
+    if len(data) % 1024 == 512:
+        data = data[512:]
+
+    start_time = time.time()
+    streams = probe_streams(data, args.start, args.end, args.algorithm, args.workers, args.min_output, args.min_ratio)
+    elapsed = time.time() - start_time
+
+    end = args.end if args.end is not None else len(data)
+    print(f"🔍 Probed ${args.start:06X}-${end:06X} in {elapsed:.2f}s: {len(streams)} candidate streams")
+    for result in streams[: args.top]:
+        print(
+            f"   ${result.offset:06X} {result.algorithm:<20} {result.consumed:>6} -> {result.output_size:>6} "
+            f"bytes ({result.ratio:.2f}x, {result.copies} copies, {result.stop_reason})"
+        )
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump([result.to_dict() for result in streams], f, indent=2)
+        print(f"Results saved to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
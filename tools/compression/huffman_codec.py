@@ -0,0 +1,355 @@
+#!/usr/bin/env python3
+"""
+Canonical Huffman Dialog Codec
+One code table trained on the whole dialog corpus, table-driven decoding (TABLE_BITS bits
+per lookup) and a packed dialog bank with a bit-offset index, so any single line decodes
+without touching the rest of the bank
+"""
+
+import heapq
+import mmap
+import os
+import struct
+import sys
+from array import array
+from collections import Counter
+from pathlib import Path
+from typing import Dict, Iterable, Iterator, List, Optional, Sequence, Tuple, Union
+
+Buffer = Union[bytes, bytearray, memoryview]
+
+# Longest code assigned; frequencies are flattened until every code fits
+MAX_CODE_LENGTH = 20
+
+# Bits resolved per table lookup; longer codes take the canonical slow path
+TABLE_BITS = 10
+
+BANK_MAGIC = b"DQ3H"
+BANK_VERSION = 1
+BANK_HEADER = struct.Struct("<4sHHII")  # magic, version, reserved, string count, code table size
+
+
+def _code_lengths(frequency: Dict[str, int]) -> Dict[str, int]:
+    """Huffman code length per symbol (ties broken by insertion order, so heap entries never compare nodes)"""
+    if len(frequency) == 1:
+        return {symbol: 1 for symbol in frequency}
+
+    heap = [(weight, order, order) for order, weight in enumerate(frequency.values())]
+    heapq.heapify(heap)
+    parents = list(range(len(heap)))
+    next_node = len(heap)
+    order = len(heap)
+    while len(heap) > 1:
+        weight_a, _, node_a = heapq.heappop(heap)
+        weight_b, _, node_b = heapq.heappop(heap)
+        parents.append(next_node)
+        parents[node_a] = parents[node_b] = next_node
+        heapq.heappush(heap, (weight_a + weight_b, order, next_node))
+        next_node += 1
+        order += 1
+
+    root = next_node - 1
+    lengths = {}
+    for leaf, symbol in enumerate(frequency):
+        depth = 0
+        node = leaf
+        while node != root:
+            node = parents[node]
+            depth += 1
+        lengths[symbol] = depth
+    return lengths
+
+
+class CanonicalHuffmanCode:
+    """
+    Canonical code: symbols sorted by (length, symbol) take consecutive codes, so the
+    table is fully described by each symbol's length
+    """
+
+    def __init__(self, lengths: Dict[str, int]):
+        if not lengths:
+            raise ValueError("A code needs at least one symbol")
+        if max(lengths.values()) > MAX_CODE_LENGTH:
+            raise ValueError(f"Code lengths exceed {MAX_CODE_LENGTH} bits")
+
+        self.symbols: List[str] = sorted(lengths, key=lambda symbol: (lengths[symbol], symbol))
+        self.lengths: List[int] = [lengths[symbol] for symbol in self.symbols]
+        self.max_length = max(self.lengths)
+
+        # Canonical assignment plus, per length, the first code, count and first symbol index
+        self.encode_table: Dict[str, Tuple[int, int]] = {}
+        self.first_code = [0] * (self.max_length + 2)
+        self.length_count = [0] * (self.max_length + 2)
+        self.first_index = [0] * (self.max_length + 2)
+        code = 0
+        previous = self.lengths[0]
+        for index, (symbol, length) in enumerate(zip(self.symbols, self.lengths)):
+            code <<= length - previous
+            previous = length
+            if not self.length_count[length]:
+                self.first_code[length] = code
+                self.first_index[length] = index
+            self.length_count[length] += 1
+            self.encode_table[symbol] = (code, length)
+            code += 1
+
+        # Every TABLE_BITS-bit prefix of a short code resolves in one lookup: (index << 5) | length
+        self.decode_table = array("I", bytes(4 << TABLE_BITS))
+        for index, (symbol, length) in enumerate(zip(self.symbols, self.lengths)):
+            if length > TABLE_BITS:
+                continue
+            code = self.encode_table[symbol][0]
+            first = code << (TABLE_BITS - length)
+            entry = (index << 5) | length
+            for prefix in range(first, first + (1 << (TABLE_BITS - length))):
+                self.decode_table[prefix] = entry
+
+    @classmethod
+    def from_frequencies(cls, frequency: Dict[str, int]) -> "CanonicalHuffmanCode":
+        """Optimal lengths, with frequencies halved until no code exceeds MAX_CODE_LENGTH"""
+        frequency = {symbol: weight for symbol, weight in frequency.items() if weight > 0}
+        lengths = _code_lengths(frequency)
+        while max(lengths.values()) > MAX_CODE_LENGTH:
+            frequency = {symbol: (weight + 1) // 2 for symbol, weight in frequency.items()}
+            lengths = _code_lengths(frequency)
+        return cls(lengths)
+
+    @classmethod
+    def train(cls, corpus: Iterable[str]) -> "CanonicalHuffmanCode":
+        """One code for every line of a dialog corpus"""
+        frequency = Counter()
+        for text in corpus:
+            frequency.update(text)
+        return cls.from_frequencies(frequency)
+
+    def covers(self, text: str) -> bool:
+        return all(symbol in self.encode_table for symbol in set(text))
+
+    def bit_strings(self) -> Dict[str, str]:
+        """symbol -> code as a '0'/'1' string (for display)"""
+        return {symbol: format(code, f"0{length}b") for symbol, (code, length) in self.encode_table.items()}
+
+    def to_bytes(self) -> bytes:
+        """Symbol count, one length byte per symbol, then the symbols as UTF-8"""
+        return struct.pack("<H", len(self.symbols)) + bytes(self.lengths) + "".join(self.symbols).encode("utf-8")
+
+    @classmethod
+    def from_bytes(cls, data: Buffer) -> Tuple["CanonicalHuffmanCode", int]:
+        """(code, bytes consumed) from the start of data; ValueError if the table is truncated or malformed"""
+        if len(data) < 2:
+            raise ValueError("Truncated code table")
+        count = struct.unpack_from("<H", data)[0]
+        lengths = bytes(data[2 : 2 + count])
+        # UTF-8 symbols are 1-4 bytes each, sized by their lead byte
+        start = end = 2 + count
+        for _ in range(count):
+            if end >= len(data):
+                raise ValueError("Truncated code table")
+            lead = data[end]
+            end += 1 if lead < 0x80 else 2 if lead >> 5 == 0x06 else 3 if lead >> 4 == 0x0E else 4
+        if end > len(data):
+            raise ValueError("Truncated code table")
+        try:
+            text = bytes(data[start:end]).decode("utf-8")
+        except UnicodeDecodeError as e:
+            raise ValueError(f"Malformed code table symbols: {e}")
+        if len(text) != count or len(lengths) != count:
+            raise ValueError("Truncated code table")
+        if len(set(text)) != count:
+            raise ValueError("Code table repeats a symbol")
+        return cls(dict(zip(text, lengths))), end
+
+    def encode(self, text: str, writer: Optional["BitWriter"] = None) -> "BitWriter":
+        writer = writer or BitWriter()
+        table = self.encode_table
+        for symbol in text:
+            code, length = table[symbol]
+            writer.write(code, length)
+        return writer
+
+    def decode(self, data: Buffer, start_bit: int, end_bit: int) -> str:
+        """Decode the bits [start_bit, end_bit) of data"""
+        if end_bit <= start_bit:
+            return ""
+
+        first_byte = start_bit >> 3
+        last_byte = (end_bit + 7) >> 3
+        # Zero padding lets every lookup read a full window past the end
+        value = int.from_bytes(data[first_byte:last_byte], "big") << MAX_CODE_LENGTH
+        total = (last_byte - first_byte) * 8 + MAX_CODE_LENGTH
+        position = start_bit - first_byte * 8
+        end = end_bit - first_byte * 8
+
+        table = self.decode_table
+        symbols = self.symbols
+        table_mask = (1 << TABLE_BITS) - 1
+        out = []
+        append = out.append
+        while position < end:
+            entry = table[(value >> (total - position - TABLE_BITS)) & table_mask]
+            if entry:
+                append(symbols[entry >> 5])
+                position += entry & 0x1F
+                continue
+
+            # Code longer than TABLE_BITS: walk the remaining lengths canonically
+            for length in range(TABLE_BITS + 1, self.max_length + 1):
+                code = (value >> (total - position - length)) & ((1 << length) - 1)
+                offset = code - self.first_code[length]
+                if self.length_count[length] and 0 <= offset < self.length_count[length]:
+                    append(symbols[self.first_index[length] + offset])
+                    position += length
+                    break
+            else:
+                raise ValueError(f"Invalid Huffman code at bit {first_byte * 8 + position}")
+
+        return "".join(out)
+
+
+class BitWriter:
+    """MSB-first bit packer"""
+
+    def __init__(self):
+        self._out = bytearray()
+        self._acc = 0
+        self._bits = 0
+
+    @property
+    def bit_position(self) -> int:
+        return len(self._out) * 8 + self._bits
+
+    def write(self, code: int, length: int):
+        self._acc = (self._acc << length) | code
+        self._bits += length
+        if self._bits >= 32:
+            spill = self._bits & 7
+            self._out.extend((self._acc >> spill).to_bytes(self._bits >> 3, "big"))
+            self._acc &= (1 << spill) - 1
+            self._bits = spill
+
+    def getvalue(self) -> bytes:
+        """Packed bits, the last byte zero-padded"""
+        size = (self._bits + 7) >> 3
+        return bytes(self._out) + (self._acc << (size * 8 - self._bits)).to_bytes(size, "big")
+
+
+class DialogBank:
+    """
+    Every line of a dialog corpus as one bit stream under a shared code, plus the bit offset
+    of each line (count + 1 entries), so decode(index) only reads that line's bits
+    """
+
+    def __init__(self, code: CanonicalHuffmanCode, offsets: Sequence[int], payload: Buffer):
+        self.code = code
+        self.offsets = offsets
+        self.payload = payload
+        self._map = None
+
+    @classmethod
+    def build(cls, lines: Sequence[str], code: Optional[CanonicalHuffmanCode] = None) -> "DialogBank":
+        code = code or CanonicalHuffmanCode.train(lines)
+        writer = BitWriter()
+        offsets = array("I", [0])
+        for text in lines:
+            code.encode(text, writer)
+            offsets.append(writer.bit_position)
+        return cls(code, offsets, writer.getvalue())
+
+    def __len__(self) -> int:
+        return len(self.offsets) - 1
+
+    def decode(self, index: int) -> str:
+        """One line, decoded in isolation"""
+        if not 0 <= index < len(self):
+            raise IndexError(f"Dialog line {index} out of range")
+        return self.code.decode(self.payload, self.offsets[index], self.offsets[index + 1])
+
+    def __iter__(self) -> Iterator[str]:
+        return (self.decode(index) for index in range(len(self)))
+
+    def to_bytes(self) -> bytes:
+        table = self.code.to_bytes()
+        offsets = array("I", self.offsets)
+        if sys.byteorder != "little":
+            offsets.byteswap()
+        header = BANK_HEADER.pack(BANK_MAGIC, BANK_VERSION, 0, len(self), len(table))
+        return header + table + offsets.tobytes() + bytes(self.payload)
+
+    @classmethod
+    def from_bytes(cls, data: Buffer) -> "DialogBank":
+        """Bank over data without copying the offsets or payload (on little-endian hosts); ValueError if malformed"""
+        view = memoryview(data)
+        if len(view) < BANK_HEADER.size:
+            raise ValueError("Truncated dialog bank")
+        magic, version, _, count, table_size = BANK_HEADER.unpack_from(view)
+        if magic != BANK_MAGIC or version != BANK_VERSION:
+            raise ValueError("Not a dialog bank")
+
+        position = BANK_HEADER.size
+        code, used = CanonicalHuffmanCode.from_bytes(view[position : position + table_size])
+        if used != table_size:
+            raise ValueError("Dialog bank code table size mismatch")
+        position += table_size
+
+        offsets_view = view[position : position + (count + 1) * 4]
+        if len(offsets_view) != (count + 1) * 4:
+            raise ValueError("Truncated dialog bank")
+        if sys.byteorder == "little" and position % 4 == 0:
+            offsets = offsets_view.cast("I")
+        else:
+            offsets = array("I", offsets_view.tobytes())
+            if sys.byteorder != "little":
+                offsets.byteswap()
+        payload = view[position + (count + 1) * 4 :]
+        if offsets[count] > len(payload) * 8:
+            raise ValueError("Dialog bank offsets run past the payload")
+        return cls(code, offsets, payload)
+
+    def save(self, path: Union[str, Path]):
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        temp_path = path.with_suffix(path.suffix + ".tmp")
+        with open(temp_path, "wb") as f:
+            f.write(self.to_bytes())
+        os.replace(temp_path, path)
+
+    @classmethod
+    def load(cls, path: Union[str, Path]) -> "DialogBank":
+        """Map a saved bank; lines decode straight from the file"""
+        with open(path, "rb") as f:
+            mapped = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        bank = cls.from_bytes(mapped)
+        bank._map = mapped
+        return bank
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+
+    parser = argparse.ArgumentParser(description="Pack dialog lines into a Huffman dialog bank, or read one back")
+    parser.add_argument("input_file", help="Text file (one line per dialog string) or a packed bank")
+    parser.add_argument("--output", "-o", help="Write the packed bank here")
+    parser.add_argument("--line", type=int, action="append", help="Decode this line of a packed bank")
+    args = parser.parse_args()
+
+    raw = Path(args.input_file).read_bytes()
+    if raw.startswith(BANK_MAGIC):
+        bank = DialogBank.load(args.input_file)
+        print(f"📖 {len(bank):,} lines, {len(bank.code.symbols)} symbols")
+        for index in args.line or []:
+            start_time = time.perf_counter()
+            text = bank.decode(index)
+            print(f"   [{index}] ({(time.perf_counter() - start_time) * 1e6:.0f}us) {text}")
+    else:
+        lines = raw.decode("utf-8").splitlines()
+        start_time = time.time()
+        bank = DialogBank.build(lines)
+        packed = bank.to_bytes()
+        elapsed = time.time() - start_time
+        original = sum(len(line.encode("utf-8")) for line in lines)
+        print(f"🗜️ {len(lines):,} lines: {original:,} -> {len(packed):,} bytes "
+              f"({len(packed) / max(original, 1):.2%}) in {elapsed:.2f}s, {len(bank.code.symbols)} symbols")
+        if args.output:
+            bank.save(args.output)
+            print(f"Bank saved to {args.output}")
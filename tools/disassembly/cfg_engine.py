@@ -0,0 +1,539 @@
+#!/usr/bin/env python3
+"""
+Recursive-Descent Control-Flow Engine for the 65816
+Worklist-driven basic-block discovery from the interrupt vectors and labels.inc,
+memoized by (ROM offset, M, X) with processor state propagated to a fixed point
+"""
+
+import json
+import re
+import struct
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, List, Any, Optional, Tuple, Set
+
+# Sibling modules, for callers that only put tools/ on the path
+sys.path.append(str(Path(__file__).parent))
+from decoder65816 import OPCODE_TABLE, CONTROL_FLOW, FLAG_M, FLAG_X, SIZE_TABLES, DecodedInstructions, next_flags, read_operand
+
+# Native-mode vectors that carry code (emulation RESET is the power-on entry)
+ENTRY_VECTORS = [
+    (0xFFFC, "RESET"),
+    (0xFFEA, "NMI"),
+    (0xFFEE, "IRQ"),
+    (0xFFE4, "COP"),
+    (0xFFE6, "BRK"),
+]
+
+# Block terminators whose successors cannot be resolved statically
+INDIRECT_MODES = {"absolute_indirect", "absolute_x_indirect", "absolute_indirect_long"}
+
+BlockKey = Tuple[int, int]  # (ROM offset, M/X flags)
+
+
+@dataclass
+class BasicBlock:
+    """Straight-line run of instructions decoded under one entry M/X state"""
+
+    start: int  # ROM offset of the first instruction
+    bank: int
+    address: int
+    p_flags: int  # M/X state on entry
+    first: int = 0  # Index of the first instruction in ControlFlowGraph.instructions
+    count: int = 0
+    end: int = 0  # ROM offset one past the last instruction
+    exit_flags: int = 0  # M/X state after the last instruction
+    terminator: str = "fallthrough"
+    successors: List[BlockKey] = field(default_factory=list)
+    calls: List[BlockKey] = field(default_factory=list)
+
+    @property
+    def key(self) -> BlockKey:
+        return (self.start, self.p_flags)
+
+    @property
+    def size(self) -> int:
+        return self.end - self.start
+
+
+class ControlFlowGraph:
+    """
+    Basic-block graph over a SNES65816Disassembler's ROM
+    Each (offset, M/X) pair is decoded once into a shared flat instruction array; blocks are split
+    when a later edge lands inside them. A call's continuation waits until its callee's return
+    state is settled, so it is decoded under that state rather than under a guess that would be
+    dropped later; continuations are still re-queued if a return state changes afterwards.
+    """
+
+    def __init__(self, disassembler, default_flags: Optional[int] = None):
+        self.disasm = disassembler
+        self.rom_data = disassembler.rom_data
+        self.rom_size = disassembler.rom_size
+        self.mapping = next(iter(disassembler.bank_map.values()))["type"] if disassembler.bank_map else "LoROM"
+        self.default_flags = disassembler.p_flags if default_flags is None else default_flags
+
+        self.instructions = DecodedInstructions()
+        self.blocks: Dict[BlockKey, BasicBlock] = {}
+        self.entries: Dict[BlockKey, str] = {}
+
+        # (offset, flags) -> owning block key, for every decoded instruction
+        self._owner: Dict[BlockKey, BlockKey] = {}
+        self._worklist: List[BlockKey] = []
+        # callee entry -> call sites (block keys) whose continuation depends on its return state
+        self._call_sites: Dict[BlockKey, Set[BlockKey]] = {}
+        # Call instruction -> (continuation offset, flags at the call, callee) still waiting on the
+        # callee; keyed by instruction rather than block so splits leave it in place
+        self._pending: Dict[BlockKey, Tuple[int, int, BlockKey]] = {}
+
+    # ------------------------------------------------------------------
+    # Address mapping
+
+    def rom_offset_for(self, bank: int, address: int) -> Optional[int]:
+        """ROM offset of bank:address, folding mirrors onto the mapped banks"""
+        offset = self.disasm.snes_to_rom_offset(address, bank)
+        if offset is None and bank not in self.disasm.bank_map:
+            offset = self.disasm.snes_to_rom_offset(address, bank & 0x3F)
+        if offset is None or offset >= self.rom_size:
+            return None
+        return offset
+
+    def snes_address_for(self, rom_offset: int) -> Tuple[int, int]:
+        """Canonical bank:address for a ROM offset"""
+        if self.mapping == "LoROM":
+            return rom_offset // 0x8000, 0x8000 | (rom_offset & 0x7FFF)
+        return rom_offset >> 16, rom_offset & 0xFFFF
+
+    # ------------------------------------------------------------------
+    # Entry points
+
+    def add_entry(self, bank: int, address: int, name: str, p_flags: Optional[int] = None) -> Optional[BlockKey]:
+        """Queue bank:address as a code entry point"""
+        offset = self.rom_offset_for(bank, address)
+        if offset is None:
+            return None
+        key = self._request(offset, self.default_flags if p_flags is None else p_flags)
+        self.entries.setdefault(key, name)
+        return key
+
+    def add_vector_entries(self) -> int:
+        """Queue the bank 0 interrupt vectors (CPU starts with 8-bit registers)"""
+        added = 0
+        for vector_addr, vector_name in ENTRY_VECTORS:
+            vector_offset = self.rom_offset_for(0, vector_addr)
+            if vector_offset is None or vector_offset + 1 >= self.rom_size:
+                continue
+            target = struct.unpack("<H", self.rom_data[vector_offset : vector_offset + 2])[0]
+            # Unused vectors are zero/FFFF; bank 0 below $8000 is RAM and I/O in both mappings
+            if target < 0x8000 or target == 0xFFFF:
+                continue
+            if self.add_entry(0, target, f"{vector_name}_handler", FLAG_M | FLAG_X):
+                added += 1
+        return added
+
+    def add_label_entries(self, labels_path: Path) -> int:
+        """Queue FUNCTION_xxxxxx labels from labels.inc (suffix is the ROM offset)"""
+        labels_path = Path(labels_path)
+        if not labels_path.exists():
+            return 0
+
+        added = 0
+        pattern = re.compile(r"^\.DEFINE\s+(FUNCTION_([0-9A-Fa-f]{6}))\s+\$([0-9A-Fa-f]+)")
+        for line in labels_path.read_text(encoding="utf-8").splitlines():
+            match = pattern.match(line.strip())
+            if not match:
+                continue
+            rom_offset = int(match.group(2), 16)
+            if rom_offset >= self.rom_size:
+                continue
+            key = self._request(rom_offset, self.default_flags)
+            self.entries.setdefault(key, match.group(1))
+            added += 1
+        return added
+
+    # ------------------------------------------------------------------
+    # Worklist
+
+    def _request(self, offset: int, p_flags: int) -> BlockKey:
+        """Block key for (offset, flags), splitting or queueing as needed"""
+        key = (offset, p_flags & (FLAG_M | FLAG_X))
+        if key in self.blocks:
+            return key
+
+        owner = self._owner.get(key)
+        if owner is not None:
+            self._split(owner, offset)
+            return key
+
+        self.blocks[key] = None
+        self._worklist.append(key)
+        return key
+
+    def _split(self, owner_key: BlockKey, offset: int):
+        """Split the block owning the instruction at offset so a new block starts there"""
+        block = self.blocks[owner_key]
+        split_at = next(
+            i for i in range(block.first, block.first + block.count) if self.instructions.offsets[i] == offset
+        )
+        p_flags = self.instructions.p_flags[split_at]
+        bank, address = self.snes_address_for(offset)
+
+        tail = BasicBlock(offset, bank, address, p_flags)
+        tail.first = split_at
+        tail.count = block.first + block.count - split_at
+        tail.end = block.end
+        tail.exit_flags = block.exit_flags
+        tail.terminator = block.terminator
+        tail.successors = block.successors
+        tail.calls = block.calls
+
+        block.count = split_at - block.first
+        block.end = offset
+        block.exit_flags = p_flags
+        block.terminator = "fallthrough"
+        block.successors = [tail.key]
+        block.calls = []
+
+        self.blocks[tail.key] = tail
+        for i in range(tail.first, tail.first + tail.count):
+            self._owner[(self.instructions.offsets[i], self.instructions.p_flags[i])] = tail.key
+        for callee in tail.calls:
+            sites = self._call_sites.get(callee)
+            if sites and owner_key in sites:
+                sites.discard(owner_key)
+                sites.add(tail.key)
+
+    def run(self, max_passes: int = 64) -> "ControlFlowGraph":
+        """Decode queued blocks and propagate call return states until a fixed point"""
+        for _ in range(max_passes):
+            while True:
+                while self._worklist:
+                    key = self._worklist.pop()
+                    if self.blocks.get(key) is None:
+                        self._decode_block(*key)
+                if not self._resume_continuations():
+                    break
+
+            if not self._propagate_return_states():
+                break
+
+        return self
+
+    def _resume_continuations(self) -> bool:
+        """
+        Queue the waiting continuations whose callee return state is now settled; when none is
+        (recursion, or callees waiting on each other), release them all under their best state
+        """
+        if not self._pending:
+            return False
+
+        ready = {}
+        for call, (offset, call_flags, callee) in self._pending.items():
+            states, complete = self._return_states(callee)
+            if complete and len(states) <= 1:
+                ready[call] = states.pop() if states else call_flags
+        if not ready:
+            for call, (offset, call_flags, callee) in self._pending.items():
+                states, _ = self._return_states(callee)
+                ready[call] = states.pop() if len(states) == 1 else call_flags
+
+        for call, flags in ready.items():
+            offset = self._pending.pop(call)[0]
+            successor = self._request(offset, flags)
+            # Looked up after the request, which may have split the calling block
+            self.blocks[self._owner[call]].successors.append(successor)
+        return True
+
+    def _decode_block(self, start: int, p_flags: int):
+        bank, address = self.snes_address_for(start)
+        block = BasicBlock(start, bank, address, p_flags)
+        block.first = len(self.instructions)
+        self.blocks[block.key] = block
+
+        data = self.rom_data
+        bank_end = (start | 0x7FFF) + 1 if self.mapping == "LoROM" else (start | 0xFFFF) + 1
+        bank_end = min(bank_end, self.rom_size)
+        offset = start
+        flag_stack: List[int] = []
+        carry: Optional[int] = None
+        # Edges are requested once the block is complete, so a branch back into it splits cleanly
+        successors: List[BlockKey] = []
+        calls: List[BlockKey] = []
+        deferred: Optional[Tuple[int, int, BlockKey]] = None
+
+        while True:
+            if offset >= bank_end:
+                block.terminator = "bank_end"
+                break
+
+            opcode = data[offset]
+            size = SIZE_TABLES[p_flags][opcode]
+            if offset + size > bank_end:
+                block.terminator = "bank_end"
+                break
+
+            self.instructions.append(offset, opcode, size, p_flags)
+            self._owner[(offset, p_flags)] = block.key
+            block.count += 1
+
+            info = OPCODE_TABLE[opcode]
+            operand = read_operand(data, offset, size)
+            instr_address = (address + (offset - start)) & 0xFFFF
+            next_offset = offset + size
+
+            # Processor state tracking within the block
+            if opcode in (0xC2, 0xE2):
+                p_flags = next_flags(opcode, operand, p_flags)
+            elif opcode == 0x08:  # PHP
+                flag_stack.append(p_flags)
+            elif opcode == 0x28:  # PLP
+                if flag_stack:
+                    p_flags = flag_stack.pop()
+            elif opcode == 0x18:  # CLC
+                carry = 0
+            elif opcode == 0x38:  # SEC
+                carry = 1
+            elif opcode == 0xFB and carry == 1:  # SEC; XCE enters emulation mode
+                p_flags = FLAG_M | FLAG_X
+
+            kind = CONTROL_FLOW.get(info.mnemonic)
+            offset = next_offset
+
+            if kind is None:
+                # Falling into an existing block ends this one
+                if (offset, p_flags) in self.blocks or (offset, p_flags) in self._owner:
+                    block.exit_flags = p_flags
+                    successors.append((offset, p_flags))
+                    break
+                continue
+
+            block.exit_flags = p_flags
+            block.terminator = kind
+
+            if kind in ("return", "halt", "interrupt"):
+                break
+
+            if info.mode in INDIRECT_MODES:
+                block.terminator = "indirect_call" if kind == "subroutine_call" else "indirect_jump"
+                if kind == "subroutine_call":
+                    successors.append((offset, p_flags))
+                break
+
+            target = self._direct_target(info, operand, bank, instr_address)
+
+            if kind == "conditional_branch":
+                if target is not None:
+                    successors.append((target, p_flags))
+                successors.append((offset, p_flags))
+            elif kind in ("unconditional_branch", "unconditional_jump"):
+                if target is not None:
+                    successors.append((target, p_flags))
+            elif kind == "subroutine_call":
+                if target is None:
+                    successors.append((offset, p_flags))
+                else:
+                    calls.append((target, p_flags))
+                    states, complete = self._return_states((target, p_flags))
+                    if complete and len(states) == 1:
+                        successors.append((offset, states.pop()))
+                    else:
+                        deferred = (offset, p_flags, (target, p_flags))
+            break
+
+        block.end = offset if block.count else start
+        if block.terminator in ("fallthrough", "bank_end"):
+            block.exit_flags = p_flags
+
+        if not block.count:
+            return
+
+        # Requests may split this block; the edges belong to whichever part holds the last instruction
+        last = self.block_instructions(block)[-1]
+        call_keys = [self._request(*callee) for callee in calls]
+        successor_keys = [self._request(*successor) for successor in successors]
+        tail = self.blocks[self._owner[(self.instructions.offsets[last], self.instructions.p_flags[last])]]
+        tail.calls = call_keys
+        tail.successors = successor_keys
+        for callee in call_keys:
+            self._call_sites.setdefault(callee, set()).add(tail.key)
+        if deferred is not None:
+            self._pending[(self.instructions.offsets[last], self.instructions.p_flags[last])] = (
+                deferred[0], deferred[1], call_keys[0]
+            )
+
+    def _direct_target(self, info, operand: int, bank: int, address: int) -> Optional[int]:
+        """ROM offset of a direct branch/jump/call target"""
+        if info.mode == "relative":
+            displacement = operand - 0x100 if operand >= 0x80 else operand
+            return self.rom_offset_for(bank, (address + 2 + displacement) & 0xFFFF)
+        if info.mode == "relative_long":
+            displacement = operand - 0x10000 if operand >= 0x8000 else operand
+            return self.rom_offset_for(bank, (address + 3 + displacement) & 0xFFFF)
+        if info.mode == "absolute":
+            return self.rom_offset_for(bank, operand)
+        if info.mode == "long":
+            return self.rom_offset_for(operand >> 16, operand & 0xFFFF)
+        return None
+
+    # ------------------------------------------------------------------
+    # Fixed point over subroutine return states
+
+    def _return_states(self, entry: BlockKey) -> Tuple[Set[int], bool]:
+        """
+        M/X states at the returns reachable from entry, and whether that set is final (no block
+        on the way is still undecoded or waiting on a continuation)
+        """
+        states: Set[int] = set()
+        seen: Set[BlockKey] = set()
+        stack = [entry]
+        complete = True
+
+        while stack:
+            key = stack.pop()
+            if key in seen:
+                continue
+            seen.add(key)
+            block = self.blocks.get(key)
+            if block is None:
+                complete = False
+                continue
+            if block.terminator == "subroutine_call" and not block.successors:
+                complete = False  # Continuation still pending
+            if block.terminator == "return":
+                states.add(block.exit_flags)
+            else:
+                stack.extend(block.successors)
+
+        return states, complete
+
+    def _return_state(self, entry: BlockKey) -> Optional[int]:
+        """Single M/X state at every return reachable from entry, or None if unknown/mixed"""
+        states, _ = self._return_states(entry)
+        return states.pop() if len(states) == 1 else None
+
+    def _propagate_return_states(self) -> bool:
+        """Re-route call continuations whose callee return state changed; True if anything did"""
+        changed = False
+        for callee, sites in list(self._call_sites.items()):
+            return_flags = self._return_state(callee)
+            if return_flags is None:
+                continue
+            for site_key in list(sites):
+                block = self.blocks.get(site_key)
+                if block is None or not block.successors or block.terminator != "subroutine_call":
+                    continue
+                continuation = block.successors[-1]
+                if continuation[1] == return_flags:
+                    continue
+                block.successors[-1] = self._request(continuation[0], return_flags)
+                changed = True
+        return changed or bool(self._worklist)
+
+    # ------------------------------------------------------------------
+    # Output
+
+    def reachable(self) -> Set[BlockKey]:
+        """Blocks reachable from the entries (continuations superseded by a return state drop out)"""
+        seen: Set[BlockKey] = set()
+        stack = list(self.entries)
+        while stack:
+            key = stack.pop()
+            if key in seen or self.blocks.get(key) is None:
+                continue
+            seen.add(key)
+            block = self.blocks[key]
+            stack.extend(block.successors)
+            stack.extend(block.calls)
+        return seen
+
+    def sorted_blocks(self) -> List[BasicBlock]:
+        return sorted((self.blocks[key] for key in self.reachable()), key=lambda b: (b.start, b.p_flags))
+
+    def block_instructions(self, block: BasicBlock) -> range:
+        """Indices into self.instructions for block"""
+        return range(block.first, block.first + block.count)
+
+    def coverage(self) -> int:
+        """Distinct ROM bytes covered by decoded instructions"""
+        covered = bytearray(self.rom_size)
+        for block in self.sorted_blocks():
+            covered[block.start : block.end] = b"\x01" * (block.end - block.start)
+        return sum(covered)
+
+    def block_table(self) -> List[Dict[str, Any]]:
+        """Basic-block records for the assembly emitters"""
+        table = []
+        for block in self.sorted_blocks():
+            table.append(
+                {
+                    "start": block.start,
+                    "end": block.end,
+                    "bank": block.bank,
+                    "address": block.address,
+                    "m": bool(block.p_flags & FLAG_M),
+                    "x": bool(block.p_flags & FLAG_X),
+                    "exit_m": bool(block.exit_flags & FLAG_M),
+                    "exit_x": bool(block.exit_flags & FLAG_X),
+                    "instructions": [
+                        [self.instructions.offsets[i], self.instructions.sizes[i]] for i in self.block_instructions(block)
+                    ],
+                    "terminator": block.terminator,
+                    "successors": [list(key) for key in block.successors],
+                    "calls": [list(key) for key in block.calls],
+                    "label": self.entries.get(block.key),
+                }
+            )
+        return table
+
+    def save_block_table(self, output_path: Path):
+        output_path = Path(output_path)
+        output_path.parent.mkdir(parents=True, exist_ok=True)
+        report = {
+            "mapping": self.mapping,
+            "blocks": len(self.reachable()),
+            "instructions": len(self.instructions),
+            "coverage_bytes": self.coverage(),
+            "entries": [{"offset": key[0], "p_flags": key[1], "name": name} for key, name in sorted(self.entries.items())],
+            "block_table": self.block_table(),
+        }
+        with open(output_path, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2)
+
+
+def build_control_flow_graph(disassembler, labels_path: Optional[Path] = None) -> ControlFlowGraph:
+    """CFG from the interrupt vectors plus any labels.inc entries"""
+    graph = ControlFlowGraph(disassembler)
+    graph.add_vector_entries()
+    if labels_path:
+        graph.add_label_entries(labels_path)
+    return graph.run()
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+
+    from snes_disasm import create_snes_disassembler
+
+    project_root = Path(__file__).parent.parent.parent
+
+    parser = argparse.ArgumentParser(description="65816 control-flow graph builder")
+    parser.add_argument("rom_file", help="Path to ROM file")
+    parser.add_argument("--labels", default=str(project_root / "src" / "labels.inc"), help="labels.inc to seed entries")
+    parser.add_argument("--output", "-o", default=str(project_root / "analysis" / "cfg_blocks.json"), help="Block table output")
+    args = parser.parse_args()
+
+    disasm = create_snes_disassembler(args.rom_file)
+
+    print(f"🎮 CFG Engine - {args.rom_file}")
+    start_time = time.time()
+    graph = build_control_flow_graph(disasm, Path(args.labels))
+    elapsed = time.time() - start_time
+
+    print(f"📌 Entries: {len(graph.entries)}")
+    print(f"🧱 Basic blocks: {len(graph.sorted_blocks()):,}")
+    print(f"📊 Instructions decoded: {len(graph.instructions):,} ({graph.coverage():,} bytes)")
+    print(f"⏱️ {elapsed:.2f}s")
+
+    graph.save_block_table(Path(args.output))
+    print(f"💾 Block table saved to: {args.output}")
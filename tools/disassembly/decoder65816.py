@@ -0,0 +1,597 @@
+#!/usr/bin/env python3
+"""
+Shared Table-Driven 65816 Decoder
+Single 256-entry opcode table used by every disassembler in the project,
+with M/X flag-dependent operand widths and flat-array linear decoding
+"""
+
+import sys
+from array import array
+from pathlib import Path
+from typing import Dict, List, Any, Optional, NamedTuple
+
+sys.path.append(str(Path(__file__).parent.parent / "analysis"))
+import stage_trace
+
+
+# Processor status bits that change immediate operand widths (set = 8-bit)
+FLAG_X = 0x10
+FLAG_M = 0x20
+
+
+class OpcodeInfo(NamedTuple):
+    """Static decode information for one opcode"""
+
+    mnemonic: str
+    mode: str  # Addressing mode name (same vocabulary as the analysis disassemblers)
+    size: int  # Instruction size with 8-bit registers
+    cycles: int  # Base cycle count (8-bit registers, no page/bank penalties)
+    width: str = ""  # "m" or "x": one extra operand byte when that flag is clear (16-bit)
+
+
+# Instruction size for each addressing mode with 8-bit registers
+MODE_SIZES = {
+    "implied": 1,
+    "accumulator": 1,
+    "immediate": 2,
+    "absolute": 3,
+    "absolute_x": 3,
+    "absolute_y": 3,
+    "absolute_indirect": 3,
+    "absolute_x_indirect": 3,
+    "absolute_indirect_long": 3,
+    "long": 4,
+    "long_x": 4,
+    "zeropage": 2,
+    "zeropage_x": 2,
+    "zeropage_y": 2,
+    "zeropage_indirect": 2,
+    "zeropage_x_indirect": 2,
+    "zeropage_indirect_y": 2,
+    "zeropage_indirect_long": 2,
+    "zeropage_indirect_long_y": 2,
+    "stack_relative": 2,
+    "stack_relative_indirect_y": 2,
+    "relative": 2,
+    "relative_long": 3,
+    "block_move": 3,
+}
+
+# Column layout shared by the eight ALU instructions (ORA AND EOR ADC STA LDA CMP SBC)
+_ALU_MODES = {
+    0x01: ("zeropage_x_indirect", 6),
+    0x03: ("stack_relative", 4),
+    0x05: ("zeropage", 3),
+    0x07: ("zeropage_indirect_long", 6),
+    0x09: ("immediate", 2),
+    0x0D: ("absolute", 4),
+    0x0F: ("long", 5),
+    0x11: ("zeropage_indirect_y", 5),
+    0x12: ("zeropage_indirect", 5),
+    0x13: ("stack_relative_indirect_y", 7),
+    0x15: ("zeropage_x", 4),
+    0x17: ("zeropage_indirect_long_y", 6),
+    0x19: ("absolute_y", 4),
+    0x1D: ("absolute_x", 4),
+    0x1F: ("long_x", 5),
+}
+
+_ALU_MNEMONICS = {0x00: "ORA", 0x20: "AND", 0x40: "EOR", 0x60: "ADC", 0x80: "STA", 0xA0: "LDA", 0xC0: "CMP", 0xE0: "SBC"}
+
+# Everything outside the ALU columns: opcode -> (mnemonic, mode, cycles[, width])
+_OTHER_OPCODES = {
+    0x00: ("BRK", "immediate", 7),
+    0x02: ("COP", "immediate", 7),
+    0x04: ("TSB", "zeropage", 5),
+    0x06: ("ASL", "zeropage", 5),
+    0x08: ("PHP", "implied", 3),
+    0x0A: ("ASL", "accumulator", 2),
+    0x0B: ("PHD", "implied", 4),
+    0x0C: ("TSB", "absolute", 6),
+    0x0E: ("ASL", "absolute", 6),
+    0x10: ("BPL", "relative", 2),
+    0x14: ("TRB", "zeropage", 5),
+    0x16: ("ASL", "zeropage_x", 6),
+    0x18: ("CLC", "implied", 2),
+    0x1A: ("INC", "accumulator", 2),
+    0x1B: ("TCS", "implied", 2),
+    0x1C: ("TRB", "absolute", 6),
+    0x1E: ("ASL", "absolute_x", 7),
+    0x20: ("JSR", "absolute", 6),
+    0x22: ("JSL", "long", 8),
+    0x24: ("BIT", "zeropage", 3),
+    0x26: ("ROL", "zeropage", 5),
+    0x28: ("PLP", "implied", 4),
+    0x2A: ("ROL", "accumulator", 2),
+    0x2B: ("PLD", "implied", 5),
+    0x2C: ("BIT", "absolute", 4),
+    0x2E: ("ROL", "absolute", 6),
+    0x30: ("BMI", "relative", 2),
+    0x34: ("BIT", "zeropage_x", 4),
+    0x36: ("ROL", "zeropage_x", 6),
+    0x38: ("SEC", "implied", 2),
+    0x3A: ("DEC", "accumulator", 2),
+    0x3B: ("TSC", "implied", 2),
+    0x3C: ("BIT", "absolute_x", 4),
+    0x3E: ("ROL", "absolute_x", 7),
+    0x40: ("RTI", "implied", 6),
+    0x42: ("WDM", "immediate", 2),
+    0x44: ("MVP", "block_move", 7),
+    0x46: ("LSR", "zeropage", 5),
+    0x48: ("PHA", "implied", 3),
+    0x4A: ("LSR", "accumulator", 2),
+    0x4B: ("PHK", "implied", 3),
+    0x4C: ("JMP", "absolute", 3),
+    0x4E: ("LSR", "absolute", 6),
+    0x50: ("BVC", "relative", 2),
+    0x54: ("MVN", "block_move", 7),
+    0x56: ("LSR", "zeropage_x", 6),
+    0x58: ("CLI", "implied", 2),
+    0x5A: ("PHY", "implied", 3),
+    0x5B: ("TCD", "implied", 2),
+    0x5C: ("JML", "long", 4),
+    0x5E: ("LSR", "absolute_x", 7),
+    0x60: ("RTS", "implied", 6),
+    0x62: ("PER", "relative_long", 6),
+    0x64: ("STZ", "zeropage", 3),
+    0x66: ("ROR", "zeropage", 5),
+    0x68: ("PLA", "implied", 4),
+    0x6A: ("ROR", "accumulator", 2),
+    0x6B: ("RTL", "implied", 6),
+    0x6C: ("JMP", "absolute_indirect", 5),
+    0x6E: ("ROR", "absolute", 6),
+    0x70: ("BVS", "relative", 2),
+    0x74: ("STZ", "zeropage_x", 4),
+    0x76: ("ROR", "zeropage_x", 6),
+    0x78: ("SEI", "implied", 2),
+    0x7A: ("PLY", "implied", 4),
+    0x7B: ("TDC", "implied", 2),
+    0x7C: ("JMP", "absolute_x_indirect", 6),
+    0x7E: ("ROR", "absolute_x", 7),
+    0x80: ("BRA", "relative", 3),
+    0x82: ("BRL", "relative_long", 4),
+    0x84: ("STY", "zeropage", 3),
+    0x86: ("STX", "zeropage", 3),
+    0x88: ("DEY", "implied", 2),
+    0x89: ("BIT", "immediate", 2, "m"),
+    0x8A: ("TXA", "implied", 2),
+    0x8B: ("PHB", "implied", 3),
+    0x8C: ("STY", "absolute", 4),
+    0x8E: ("STX", "absolute", 4),
+    0x90: ("BCC", "relative", 2),
+    0x94: ("STY", "zeropage_x", 4),
+    0x96: ("STX", "zeropage_y", 4),
+    0x98: ("TYA", "implied", 2),
+    0x9A: ("TXS", "implied", 2),
+    0x9B: ("TXY", "implied", 2),
+    0x9C: ("STZ", "absolute", 4),
+    0x9E: ("STZ", "absolute_x", 5),
+    0xA0: ("LDY", "immediate", 2, "x"),
+    0xA2: ("LDX", "immediate", 2, "x"),
+    0xA4: ("LDY", "zeropage", 3),
+    0xA6: ("LDX", "zeropage", 3),
+    0xA8: ("TAY", "implied", 2),
+    0xAA: ("TAX", "implied", 2),
+    0xAB: ("PLB", "implied", 4),
+    0xAC: ("LDY", "absolute", 4),
+    0xAE: ("LDX", "absolute", 4),
+    0xB0: ("BCS", "relative", 2),
+    0xB4: ("LDY", "zeropage_x", 4),
+    0xB6: ("LDX", "zeropage_y", 4),
+    0xB8: ("CLV", "implied", 2),
+    0xBA: ("TSX", "implied", 2),
+    0xBB: ("TYX", "implied", 2),
+    0xBC: ("LDY", "absolute_x", 4),
+    0xBE: ("LDX", "absolute_y", 4),
+    0xC0: ("CPY", "immediate", 2, "x"),
+    0xC2: ("REP", "immediate", 3),
+    0xC4: ("CPY", "zeropage", 3),
+    0xC6: ("DEC", "zeropage", 5),
+    0xC8: ("INY", "implied", 2),
+    0xCA: ("DEX", "implied", 2),
+    0xCB: ("WAI", "implied", 3),
+    0xCC: ("CPY", "absolute", 4),
+    0xCE: ("DEC", "absolute", 6),
+    0xD0: ("BNE", "relative", 2),
+    0xD4: ("PEI", "zeropage_indirect", 6),
+    0xD6: ("DEC", "zeropage_x", 6),
+    0xD8: ("CLD", "implied", 2),
+    0xDA: ("PHX", "implied", 3),
+    0xDB: ("STP", "implied", 3),
+    0xDC: ("JML", "absolute_indirect_long", 6),
+    0xDE: ("DEC", "absolute_x", 7),
+    0xE0: ("CPX", "immediate", 2, "x"),
+    0xE2: ("SEP", "immediate", 3),
+    0xE4: ("CPX", "zeropage", 3),
+    0xE6: ("INC", "zeropage", 5),
+    0xE8: ("INX", "implied", 2),
+    0xEA: ("NOP", "implied", 2),
+    0xEB: ("XBA", "implied", 3),
+    0xEC: ("CPX", "absolute", 4),
+    0xEE: ("INC", "absolute", 6),
+    0xF0: ("BEQ", "relative", 2),
+    0xF4: ("PEA", "absolute", 5),
+    0xF6: ("INC", "zeropage_x", 6),
+    0xF8: ("SED", "implied", 2),
+    0xFA: ("PLX", "implied", 4),
+    0xFB: ("XCE", "implied", 2),
+    0xFC: ("JSR", "absolute_x_indirect", 8),
+    0xFE: ("INC", "absolute_x", 7),
+}
+
+# Short descriptions used when a disassembler has no curated text of its own
+MNEMONIC_DESCRIPTIONS = {
+    "ADC": "Add with carry",
+    "AND": "Logical AND",
+    "ASL": "Arithmetic shift left",
+    "BCC": "Branch if carry clear",
+    "BCS": "Branch if carry set",
+    "BEQ": "Branch if equal",
+    "BIT": "Test bits",
+    "BMI": "Branch if minus",
+    "BNE": "Branch if not equal",
+    "BPL": "Branch if plus",
+    "BRA": "Branch always",
+    "BRK": "Break",
+    "BRL": "Branch always long",
+    "BVC": "Branch if overflow clear",
+    "BVS": "Branch if overflow set",
+    "CLC": "Clear carry flag",
+    "CLD": "Clear decimal mode",
+    "CLI": "Clear interrupt disable",
+    "CLV": "Clear overflow flag",
+    "CMP": "Compare accumulator",
+    "COP": "Coprocessor",
+    "CPX": "Compare X register",
+    "CPY": "Compare Y register",
+    "DEC": "Decrement",
+    "DEX": "Decrement X register",
+    "DEY": "Decrement Y register",
+    "EOR": "Exclusive OR",
+    "INC": "Increment",
+    "INX": "Increment X register",
+    "INY": "Increment Y register",
+    "JML": "Jump long",
+    "JMP": "Jump",
+    "JSL": "Jump to subroutine long",
+    "JSR": "Jump to subroutine",
+    "LDA": "Load accumulator",
+    "LDX": "Load X register",
+    "LDY": "Load Y register",
+    "LSR": "Logical shift right",
+    "MVN": "Block move negative",
+    "MVP": "Block move positive",
+    "NOP": "No operation",
+    "ORA": "Logical OR",
+    "PEA": "Push effective absolute address",
+    "PEI": "Push effective indirect address",
+    "PER": "Push effective relative address",
+    "PHA": "Push accumulator",
+    "PHB": "Push data bank",
+    "PHD": "Push direct page",
+    "PHK": "Push program bank",
+    "PHP": "Push processor status",
+    "PHX": "Push X register",
+    "PHY": "Push Y register",
+    "PLA": "Pull accumulator",
+    "PLB": "Pull data bank",
+    "PLD": "Pull direct page",
+    "PLP": "Pull processor status",
+    "PLX": "Pull X register",
+    "PLY": "Pull Y register",
+    "REP": "Reset processor status bits",
+    "ROL": "Rotate left",
+    "ROR": "Rotate right",
+    "RTI": "Return from interrupt",
+    "RTL": "Return from subroutine long",
+    "RTS": "Return from subroutine",
+    "SBC": "Subtract with carry",
+    "SEC": "Set carry flag",
+    "SED": "Set decimal mode",
+    "SEI": "Set interrupt disable",
+    "SEP": "Set processor status bits",
+    "STA": "Store accumulator",
+    "STP": "Stop processor",
+    "STX": "Store X register",
+    "STY": "Store Y register",
+    "STZ": "Store zero",
+    "TAX": "Transfer A to X",
+    "TAY": "Transfer A to Y",
+    "TCD": "Transfer A to direct page",
+    "TCS": "Transfer A to stack",
+    "TDC": "Transfer direct page to A",
+    "TRB": "Test and reset bits",
+    "TSB": "Test and set bits",
+    "TSC": "Transfer stack to A",
+    "TSX": "Transfer stack to X",
+    "TXA": "Transfer X to A",
+    "TXS": "Transfer X to stack",
+    "TXY": "Transfer X to Y",
+    "TYA": "Transfer Y to A",
+    "TYX": "Transfer Y to X",
+    "WAI": "Wait for interrupt",
+    "WDM": "Reserved",
+    "XBA": "Exchange B and A",
+    "XCE": "Exchange carry and emulation",
+}
+
+# Control-flow class per mnemonic (anything not listed falls through to the next instruction)
+CONTROL_FLOW = {
+    "JSR": "subroutine_call",
+    "JSL": "subroutine_call",
+    "RTS": "return",
+    "RTL": "return",
+    "RTI": "return",
+    "BRA": "unconditional_branch",
+    "BRL": "unconditional_branch",
+    "JMP": "unconditional_jump",
+    "JML": "unconditional_jump",
+    "BPL": "conditional_branch",
+    "BMI": "conditional_branch",
+    "BVC": "conditional_branch",
+    "BVS": "conditional_branch",
+    "BCC": "conditional_branch",
+    "BCS": "conditional_branch",
+    "BNE": "conditional_branch",
+    "BEQ": "conditional_branch",
+    "BRK": "interrupt",
+    "COP": "interrupt",
+    "STP": "halt",
+}
+
+# Opcodes that dominate compiled 65816 code; used by content classifiers as a code-density
+# signal now that every byte decodes to some instruction
+COMMON_CODE_MNEMONICS = frozenset(
+    [
+        "LDA", "STA", "LDX", "STX", "LDY", "STY", "STZ", "JSR", "JSL", "RTS", "RTL", "JMP", "JML",
+        "BRA", "BEQ", "BNE", "BCC", "BCS", "BPL", "BMI", "REP", "SEP", "PHA", "PLA", "PHP", "PLP",
+        "PHB", "PLB", "PHX", "PLX", "PHY", "PLY", "CMP", "CPX", "CPY", "INX", "INY", "DEX", "DEY",
+        "CLC", "SEC", "ADC", "SBC", "AND", "ORA", "TAX", "TAY", "TXA", "TYA", "ASL", "LSR",
+    ]
+)
+
+
+def _build_opcode_table() -> tuple:
+    table: List[Optional[OpcodeInfo]] = [None] * 256
+
+    for row, mnemonic in _ALU_MNEMONICS.items():
+        for column, (mode, cycles) in _ALU_MODES.items():
+            opcode = row + column
+            # STA has no immediate form; $89 is BIT #imm
+            if opcode == 0x89:
+                continue
+            width = "m" if mode == "immediate" else ""
+            table[opcode] = OpcodeInfo(mnemonic, mode, MODE_SIZES[mode], cycles, width)
+
+    for opcode, entry in _OTHER_OPCODES.items():
+        mnemonic, mode, cycles = entry[:3]
+        width = entry[3] if len(entry) > 3 else ""
+        table[opcode] = OpcodeInfo(mnemonic, mode, MODE_SIZES[mode], cycles, width)
+
+    missing = [f"${opcode:02X}" for opcode, info in enumerate(table) if info is None]
+    assert not missing, f"Opcode table incomplete: {missing}"
+    return tuple(table)
+
+
+OPCODE_TABLE = _build_opcode_table()
+
+COMMON_CODE_OPCODES = frozenset(
+    opcode for opcode, info in enumerate(OPCODE_TABLE) if info.mnemonic in COMMON_CODE_MNEMONICS
+)
+
+
+def _build_size_tables() -> Dict[int, bytes]:
+    """256-entry size table for each of the four M/X states"""
+    tables = {}
+    for p_flags in (0, FLAG_X, FLAG_M, FLAG_M | FLAG_X):
+        sizes = bytearray(256)
+        for opcode, info in enumerate(OPCODE_TABLE):
+            size = info.size
+            if info.width == "m" and not p_flags & FLAG_M:
+                size += 1
+            elif info.width == "x" and not p_flags & FLAG_X:
+                size += 1
+            sizes[opcode] = size
+        tables[p_flags] = bytes(sizes)
+    return tables
+
+
+SIZE_TABLES = _build_size_tables()
+
+
+def instruction_size(opcode: int, p_flags: int = FLAG_M | FLAG_X) -> int:
+    """Instruction size for opcode under the given M/X state"""
+    return SIZE_TABLES[p_flags & (FLAG_M | FLAG_X)][opcode]
+
+
+def next_flags(opcode: int, operand: int, p_flags: int) -> int:
+    """M/X state after executing opcode (REP clears bits, SEP sets them)"""
+    if opcode == 0xC2:
+        return p_flags & ~operand & (FLAG_M | FLAG_X)
+    if opcode == 0xE2:
+        return (p_flags | operand) & (FLAG_M | FLAG_X)
+    return p_flags
+
+
+def read_operand(data: bytes, offset: int, size: int) -> int:
+    """Little-endian operand value of the instruction at offset"""
+    if size == 2:
+        return data[offset + 1]
+    if size == 3:
+        return data[offset + 1] | (data[offset + 2] << 8)
+    if size == 4:
+        return data[offset + 1] | (data[offset + 2] << 8) | (data[offset + 3] << 16)
+    return 0
+
+
+class DecodedInstructions:
+    """
+    Flat structure-of-arrays instruction stream
+    Entry i is the instruction at offsets[i] with opcodes[i], sizes[i] and the M/X state
+    (p_flags[i]) it was decoded under; operands are read back from the source data on demand.
+    """
+
+    def __init__(self):
+        self.offsets = array("I")
+        self.opcodes = bytearray()
+        self.sizes = bytearray()
+        self.p_flags = bytearray()
+
+    def __len__(self) -> int:
+        return len(self.offsets)
+
+    def append(self, offset: int, opcode: int, size: int, p_flags: int):
+        self.offsets.append(offset)
+        self.opcodes.append(opcode)
+        self.sizes.append(size)
+        self.p_flags.append(p_flags)
+
+    def info(self, index: int) -> OpcodeInfo:
+        return OPCODE_TABLE[self.opcodes[index]]
+
+    def operand(self, index: int, data: bytes) -> int:
+        return read_operand(data, self.offsets[index], self.sizes[index])
+
+
+def decode_linear(
+    data: bytes,
+    start: int = 0,
+    end: Optional[int] = None,
+    p_flags: int = FLAG_M | FLAG_X,
+    track_flags: bool = True,
+) -> DecodedInstructions:
+    """
+    Linear sweep from start to end into a flat instruction array
+    With track_flags, REP/SEP update the M/X state for the instructions that follow.
+    A trailing instruction that would run past end is not emitted.
+    """
+    end = len(data) if end is None else min(end, len(data))
+    decoded = DecodedInstructions()
+    append_offset = decoded.offsets.append
+    append_opcode = decoded.opcodes.append
+    append_size = decoded.sizes.append
+    append_flags = decoded.p_flags.append
+
+    p_flags &= FLAG_M | FLAG_X
+    sizes = SIZE_TABLES[p_flags]
+    pos = start
+
+    while pos < end:
+        opcode = data[pos]
+        size = sizes[opcode]
+        if pos + size > end:
+            break
+
+        append_offset(pos)
+        append_opcode(opcode)
+        append_size(size)
+        append_flags(p_flags)
+
+        if track_flags and (opcode == 0xC2 or opcode == 0xE2):
+            p_flags = next_flags(opcode, data[pos + 1], p_flags)
+            sizes = SIZE_TABLES[p_flags]
+
+        pos += size
+
+    stage_trace.count("disasm.instructions_decoded", len(decoded.offsets))
+    return decoded
+
+
+def branch_target(opcode: int, address: int, operand: int) -> Optional[int]:
+    """Target of a relative branch at address (16-bit within the bank), or None"""
+    mode = OPCODE_TABLE[opcode].mode
+    if mode == "relative":
+        displacement = operand - 0x100 if operand >= 0x80 else operand
+        return (address + 2 + displacement) & 0xFFFF
+    if mode == "relative_long":
+        displacement = operand - 0x10000 if operand >= 0x8000 else operand
+        return (address + 3 + displacement) & 0xFFFF
+    return None
+
+
+def format_operand(opcode: int, operand: int, size: int, address: int = 0) -> str:
+    """Operand text in standard 65816 syntax (relative targets resolved against address)"""
+    mode = OPCODE_TABLE[opcode].mode
+
+    if mode == "implied":
+        return ""
+    if mode == "accumulator":
+        return "A"
+    if mode == "immediate":
+        return f"#${operand:04X}" if size == 3 else f"#${operand:02X}"
+    if mode in ("relative", "relative_long"):
+        return f"${branch_target(opcode, address, operand):04X}"
+    if mode == "block_move":
+        # Operand bytes are destination bank then source bank; syntax is source,destination
+        return f"${operand >> 8:02X},${operand & 0xFF:02X}"
+
+    templates = {
+        "absolute": "${:04X}",
+        "absolute_x": "${:04X},X",
+        "absolute_y": "${:04X},Y",
+        "absolute_indirect": "(${:04X})",
+        "absolute_x_indirect": "(${:04X},X)",
+        "absolute_indirect_long": "[${:04X}]",
+        "long": "${:06X}",
+        "long_x": "${:06X},X",
+        "zeropage": "${:02X}",
+        "zeropage_x": "${:02X},X",
+        "zeropage_y": "${:02X},Y",
+        "zeropage_indirect": "(${:02X})",
+        "zeropage_x_indirect": "(${:02X},X)",
+        "zeropage_indirect_y": "(${:02X}),Y",
+        "zeropage_indirect_long": "[${:02X}]",
+        "zeropage_indirect_long_y": "[${:02X}],Y",
+        "stack_relative": "${:02X},S",
+        "stack_relative_indirect_y": "(${:02X},S),Y",
+    }
+    return templates[mode].format(operand)
+
+
+def opcode_definitions() -> Dict[int, Dict[str, Any]]:
+    """
+    All 256 opcodes in the dict schema the analysis disassemblers use
+    ('mnemonic', 'addressing', 'size', 'cycles', 'flags_affected', 'description', 'analysis');
+    callers layer their curated descriptions and analysis metadata on top.
+    """
+    definitions = {}
+    for opcode, info in enumerate(OPCODE_TABLE):
+        mode_text = info.mode.replace("zeropage", "direct page").replace("_", " ")
+        analysis = {"type": "control" if info.mnemonic in CONTROL_FLOW else "generic", "modifies": [], "reads": []}
+        if info.mnemonic in CONTROL_FLOW:
+            analysis["control_flow"] = CONTROL_FLOW[info.mnemonic]
+        definitions[opcode] = {
+            "mnemonic": info.mnemonic,
+            "addressing": info.mode,
+            "size": info.size,
+            "cycles": info.cycles,
+            "width": info.width,
+            "flags_affected": "",
+            "description": f"{MNEMONIC_DESCRIPTIONS[info.mnemonic]} ({mode_text})",
+            "analysis": analysis,
+        }
+    return definitions
+
+
+if __name__ == "__main__":
+    import argparse
+    import time
+    from pathlib import Path
+
+    parser = argparse.ArgumentParser(description="Shared 65816 decoder - linear sweep benchmark")
+    parser.add_argument("rom_file", help="Path to ROM file")
+    parser.add_argument("--m16", action="store_true", help="Start with a 16-bit accumulator")
+    parser.add_argument("--x16", action="store_true", help="Start with 16-bit index registers")
+    args = parser.parse_args()
+
+    rom_data = Path(args.rom_file).read_bytes()
+    if len(rom_data) % 1024 == 512:
+        rom_data = rom_data[512:]
+
+    start_flags = (0 if args.m16 else FLAG_M) | (0 if args.x16 else FLAG_X)
+
+    start_time = time.time()
+    decoded = decode_linear(rom_data, p_flags=start_flags)
+    elapsed = time.time() - start_time
+
+    print(f"Decoded {len(decoded):,} instructions from {len(rom_data):,} bytes in {elapsed * 1000:.1f} ms")
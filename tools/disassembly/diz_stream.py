@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+"""
+Streaming DiztinGUIsh (.diz) Loader
+Reads a .diz project in fixed-size chunks (gunzipping as it goes) and keeps only compact
+results: the per-byte DataType marks as one uint8 array the size of the ROM, and every label
+name and comment interned into a single string arena. diz_parser builds Python objects per
+label and region instead; use this loader when only the marks and labels are needed.
+"""
+
+import codecs
+import json
+import re
+import sys
+import time
+import zlib
+from array import array
+from bisect import bisect_left
+from pathlib import Path
+from typing import Dict, Iterator, Optional, Tuple, Union
+
+from diz_parser import DataType
+
+# Compressed bytes read per step
+CHUNK_SIZE = 0x10000
+
+_NON_SPACE = re.compile(r"\S")
+_DECODER = json.JSONDecoder()
+
+# Separators stripped from an array segment, and the digit -> value table for the fast path
+_SEPARATORS = b", \t\r\n"
+_DIGIT_VALUES = bytes(range(256)).translate(bytes.maketrans(b"0123456789", bytes(range(10))))
+
+# Mark values this DataType enum knows; anything else reads as UNREACHED
+_DATA_TYPES = {data_type.value: data_type for data_type in DataType}
+
+
+class _JsonStream:
+    """Just enough incremental JSON reading for the .diz layout: small values whole, big arrays in segments"""
+
+    def __init__(self, path: Path, chunk_size: int = CHUNK_SIZE):
+        self._file = open(path, "rb")
+        self._chunk_size = chunk_size
+        magic = self._file.read(2)
+        self._file.seek(0)
+        # wbits 31 = gzip container
+        self._inflate = zlib.decompressobj(31) if magic == b"\x1f\x8b" else None
+        self._decode = codecs.getincrementaldecoder("utf-8-sig")()
+        self.buffer = ""
+        self.pos = 0
+        self.eof = False
+
+    def close(self):
+        self._file.close()
+
+    def fill(self) -> bool:
+        """Append the next decompressed chunk, dropping what has been consumed; False at end of input"""
+        if self.eof:
+            return False
+        raw = self._file.read(self._chunk_size)
+        if raw:
+            data = self._inflate.decompress(raw) if self._inflate else raw
+        else:
+            data = self._inflate.flush() if self._inflate else b""
+            self.eof = True
+        self.buffer = self.buffer[self.pos :] + self._decode.decode(data, final=self.eof)
+        self.pos = 0
+        return True
+
+    def peek(self) -> str:
+        """Next non-whitespace character (not consumed), or "" at end of input"""
+        while True:
+            match = _NON_SPACE.search(self.buffer, self.pos)
+            if match:
+                self.pos = match.start()
+                return self.buffer[self.pos]
+            self.pos = len(self.buffer)
+            if not self.fill():
+                return ""
+
+    def expect(self, char: str):
+        if self.peek() != char:
+            raise ValueError(f"Expected {char!r} in .diz project")
+        self.pos += 1
+
+    def value(self):
+        """One complete JSON value, refilling until it parses"""
+        self.peek()
+        while True:
+            try:
+                value, end = _DECODER.raw_decode(self.buffer, self.pos)
+            except json.JSONDecodeError:
+                if not self.fill():
+                    raise
+                continue
+            # A number that ends the buffer may continue in the next chunk
+            if end == len(self.buffer) and self.fill():
+                continue
+            self.pos = end
+            return value
+
+    def members(self) -> Iterator[str]:
+        """Keys of the object starting here; the caller consumes each member's value"""
+        self.expect("{")
+        if self.peek() == "}":
+            self.pos += 1
+            return
+        while True:
+            key = self.value()
+            self.expect(":")
+            yield key
+            separator = self.peek()
+            self.pos += 1
+            if separator == "}":
+                return
+            if separator != ",":
+                raise ValueError("Malformed object in .diz project")
+
+    def byte_array(self, into: Optional[bytearray]) -> int:
+        """
+        Read an array of 0-255 integers into into (or just count them when into is None)
+        Segments of single digits convert with one translate; others go through json.
+        """
+        self.expect("[")
+        if self.peek() == "]":
+            self.pos += 1
+            return 0
+
+        count = 0
+        while True:
+            end = self.buffer.find("]", self.pos)
+            cut = end if end >= 0 else self.buffer.rfind(",", self.pos)
+            if cut >= 0:
+                segment = self.buffer[self.pos : cut]
+                elements = segment.count(",") + 1
+                count += elements
+                if into is not None:
+                    digits = segment.encode("ascii").translate(None, _SEPARATORS)
+                    if len(digits) == elements:
+                        into.extend(digits.translate(_DIGIT_VALUES))
+                    else:
+                        into.extend(json.loads(f"[{segment}]"))
+                self.pos = cut + 1
+                if end >= 0:
+                    return count
+            if not self.fill():
+                raise ValueError("Unterminated array in .diz project")
+
+
+class LabelArena:
+    """
+    Labels as parallel arrays: address, name id, comment id
+    Names and comments are interned once into a UTF-8 blob (id 0 is the empty string) and
+    decoded only when asked for.
+    """
+
+    def __init__(self):
+        self.addresses = array("I")
+        self.name_ids = array("I")
+        self.comment_ids = array("I")
+        self._blob = bytearray()
+        self._starts = array("I", [0, 0])
+        self._interned: Dict[str, int] = {"": 0}
+
+    def __len__(self) -> int:
+        return len(self.addresses)
+
+    def intern(self, text: str) -> int:
+        string_id = self._interned.get(text)
+        if string_id is None:
+            string_id = len(self._starts) - 1
+            self._interned[text] = string_id
+            self._blob.extend(text.encode("utf-8"))
+            self._starts.append(len(self._blob))
+        return string_id
+
+    def add(self, address: int, name: str, comment: str = ""):
+        self.addresses.append(address)
+        self.name_ids.append(self.intern(name))
+        self.comment_ids.append(self.intern(comment))
+
+    def finish(self):
+        """Sort by address and drop the interning table"""
+        order = sorted(range(len(self.addresses)), key=self.addresses.__getitem__)
+        self.addresses = array("I", map(self.addresses.__getitem__, order))
+        self.name_ids = array("I", map(self.name_ids.__getitem__, order))
+        self.comment_ids = array("I", map(self.comment_ids.__getitem__, order))
+        self._blob = bytes(self._blob)
+        self._interned = None
+
+    def string(self, string_id: int) -> str:
+        return self._blob[self._starts[string_id] : self._starts[string_id + 1]].decode("utf-8")
+
+    def name(self, index: int) -> str:
+        return self.string(self.name_ids[index])
+
+    def comment(self, index: int) -> str:
+        return self.string(self.comment_ids[index])
+
+    def find(self, address: int) -> Optional[int]:
+        """Index of the label at address (after finish), or None"""
+        index = bisect_left(self.addresses, address)
+        if index < len(self.addresses) and self.addresses[index] == address:
+            return index
+        return None
+
+    def __iter__(self) -> Iterator[Tuple[int, str, str]]:
+        """(address, name, comment) in address order"""
+        for index in range(len(self.addresses)):
+            yield self.addresses[index], self.name(index), self.comment(index)
+
+
+class DizProject:
+    """Marks and labels of a streamed .diz project"""
+
+    def __init__(self, path: Path, name: str, rom_size: int, flags: bytearray, labels: LabelArena):
+        self.path = path
+        self.name = name
+        self.rom_size = rom_size
+        self._flags = flags
+        self.flags = memoryview(flags)  # DataType value per ROM byte
+        self.labels = labels
+
+    def data_type_at(self, offset: int) -> DataType:
+        return _DATA_TYPES.get(self.flags[offset], DataType.UNREACHED) if offset < len(self.flags) else DataType.UNREACHED
+
+    def type_counts(self) -> Dict[str, int]:
+        """Bytes carrying each DataType mark"""
+        return {data_type.name: self._flags.count(data_type.value) for data_type in DataType}
+
+    @property
+    def marked_bytes(self) -> int:
+        return len(self._flags) - self._flags.count(DataType.UNREACHED.value)
+
+    @property
+    def completion_percentage(self) -> float:
+        return self.marked_bytes / self.rom_size * 100.0 if self.rom_size else 0.0
+
+
+def load_diz(diz_path: Union[str, Path], chunk_size: int = CHUNK_SIZE) -> DizProject:
+    """Stream a (gzipped or plain) JSON .diz project into flags and a label arena"""
+    path = Path(diz_path)
+    if not path.exists():
+        raise FileNotFoundError(f"DiztinGUIsh file not found: {diz_path}")
+
+    stream = _JsonStream(path, chunk_size)
+    name = ""
+    rom_size = 0
+    flags = bytearray()
+    labels = LabelArena()
+
+    try:
+        for key in stream.members():
+            if key == "ProjectName":
+                name = str(stream.value())
+            elif key == "RomBytes":
+                # The ROM itself comes from the ROM file; only its size matters here
+                rom_size = stream.byte_array(None)
+            elif key == "Data":
+                stream.byte_array(flags)
+            elif key == "Labels":
+                for address_key in stream.members():
+                    label = stream.value()
+                    try:
+                        address = int(address_key)
+                    except ValueError:
+                        continue
+                    labels.add(address, label.get("Name", f"label_{address:06X}"), label.get("Comment", ""))
+            else:
+                stream.value()
+    except (json.JSONDecodeError, zlib.error, UnicodeDecodeError) as e:
+        raise ValueError(f"Failed to stream .diz file {path}: {e}")
+    finally:
+        stream.close()
+
+    rom_size = rom_size or len(flags)
+    if len(flags) < rom_size:
+        flags.extend(bytes(rom_size - len(flags)))
+
+    labels.finish()
+    return DizProject(path, name, rom_size, flags, labels)
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Stream a DiztinGUIsh (.diz) project and summarize it")
+    parser.add_argument("diz_file", help="Path to .diz file")
+    parser.add_argument("--labels", type=int, default=10, help="Labels to print")
+    args = parser.parse_args()
+
+    try:
+        start_time = time.time()
+        project = load_diz(args.diz_file)
+        elapsed = time.time() - start_time
+    except (OSError, ValueError) as e:
+        print(f"❌ Error: {e}")
+        sys.exit(1)
+
+    print(f"✅ Streamed {project.path.name} in {elapsed:.2f}s")
+    print(f"📊 {len(project.labels):,} labels, {project.rom_size:,} bytes ({project.completion_percentage:.1f}% marked)")
+    for type_name, count in project.type_counts().items():
+        if count:
+            print(f"   {type_name:<12} {count:>10,}")
+    for address, name, comment in list(project.labels)[: args.labels]:
+        print(f"   ${address:06X} {name}" + (f" ; {comment}" if comment else ""))
@@ -12,6 +12,14 @@ from dataclasses import dataclass, field
 from enum import Enum
 import json
 
+# Sibling modules, for callers that only put tools/ on the path
+sys.path.append(str(Path(__file__).parent))
+from decoder65816 import OPCODE_TABLE, FLAG_M, FLAG_X, SIZE_TABLES, decode_linear, DecodedInstructions
+
+# Shared address mapping tables
+sys.path.append(str(Path(__file__).parent.parent / "analysis"))
+from address_map import LOROM, address_map_for
+
 
 class AddressingMode(Enum):
     """65816 Addressing modes"""
@@ -42,6 +50,35 @@ class AddressingMode(Enum):
     BLOCK_MOVE = "block"
 
 
+# Shared decoder mode names -> AddressingMode
+ADDRESSING_MODES = {
+    "implied": AddressingMode.IMPLIED,
+    "accumulator": AddressingMode.ACCUMULATOR,
+    "immediate": AddressingMode.IMMEDIATE,
+    "absolute": AddressingMode.ABSOLUTE,
+    "absolute_x": AddressingMode.ABSOLUTE_X,
+    "absolute_y": AddressingMode.ABSOLUTE_Y,
+    "absolute_indirect": AddressingMode.INDIRECT,
+    "absolute_x_indirect": AddressingMode.INDIRECT_X,
+    "absolute_indirect_long": AddressingMode.INDIRECT_LONG,
+    "long": AddressingMode.ABSOLUTE_LONG,
+    "long_x": AddressingMode.ABSOLUTE_LONG_X,
+    "zeropage": AddressingMode.DIRECT_PAGE,
+    "zeropage_x": AddressingMode.DIRECT_PAGE_X,
+    "zeropage_y": AddressingMode.DIRECT_PAGE_Y,
+    "zeropage_indirect": AddressingMode.DIRECT_PAGE_INDIRECT,
+    "zeropage_x_indirect": AddressingMode.DIRECT_PAGE_INDIRECT_X,
+    "zeropage_indirect_y": AddressingMode.DIRECT_PAGE_INDIRECT_Y,
+    "zeropage_indirect_long": AddressingMode.DIRECT_PAGE_INDIRECT_LONG,
+    "zeropage_indirect_long_y": AddressingMode.DIRECT_PAGE_INDIRECT_LONG_Y,
+    "stack_relative": AddressingMode.STACK_RELATIVE,
+    "stack_relative_indirect_y": AddressingMode.STACK_RELATIVE_INDIRECT_Y,
+    "relative": AddressingMode.RELATIVE,
+    "relative_long": AddressingMode.RELATIVE_LONG,
+    "block_move": AddressingMode.BLOCK_MOVE,
+}
+
+
 @dataclass
 class Instruction:
     """Represents a 65816 instruction"""
@@ -156,10 +193,14 @@ class SNES65816Disassembler:
     def __init__(self, rom_data: bytes):
         self.rom_data = rom_data
         self.rom_size = len(rom_data)
+        self._classification = None
 
         # Initialize instruction table
         self._build_instruction_table()
 
+        # Default M/X state: 16-bit accumulator, 8-bit index registers
+        self.p_flags = FLAG_X
+
         # Disassembly state
         self.functions: Dict[int, Function] = {}
         self.instructions: Dict[int, Instruction] = {}
@@ -167,6 +208,8 @@ class SNES65816Disassembler:
         self.labels: Dict[int, str] = {}
 
         # Banking information
+        self.rom_mapping = self._detect_rom_mapping()
+        self.address_map = address_map_for(self.rom_mapping, self.rom_size)
         self.bank_map = self._analyze_banking_system()
 
         # Analysis state
@@ -174,146 +217,19 @@ class SNES65816Disassembler:
         self.pending_analysis: Set[int] = set()
 
     def _build_instruction_table(self):
-        """Build 65816 instruction decode table"""
-        # This is a comprehensive 65816 instruction table
+        """Build 65816 instruction decode table from the shared 256-entry opcode table"""
         # Format: opcode -> (mnemonic, addressing_mode, size, cycles)
-        self.instruction_table = {
-            # ADC - Add with carry
-            0x61: ("ADC", AddressingMode.DIRECT_PAGE_INDIRECT_X, 2, 6),
-            0x63: ("ADC", AddressingMode.STACK_RELATIVE, 2, 4),
-            0x65: ("ADC", AddressingMode.DIRECT_PAGE, 2, 3),
-            0x67: ("ADC", AddressingMode.DIRECT_PAGE_INDIRECT_LONG, 2, 6),
-            0x69: ("ADC", AddressingMode.IMMEDIATE, 0, 2),  # Size varies with M flag
-            0x6D: ("ADC", AddressingMode.ABSOLUTE, 3, 4),
-            0x6F: ("ADC", AddressingMode.ABSOLUTE_LONG, 4, 5),
-            0x71: ("ADC", AddressingMode.DIRECT_PAGE_INDIRECT_Y, 2, 5),
-            0x72: ("ADC", AddressingMode.DIRECT_PAGE_INDIRECT, 2, 5),
-            0x73: ("ADC", AddressingMode.STACK_RELATIVE_INDIRECT_Y, 2, 7),
-            0x75: ("ADC", AddressingMode.DIRECT_PAGE_X, 2, 4),
-            0x77: ("ADC", AddressingMode.DIRECT_PAGE_INDIRECT_LONG_Y, 2, 6),
-            0x79: ("ADC", AddressingMode.ABSOLUTE_Y, 3, 4),
-            0x7D: ("ADC", AddressingMode.ABSOLUTE_X, 3, 4),
-            0x7F: ("ADC", AddressingMode.ABSOLUTE_LONG_X, 4, 5),
-            # AND - Logical AND
-            0x21: ("AND", AddressingMode.DIRECT_PAGE_INDIRECT_X, 2, 6),
-            0x23: ("AND", AddressingMode.STACK_RELATIVE, 2, 4),
-            0x25: ("AND", AddressingMode.DIRECT_PAGE, 2, 3),
-            0x27: ("AND", AddressingMode.DIRECT_PAGE_INDIRECT_LONG, 2, 6),
-            0x29: ("AND", AddressingMode.IMMEDIATE, 0, 2),
-            0x2D: ("AND", AddressingMode.ABSOLUTE, 3, 4),
-            0x2F: ("AND", AddressingMode.ABSOLUTE_LONG, 4, 5),
-            0x31: ("AND", AddressingMode.DIRECT_PAGE_INDIRECT_Y, 2, 5),
-            0x32: ("AND", AddressingMode.DIRECT_PAGE_INDIRECT, 2, 5),
-            0x33: ("AND", AddressingMode.STACK_RELATIVE_INDIRECT_Y, 2, 7),
-            0x35: ("AND", AddressingMode.DIRECT_PAGE_X, 2, 4),
-            0x37: ("AND", AddressingMode.DIRECT_PAGE_INDIRECT_LONG_Y, 2, 6),
-            0x39: ("AND", AddressingMode.ABSOLUTE_Y, 3, 4),
-            0x3D: ("AND", AddressingMode.ABSOLUTE_X, 3, 4),
-            0x3F: ("AND", AddressingMode.ABSOLUTE_LONG_X, 4, 5),
-            # BRA, BRL - Branch always
-            0x80: ("BRA", AddressingMode.RELATIVE, 2, 3),
-            0x82: ("BRL", AddressingMode.RELATIVE_LONG, 3, 4),
-            # Branch instructions
-            0x10: ("BPL", AddressingMode.RELATIVE, 2, 2),
-            0x30: ("BMI", AddressingMode.RELATIVE, 2, 2),
-            0x50: ("BVC", AddressingMode.RELATIVE, 2, 2),
-            0x70: ("BVS", AddressingMode.RELATIVE, 2, 2),
-            0x90: ("BCC", AddressingMode.RELATIVE, 2, 2),
-            0xB0: ("BCS", AddressingMode.RELATIVE, 2, 2),
-            0xD0: ("BNE", AddressingMode.RELATIVE, 2, 2),
-            0xF0: ("BEQ", AddressingMode.RELATIVE, 2, 2),
-            # JSR, JSL - Jump to subroutine
-            0x20: ("JSR", AddressingMode.ABSOLUTE, 3, 6),
-            0x22: ("JSL", AddressingMode.ABSOLUTE_LONG, 4, 8),
-            0xFC: ("JSR", AddressingMode.INDIRECT_X, 3, 8),
-            # JMP, JML - Jump
-            0x4C: ("JMP", AddressingMode.ABSOLUTE, 3, 3),
-            0x5C: ("JML", AddressingMode.ABSOLUTE_LONG, 4, 4),
-            0x6C: ("JMP", AddressingMode.INDIRECT, 3, 5),
-            0x7C: ("JMP", AddressingMode.INDIRECT_X, 3, 6),
-            0xDC: ("JML", AddressingMode.INDIRECT_LONG, 3, 6),
-            # RTS, RTL, RTI - Return
-            0x40: ("RTI", AddressingMode.IMPLIED, 1, 6),
-            0x60: ("RTS", AddressingMode.IMPLIED, 1, 6),
-            0x6B: ("RTL", AddressingMode.IMPLIED, 1, 6),
-            # Load/Store instructions
-            0xA9: ("LDA", AddressingMode.IMMEDIATE, 0, 2),  # Size varies with M flag
-            0xA2: ("LDX", AddressingMode.IMMEDIATE, 0, 2),  # Size varies with X flag
-            0xA0: ("LDY", AddressingMode.IMMEDIATE, 0, 2),  # Size varies with X flag
-            0xAD: ("LDA", AddressingMode.ABSOLUTE, 3, 4),
-            0xAE: ("LDX", AddressingMode.ABSOLUTE, 3, 4),
-            0xAC: ("LDY", AddressingMode.ABSOLUTE, 3, 4),
-            0x8D: ("STA", AddressingMode.ABSOLUTE, 3, 4),
-            0x8E: ("STX", AddressingMode.ABSOLUTE, 3, 4),
-            0x8C: ("STY", AddressingMode.ABSOLUTE, 3, 4),
-            # Stack operations
-            0x48: ("PHA", AddressingMode.IMPLIED, 1, 3),
-            0x68: ("PLA", AddressingMode.IMPLIED, 1, 4),
-            0x8B: ("PHB", AddressingMode.IMPLIED, 1, 3),
-            0xAB: ("PLB", AddressingMode.IMPLIED, 1, 4),
-            0x0B: ("PHD", AddressingMode.IMPLIED, 1, 4),
-            0x2B: ("PLD", AddressingMode.IMPLIED, 1, 5),
-            0x4B: ("PHK", AddressingMode.IMPLIED, 1, 3),
-            0x08: ("PHP", AddressingMode.IMPLIED, 1, 3),
-            0x28: ("PLP", AddressingMode.IMPLIED, 1, 4),
-            0xDA: ("PHX", AddressingMode.IMPLIED, 1, 3),
-            0xFA: ("PLX", AddressingMode.IMPLIED, 1, 4),
-            0x5A: ("PHY", AddressingMode.IMPLIED, 1, 3),
-            0x7A: ("PLY", AddressingMode.IMPLIED, 1, 4),
-            # Processor status
-            0x18: ("CLC", AddressingMode.IMPLIED, 1, 2),
-            0x38: ("SEC", AddressingMode.IMPLIED, 1, 2),
-            0x58: ("CLI", AddressingMode.IMPLIED, 1, 2),
-            0x78: ("SEI", AddressingMode.IMPLIED, 1, 2),
-            0xB8: ("CLV", AddressingMode.IMPLIED, 1, 2),
-            0xD8: ("CLD", AddressingMode.IMPLIED, 1, 2),
-            0xF8: ("SED", AddressingMode.IMPLIED, 1, 2),
-            # Processor control
-            0xC2: ("REP", AddressingMode.IMMEDIATE, 2, 3),
-            0xE2: ("SEP", AddressingMode.IMMEDIATE, 2, 3),
-            0xFB: ("XCE", AddressingMode.IMPLIED, 1, 2),
-            # Transfers
-            0xAA: ("TAX", AddressingMode.IMPLIED, 1, 2),
-            0xA8: ("TAY", AddressingMode.IMPLIED, 1, 2),
-            0xBA: ("TSX", AddressingMode.IMPLIED, 1, 2),
-            0x8A: ("TXA", AddressingMode.IMPLIED, 1, 2),
-            0x9A: ("TXS", AddressingMode.IMPLIED, 1, 2),
-            0x98: ("TYA", AddressingMode.IMPLIED, 1, 2),
-            0x5B: ("TCD", AddressingMode.IMPLIED, 1, 2),
-            0x7B: ("TDC", AddressingMode.IMPLIED, 1, 2),
-            0x1B: ("TCS", AddressingMode.IMPLIED, 1, 2),
-            0x3B: ("TSC", AddressingMode.IMPLIED, 1, 2),
-            0x0A: ("ASL", AddressingMode.ACCUMULATOR, 1, 2),
-            # Compare
-            0xC9: ("CMP", AddressingMode.IMMEDIATE, 0, 2),
-            0xE0: ("CPX", AddressingMode.IMMEDIATE, 0, 2),
-            0xC0: ("CPY", AddressingMode.IMMEDIATE, 0, 2),
-            # Increment/Decrement
-            0xE8: ("INX", AddressingMode.IMPLIED, 1, 2),
-            0xCA: ("DEX", AddressingMode.IMPLIED, 1, 2),
-            0xC8: ("INY", AddressingMode.IMPLIED, 1, 2),
-            0x88: ("DEY", AddressingMode.IMPLIED, 1, 2),
-            0x1A: ("INC", AddressingMode.ACCUMULATOR, 1, 2),
-            0x3A: ("DEC", AddressingMode.ACCUMULATOR, 1, 2),
-            # Misc
-            0xEA: ("NOP", AddressingMode.IMPLIED, 1, 2),
-            0x00: ("BRK", AddressingMode.IMMEDIATE, 2, 8),
-            0x02: ("COP", AddressingMode.IMMEDIATE, 2, 8),
-            0xDB: ("STP", AddressingMode.IMPLIED, 1, 3),
-            0xCB: ("WAI", AddressingMode.IMPLIED, 1, 3),
-            # Block moves
-            0x44: ("MVP", AddressingMode.BLOCK_MOVE, 3, 7),
-            0x54: ("MVN", AddressingMode.BLOCK_MOVE, 3, 7),
-        }
+        # Size is 0 for immediates whose width follows the M or X flag
+        self.instruction_table = {}
+        for opcode, info in enumerate(OPCODE_TABLE):
+            size = 0 if info.width else info.size
+            self.instruction_table[opcode] = (info.mnemonic, ADDRESSING_MODES[info.mode], size, info.cycles)
 
     def _analyze_banking_system(self) -> Dict[int, Dict[str, Any]]:
         """Analyze SNES banking system for this ROM"""
         bank_map = {}
 
-        # Determine if this is LoROM or HiROM
-        rom_mapping = self._detect_rom_mapping()
-
-        if rom_mapping == "LoROM":
+        if self.rom_mapping == LOROM:
             # LoROM: 32KB banks starting at $8000
             total_banks = (self.rom_size + 0x7FFF) // 0x8000
 
@@ -325,7 +241,7 @@ class SNES65816Disassembler:
                     "snes_start": 0x8000,
                     "snes_end": 0xFFFF,
                     "size": min(0x8000, self.rom_size - rom_offset),
-                    "description": self._classify_bank_content(bank, rom_offset),
+                    "description": self._classify_bank_content(bank, rom_offset, 0x8000),
                 }
 
                 # Mirror in upper half
@@ -345,7 +261,7 @@ class SNES65816Disassembler:
                     "snes_start": 0x0000,
                     "snes_end": 0xFFFF,
                     "size": min(0x10000, self.rom_size - rom_offset),
-                    "description": self._classify_bank_content(bank, rom_offset),
+                    "description": self._classify_bank_content(bank, rom_offset, 0x10000),
                 }
 
         return bank_map
@@ -408,45 +324,36 @@ class SNES65816Disassembler:
 
         return score
 
-    def _classify_bank_content(self, bank: int, rom_offset: int) -> str:
-        """Classify the content type of a ROM bank"""
-        if rom_offset >= self.rom_size:
-            return "Empty"
-
-        # Sample first 1KB of bank to classify content
-        sample_size = min(0x400, self.rom_size - rom_offset)
-        sample_data = self.rom_data[rom_offset : rom_offset + sample_size]
-
-        if not sample_data:
-            return "Empty"
-
-        # Check for code patterns
-        code_instructions = 0
-        for i in range(0, len(sample_data) - 1):
-            if sample_data[i] in self.instruction_table:
-                code_instructions += 1
+    # Bank descriptions for the shared classifier's region types
+    BANK_DESCRIPTIONS = {
+        "code": "Program code",
+        "graphics": "Graphics data",
+        "text": "Text/Dialog data",
+        "audio": "Audio data",
+        "pointers": "Pointer tables",
+        "compressed": "Compressed data",
+        "fill": "Empty/Padding",
+    }
 
-        code_density = code_instructions / len(sample_data)
+    @property
+    def classification(self):
+        """Shared single-pass region classification of the ROM (see rom_classifier)"""
+        if self._classification is None:
+            from rom_classifier import classify_rom
 
-        # Check for graphics patterns (repetitive tile data)
-        graphics_score = self._detect_graphics_patterns(sample_data)
+            self._classification = classify_rom(self.rom_data)
+        return self._classification
 
-        # Check for text/data patterns
-        text_score = self._detect_text_patterns(sample_data)
+    def _classify_bank_content(self, bank: int, rom_offset: int, bank_size: int = 0x8000) -> str:
+        """Classify the content type of a ROM bank"""
+        if rom_offset >= self.rom_size:
+            return "Empty"
 
-        # Classification
         if bank == 0:
             return "System/Boot code"
-        elif code_density > 0.3:
-            return "Program code"
-        elif graphics_score > 0.7:
-            return "Graphics data"
-        elif text_score > 0.6:
-            return "Text/Dialog data"
-        elif self._detect_audio_patterns(sample_data):
-            return "Audio data"
-        else:
-            return "Data/Unknown"
+
+        summary = self.classification.summarize(rom_offset, rom_offset + bank_size)
+        return self.BANK_DESCRIPTIONS.get(summary["type"], "Data/Unknown")
 
     def _detect_graphics_patterns(self, data: bytes) -> float:
         """Detect if data contains graphics patterns"""
@@ -566,42 +473,24 @@ class SNES65816Disassembler:
 
         return instructions
 
-    def disassemble_instruction(self, rom_offset: int, snes_addr: int, bank: int) -> Optional[Instruction]:
-        """Disassemble a single instruction"""
+    def disassemble_instruction(
+        self, rom_offset: int, snes_addr: int, bank: int, p_flags: Optional[int] = None
+    ) -> Optional[Instruction]:
+        """Disassemble a single instruction (immediate widths follow p_flags, default self.p_flags)"""
         if rom_offset >= self.rom_size:
             return None
 
         opcode = self.rom_data[rom_offset]
+        mnemonic, addressing_mode, _, cycles = self.instruction_table[opcode]
 
-        if opcode not in self.instruction_table:
-            # Unknown opcode - treat as data byte
-            return Instruction(
-                address=snes_addr,
-                opcode=opcode,
-                mnemonic="DB",
-                addressing_mode=AddressingMode.IMPLIED,
-                operand_bytes=b"",
-                size=1,
-                cycles=0,
-                description=f"Unknown opcode ${opcode:02X}",
-            )
-
-        mnemonic, addressing_mode, base_size, cycles = self.instruction_table[opcode]
-
-        # Handle variable-size instructions (immediate mode)
-        instruction_size = base_size
-        if base_size == 0:  # Variable size based on processor flags
-            if mnemonic in ["LDA", "ADC", "SBC", "AND", "ORA", "EOR", "CMP"]:
-                instruction_size = 3  # Assume 16-bit mode for now
-            else:
-                instruction_size = 2  # 8-bit index registers
+        if p_flags is None:
+            p_flags = self.p_flags
+        instruction_size = SIZE_TABLES[p_flags & (FLAG_M | FLAG_X)][opcode]
 
-        # Extract operand bytes
-        operand_size = instruction_size - 1
         if rom_offset + instruction_size > self.rom_size:
             return None
 
-        operand_bytes = self.rom_data[rom_offset + 1 : rom_offset + instruction_size]
+        operand_bytes = bytes(self.rom_data[rom_offset + 1 : rom_offset + instruction_size])
 
         return Instruction(
             address=snes_addr,
@@ -613,22 +502,22 @@ class SNES65816Disassembler:
             cycles=cycles,
         )
 
-    def snes_to_rom_offset(self, snes_addr: int, bank: int) -> Optional[int]:
-        """Convert SNES address to ROM file offset"""
-        if bank not in self.bank_map:
-            return None
+    def sweep_rom(self, p_flags: Optional[int] = None, track_flags: bool = True) -> DecodedInstructions:
+        """Linear sweep of the whole ROM into flat instruction arrays (offsets, opcodes, sizes, flags)"""
+        return decode_linear(self.rom_data, 0, self.rom_size, self.p_flags if p_flags is None else p_flags, track_flags)
 
-        bank_info = self.bank_map[bank]
+    def build_control_flow_graph(self, labels_path: Optional[Path] = None):
+        """Basic-block graph from the interrupt vectors and labels.inc (see cfg_engine)"""
+        from cfg_engine import build_control_flow_graph
 
-        if bank_info["type"] == "LoROM":
-            if 0x8000 <= snes_addr <= 0xFFFF:
-                offset_in_bank = snes_addr - 0x8000
-                return bank_info["rom_offset"] + offset_in_bank
-        else:  # HiROM
-            if 0x0000 <= snes_addr <= 0xFFFF:
-                return bank_info["rom_offset"] + snes_addr
+        return build_control_flow_graph(self, labels_path)
 
-        return None
+    def snes_to_rom_offset(self, snes_addr: int, bank: int) -> Optional[int]:
+        """Convert SNES address to ROM file offset (None for WRAM, I/O and open bus)"""
+        if not 0 <= snes_addr <= 0xFFFF:
+            return None
+        # HiROM banks 00-3F/80-BF mirror only the upper half of their 64KB bank, as address_map has it
+        return self.address_map.to_offset((bank << 16) | snes_addr)
 
     def analyze_function(self, start_addr: int, bank: int = 0) -> Optional[Function]:
         """Analyze a function starting at the given address"""
@@ -767,15 +656,14 @@ def create_snes_disassembler(rom_path: str) -> SNES65816Disassembler:
     if not rom_file.exists():
         raise FileNotFoundError(f"ROM file not found: {rom_path}")
 
-    with open(rom_file, "rb") as f:
-        rom_data = f.read()
+    # Shared memory-mapped image, header already skipped
+    from rom_image import open_rom_image
 
-    # Remove header if present
-    if len(rom_data) % 1024 == 512:
+    image = open_rom_image(rom_file)
+    if image.header_size:
         print(f"Removing 512-byte header from ROM")
-        rom_data = rom_data[512:]
 
-    return SNES65816Disassembler(rom_data)
+    return SNES65816Disassembler(image.data)
 
 
 if __name__ == "__main__":
@@ -788,6 +676,8 @@ if __name__ == "__main__":
     parser.add_argument("--bank", type=int, default=0, help="Bank number")
     parser.add_argument("--analyze-functions", action="store_true", help="Analyze functions")
     parser.add_argument("--output", "-o", help="Output file")
+    parser.add_argument("--cfg", metavar="BLOCKS_JSON", help="Build the control-flow graph and save its block table")
+    parser.add_argument("--labels", help="labels.inc used to seed CFG entry points")
 
     args = parser.parse_args()
 
@@ -838,6 +728,13 @@ if __name__ == "__main__":
                 print(f"   Size: {function.size} bytes")
                 print(f"   Instructions: {len(function.instructions)}")
 
+    if args.cfg:
+        print(f"\n🧱 Building control-flow graph...")
+        graph = disasm.build_control_flow_graph(Path(args.labels) if args.labels else None)
+        graph.save_block_table(Path(args.cfg))
+        print(f"📌 {len(graph.entries)} entries, {len(graph.sorted_blocks()):,} blocks, {graph.coverage():,} code bytes")
+        print(f"💾 Block table saved to: {args.cfg}")
+
     # Output
     result = "\n".join(output_lines)
 
@@ -101,6 +101,15 @@ class DataStructure:
 class DQ3StructureParser:
     """Parser for Dragon Quest III data structures from .mlb files"""
 
+    # Byte width of each scalar data type as stored in WRAM
+    SCALAR_WIDTHS = {
+        "uint8": 1,
+        "uint16": 2,
+        "uint24": 3,
+        "item_id": 1,
+        "spell_flags": 1,
+    }
+
     def __init__(self):
         self.structures: Dict[str, DataStructure] = {}
         self.raw_entries: List[Dict[str, Any]] = []
@@ -470,11 +479,71 @@ class DQ3StructureParser:
         with open(output_path / "dq3_structures.json", "w") as f:
             json.dump(export_data, f, indent="\t")
 
+    def load_json_export(self, file_path: str) -> Dict[str, DataStructure]:
+        """Rebuild the structures from a dq3_structures.json export"""
+        with open(file_path, "r", encoding="utf-8") as f:
+            export_data = json.load(f)
+
+        for name, entry in export_data.items():
+            structure = DataStructure(
+                name=entry["name"],
+                base_address=int(entry["base_address"].lstrip("$"), 16),
+                total_size=entry["total_size"],
+                structure_type=DataStructureType(entry["structure_type"]),
+                description=entry["description"],
+                completion_status=entry.get("completion_status", "partial"),
+            )
+            for field_entry in entry["fields"]:
+                structure.add_field(
+                    MemoryField(
+                        name=field_entry["name"],
+                        offset=field_entry["offset"],
+                        size=field_entry["size"],
+                        data_type=field_entry["data_type"],
+                        description=field_entry["description"],
+                        valid_range=field_entry.get("valid_range"),
+                        notes=field_entry.get("notes", ""),
+                    )
+                )
+            self.structures[name] = structure
+
+        return self.structures
+
+    @staticmethod
+    def _c_identifier(name: str) -> str:
+        """Make a field name usable as a C/C++ identifier (e.g. '2_Level' -> 'Field_2_Level')"""
+        identifier = re.sub(r"\W", "_", name)
+        if not identifier or identifier[0].isdigit():
+            identifier = f"Field_{identifier}"
+        return identifier
+
     def _generate_c_headers(self, output_path: Path):
         """Generate C header files for structure definitions"""
         headers_dir = output_path / "headers"
         headers_dir.mkdir(exist_ok=True)
 
+        roster = self._build_party_roster()
+        roster_names = {structure.name for structure in roster[1:]} if roster else set()
+
+        for name, structure in self.structures.items():
+            # Identical party member layouts are folded into the shared roster type below
+            if name in roster_names:
+                continue
+
+            self._generate_c_header(headers_dir, name, structure)
+
+            # Packed, layout-exact C++ view alongside the C header
+            self._generate_cpp_view(headers_dir, name, structure)
+
+        if roster:
+            self._generate_party_roster(headers_dir, roster)
+
+        self._generate_cpp_view_common(headers_dir)
+
+    def _generate_c_header(
+        self, headers_dir: Path, name: str, structure: DataStructure, extra_defines: Optional[List[str]] = None
+    ):
+        """Generate a single C header file for one structure definition"""
         # Type mapping for C headers
         type_map = {
             "uint8": "uint8_t",
@@ -485,46 +554,404 @@ class DQ3StructureParser:
             "spell_flags": "uint8_t",
         }
 
-        for name, structure in self.structures.items():
-            filename = f"{name.lower()}.h"
+        filename = f"{name.lower()}.h"
 
-            lines = [
-                f"/* {name} Data Structure */",
-                f"/* Generated from Dragon Quest III analysis */",
-                f"/* Base Address: ${structure.base_address:04X} */",
-                f"/* Size: {structure.total_size} bytes */",
+        lines = [
+            f"/* {name} Data Structure */",
+            f"/* Generated from Dragon Quest III analysis */",
+            f"/* Base Address: ${structure.base_address:04X} */",
+            f"/* Size: {structure.total_size} bytes */",
+            "",
+            "#ifndef DQ3_" + name.upper() + "_H",
+            "#define DQ3_" + name.upper() + "_H",
+            "",
+            "#include <stdint.h>",
+            "",
+            f"#define {name.upper()}_BASE_ADDR 0x{structure.base_address:04X}",
+            f"#define {name.upper()}_SIZE {structure.total_size}",
+        ]
+
+        lines.extend(extra_defines or [])
+        lines.extend(["", f"typedef struct {{"])
+
+        for field in structure.fields:
+            c_type = type_map.get(field.data_type, "uint8_t")
+            field_name = self._c_identifier(field.name)
+
+            # Handle arrays
+            if "[" in field.data_type:
+                array_match = re.search(r"byte\[(\d+)\]", field.data_type)
+                if array_match:
+                    array_size = array_match.group(1)
+                    lines.append(f"\t{c_type} {field_name}[{array_size}]; /* {field.description} */")
+                else:
+                    lines.append(f"\t{c_type} {field_name}; /* {field.description} */")
+            elif field.data_type == "string":
+                lines.append(f"\t{c_type} {field_name}[{field.size}]; /* {field.description} */")
+            else:
+                lines.append(f"\t{c_type} {field_name}; /* {field.description} */")
+
+        lines.extend([f"}} {name}_t;", "", "#endif /* DQ3_" + name.upper() + "_H */", ""])
+
+        with open(headers_dir / filename, "w") as f:
+            f.write("\n".join(lines))
+
+    def _build_party_roster(self) -> List[DataStructure]:
+        """Collect the Hero + PartyMember_N structures that form one contiguous 60-byte roster
+
+        Returns the structures in slot order (Hero is slot 0, PartyMember_N is slot N-1), or an
+        empty list if the slots don't line up as HERO_BASE_ADDR + n * HERO_SIZE.
+        """
+        hero = self.structures.get("Hero")
+        if not hero:
+            return []
+
+        roster = [hero]
+        while f"PartyMember_{len(roster) + 1}" in self.structures:
+            roster.append(self.structures[f"PartyMember_{len(roster) + 1}"])
+
+        for slot, structure in enumerate(roster):
+            if structure.total_size != hero.total_size:
+                return []
+            if structure.base_address != hero.base_address + slot * hero.total_size:
+                return []
+
+        return roster if len(roster) > 1 else []
+
+    def _build_party_member_layout(self, roster: List[DataStructure]) -> DataStructure:
+        """Merge per-slot fields into one slot-agnostic PartyMember layout
+
+        Field names lose their 'Hero_' / 'N_' prefixes; party member slots are merged first so
+        their generic descriptions win, with Hero-only fields (e.g. spells) filled in after.
+        """
+        hero = roster[0]
+        layout = DataStructure(
+            name="PartyMember",
+            base_address=hero.base_address,
+            total_size=hero.total_size,
+            structure_type=DataStructureType.CHARACTER,
+            description=f"Shared roster slot layout ({len(roster)} slots)",
+            completion_status=hero.completion_status,
+        )
+
+        known_offsets = set()
+        for structure in roster[1:] + roster[:1]:
+            for field in structure.fields:
+                if field.offset in known_offsets:
+                    continue
+                known_offsets.add(field.offset)
+                layout.add_field(
+                    MemoryField(
+                        name=re.sub(r"^(Hero_|\d+_)", "", field.name),
+                        offset=field.offset,
+                        size=field.size,
+                        data_type=field.data_type,
+                        description=self._strip_slot_prefix(field.description),
+                        valid_range=field.valid_range,
+                    )
+                )
+
+        return layout
+
+    @staticmethod
+    def _strip_slot_prefix(description: str) -> str:
+        """Drop the per-slot owner from a description ('Party member #2 - Max HP' -> 'Max HP')"""
+        stripped = re.sub(r"^(Hero|Party member #\d+)\s*(-\s*)?", "", description)
+        return stripped[:1].upper() + stripped[1:] if stripped else description
+
+    def _generate_party_roster(self, headers_dir: Path, roster: List[DataStructure]):
+        """Generate the slot-indexed roster type and SoA snapshot layout
+
+        partymember.h / partymember_view.hpp hold the single 60-byte slot layout;
+        party_roster.hpp adds a compile-time slot index, a runtime roster view, and
+        RosterSoA, which stores each stat for every slot (and frame) contiguously so
+        per-stat scans are cache-linear and vectorizable.
+        """
+        layout = self._build_party_member_layout(roster)
+        slots = len(roster)
+
+        self._generate_c_header(
+            headers_dir,
+            layout.name,
+            layout,
+            extra_defines=[
+                f"#define PARTY_ROSTER_SLOTS {slots}",
+                f"#define PARTY_ROSTER_SIZE (PARTY_ROSTER_SLOTS * PARTYMEMBER_SIZE)",
+                f"#define PARTYMEMBER_SLOT_ADDR(n) (PARTYMEMBER_BASE_ADDR + (n) * PARTYMEMBER_SIZE)",
+            ],
+        )
+        self._generate_cpp_view(headers_dir, layout.name, layout)
+
+        # Scalar columns: (name, C++ type, offset) and byte-block columns: (name, size)
+        scalar_types = {1: "uint8_t", 2: "uint16_t", 3: "uint32_t"}
+        scalars = []
+        blocks = []
+        for field in layout.fields:
+            accessor = self._c_identifier(field.name)
+            if self.SCALAR_WIDTHS.get(field.data_type) == field.size:
+                scalars.append((accessor, scalar_types[field.size]))
+            else:
+                blocks.append((accessor, field.size))
+
+        lines = [
+            "/* Party Roster */",
+            "/* Generated from Dragon Quest III analysis */",
+            f"/* Base Address: ${layout.base_address:04X} */",
+            f"/* Slots: {slots} x {layout.total_size} bytes */",
+            "",
+            "#ifndef DQ3_PARTY_ROSTER_HPP",
+            "#define DQ3_PARTY_ROSTER_HPP",
+            "",
+            "#include <algorithm>",
+            "#include <cstddef>",
+            "#include <cstdint>",
+            "#include <span>",
+            "",
+            '#include "partymember_view.hpp"',
+            "",
+            "namespace dq3 {",
+            "",
+            "/* Compile-time roster slot: slot 0 is the Hero, slot n is party member #(n + 1) */",
+            "template <std::size_t Slot>",
+            "struct RosterSlot {",
+            '\tstatic_assert(Slot < PARTY_ROSTER_SLOTS, "Roster slot out of range");',
+            "",
+            "\tstatic constexpr uint32_t base_addr = PARTYMEMBER_SLOT_ADDR(Slot);",
+            "",
+            "\tstatic PartyMember_View from_wram(std::span<const uint8_t> wram) {",
+            "\t\treturn PartyMember_View(wram.subspan<base_addr, PARTYMEMBER_SIZE>());",
+            "\t}",
+            "};",
+            "",
+            "class Roster_View {",
+            "public:",
+            "\tconstexpr explicit Roster_View(std::span<const uint8_t, PARTY_ROSTER_SIZE> bytes) : bytes_(bytes) {}",
+            "",
+            "\t/* wram must cover at least PARTYMEMBER_BASE_ADDR + PARTY_ROSTER_SIZE bytes */",
+            "\tstatic Roster_View from_wram(std::span<const uint8_t> wram) {",
+            "\t\treturn Roster_View(wram.subspan<PARTYMEMBER_BASE_ADDR, PARTY_ROSTER_SIZE>());",
+            "\t}",
+            "",
+            "\ttemplate <std::size_t Slot>",
+            "\tPartyMember_View slot() const {",
+            '\t\tstatic_assert(Slot < PARTY_ROSTER_SLOTS, "Roster slot out of range");',
+            "\t\treturn PartyMember_View(bytes_.subspan<Slot * PARTYMEMBER_SIZE, PARTYMEMBER_SIZE>());",
+            "\t}",
+            "",
+            "\tPartyMember_View slot(std::size_t n) const {",
+            "\t\treturn PartyMember_View(std::span<const uint8_t, PARTYMEMBER_SIZE>(bytes_.data() + n * PARTYMEMBER_SIZE, PARTYMEMBER_SIZE));",
+            "\t}",
+            "",
+            "private:",
+            "\tstd::span<const uint8_t, PARTY_ROSTER_SIZE> bytes_;",
+            "};",
+            "",
+            "/*",
+            " * Structure-of-arrays roster snapshots: entry [frame * PARTY_ROSTER_SLOTS + slot] of each",
+            " * column holds that stat for one slot in one captured frame. Large Frames counts should be",
+            " * heap-allocated (e.g. std::make_unique<RosterSoA<4096>>()).",
+            " */",
+            "template <std::size_t Frames = 1>",
+            "struct RosterSoA {",
+            "\tstatic constexpr std::size_t frames = Frames;",
+            "\tstatic constexpr std::size_t count = Frames * PARTY_ROSTER_SLOTS;",
+            "",
+        ]
+
+        for accessor, c_type in scalars:
+            lines.append(f"\talignas(32) {c_type} {accessor}[count];")
+        for accessor, size in blocks:
+            lines.append(f"\tuint8_t {accessor}[count][{size}];")
+
+        lines.extend(
+            [
                 "",
-                "#ifndef DQ3_" + name.upper() + "_H",
-                "#define DQ3_" + name.upper() + "_H",
+                "\t/* Gather every roster slot of one WRAM frame into the columns */",
+                "\tvoid capture(std::size_t frame, std::span<const uint8_t> wram) {",
+                "\t\tconst Roster_View roster = Roster_View::from_wram(wram);",
+                "\t\tfor (std::size_t slot = 0; slot < PARTY_ROSTER_SLOTS; ++slot) {",
+                "\t\t\tconst PartyMember_View member = roster.slot(slot);",
+                "\t\t\tconst std::size_t i = frame * PARTY_ROSTER_SLOTS + slot;",
+            ]
+        )
+
+        for accessor, _ in scalars:
+            lines.append(f"\t\t\t{accessor}[i] = member.{accessor}();")
+        for accessor, _ in blocks:
+            lines.append(f"\t\t\tstd::ranges::copy(member.{accessor}(), {accessor}[i]);")
+
+        lines.extend(
+            [
+                "\t\t}",
+                "\t}",
+                "};",
                 "",
-                "#include <stdint.h>",
+                "} /* namespace dq3 */",
                 "",
-                f"#define {name.upper()}_BASE_ADDR 0x{structure.base_address:04X}",
-                f"#define {name.upper()}_SIZE {structure.total_size}",
+                "#endif /* DQ3_PARTY_ROSTER_HPP */",
                 "",
-                f"typedef struct {{",
             ]
+        )
 
-            for field in structure.fields:
-                c_type = type_map.get(field.data_type, "uint8_t")
-
-                # Handle arrays
-                if "[" in field.data_type:
-                    array_match = re.search(r"byte\[(\d+)\]", field.data_type)
-                    if array_match:
-                        array_size = array_match.group(1)
-                        lines.append(f"\t{c_type} {field.name}[{array_size}]; /* {field.description} */")
-                    else:
-                        lines.append(f"\t{c_type} {field.name}; /* {field.description} */")
-                elif field.data_type == "string":
-                    lines.append(f"\t{c_type} {field.name}[{field.size}]; /* {field.description} */")
-                else:
-                    lines.append(f"\t{c_type} {field.name}; /* {field.description} */")
+        with open(headers_dir / "party_roster.hpp", "w") as f:
+            f.write("\n".join(lines))
+
+    def _generate_cpp_view_common(self, headers_dir: Path):
+        """Generate shared little-endian read helpers used by all *_view.hpp headers"""
+        lines = [
+            "/* Shared helpers for DQ3 zero-copy structure views */",
+            "/* Generated from Dragon Quest III analysis */",
+            "/* Requires C++20 (std::span) */",
+            "",
+            "#ifndef DQ3_VIEW_HPP",
+            "#define DQ3_VIEW_HPP",
+            "",
+            "#include <cstddef>",
+            "#include <cstdint>",
+            "#include <span>",
+            "",
+            "namespace dq3 {",
+            "",
+            "/* SNES WRAM is little-endian; compose bytes so reads are host-independent and unaligned-safe */",
+            "constexpr uint16_t read_u16le(const uint8_t* p) {",
+            "\treturn static_cast<uint16_t>(p[0] | (p[1] << 8));",
+            "}",
+            "",
+            "constexpr uint32_t read_u24le(const uint8_t* p) {",
+            "\treturn static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |",
+            "\t\t(static_cast<uint32_t>(p[2]) << 16);",
+            "}",
+            "",
+            "} /* namespace dq3 */",
+            "",
+            "#endif /* DQ3_VIEW_HPP */",
+            "",
+        ]
 
-            lines.extend([f"}} {name}_t;", "", "#endif /* DQ3_" + name.upper() + "_H */", ""])
+        with open(headers_dir / "dq3_view.hpp", "w") as f:
+            f.write("\n".join(lines))
 
-            with open(headers_dir / filename, "w") as f:
-                f.write("\n".join(lines))
+    def _generate_cpp_view(self, headers_dir: Path, name: str, structure: DataStructure):
+        """Generate a packed, static_assert-checked C++ view over raw WRAM bytes
+
+        The packed struct mirrors the exact byte layout (including undocumented gaps) so it
+        can be overlaid on a WRAM dump; the view class reads fields straight out of a
+        std::span<const uint8_t> (e.g. an mmap'd save state) without copying.
+        """
+        guard = f"DQ3_{name.upper()}_VIEW_HPP"
+        size_macro = f"{name.upper()}_SIZE"
+        base_macro = f"{name.upper()}_BASE_ADDR"
+
+        # Merge documented fields and gaps into one ordered layout
+        layout: List[Tuple[int, int, Optional[MemoryField]]] = []
+        for start, end in structure.get_gaps():
+            layout.append((start, end - start + 1, None))
+        current_pos = 0
+        for field in sorted(structure.fields, key=lambda f: f.offset):
+            # Overlapping labels can't share packed storage; they're still exposed as accessors
+            if field.offset >= current_pos:
+                layout.append((field.offset, field.size, field))
+                current_pos = field.end_offset + 1
+        layout.sort(key=lambda entry: entry[0])
+
+        lines = [
+            f"/* {name} Zero-Copy View */",
+            f"/* Generated from Dragon Quest III analysis */",
+            f"/* Base Address: ${structure.base_address:04X} */",
+            f"/* Size: {structure.total_size} bytes */",
+            "",
+            f"#ifndef {guard}",
+            f"#define {guard}",
+            "",
+            "#include <cstddef>",
+            "#include <cstdint>",
+            "#include <span>",
+            "",
+            '#include "dq3_view.hpp"',
+            f'#include "{name.lower()}.h"',
+            "",
+            "namespace dq3 {",
+            "",
+            "#pragma pack(push, 1)",
+            f"struct {name}_Packed {{",
+        ]
+
+        for offset, size, field in layout:
+            if field is None:
+                lines.append(f"\tuint8_t Reserved_{offset:02X}[{size}]; /* Undocumented +{offset:02X} */")
+            else:
+                lines.append(f"\tuint8_t {self._c_identifier(field.name)}[{size}]; /* +{offset:02X} */")
+
+        lines.extend(
+            [
+                "};",
+                "#pragma pack(pop)",
+                "",
+                f'static_assert(sizeof({name}_Packed) == {size_macro}, "{name}_Packed must match the WRAM block size");',
+            ]
+        )
+
+        for offset, size, field in layout:
+            member = f"Reserved_{offset:02X}" if field is None else self._c_identifier(field.name)
+            lines.append(f"static_assert(offsetof({name}_Packed, {member}) == 0x{offset:02X});")
+
+        lines.extend(
+            [
+                "",
+                f"class {name}_View {{",
+                "public:",
+                f"\tstatic constexpr uint32_t base_addr = {base_macro};",
+                f"\tstatic constexpr std::size_t size = {size_macro};",
+                "",
+                f"\tconstexpr explicit {name}_View(std::span<const uint8_t, {size_macro}> bytes) : bytes_(bytes) {{}}",
+                "",
+                "\t/* wram must cover at least base_addr + size bytes (e.g. a full 128KB WRAM dump) */",
+                f"\tstatic {name}_View from_wram(std::span<const uint8_t> wram) {{",
+                f"\t\treturn {name}_View(wram.subspan<{base_macro}, {size_macro}>());",
+                "\t}",
+                "",
+                f"\tconst {name}_Packed& raw() const {{ return *reinterpret_cast<const {name}_Packed*>(bytes_.data()); }}",
+                f"\tstd::span<const uint8_t, {size_macro}> bytes() const {{ return bytes_; }}",
+                "",
+            ]
+        )
+
+        for field in structure.fields:
+            accessor = self._c_identifier(field.name)
+            width = self.SCALAR_WIDTHS.get(field.data_type)
+            comment = field.description.replace("\n", " ")
+
+            if width == field.size == 1:
+                body = f"uint8_t {accessor}() const {{ return bytes_[0x{field.offset:02X}]; }}"
+            elif width == field.size == 2:
+                body = f"uint16_t {accessor}() const {{ return read_u16le(bytes_.data() + 0x{field.offset:02X}); }}"
+            elif width == field.size == 3:
+                body = f"uint32_t {accessor}() const {{ return read_u24le(bytes_.data() + 0x{field.offset:02X}); }}"
+            else:
+                # Strings, flag blocks and per-slot tables are exposed as fixed-extent byte spans
+                body = (
+                    f"std::span<const uint8_t, {field.size}> {accessor}() const "
+                    f"{{ return bytes_.subspan<0x{field.offset:02X}, {field.size}>(); }}"
+                )
+
+            lines.extend([f"\t/* {comment} */", f"\t{body}"])
+
+        lines.extend(
+            [
+                "",
+                "private:",
+                f"\tstd::span<const uint8_t, {size_macro}> bytes_;",
+                "};",
+                "",
+                "} /* namespace dq3 */",
+                "",
+                f"#endif /* {guard} */",
+                "",
+            ]
+        )
+
+        with open(headers_dir / f"{name.lower()}_view.hpp", "w") as f:
+            f.write("\n".join(lines))
 
     def _generate_analysis_report(self, output_path: Path):
         """Generate analysis and statistics report"""
@@ -620,7 +1047,7 @@ def main():
     print(f"\n🎯 Documentation generated in: {args.output}/")
     print("   📄 dq3_data_structures.md - Master documentation")
     print("   📂 structures/ - Individual structure docs")
-    print("   🔧 headers/ - C header files")
+    print("   🔧 headers/ - C header files + packed C++ views (*_view.hpp)")
     print("   📊 dq3_analysis_report.md - Statistical analysis")
 
 
@@ -347,10 +347,10 @@ class CodeFormatter:
                 "errors": [],
             }
 
-    def format_all_files(self, verbose: bool = False) -> Dict[str, Any]:
-        """Format all files in the project"""
+    def format_all_files(self, verbose: bool = False, files: Optional[List[Path]] = None) -> Dict[str, Any]:
+        """Format all files in the project (or only files)"""
         start_time = time.time()
-        files_to_format = self.find_files_to_format()
+        files_to_format = self.find_files_to_format() if files is None else list(files)
 
         results = {
             "timestamp": time.strftime("%Y-%m-%d %H:%M:%S"),
@@ -472,12 +472,12 @@ class CodeFormatter:
         return compliance_result
 
 
-def run_automated_formatting():
+def run_automated_formatting(formatter: Optional[CodeFormatter] = None, files: Optional[List[Path]] = None):
     """Main function to run automated formatting every prompt"""
-    formatter = CodeFormatter()
+    formatter = formatter or CodeFormatter()
 
     # Run formatting
-    results = formatter.format_all_files()
+    results = formatter.format_all_files(files=files)
 
     # Check EditorConfig compliance
     compliance = formatter.check_editorconfig_compliance()